@@ -0,0 +1,304 @@
+#include "async_logger.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct LoggerState {
+    std::mutex mutex;   // 保护 rings / output / 启停
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::thread writer;
+    std::atomic<bool> running{false};
+    bool stopped = false;
+    FILE* output = stdout;
+    bool owns_output = false;
+    size_t ring_capacity = 1 << 20;
+    uint32_t next_thread_id = 1;
+
+    std::atomic<uint64_t> flush_requested{0};
+    uint64_t flush_completed = 0;
+    std::condition_variable flush_cv;
+
+    ~LoggerState() {
+        AsyncLogger::shutdown();
+        if (owns_output && output) {
+            fclose(output);
+        }
+    }
+};
+
+LoggerState& state() {
+    static LoggerState instance;
+    return instance;
+}
+
+// 线程退出时只做标记，后台线程写完剩余记录后再回收
+struct ThreadRingHolder {
+    std::shared_ptr<LogRing> ring;
+    ~ThreadRingHolder() {
+        if (ring) ring->retired = true;
+    }
+};
+
+const char* level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO ";
+        case LogLevel::Warn: return "WARN ";
+        case LogLevel::Error: return "ERROR";
+        default: return "?    ";
+    }
+}
+
+template <typename T>
+void append_number(std::string& out, T value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+}
+
+std::atomic<uint8_t> AsyncLogger::runtime_level_{static_cast<uint8_t>(OKX_LOG_LEVEL)};
+std::atomic<uint64_t> AsyncLogger::dropped_{0};
+
+LogRing::LogRing(size_t capacity)
+    : buffer_(new char[std::bit_ceil(std::max<size_t>(capacity, 4096))]),
+      capacity_(std::bit_ceil(std::max<size_t>(capacity, 4096))),
+      mask_(capacity_ - 1) {}
+
+char* LogRing::reserve(size_t size) {
+    uint64_t length = (size + sizeof(uint64_t) + 7) & ~uint64_t(7);
+    if (length > capacity_ / 2) return nullptr;
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    size_t offset = head & mask_;
+    size_t contiguous = capacity_ - offset;
+    uint64_t needed = contiguous < length ? length + contiguous : length;
+
+    if (head + needed - cached_tail_ > capacity_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head + needed - cached_tail_ > capacity_) return nullptr;
+    }
+
+    if (contiguous < length) {
+        uint64_t padding = contiguous | kPaddingFlag;
+        memcpy(buffer_.get() + offset, &padding, sizeof(padding));
+        head += contiguous;
+        offset = 0;
+    }
+
+    memcpy(buffer_.get() + offset, &length, sizeof(length));
+    pending_head_ = head + length;
+    return buffer_.get() + offset + sizeof(uint64_t);
+}
+
+void LogRing::commit() {
+    head_.store(pending_head_, std::memory_order_release);
+}
+
+int64_t AsyncLogger::realtime_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+LogRing* AsyncLogger::thread_ring() {
+    thread_local ThreadRingHolder holder;
+    if (holder.ring) return holder.ring.get();
+
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.stopped) return nullptr;
+
+    holder.ring = std::make_shared<LogRing>(s.ring_capacity);
+    holder.ring->thread_id = s.next_thread_id++;
+    s.rings.push_back(holder.ring);
+
+    if (!s.running) {
+        s.running = true;
+        s.writer = std::thread(&AsyncLogger::writer_loop);
+    }
+    return holder.ring.get();
+}
+
+void AsyncLogger::set_output(FILE* output) {
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.owns_output && s.output) {
+        fclose(s.output);
+    }
+    s.output = output;
+    s.owns_output = false;
+}
+
+bool AsyncLogger::open_file(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "a");
+    if (!file) return false;
+
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.owns_output && s.output) {
+        fclose(s.output);
+    }
+    s.output = file;
+    s.owns_output = true;
+    return true;
+}
+
+void AsyncLogger::set_ring_capacity(size_t bytes) {
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.ring_capacity = bytes;
+}
+
+void AsyncLogger::flush() {
+    LoggerState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    if (!s.running) return;
+
+    uint64_t target = s.flush_requested.fetch_add(1) + 1;
+    s.flush_cv.notify_all();
+    s.flush_cv.wait(lock, [&] { return s.flush_completed >= target || !s.running; });
+}
+
+void AsyncLogger::shutdown() {
+    LoggerState& s = state();
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stopped = true;
+        s.running = false;
+        writer = std::move(s.writer);
+    }
+    // 后台线程退出前会再写一遍剩余记录
+    if (writer.joinable()) {
+        writer.join();
+    }
+    s.flush_cv.notify_all();
+}
+
+void AsyncLogger::writer_loop() {
+    LoggerState& s = state();
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::string text;
+    // (时间戳, 起始偏移, 长度)，同一轮内多线程记录按时间排序后输出
+    std::vector<std::tuple<int64_t, size_t, size_t>> lines;
+    std::string ordered;
+
+    while (true) {
+        bool running = s.running.load();
+        uint64_t flush_target = s.flush_requested.load();
+
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            rings = s.rings;
+        }
+
+        text.clear();
+        lines.clear();
+        for (const auto& ring : rings) {
+            ring->drain([&](const char* payload, size_t size) {
+                RecordHeader header;
+                memcpy(&header, payload, sizeof(header));
+                size_t start = text.size();
+                format_record(payload, size, ring->thread_id, text);
+                lines.emplace_back(header.timestamp_ns, start, text.size() - start);
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(s.mutex);
+        if (!lines.empty() && s.output) {
+            std::stable_sort(lines.begin(), lines.end(),
+                             [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+            ordered.clear();
+            for (const auto& [timestamp, start, length] : lines) {
+                ordered.append(text, start, length);
+            }
+            fwrite(ordered.data(), 1, ordered.size(), s.output);
+            fflush(s.output);
+        }
+
+        // 线程已退出且已写空的环可以回收
+        std::erase_if(s.rings, [](const std::shared_ptr<LogRing>& ring) { return ring->retired && ring->empty(); });
+
+        if (flush_target > s.flush_completed) {
+            s.flush_completed = flush_target;
+            s.flush_cv.notify_all();
+        }
+        if (!running) break;
+
+        if (lines.empty()) {
+            // 空闲时让出CPU；flush() 请求会在下一轮立即处理
+            s.flush_cv.wait_for(lock, std::chrono::milliseconds(1), [&] {
+                return s.flush_requested.load() > s.flush_completed || !s.running;
+            });
+        }
+    }
+}
+
+void AsyncLogger::format_record(const char* payload, size_t size, uint32_t thread_id, std::string& out) {
+    RecordHeader header;
+    memcpy(&header, payload, sizeof(header));
+    const char* cursor = payload + sizeof(header);
+    const char* end = payload + size;
+
+    time_t seconds = static_cast<time_t>(header.timestamp_ns / 1000000000);
+    tm local;
+    localtime_r(&seconds, &local);
+    char stamp[48];
+    size_t stamp_len = strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+    stamp_len += snprintf(stamp + stamp_len, sizeof(stamp) - stamp_len, ".%06lld",
+                          static_cast<long long>(header.timestamp_ns % 1000000000 / 1000));
+    out.append(stamp, stamp_len);
+    out += ' ';
+    out += level_name(header.site->level);
+    out += " [T";
+    append_number(out, thread_id);
+    out += "] ";
+
+    const char* format = header.site->format;
+    while (*format) {
+        if (format[0] == '{' && format[1] == '}') {
+            format += 2;
+            if (cursor >= end) continue;
+
+            uint8_t tag = static_cast<uint8_t>(*cursor++);
+            if (tag == TagString) {
+                uint32_t length;
+                memcpy(&length, cursor, sizeof(length));
+                out.append(cursor + sizeof(length), length);
+                cursor += sizeof(length) + length;
+                continue;
+            }
+
+            uint64_t bits;
+            memcpy(&bits, cursor, sizeof(bits));
+            cursor += sizeof(bits);
+            switch (tag) {
+                case TagInt: append_number(out, static_cast<int64_t>(bits)); break;
+                case TagUint: append_number(out, bits); break;
+                case TagDouble: {
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+                    append_number(out, value);
+                    break;
+                }
+                case TagBool: out += bits ? "true" : "false"; break;
+                case TagChar: out += static_cast<char>(bits); break;
+                default: break;
+            }
+        } else {
+            out += *format++;
+        }
+    }
+    out += '\n';
+}
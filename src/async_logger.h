@@ -0,0 +1,241 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// 编译期日志级别，低于该级别的调用连同参数求值一起被编译掉
+#define OKX_LOG_LEVEL_DEBUG 0
+#define OKX_LOG_LEVEL_INFO 1
+#define OKX_LOG_LEVEL_WARN 2
+#define OKX_LOG_LEVEL_ERROR 3
+#define OKX_LOG_LEVEL_OFF 4
+
+#ifndef OKX_LOG_LEVEL
+#define OKX_LOG_LEVEL OKX_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
+
+// 每个调用点一份静态描述，记录里只存它的地址作为格式id
+struct LogSite {
+    LogLevel level;
+    const char* format;   // "{}" 为参数占位符
+    const char* file;
+    int line;
+};
+
+// 单生产者单消费者字节环，每个写日志的线程一个。
+// 记录格式: [uint64 长度][payload]，长度按8字节对齐；环尾放不下时写一条填充记录后回绕
+class LogRing {
+public:
+    explicit LogRing(size_t capacity);
+
+    // 预留 size 字节的连续空间，满时返回 nullptr（调用方丢弃该条）
+    char* reserve(size_t size);
+    void commit();
+
+    // 消费端: 对每条记录调用 fn(payload, size)
+    template <typename Fn>
+    size_t drain(Fn&& fn);
+
+    bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+    std::atomic<bool> retired{false};
+    uint32_t thread_id = 0;
+
+private:
+    static constexpr uint64_t kPaddingFlag = uint64_t(1) << 63;
+
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;
+    uint64_t pending_head_ = 0;
+    alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+template <typename Fn>
+size_t LogRing::drain(Fn&& fn) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    size_t count = 0;
+
+    while (tail < head) {
+        const char* record = buffer_.get() + (tail & mask_);
+        uint64_t length;
+        memcpy(&length, record, sizeof(length));
+        if (length & kPaddingFlag) {
+            tail += length & ~kPaddingFlag;
+            continue;
+        }
+        fn(record + sizeof(uint64_t), static_cast<size_t>(length - sizeof(uint64_t)));
+        tail += length;
+        ++count;
+    }
+    tail_.store(tail, std::memory_order_release);
+    return count;
+}
+
+class AsyncLogger {
+public:
+    // 热路径: 编码为 [site指针, 时间戳, 参数...] 写入本线程的环，不做格式化和I/O
+    template <typename... Args>
+    static void log(const LogSite* site, const Args&... args);
+
+    static bool enabled(LogLevel level) {
+        return static_cast<uint8_t>(level) >= runtime_level_.load(std::memory_order_relaxed);
+    }
+    // 运行期可以进一步提高级别，不能低于编译期级别
+    static void set_level(LogLevel level) {
+        uint8_t value = static_cast<uint8_t>(level);
+        runtime_level_ = value > OKX_LOG_LEVEL ? value : static_cast<uint8_t>(OKX_LOG_LEVEL);
+    }
+
+    // 输出目标，默认 stdout；open_file 以追加方式打开
+    static void set_output(FILE* output);
+    static bool open_file(const std::string& path);
+    // 新线程的环大小（字节，取整为2的幂），需在该线程第一次写日志前设置
+    static void set_ring_capacity(size_t bytes);
+
+    // 等待后台线程把当前所有记录写出
+    static void flush();
+    static void shutdown();
+    static uint64_t dropped() { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    enum Tag : uint8_t { TagInt = 1, TagUint, TagDouble, TagBool, TagChar, TagString };
+
+    struct RecordHeader {
+        const LogSite* site;
+        int64_t timestamp_ns;
+    };
+
+    static std::atomic<uint8_t> runtime_level_;
+    static std::atomic<uint64_t> dropped_;
+
+    static LogRing* thread_ring();
+    static int64_t realtime_ns();
+
+    template <typename T>
+    static size_t encoded_size(const T& value);
+    template <typename T>
+    static char* encode(char* out, const T& value);
+
+
+    // 后台线程: 轮询所有线程的环，格式化后批量写出
+    static void writer_loop();
+    static void format_record(const char* payload, size_t size, uint32_t thread_id, std::string& out);
+};
+
+template <typename T>
+size_t AsyncLogger::encoded_size(const T& value) {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return 1 + sizeof(uint32_t) + std::string_view(value).size();
+    } else {
+        return 1 + 8;
+    }
+}
+
+template <typename T>
+char* AsyncLogger::encode(char* out, const T& value) {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        std::string_view text(value);
+        uint32_t length = static_cast<uint32_t>(text.size());
+        *out++ = TagString;
+        memcpy(out, &length, sizeof(length));
+        memcpy(out + sizeof(length), text.data(), length);
+        return out + sizeof(length) + length;
+    } else {
+        uint8_t tag;
+        uint64_t bits = 0;
+        if constexpr (std::is_same_v<T, bool>) {
+            tag = TagBool;
+            bits = value ? 1 : 0;
+        } else if constexpr (std::is_same_v<T, char>) {
+            tag = TagChar;
+            bits = static_cast<unsigned char>(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            tag = TagDouble;
+            double d = static_cast<double>(value);
+            memcpy(&bits, &d, sizeof(d));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            tag = TagInt;
+            int64_t v = value;
+            memcpy(&bits, &v, sizeof(v));
+        } else if constexpr (std::is_integral_v<T>) {
+            tag = TagUint;
+            bits = value;
+        } else if constexpr (std::is_enum_v<T>) {
+            tag = TagInt;
+            int64_t v = static_cast<int64_t>(value);
+            memcpy(&bits, &v, sizeof(v));
+        } else {
+            static_assert(sizeof(T) == 0, "unsupported log argument type");
+        }
+        *out++ = static_cast<char>(tag);
+        memcpy(out, &bits, sizeof(bits));
+        return out + sizeof(bits);
+    }
+}
+
+template <typename... Args>
+void AsyncLogger::log(const LogSite* site, const Args&... args) {
+    if (!enabled(site->level)) return;
+
+    LogRing* ring = thread_ring();
+    size_t size = sizeof(RecordHeader) + (size_t(0) + ... + encoded_size(args));
+    char* out = ring ? ring->reserve(size) : nullptr;
+    if (!out) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    RecordHeader header{site, realtime_ns()};
+    memcpy(out, &header, sizeof(header));
+    char* cursor = out + sizeof(header);
+    ((cursor = encode(cursor, args)), ...);
+    (void)cursor;
+    ring->commit();
+}
+
+#define OKX_LOG_AT(level_value, fmt, ...)                                                   \
+    do {                                                                                  \
+        static constexpr LogSite okx_log_site_{level_value, fmt, __FILE__, __LINE__};     \
+        AsyncLogger::log(&okx_log_site_ __VA_OPT__(, ) __VA_ARGS__);                      \
+    } while (0)
+
+// 被过滤的级别: 参数只做类型检查，不求值也不产生代码
+#define OKX_LOG_DISABLED(fmt, ...)                                                        \
+    do {                                                                                  \
+        if constexpr (false) AsyncLogger::log(nullptr __VA_OPT__(, ) __VA_ARGS__);        \
+    } while (0)
+
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_DEBUG
+#define OKX_LOG_DEBUG(fmt, ...) OKX_LOG_AT(LogLevel::Debug, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define OKX_LOG_DEBUG(fmt, ...) OKX_LOG_DISABLED(fmt __VA_OPT__(, ) __VA_ARGS__)
+#endif
+
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_INFO
+#define OKX_LOG_INFO(fmt, ...) OKX_LOG_AT(LogLevel::Info, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define OKX_LOG_INFO(fmt, ...) OKX_LOG_DISABLED(fmt __VA_OPT__(, ) __VA_ARGS__)
+#endif
+
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_WARN
+#define OKX_LOG_WARN(fmt, ...) OKX_LOG_AT(LogLevel::Warn, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define OKX_LOG_WARN(fmt, ...) OKX_LOG_DISABLED(fmt __VA_OPT__(, ) __VA_ARGS__)
+#endif
+
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_ERROR
+#define OKX_LOG_ERROR(fmt, ...) OKX_LOG_AT(LogLevel::Error, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define OKX_LOG_ERROR(fmt, ...) OKX_LOG_DISABLED(fmt __VA_OPT__(, ) __VA_ARGS__)
+#endif
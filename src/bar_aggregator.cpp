@@ -0,0 +1,161 @@
+#include "bar_aggregator.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+template <typename T>
+bool parse_number(std::string_view text, T& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && !text.empty();
+}
+
+// 向下对齐，负数时间也正确
+int64_t align_down(int64_t ms, int64_t interval) {
+    int64_t remainder = ms % interval;
+    return remainder < 0 ? ms - remainder - interval : ms - remainder;
+}
+
+}
+
+BarAggregator::BarAggregator(std::vector<int64_t> intervals_ms, int64_t grace_ms, int64_t resolution_ms)
+    : intervals_(std::move(intervals_ms)),
+      grace_ms_(grace_ms > 0 ? grace_ms : 0),
+      resolution_ms_(resolution_ms > 0 ? resolution_ms : 1),
+      wheel_(to_tick(now_ms())),
+      stats_{} {
+    // 非正周期没有意义，直接去掉
+    intervals_.erase(std::remove_if(intervals_.begin(), intervals_.end(), [](int64_t ms) { return ms <= 0; }),
+                     intervals_.end());
+}
+
+void BarAggregator::on_tick(const TickerView& ticker) {
+    double price = 0;
+    if (!parse_number(ticker.last, price)) {
+        return;
+    }
+    double vol24h = NAN;
+    parse_number(ticker.vol24h, vol24h);
+    int64_t ts = 0;
+    if (!parse_number(ticker.ts, ts)) {
+        ts = now_ms();
+    }
+    on_tick(ticker.inst_id, price, vol24h, ts);
+}
+
+void BarAggregator::on_tick(std::string_view inst_id, double price, double vol24h, int64_t ts_ms) {
+    uint32_t instrument = acquire(inst_id);
+    stats_.ticks++;
+
+    double delta = 0;
+    double& last_vol = last_vol24h_[instrument];
+    if (!std::isnan(vol24h)) {
+        if (!std::isnan(last_vol) && vol24h > last_vol) {
+            delta = vol24h - last_vol;
+        }
+        last_vol = vol24h;
+    }
+
+    bool late = false;
+    size_t count = intervals_.size();
+    uint32_t base = instrument * static_cast<uint32_t>(count);
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t slot = base + static_cast<uint32_t>(k);
+        State& state = states_[slot];
+        int64_t start = align_down(ts_ms, intervals_[k]);
+
+        if (state.open_bar && start > state.start_ms) {
+            close(slot);
+        }
+        if (state.open_bar ? start < state.start_ms : start < state.closed_end_ms) {
+            late = true;
+            continue;
+        }
+
+        if (!state.open_bar) {
+            state.start_ms = start;
+            state.open = state.high = state.low = price;
+            state.volume = 0;
+            state.ticks = 0;
+            state.open_bar = true;
+            // 向上取整，保证不会早于 grace 收线
+            wheel_.schedule(slot, to_tick(start + intervals_[k] + grace_ms_ + resolution_ms_ - 1));
+        }
+        state.high = std::max(state.high, price);
+        state.low = std::min(state.low, price);
+        state.close = price;
+        state.volume += delta;
+        state.ticks++;
+    }
+    if (late) {
+        stats_.late_ticks++;
+    }
+}
+
+void BarAggregator::poll(int64_t now_ms) {
+    wheel_.advance(to_tick(now_ms), [&](uint32_t slot) {
+        const State& state = states_[slot];
+        if (!state.open_bar) return;
+        if (state.start_ms + intervals_[slot % intervals_.size()] + grace_ms_ > now_ms) {
+            wheel_.schedule(slot, wheel_.current_tick() + 1);
+            return;
+        }
+        stats_.timer_closes++;
+        close(slot);
+    });
+}
+
+void BarAggregator::flush() {
+    if (pending_.empty()) return;
+    if (callback_) {
+        callback_(std::span<const Bar>(pending_));
+    }
+    // 保留容量，下一批不再分配
+    pending_.clear();
+}
+
+int64_t BarAggregator::now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint32_t BarAggregator::acquire(std::string_view inst_id) {
+    auto it = index_.find(inst_id);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    uint32_t instrument = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(inst_id);
+    index_.emplace(names_.back(), instrument);
+    states_.resize(states_.size() + intervals_.size());
+    last_vol24h_.push_back(NAN);
+    return instrument;
+}
+
+void BarAggregator::close(uint32_t slot) {
+    State& state = states_[slot];
+    size_t k = slot % intervals_.size();
+    Bar bar;
+    bar.inst_id = names_[slot / intervals_.size()];
+    bar.interval_ms = intervals_[k];
+    bar.start_ms = state.start_ms;
+    bar.open = state.open;
+    bar.high = state.high;
+    bar.low = state.low;
+    bar.close = state.close;
+    bar.volume = state.volume;
+    bar.ticks = state.ticks;
+    pending_.push_back(bar);
+
+    state.open_bar = false;
+    state.closed_end_ms = state.start_ms + intervals_[k];
+    wheel_.cancel(slot);
+    stats_.bars_closed++;
+}
+
+uint64_t BarAggregator::to_tick(int64_t ms) const {
+    return ms > 0 ? static_cast<uint64_t>(ms / resolution_ms_) : 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "ticker_batch.h"
+#include "timer_wheel.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// OHLCV K线聚合: 每个交易对同时维护多个周期，状态按 交易对id x 周期 平铺存放
+// 按 ticker 的 ts（事件时间）划分K线；行情停顿时由时间轮在 周期结束 + grace 后收线
+
+struct Bar {
+    std::string_view inst_id;   // 指向聚合器内部，聚合器存活期间有效
+    int64_t interval_ms;
+    int64_t start_ms;           // 按周期对齐的开始时间
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;              // 相邻 vol24h 的差值之和，负差值（24h 窗口滑出）记为 0
+    uint32_t ticks;
+};
+
+struct BarStats {
+    uint64_t ticks;
+    uint64_t late_ticks;        // ts 落在已收线K线内，被丢弃
+    uint64_t bars_closed;
+    uint64_t timer_closes;      // 其中由时间轮收线的数量
+};
+
+class BarAggregator {
+public:
+    using BarCallback = std::function<void(std::span<const Bar>)>;
+
+    // resolution_ms 为时间轮精度
+    explicit BarAggregator(std::vector<int64_t> intervals_ms = {1000, 60000, 300000},
+                           int64_t grace_ms = 250, int64_t resolution_ms = 10);
+
+    // 收线的K线先攒着，flush() 时一次交付
+    void set_callback(BarCallback callback) { callback_ = std::move(callback); }
+
+    // 解析 last/vol24h/ts 后累加；ts 缺失时使用本机时间
+    void on_tick(const TickerView& ticker);
+    void on_tick(std::string_view inst_id, double price, double vol24h, int64_t ts_ms);
+    // 按本机时间收掉超过 周期结束 + grace 仍无新 tick 的K线
+    void poll(int64_t now_ms);
+    void flush();
+
+    const std::vector<int64_t>& intervals() const { return intervals_; }
+    size_t instrument_count() const { return names_.size(); }
+    BarStats stats() const { return stats_; }
+
+    // Unix 毫秒，与 OKX ts 同一时间基准
+    static int64_t now_ms();
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+    };
+
+    struct State {
+        int64_t start_ms = 0;
+        int64_t closed_end_ms = INT64_MIN;  // 上一根已收线K线的结束时间
+        double open = 0;
+        double high = 0;
+        double low = 0;
+        double close = 0;
+        double volume = 0;
+        uint32_t ticks = 0;
+        bool open_bar = false;
+    };
+
+    std::vector<int64_t> intervals_;
+    int64_t grace_ms_;
+    int64_t resolution_ms_;
+    BarCallback callback_;
+    TimerWheel wheel_;
+
+    // 时间轮 id 即 instrument * intervals_.size() + k
+    std::vector<State> states_;
+    std::vector<double> last_vol24h_;
+    // deque 追加时不移动已有元素，Bar::inst_id 可以直接指向这里
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, uint32_t, StringHash, std::equal_to<>> index_;
+
+    std::vector<Bar> pending_;
+    BarStats stats_;
+
+    uint32_t acquire(std::string_view inst_id);
+    void close(uint32_t slot);
+    uint64_t to_tick(int64_t ms) const;
+};
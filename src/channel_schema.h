@@ -0,0 +1,343 @@
+#pragma once
+#include "json_scanner.h"
+#include "json_validator.h"
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 字段解码方式，由成员类型推导
+enum class FieldKind : uint8_t {
+    String,   // std::string，拷贝并反转义
+    View,     // std::string_view，零拷贝指向输入，保留原始转义文本
+    Int64,    // int64_t，例如毫秒时间戳
+    Decimal   // double
+};
+
+using FieldMask = uint64_t;
+// 所有字段，超出字段数的位被忽略
+constexpr FieldMask kAllFields = ~FieldMask(0);
+
+template <typename M>
+constexpr FieldKind field_kind_of() {
+    if constexpr (std::is_same_v<M, std::string>) return FieldKind::String;
+    else if constexpr (std::is_same_v<M, std::string_view>) return FieldKind::View;
+    else if constexpr (std::is_same_v<M, int64_t>) return FieldKind::Int64;
+    else {
+        static_assert(std::is_same_v<M, double>, "unsupported schema member type");
+        return FieldKind::Decimal;
+    }
+}
+
+template <typename T, typename M>
+struct FieldDesc {
+    std::string_view key;
+    M T::* member;
+    FieldKind kind;
+};
+
+template <typename T, typename M>
+constexpr FieldDesc<T, M> field(std::string_view key, M T::* member) {
+    return {key, member, field_kind_of<M>()};
+}
+
+// 每个频道结构体特化此模板，提供:
+//   static constexpr std::string_view channel;
+//   static constexpr auto fields = std::make_tuple(field("instId", &T::inst_id), ...);
+template <typename T>
+struct ChannelSchema;
+
+// 由 ChannelSchema 在编译期生成解析器、key分发完美哈希、序列化器和字段掩码
+template <typename T>
+class SchemaCodec {
+public:
+    static constexpr size_t field_count = std::tuple_size_v<std::decay_t<decltype(ChannelSchema<T>::fields)>>;
+    static_assert(field_count > 0 && field_count <= 64, "schema must have 1..64 fields");
+
+    static constexpr std::string_view channel() { return ChannelSchema<T>::channel; }
+
+    static constexpr FieldMask full_mask() {
+        return field_count == 64 ? ~FieldMask(0) : (FieldMask(1) << field_count) - 1;
+    }
+
+    // 编译期按key取字段位，未知key会导致编译错误
+    static constexpr FieldMask mask_of(std::string_view key) {
+        for (size_t i = 0; i < field_count; ++i) {
+            if (keys_[i] == key) return FieldMask(1) << i;
+        }
+        throw "unknown schema key";
+    }
+
+    static constexpr std::string_view key_at(size_t index) { return keys_[index]; }
+
+    // key -> 字段下标，未知key返回 field_count
+    static size_t lookup(std::string_view key) {
+        size_t index = table_[hash(key, hash_seed_) & (table_size_ - 1)];
+        if (index < field_count && keys_[index] == key) return index;
+        return field_count;
+    }
+
+    // 单趟解析对象第一层成员，返回出现过的字段掩码；未出现的字段被重置
+    // wanted 之外的字段直接跳过，wanted 全部找到后停止扫描
+    static FieldMask parse_object(std::string_view json, T& out, FieldMask wanted = full_mask()) {
+        FieldMask present = 0;
+        JsonScanner::for_each_member(json, [&](std::string_view key, std::string_view value, bool) {
+            return decode_member(key, value, out, present, wanted);
+        });
+        reset_missing(out, present);
+        return present;
+    }
+
+    // 供其它遍历器（如结构索引）逐个喂入成员；返回 false 表示 wanted 已全部找到
+    static bool decode_member(std::string_view key, std::string_view value, T& out, FieldMask& present, FieldMask wanted = full_mask()) {
+        return decode_index(lookup(key), value, out, present, wanted);
+    }
+
+    // 同上，expected 为预计的字段下标: 推送通常按字段表顺序排列 key，先比一次 key 命中就不用算哈希
+    static bool decode_member(std::string_view key, std::string_view value, T& out, FieldMask& present, FieldMask wanted,
+                              size_t& expected) {
+        size_t index = expected < field_count && keys_[expected] == key ? expected : lookup(key);
+        expected = index + 1;
+        return decode_index(index, value, out, present, wanted);
+    }
+
+    static bool decode_index(size_t index, std::string_view value, T& out, FieldMask& present, FieldMask wanted) {
+        FieldMask bit = index < field_count ? FieldMask(1) << index : 0;
+        if (bit & wanted & ~present) {
+            decoders_[index](out, value);
+            present |= bit;
+        }
+        return (present & wanted) != wanted;
+    }
+
+    static void reset_missing(T& out, FieldMask present) {
+        FieldMask missing = full_mask() & ~present;
+        if (missing) {
+            reset_fields(out, missing);
+        }
+    }
+
+    // 解析完整频道推送 {"arg":{"channel":...},"data":[...]}，复用 out 中已有元素的容量
+    static bool parse_message(std::string_view json, std::vector<T>& out, FieldMask wanted = full_mask()) {
+        std::string_view data;
+        bool channel_matched = false;
+
+        JsonScanner::for_each_member(json, [&](std::string_view key, std::string_view value, bool is_string) {
+            if (key == "arg" && !is_string) {
+                JsonScanner::for_each_member(value, [&](std::string_view arg_key, std::string_view arg_value, bool) {
+                    if (arg_key == "channel") {
+                        channel_matched = arg_value == channel();
+                        return false;
+                    }
+                    return true;
+                });
+            } else if (key == "data" && !is_string) {
+                data = value;
+            }
+            return true;
+        });
+
+        if (!channel_matched) {
+            out.clear();
+            return false;
+        }
+        return parse_data(data, out, wanted);
+    }
+
+    // 只解析 data 数组，调用方已确认频道（如客户端按 arg.channel 分发后）
+    static bool parse_data(std::string_view data, std::vector<T>& out, FieldMask wanted = full_mask()) {
+        if (data.empty()) {
+            out.clear();
+            return false;
+        }
+
+        size_t count = 0;
+        JsonScanner::for_each_element(data, [&](std::string_view element) {
+            if (element.empty() || element.front() != '{') return true;
+            if (count == out.size()) out.emplace_back();
+            parse_object(element, out[count], wanted);
+            ++count;
+            return true;
+        });
+
+        out.resize(count);
+        return count > 0;
+    }
+
+    // 按字段表顺序访问每个成员: fn(key, member&)
+    template <typename Fn>
+    static void for_each_field(T& value, Fn&& fn) {
+        for_each_field_impl(value, fn, std::make_index_sequence<field_count>{});
+    }
+
+    static void serialize(const T& value, std::string& out) {
+        out.push_back('{');
+        serialize_fields(value, out, std::make_index_sequence<field_count>{});
+        out.push_back('}');
+    }
+
+    static std::string serialize(const T& value) {
+        std::string out;
+        serialize(value, out);
+        return out;
+    }
+
+private:
+    using Decoder = void (*)(T&, std::string_view);
+
+    template <size_t I>
+    static constexpr const auto& field_at() {
+        return std::get<I>(ChannelSchema<T>::fields);
+    }
+
+    template <size_t... I>
+    static constexpr std::array<std::string_view, field_count> make_keys(std::index_sequence<I...>) {
+        return {field_at<I>().key...};
+    }
+
+    static constexpr std::array<std::string_view, field_count> keys_ = make_keys(std::make_index_sequence<field_count>{});
+
+    // FNV-1a，种子在编译期搜索直到所有key落到不同槽位
+    static constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+        for (char c : key) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    struct HashParams {
+        size_t size;
+        uint32_t seed;
+    };
+
+    static constexpr HashParams find_hash_params() {
+        size_t size = 1;
+        while (size < field_count * 2) size <<= 1;
+
+        for (; size <= 4096; size <<= 1) {
+            for (uint32_t seed = 0; seed < 20000; ++seed) {
+                uint64_t used[64] = {};
+                bool ok = true;
+                for (size_t i = 0; i < field_count && ok; ++i) {
+                    size_t slot = hash(keys_[i], seed) & (size - 1);
+                    ok = !(used[slot / 64] & (uint64_t(1) << (slot % 64)));
+                    used[slot / 64] |= uint64_t(1) << (slot % 64);
+                }
+                if (ok) return {size, seed};
+            }
+        }
+        throw "no perfect hash found";
+    }
+
+    static constexpr HashParams hash_params_ = find_hash_params();
+    static constexpr size_t table_size_ = hash_params_.size;
+    static constexpr uint32_t hash_seed_ = hash_params_.seed;
+
+    static constexpr std::array<uint8_t, table_size_> make_table() {
+        std::array<uint8_t, table_size_> table{};
+        for (auto& slot : table) slot = static_cast<uint8_t>(field_count);
+        for (size_t i = 0; i < field_count; ++i) {
+            table[hash(keys_[i], hash_seed_) & (table_size_ - 1)] = static_cast<uint8_t>(i);
+        }
+        return table;
+    }
+
+    static constexpr std::array<uint8_t, table_size_> table_ = make_table();
+
+    template <typename M>
+    static void decode(M& target, std::string_view raw) {
+        constexpr FieldKind kind = field_kind_of<M>();
+        if constexpr (kind == FieldKind::String) {
+            // 行情值几乎不含转义，只有出现反斜杠时才走反转义；非法转义保留原文
+            if (!memchr(raw.data(), '\\', raw.size()) || !JsonValidator::unescape(raw, target)) {
+                target.assign(raw.data(), raw.size());
+            }
+        } else if constexpr (kind == FieldKind::View) {
+            target = raw;
+        } else {
+            target = M{};
+            std::from_chars(raw.data(), raw.data() + raw.size(), target);
+        }
+    }
+
+    template <size_t I>
+    static void decode_field(T& out, std::string_view raw) {
+        decode(out.*(field_at<I>().member), raw);
+    }
+
+    template <size_t... I>
+    static constexpr std::array<Decoder, field_count> make_decoders(std::index_sequence<I...>) {
+        return {&decode_field<I>...};
+    }
+
+    static constexpr std::array<Decoder, field_count> decoders_ = make_decoders(std::make_index_sequence<field_count>{});
+
+    template <typename Fn, size_t... I>
+    static void for_each_field_impl(T& value, Fn& fn, std::index_sequence<I...>) {
+        (fn(field_at<I>().key, value.*(field_at<I>().member)), ...);
+    }
+
+    template <size_t... I>
+    static void reset_fields_impl(T& out, FieldMask missing, std::index_sequence<I...>) {
+        ((missing & (FieldMask(1) << I) ? void(reset(out.*(field_at<I>().member))) : void()), ...);
+    }
+
+    static void reset_fields(T& out, FieldMask missing) {
+        reset_fields_impl(out, missing, std::make_index_sequence<field_count>{});
+    }
+
+    template <typename M>
+    static void reset(M& target) {
+        if constexpr (field_kind_of<M>() == FieldKind::String) {
+            target.clear();
+        } else {
+            target = M{};
+        }
+    }
+
+    static void append_escaped(std::string& out, std::string_view value) {
+        static constexpr char hex[] = "0123456789abcdef";
+        for (char c : value) {
+            auto byte = static_cast<unsigned char>(c);
+            if (byte < 0x20) {
+                out.append("\\u00");
+                out.push_back(hex[byte >> 4]);
+                out.push_back(hex[byte & 0xF]);
+                continue;
+            }
+            if (c == '"' || c == '\\') out.push_back('\\');
+            out.push_back(c);
+        }
+    }
+
+    template <typename M>
+    static void serialize_value(std::string& out, const M& value) {
+        out.push_back('"');
+        if constexpr (field_kind_of<M>() == FieldKind::String) {
+            append_escaped(out, value);
+        } else if constexpr (field_kind_of<M>() == FieldKind::View) {
+            // 视图持有的是输入里的原始转义文本，原样写回
+            out.append(value);
+        } else {
+            // OKX 以字符串形式下发数值，序列化保持一致
+            char buf[32];
+            auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            out.append(buf, result.ptr - buf);
+        }
+        out.push_back('"');
+    }
+
+    template <size_t... I>
+    static void serialize_fields(const T& value, std::string& out, std::index_sequence<I...>) {
+        ((out.append(I == 0 ? "\"" : ",\""), out.append(field_at<I>().key), out.append("\":"),
+          serialize_value(out, value.*(field_at<I>().member))), ...);
+    }
+};
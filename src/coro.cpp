@@ -0,0 +1,125 @@
+#include "coro.h"
+#include <array>
+#include <new>
+
+namespace {
+
+constexpr size_t kClasses = FramePool::kMaxPooledSize / FramePool::kGranularity;
+// 每级最多缓存的空闲帧数，超出的直接归还
+constexpr size_t kMaxCached = 256;
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+struct FreeLists {
+    std::array<FreeFrame*, kClasses> heads{};
+    std::array<size_t, kClasses> counts{};
+
+    ~FreeLists() {
+        for (FreeFrame* head : heads) {
+            while (head) {
+                FreeFrame* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+};
+
+thread_local FreeLists free_lists;
+std::atomic<uint64_t> fresh_count{0};
+
+size_t size_class(size_t size) {
+    return (size + FramePool::kGranularity - 1) / FramePool::kGranularity - 1;
+}
+
+}
+
+void* FramePool::allocate(size_t size) {
+    if (size > kMaxPooledSize) {
+        fresh_count.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    size_t index = size_class(size);
+    if (FreeFrame* frame = free_lists.heads[index]) {
+        free_lists.heads[index] = frame->next;
+        free_lists.counts[index]--;
+        return frame;
+    }
+    fresh_count.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new((index + 1) * kGranularity);
+}
+
+void FramePool::deallocate(void* ptr, size_t size) noexcept {
+    if (size > kMaxPooledSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    // 在哪个线程结束就挂到哪个线程的链表上
+    size_t index = size_class(size);
+    if (free_lists.counts[index] >= kMaxCached) {
+        ::operator delete(ptr);
+        return;
+    }
+    auto* frame = static_cast<FreeFrame*>(ptr);
+    frame->next = free_lists.heads[index];
+    free_lists.heads[index] = frame;
+    free_lists.counts[index]++;
+}
+
+uint64_t FramePool::fresh_allocations() {
+    return fresh_count.load(std::memory_order_relaxed);
+}
+
+void CoroExecutor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(handle);
+    }
+    cv_.notify_one();
+}
+
+size_t CoroExecutor::poll() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ready_.empty()) return 0;
+        running_.swap(ready_);
+    }
+
+    // 恢复期间新 post 的协程进入另一个队列，留到下一轮
+    size_t count = running_.size();
+    for (auto handle : running_) {
+        handle.resume();
+    }
+    running_.clear();
+    return count;
+}
+
+size_t CoroExecutor::run_for(std::chrono::milliseconds timeout) {
+    size_t count = poll();
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!stopped()) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!cv_.wait_until(lock, deadline, [this] { return !ready_.empty() || stopped(); })) {
+                break;
+            }
+        }
+        count += poll();
+    }
+    return count;
+}
+
+void CoroExecutor::run() {
+    while (!stopped()) {
+        run_for(std::chrono::milliseconds(100));
+    }
+}
+
+void CoroExecutor::stop() {
+    stopped_.store(true, std::memory_order_release);
+    cv_.notify_all();
+}
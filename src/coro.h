@@ -0,0 +1,257 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// 协程帧分配器: 按 64 字节分级的线程本地空闲链表，帧释放后留给同尺寸的下一个协程复用
+class FramePool {
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* ptr, size_t size) noexcept;
+    // 实际向 ::operator new 申请的次数，用于确认稳态下不再分配
+    static uint64_t fresh_allocations();
+
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kMaxPooledSize = 4096;
+};
+
+// 在调用 run/poll 的线程上恢复协程；post 可在任意线程调用
+class CoroExecutor {
+public:
+    void post(std::coroutine_handle<> handle);
+
+    // 恢复已就绪的协程，不等待，返回恢复的数量
+    size_t poll();
+    // 最多等待 timeout 后返回，期间就绪的协程都会被恢复
+    size_t run_for(std::chrono::milliseconds timeout);
+    // 一直运行到 stop()
+    void run();
+    void stop();
+    bool stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    // 两个队列交替使用，保留容量，稳态下 post 不分配
+    std::vector<std::coroutine_handle<>> ready_;
+    std::vector<std::coroutine_handle<>> running_;
+    std::atomic<bool> stopped_{false};
+};
+
+// 协程帧统一从 FramePool 分配
+struct PooledPromise {
+    static void* operator new(size_t size) { return FramePool::allocate(size); }
+    static void operator delete(void* ptr, size_t size) noexcept { FramePool::deallocate(ptr, size); }
+};
+
+// 惰性任务: co_await 时才开始执行，结束后对称转移回等待者
+template <typename T = void>
+class Task;
+
+namespace coro_detail {
+
+template <typename Promise>
+struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+};
+
+struct PromiseBase : PooledPromise {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+}
+
+template <typename T>
+class Task {
+public:
+    struct promise_type : coro_detail::PromiseBase {
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        coro_detail::FinalAwaiter<promise_type> final_suspend() noexcept { return {}; }
+        void return_value(T result) { value.emplace(std::move(result)); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    T await_resume() {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+        return std::move(*handle_.promise().value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <>
+class Task<void> {
+public:
+    struct promise_type : coro_detail::PromiseBase {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        coro_detail::FinalAwaiter<promise_type> final_suspend() noexcept { return {}; }
+        void return_void() {}
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    void await_resume() {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace coro_detail {
+
+// spawn 使用的外层协程: 结束时自行销毁
+struct Detached {
+    struct promise_type : PooledPromise {
+        Detached get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+inline Detached run_detached(Task<void> task) {
+    co_await std::move(task);
+}
+
+}
+
+// 在 executor 线程上启动任务，任务结束后自动释放
+inline void spawn(CoroExecutor& executor, Task<void> task) {
+    executor.post(coro_detail::run_detached(std::move(task)).handle);
+}
+
+// 有界异步队列: 生产者在任意线程写入预分配槽位（赋值复用已有容量），
+// 满时覆盖最旧元素并计数；单个消费者用 co_await next() 逐个取出
+template <typename T>
+class AsyncQueue {
+public:
+    AsyncQueue(CoroExecutor* executor, size_t capacity)
+        : executor_(executor), slots_(capacity > 0 ? capacity : 1), head_(0), count_(0), closed_(false), dropped_(0) {}
+
+    // fill(T& slot) 就地写入
+    template <typename Fill>
+    void push_with(Fill&& fill) {
+        std::coroutine_handle<> waiter;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) return;
+            size_t tail = (head_ + count_) % slots_.size();
+            fill(slots_[tail]);
+            if (count_ == slots_.size()) {
+                // 满: tail 即最旧的槽位，已被覆盖
+                head_ = (head_ + 1) % slots_.size();
+                dropped_++;
+            } else {
+                count_++;
+            }
+            waiter = std::exchange(waiter_, nullptr);
+        }
+        resume(waiter);
+    }
+
+    void close() {
+        std::coroutine_handle<> waiter;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            waiter = std::exchange(waiter_, nullptr);
+        }
+        resume(waiter);
+    }
+
+    // co_await next(): 返回的指针在下一次 next() 之前有效；队列关闭且取空后返回 nullptr
+    auto next() {
+        struct Awaiter {
+            AsyncQueue& queue;
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                std::lock_guard<std::mutex> lock(queue.mutex_);
+                if (queue.count_ > 0 || queue.closed_) return false;
+                queue.waiter_ = handle;
+                return true;
+            }
+            const T* await_resume() {
+                std::lock_guard<std::mutex> lock(queue.mutex_);
+                if (queue.count_ == 0) return nullptr;
+                // 与 current_ 交换而不是拷贝，两边的容量都留着复用
+                std::swap(queue.current_, queue.slots_[queue.head_]);
+                queue.head_ = (queue.head_ + 1) % queue.slots_.size();
+                queue.count_--;
+                return &queue.current_;
+            }
+        };
+        return Awaiter{*this};
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    CoroExecutor* executor_;
+    mutable std::mutex mutex_;
+    std::vector<T> slots_;
+    T current_;
+    size_t head_;
+    size_t count_;
+    bool closed_;
+    uint64_t dropped_;
+    std::coroutine_handle<> waiter_;
+
+    void resume(std::coroutine_handle<> waiter) {
+        if (!waiter) return;
+        if (executor_) executor_->post(waiter);
+        else waiter.resume();
+    }
+};
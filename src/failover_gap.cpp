@@ -0,0 +1,46 @@
+#include "failover_gap.h"
+
+FailoverGapCounter::State& FailoverGapCounter::state(std::string_view inst_id) {
+    auto it = states_.find(inst_id);
+    if (it == states_.end()) {
+        it = states_.emplace(std::string(inst_id), State{}).first;
+    }
+    return it->second;
+}
+
+bool FailoverGapCounter::on_primary(std::string_view inst_id, int64_t ts) {
+    State& s = state(inst_id);
+    // 平时同一毫秒可能有多条更新，只在切换后的追赶阶段按 ts 去重；没有 ts 的更新无法判断，照常分发
+    if (s.catching_up && ts > 0) {
+        if (ts <= s.primary_ts) return false;
+        s.catching_up = false;
+    }
+    if (ts > s.primary_ts) s.primary_ts = ts;
+    return true;
+}
+
+void FailoverGapCounter::on_standby(std::string_view inst_id, int64_t ts) {
+    State& s = state(inst_id);
+    s.standby_ts[s.next] = ts;
+    s.next = (s.next + 1) % kWindow;
+}
+
+uint64_t FailoverGapCounter::promote() {
+    uint64_t missed = 0;
+    for (auto& [inst_id, s] : states_) {
+        for (int64_t ts : s.standby_ts) {
+            // 0 为空槽；同一 ts 视为主连接已分发过的同一条更新
+            if (ts > s.primary_ts) missed++;
+        }
+        s.catching_up = s.primary_ts > 0;
+    }
+    clear_standby();
+    return missed;
+}
+
+void FailoverGapCounter::clear_standby() {
+    for (auto& [inst_id, s] : states_) {
+        s.standby_ts.fill(0);
+        s.next = 0;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// 热备切换时漏掉的更新数: 记录主连接每个交易对最后分发的 ts，
+// 以及热备连接每个交易对最近 kWindow 条 ts；提升时热备上比主连接更新的条数即为漏掉的更新
+class FailoverGapCounter {
+public:
+    static constexpr size_t kWindow = 64;
+
+    // 主连接即将分发一条更新。提升之后、该交易对出现比旧主连接更新的 ts 之前，
+    // ts 不比已分发的新的更新是旧主连接分发过的，返回 false，调用方丢弃
+    bool on_primary(std::string_view inst_id, int64_t ts);
+    void on_standby(std::string_view inst_id, int64_t ts);
+
+    // 热备提升为主连接时调用，返回漏掉的更新数（每个交易对最多 kWindow），清空热备窗口并开始去重
+    uint64_t promote();
+    // 热备断开，窗口作废
+    void clear_standby();
+
+    size_t instrument_count() const { return states_.size(); }
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+    };
+
+    struct State {
+        int64_t primary_ts = 0;
+        std::array<int64_t, kWindow> standby_ts{};
+        uint32_t next = 0;
+        bool catching_up = false;   // 提升后尚未越过旧主连接的最后 ts
+    };
+
+    std::unordered_map<std::string, State, StringHash, std::equal_to<>> states_;
+
+    State& state(std::string_view inst_id);
+};
@@ -0,0 +1,66 @@
+#include "hmac_signer.h"
+#include "async_logger.h"
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+
+HmacSigner::HmacSigner() : mac_(EVP_MAC_fetch(nullptr, "HMAC", nullptr)), context_(nullptr), keyed_(false) {
+    if (mac_) {
+        context_ = EVP_MAC_CTX_new(static_cast<EVP_MAC*>(mac_));
+    }
+    if (!context_) {
+        OKX_LOG_ERROR("HMAC: failed to create EVP_MAC context");
+    }
+}
+
+HmacSigner::~HmacSigner() {
+    EVP_MAC_CTX_free(static_cast<EVP_MAC_CTX*>(context_));
+    EVP_MAC_free(static_cast<EVP_MAC*>(mac_));
+}
+
+bool HmacSigner::set_key(std::string_view secret) {
+    if (!context_) return false;
+
+    char digest_name[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest_name, 0),
+        OSSL_PARAM_construct_end()};
+    // 密钥调度在这里做一次
+    keyed_ = EVP_MAC_init(static_cast<EVP_MAC_CTX*>(context_), reinterpret_cast<const unsigned char*>(secret.data()),
+                          secret.size(), params) == 1;
+    if (!keyed_) {
+        OKX_LOG_ERROR("HMAC: EVP_MAC_init failed");
+    }
+    return keyed_;
+}
+
+bool HmacSigner::sign(std::string_view message, unsigned char (&digest)[kDigestSize]) {
+    if (!keyed_) return false;
+    auto* context = static_cast<EVP_MAC_CTX*>(context_);
+
+    // key 传空表示沿用已设置的密钥，只把状态恢复到预先算好的 ipad/opad
+    size_t length = 0;
+    return EVP_MAC_init(context, nullptr, 0, nullptr) == 1 &&
+           EVP_MAC_update(context, reinterpret_cast<const unsigned char*>(message.data()), message.size()) == 1 &&
+           EVP_MAC_final(context, digest, &length, kDigestSize) == 1 && length == kDigestSize;
+}
+
+bool HmacSigner::sign_base64(std::string_view message, std::string& out) {
+    unsigned char digest[kDigestSize];
+    if (!sign(message, digest)) return false;
+    out = base64(digest, kDigestSize);
+    return true;
+}
+
+std::string HmacSigner::login_prehash(std::string_view timestamp) {
+    std::string prehash(timestamp);
+    prehash += "GET/users/self/verify";
+    return prehash;
+}
+
+std::string HmacSigner::base64(const unsigned char* data, size_t size) {
+    std::string out(4 * ((size + 2) / 3), '\0');
+    int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()), data, static_cast<int>(size));
+    out.resize(written > 0 ? static_cast<size_t>(written) : 0);
+    return out;
+}
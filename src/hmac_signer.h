@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// HMAC-SHA256 签名器: 设置密钥时预先计算好内外层填充状态，每次签名只重置上下文，
+// 不再重新派生密钥。单线程使用
+class HmacSigner {
+public:
+    static constexpr size_t kDigestSize = 32;
+
+    HmacSigner();
+    ~HmacSigner();
+    HmacSigner(const HmacSigner&) = delete;
+    HmacSigner& operator=(const HmacSigner&) = delete;
+
+    bool set_key(std::string_view secret);
+    bool has_key() const { return keyed_; }
+
+    bool sign(std::string_view message, unsigned char (&digest)[kDigestSize]);
+    // base64(HMAC-SHA256)，OKX 签名格式
+    bool sign_base64(std::string_view message, std::string& out);
+
+    // OKX WebSocket 登录的待签名串: timestamp + "GET" + "/users/self/verify"
+    static std::string login_prehash(std::string_view timestamp);
+    static std::string base64(const unsigned char* data, size_t size);
+
+private:
+    void* mac_;       // EVP_MAC*
+    void* context_;   // EVP_MAC_CTX*，已设置密钥
+    bool keyed_;
+};
@@ -1,11 +1,22 @@
 #include "json_parser.h"
-#include <sstream>
+#include "okx_channels.h"
+#include "json_validator.h"
+#include "json_stage1.h"
+#include <atomic>
+#include <charconv>
+#include <cstring>
 #include <iostream>
-#include <ctime>
 
-std::optional<std::unordered_map<std::string, std::string>> JsonParser::parse_simple(const std::string& json) {
+std::optional<std::unordered_map<std::string, std::string>> JsonParser::parse_simple(const std::string& json, ParseMode mode) {
     std::unordered_map<std::string, std::string> result;
 
+    if (mode == ParseMode::Strict) {
+        if (!parse_simple_strict(json, result)) {
+            return std::nullopt;
+        }
+        return result.empty() ? std::nullopt : std::make_optional(result);
+    }
+
     const char* ptr = json.c_str();
     const char* end = ptr + json.length();
 
@@ -73,176 +84,315 @@ std::optional<std::unordered_map<std::string, std::string>> JsonParser::parse_si
     return result.empty() ? std::nullopt : std::make_optional(result);
 }
 
-std::optional<std::vector<TickerData>> JsonParser::parse_ticker_data(const std::string& json) {
-    // 高性能ticker解析 - 专门针对OKX ticker消息优化
+// 比较可能含转义的原始字符串
+static bool raw_string_equals(std::string_view raw, std::string_view expected) {
+    if (raw.find('\\') == std::string_view::npos) {
+        return raw == expected;
+    }
+    char buf[64];
+    if (raw.size() > sizeof(buf)) return false;
+    size_t len = JsonValidator::unescape(raw, buf);
+    return len != JsonValidator::npos && std::string_view(buf, len) == expected;
+}
 
-    // 快速通道检查（更灵活的匹配）
-    if (json.find("\"channel\"") == std::string::npos || json.find("\"tickers\"") == std::string::npos) {
-        return std::nullopt;
+// 在结构索引上按深度精确匹配，只认顶层的 arg.channel 和 data，
+// 嵌套对象或字符串值中出现的同名key都不会命中。Strict 时先整条校验，key 按转义后的内容比较
+template <bool Strict = false, typename Fn>
+static bool for_each_ticker_object(std::string_view json, Fn&& fn) {
+    if (Strict && !JsonValidator::validate(json)) {
+        return false;
     }
+    auto equals = [](std::string_view raw, std::string_view expected) {
+        return Strict ? raw_string_equals(raw, expected) : raw == expected;
+    };
 
-    // 查找data数组的开始和结束位置（更灵活的匹配）
-    size_t data_pos = json.find("\"data\"");
-    if (data_pos == std::string::npos) {
-        return std::nullopt;
+    thread_local StructuralIndex index;
+    if (!index.build(json) || index.size() == 0) {
+        return false;
     }
 
-    // 从data字段位置开始查找数组开始符号
-    size_t data_start = json.find('[', data_pos);
-    if (data_start == std::string::npos) {
-        return std::nullopt;
+    bool is_ticker = false;
+    size_t data = StructuralIndex::npos;
+    size_t end = index.for_each_member(0, [&](std::string_view key, std::string_view, bool, size_t value_index) {
+        if (value_index == StructuralIndex::npos) return true;
+
+        if (equals(key, "arg") && index.at(value_index) == '{') {
+            index.for_each_member(value_index, [&](std::string_view arg_key, std::string_view arg_value, bool is_string, size_t) {
+                if (equals(arg_key, "channel")) {
+                    is_ticker = is_string && equals(arg_value, "tickers");
+                    return false;
+                }
+                return true;
+            });
+        } else if (equals(key, "data") && index.at(value_index) == '[') {
+            data = value_index;
+        }
+        return true;
+    });
+
+    if (end == StructuralIndex::npos || !is_ticker || data == StructuralIndex::npos) {
+        return false;
     }
 
-    data_start += 1; // 跳过 '['
+    bool valid = true;
+    index.for_each_element(data, [&](std::string_view, size_t value_index) {
+        if (value_index != StructuralIndex::npos && index.at(value_index) == '{') {
+            valid = fn(index, value_index);
+        }
+        return valid;
+    });
+    return valid;
+}
+
+void JsonParser::visit_ticker_objects(std::string_view json, TickerObjectFn fn, void* context) {
+    for_each_ticker_object(json, [&](const StructuralIndex& index, size_t object) {
+        fn(context, index, object);
+        return true;
+    });
+}
 
-    // 找到匹配的 ']'
-    size_t data_end = data_start;
-    int bracket_depth = 1;
+void JsonParser::store_ticker(TickerBatch& batch, const TickerView& view) {
+    // 字段拷贝进arena，batch不依赖输入缓冲区的生命周期；未解析的字段为空，不占空间
+    batch.append(view);
+}
 
-    while (data_end < json.length() && bracket_depth > 0) {
-        char c = json[data_end];
-        if (c == '[') bracket_depth++;
-        else if (c == ']') bracket_depth--;
-        data_end++;
-    }
+// 整条校验之后只剩孤立代理项这一种转义错误，含反斜杠的值才需要试着还原
+static bool escapes_valid(std::string_view value) {
+    if (!memchr(value.data(), '\\', value.size())) return true;
+    thread_local std::string scratch;
+    return JsonValidator::unescape(value, scratch);
+}
 
-    if (bracket_depth != 0) {
-        return std::nullopt;
-    }
+template <typename T>
+static bool decode_object(const StructuralIndex& index, size_t object, T& out, bool strict) {
+    FieldMask present = 0;
+    size_t expected = 0;
+    bool valid = true;
+    index.for_each_member(object, [&](std::string_view key, std::string_view value, bool is_string, size_t) {
+        if (strict && is_string && !escapes_valid(value)) {
+            valid = false;
+            return false;
+        }
+        return SchemaCodec<T>::decode_member(key, value, out, present, SchemaCodec<T>::full_mask(), expected);
+    });
+    SchemaCodec<T>::reset_missing(out, present);
+    return valid;
+}
 
+std::optional<std::vector<TickerData>> JsonParser::parse_ticker_data(const std::string& json, ParseMode mode) {
+    // 高性能ticker解析 - 专门针对OKX ticker消息优化
     // 预分配向量空间（假设最多几个ticker）
     std::vector<TickerData> tickers;
     tickers.reserve(4);
 
-    // 高效解析ticker对象
-    const char* ptr = json.c_str() + data_start;
-    const char* end_ptr = json.c_str() + data_end - 1;
+    bool strict = mode == ParseMode::Strict;
+    auto decode = [&](const StructuralIndex& index, size_t object) {
+        TickerData& ticker = tickers.emplace_back();
+        bool valid = decode_object(index, object, ticker, strict);
+        if (ticker.inst_id.empty()) {
+            tickers.pop_back();
+        }
+        return valid;
+    };
+    bool valid = strict ? for_each_ticker_object<true>(json, decode) : for_each_ticker_object(json, decode);
 
-    while (ptr < end_ptr) {
-        // 跳过分隔符和空白
-        while (ptr < end_ptr && (*ptr == ',' || *ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')) {
-            ++ptr;
+    if (!valid || tickers.empty()) {
+        return std::nullopt;
+    }
+    return tickers;
+}
+
+bool JsonParser::parse_ticker_data_into(std::string_view json, TickerBatch& batch, ParseMode mode, FieldMask wanted) {
+    batch.clear();
+    MonotonicArena& arena = batch.arena_;
+    // instId 用来判断对象是否为有效 ticker，总是解析
+    wanted = (wanted & SchemaCodec<TickerView>::full_mask()) | SchemaCodec<TickerView>::mask_of("instId");
+
+    if (mode == ParseMode::Strict) {
+        // 与快速模式同一趟结构索引遍历，只多整条校验和含转义字段的还原
+        bool valid = for_each_ticker_object<true>(json, [&](const StructuralIndex& index, size_t object) {
+            TickerView view;
+            FieldMask present = 0;
+            size_t expected = 0;
+            index.for_each_member(object, [&](std::string_view key, std::string_view value, bool, size_t) {
+                return SchemaCodec<TickerView>::decode_member(key, value, view, present, wanted, expected);
+            });
+            if (view.inst_id.empty()) return true;
+
+            bool unescaped = true;
+            TickerView& stored = batch.views_.emplace_back(view);
+            SchemaCodec<TickerView>::for_each_field(stored, [&](std::string_view, std::string_view& value) {
+                if (!memchr(value.data(), '\\', value.size())) {
+                    value = arena.store(value);
+                    return;
+                }
+                char* dst = arena.allocate(value.size());
+                size_t len = JsonValidator::unescape(value, dst);
+                if (len == JsonValidator::npos) {
+                    unescaped = false;
+                    len = 0;
+                }
+                value = std::string_view(dst, len);
+            });
+            return unescaped;
+        });
+
+        if (!valid) {
+            batch.clear();
+            return false;
         }
+        return !batch.empty();
+    }
 
-        if (ptr >= end_ptr || *ptr != '{') {
-            break;
+    for_each_ticker_object(json, [&](const StructuralIndex& index, size_t object) {
+        TickerView view;
+        FieldMask present = 0;
+        size_t expected = 0;
+        index.for_each_member(object, [&](std::string_view key, std::string_view value, bool, size_t) {
+            return SchemaCodec<TickerView>::decode_member(key, value, view, present, wanted, expected);
+        });
+        if (!view.inst_id.empty()) {
+            store_ticker(batch, view);
         }
+        return true;
+    });
 
-        // 找到对象的结束位置
-        const char* obj_start = ptr;
-        int brace_depth = 1;
-        ++ptr; // 跳过 '{'
+    return !batch.empty();
+}
 
-        while (ptr < end_ptr && brace_depth > 0) {
-            if (*ptr == '{') brace_depth++;
-            else if (*ptr == '}') brace_depth--;
-            ++ptr;
+// 严格模式下递归收集所有叶子键值，语义与快速模式一致（嵌套key平铺）
+static bool collect_members_strict(std::string_view value, std::unordered_map<std::string, std::string>& result) {
+    bool valid = true;
+    std::string key;
+
+    if (value.front() == '[') {
+        JsonScanner::for_each_element(value, [&](std::string_view element) {
+            if (element.front() == '{' || element.front() == '[') {
+                valid = collect_members_strict(element, result);
+            }
+            return valid;
+        });
+        return valid;
+    }
+
+    JsonScanner::for_each_member(value, [&](std::string_view raw_key, std::string_view raw_value, bool is_string) {
+        if (!JsonValidator::unescape(raw_key, key)) {
+            valid = false;
+            return false;
         }
 
-        if (brace_depth != 0) {
-            break;
+        if (is_string) {
+            valid = JsonValidator::unescape(raw_value, result[key]);
+        } else if (raw_value.front() == '{' || raw_value.front() == '[') {
+            valid = collect_members_strict(raw_value, result);
+        } else {
+            result[key].assign(raw_value.data(), raw_value.size());
         }
+        return valid;
+    });
+    return valid;
+}
 
-        // 使用string_view避免复制，直接解析
-        std::string_view ticker_json(obj_start, ptr - obj_start);
-        TickerData ticker;
+bool JsonParser::parse_simple_strict(std::string_view json, std::unordered_map<std::string, std::string>& result) {
+    if (!JsonValidator::validate(json)) {
+        return false;
+    }
 
-        if (parse_ticker_object(ticker_json, ticker)) {
-            tickers.emplace_back(std::move(ticker));
-        }
+    const char* start = JsonScanner::skip_whitespace(json.data(), json.data() + json.size());
+    std::string_view value(start, json.data() + json.size() - start);
+    if (value.front() != '{' && value.front() != '[') {
+        return false;
     }
 
-    return tickers.empty() ? std::nullopt : std::make_optional(std::move(tickers));
+    if (!collect_members_strict(value, result)) {
+        result.clear();
+        return false;
+    }
+    return true;
 }
 
-std::string JsonParser::create_subscription_message(const std::string& channel, const std::string& inst_id) {
-    std::ostringstream oss;
-    oss << "{"
-        << "\"id\":\"" << std::time(nullptr) << "\","
-        << "\"op\":\"subscribe\","
-        << "\"args\":[{\"channel\":\"" << channel << "\","
-        << "\"instId\":\"" << inst_id << "\"}]"
-        << "}";
-    return oss.str();
-}
-
-void JsonParser::skip_whitespace(const char*& ptr, const char* end) {
-    while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')) {
-        ++ptr;
-    }
+uint64_t JsonParser::next_request_id() {
+    // 进程内单调递增，订阅和下单共用，同一连接上不会重复
+    static std::atomic<uint64_t> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
 }
 
-std::string_view JsonParser::extract_string_value(std::string_view json, std::string_view key) {
-    // 构建搜索模式: "key":
-    std::string search_pattern = "\"";
-    search_pattern += key;
-    search_pattern += "\":";
+void JsonParser::append_request_id(std::string& out, uint64_t id) {
+    char digits[20];
+    auto result = std::to_chars(digits, digits + sizeof(digits), id);
+    out.append(digits, result.ptr - digits);
+}
 
-    size_t pos = json.find(search_pattern);
-    if (pos == std::string_view::npos) {
-        return {};
+static std::string create_channel_op(std::string_view op, std::string_view channel, std::string_view key, std::string_view value,
+                                     uint64_t id = JsonParser::next_request_id()) {
+    std::string out;
+    out.reserve(64 + channel.size() + value.size());
+    out += "{\"id\":\"";
+    JsonParser::append_request_id(out, id);
+    out += "\",\"op\":\"";
+    out += op;
+    out += "\",\"args\":[{\"channel\":\"";
+    out += channel;
+    out += '"';
+    if (!value.empty()) {
+        out += ",\"";
+        out += key;
+        out += "\":\"";
+        out += value;
+        out += '"';
     }
+    out += "}]}";
+    return out;
+}
 
-    pos += search_pattern.length();
-
-    // 跳过空白字符
-    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' || json[pos] == '\r')) {
-        pos++;
-    }
+std::string JsonParser::create_subscription_message(const std::string& channel, const std::string& inst_id) {
+    return create_channel_op("subscribe", channel, "instId", inst_id);
+}
 
-    if (pos >= json.length()) {
-        return {};
-    }
+std::string JsonParser::create_subscription_message(const std::string& channel, const std::string& inst_id, uint64_t id) {
+    return create_channel_op("subscribe", channel, "instId", inst_id, id);
+}
 
-    size_t end_pos;
-    if (json[pos] == '"') {
-        // 字符串值
-        pos++; // 跳过开始的引号
-        end_pos = json.find('"', pos);
-        if (end_pos == std::string_view::npos) {
-            return {};
-        }
-    } else {
-        // 数字或其他非字符串值
-        end_pos = pos;
-        while (end_pos < json.length() &&
-               json[end_pos] != ',' &&
-               json[end_pos] != '}' &&
-               json[end_pos] != ']' &&
-               json[end_pos] != ' ' &&
-               json[end_pos] != '\t' &&
-               json[end_pos] != '\n' &&
-               json[end_pos] != '\r') {
-            end_pos++;
-        }
-    }
+std::string JsonParser::create_unsubscription_message(const std::string& channel, const std::string& inst_id) {
+    return create_channel_op("unsubscribe", channel, "instId", inst_id);
+}
 
-    return json.substr(pos, end_pos - pos);
+std::string JsonParser::create_login_message(const std::string& api_key, const std::string& passphrase,
+                                             const std::string& timestamp, const std::string& sign) {
+    std::string out;
+    out.reserve(96 + api_key.size() + passphrase.size() + timestamp.size() + sign.size());
+    out += "{\"op\":\"login\",\"args\":[{\"apiKey\":\"";
+    out += api_key;
+    out += "\",\"passphrase\":\"";
+    out += passphrase;
+    out += "\",\"timestamp\":\"";
+    out += timestamp;
+    out += "\",\"sign\":\"";
+    out += sign;
+    out += "\"}]}";
+    return out;
 }
 
-bool JsonParser::parse_ticker_object(std::string_view json, TickerData& ticker) {
-    // 直接从字符串视图中提取各个字段，零拷贝
-    auto extract_and_assign = [&](const char* key, std::string& target) {
-        auto value = extract_string_value(json, key);
-        target.assign(value.data(), value.size());
-    };
+std::string JsonParser::create_private_subscription_message(const std::string& channel, const std::string& inst_type) {
+    // account 频道不带 instType
+    return create_channel_op("subscribe", channel, "instType", inst_type);
+}
 
-    extract_and_assign("instType", ticker.inst_type);
-    extract_and_assign("instId", ticker.inst_id);
-    extract_and_assign("last", ticker.last);
-    extract_and_assign("lastSz", ticker.last_sz);
-    extract_and_assign("askPx", ticker.ask_px);
-    extract_and_assign("askSz", ticker.ask_sz);
-    extract_and_assign("bidPx", ticker.bid_px);
-    extract_and_assign("bidSz", ticker.bid_sz);
-    extract_and_assign("open24h", ticker.open24h);
-    extract_and_assign("high24h", ticker.high24h);
-    extract_and_assign("low24h", ticker.low24h);
-    extract_and_assign("volCcy24h", ticker.vol_ccy24h);
-    extract_and_assign("vol24h", ticker.vol24h);
-    extract_and_assign("sodUtc0", ticker.sod_utc0);
-    extract_and_assign("sodUtc8", ticker.sod_utc8);
-    extract_and_assign("ts", ticker.ts);
-
-    return !ticker.inst_id.empty();
+void TickerData::assign(const TickerView& view) {
+    inst_type.assign(view.inst_type.data(), view.inst_type.size());
+    inst_id.assign(view.inst_id.data(), view.inst_id.size());
+    last.assign(view.last.data(), view.last.size());
+    last_sz.assign(view.last_sz.data(), view.last_sz.size());
+    ask_px.assign(view.ask_px.data(), view.ask_px.size());
+    ask_sz.assign(view.ask_sz.data(), view.ask_sz.size());
+    bid_px.assign(view.bid_px.data(), view.bid_px.size());
+    bid_sz.assign(view.bid_sz.data(), view.bid_sz.size());
+    open24h.assign(view.open24h.data(), view.open24h.size());
+    high24h.assign(view.high24h.data(), view.high24h.size());
+    low24h.assign(view.low24h.data(), view.low24h.size());
+    vol_ccy24h.assign(view.vol_ccy24h.data(), view.vol_ccy24h.size());
+    vol24h.assign(view.vol24h.data(), view.vol24h.size());
+    sod_utc0.assign(view.sod_utc0.data(), view.sod_utc0.size());
+    sod_utc8.assign(view.sod_utc8.data(), view.sod_utc8.size());
+    ts.assign(view.ts.data(), view.ts.size());
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include <unordered_map>
 #include <vector>
 #include <string_view>
+#include "ticker_batch.h"
+#include "channel_schema.h"
+
+class StructuralIndex;
 
 struct TickerData {
     std::string inst_type;
@@ -22,16 +26,47 @@ struct TickerData {
     std::string sod_utc0;
     std::string sod_utc8;
     std::string ts;
+
+    // 复用已有字符串容量，避免稳态下重新分配
+    void assign(const TickerView& view);
+};
+
+// Fast: 假设输入格式正确，追求最低延迟
+// Strict: 完整校验JSON结构，处理转义，只匹配正确深度的key，格式错误整条消息拒绝
+enum class ParseMode {
+    Fast,
+    Strict
 };
 
 class JsonParser {
 public:
-    static std::optional<std::unordered_map<std::string, std::string>> parse_simple(const std::string& json);
-    static std::optional<std::vector<TickerData>> parse_ticker_data(const std::string& json);
+    static std::optional<std::unordered_map<std::string, std::string>> parse_simple(const std::string& json, ParseMode mode = ParseMode::Fast);
+    static std::optional<std::vector<TickerData>> parse_ticker_data(const std::string& json, ParseMode mode = ParseMode::Fast);
+    // 解析到调用方复用的batch，batch每条消息重置；返回是否解析出ticker
+    // wanted 为字段掩码（见 ticker_fields.h），掩码外的字段跳过不拷贝、保持为空，对象内找齐后停止扫描；instId 总会解析
+    static bool parse_ticker_data_into(std::string_view json, TickerBatch& batch, ParseMode mode = ParseMode::Fast,
+                                       FieldMask wanted = kAllFields);
+    // 编译期掩码的快速路径，定义在 ticker_fields.h
+    template <FieldMask Wanted>
+    static bool parse_ticker_fields_into(std::string_view json, TickerBatch& batch);
     static std::string create_subscription_message(const std::string& channel, const std::string& inst_id);
+    // 指定请求 id，用于按 id 匹配订阅回执
+    static std::string create_subscription_message(const std::string& channel, const std::string& inst_id, uint64_t id);
+    static std::string create_unsubscription_message(const std::string& channel, const std::string& inst_id);
+    // 私有频道: 登录请求和按 instType 订阅（orders/positions/account）
+    static std::string create_login_message(const std::string& api_key, const std::string& passphrase,
+                                            const std::string& timestamp, const std::string& sign);
+    static std::string create_private_subscription_message(const std::string& channel, const std::string& inst_type);
+    // 请求 id: 进程内唯一的递增整数，以十进制字符串写入 "id" 字段
+    static uint64_t next_request_id();
+    static void append_request_id(std::string& out, uint64_t id);
 
 private:
-    static std::string_view extract_string_value(std::string_view json, std::string_view key);
-    static bool parse_ticker_object(std::string_view json, TickerData& ticker);
-    static void skip_whitespace(const char*& ptr, const char* end);
+    // 快速路径: 建立结构索引，对 data 数组中的每个 ticker 对象调用 fn(context, index, object)
+    using TickerObjectFn = void (*)(void* context, const StructuralIndex& index, size_t object);
+    static void visit_ticker_objects(std::string_view json, TickerObjectFn fn, void* context);
+    // 把解码好的视图存入batch，字段拷贝进arena
+    static void store_ticker(TickerBatch& batch, const TickerView& view);
+
+    static bool parse_simple_strict(std::string_view json, std::unordered_map<std::string, std::string>& result);
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstring>
+#include <string_view>
+
+// 轻量JSON扫描原语：识别字符串引号和转义，按对象深度遍历成员
+class JsonScanner {
+public:
+    static const char* skip_whitespace(const char* ptr, const char* end) {
+        while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')) {
+            ++ptr;
+        }
+        return ptr;
+    }
+
+    // ptr 指向开引号，返回闭引号位置；未闭合返回 nullptr
+    static const char* find_string_end(const char* ptr, const char* end) {
+        const char* start = ++ptr;
+        while (ptr < end) {
+            const char* quote = static_cast<const char*>(memchr(ptr, '"', end - ptr));
+            if (!quote) return nullptr;
+
+            // 前面有奇数个反斜杠说明引号被转义
+            const char* back = quote;
+            while (back > start && back[-1] == '\\') --back;
+            if (((quote - back) & 1) == 0) return quote;
+            ptr = quote + 1;
+        }
+        return nullptr;
+    }
+
+    // 跳过任意JSON值，返回值之后的位置；格式错误返回 nullptr
+    static const char* skip_value(const char* ptr, const char* end) {
+        if (ptr >= end) return nullptr;
+
+        if (*ptr == '"') {
+            const char* close = find_string_end(ptr, end);
+            return close ? close + 1 : nullptr;
+        }
+
+        if (*ptr == '{' || *ptr == '[') {
+            int depth = 0;
+            while (ptr < end) {
+                char c = *ptr;
+                if (c == '"') {
+                    ptr = find_string_end(ptr, end);
+                    if (!ptr) return nullptr;
+                } else if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) return ptr + 1;
+                }
+                ++ptr;
+            }
+            return nullptr;
+        }
+
+        while (ptr < end && *ptr != ',' && *ptr != '}' && *ptr != ']' &&
+               *ptr != ' ' && *ptr != '\t' && *ptr != '\n' && *ptr != '\r') {
+            ++ptr;
+        }
+        return ptr;
+    }
+
+    // 遍历对象的第一层成员: fn(key, value, is_string) 返回 false 时提前结束
+    // 字符串值不含引号，对象/数组值包含括号
+    template <typename Fn>
+    static bool for_each_member(std::string_view object, Fn&& fn) {
+        const char* ptr = object.data();
+        const char* end = ptr + object.size();
+
+        ptr = skip_whitespace(ptr, end);
+        if (ptr >= end || *ptr != '{') return false;
+        ++ptr;
+
+        while (true) {
+            ptr = skip_whitespace(ptr, end);
+            if (ptr >= end) return false;
+            if (*ptr == '}') return true;
+            if (*ptr != '"') return false;
+
+            const char* key_end = find_string_end(ptr, end);
+            if (!key_end) return false;
+            std::string_view key(ptr + 1, key_end - ptr - 1);
+
+            ptr = skip_whitespace(key_end + 1, end);
+            if (ptr >= end || *ptr != ':') return false;
+            ptr = skip_whitespace(ptr + 1, end);
+
+            const char* value_start = ptr;
+            const char* value_end = skip_value(ptr, end);
+            if (!value_end) return false;
+
+            bool is_string = *value_start == '"';
+            std::string_view value = is_string
+                ? std::string_view(value_start + 1, value_end - value_start - 2)
+                : std::string_view(value_start, value_end - value_start);
+
+            if (!fn(key, value, is_string)) return true;
+
+            ptr = skip_whitespace(value_end, end);
+            if (ptr < end && *ptr == ',') {
+                ++ptr;
+            } else if (ptr < end && *ptr == '}') {
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    // 遍历数组元素: fn(value) 返回 false 时提前结束
+    template <typename Fn>
+    static bool for_each_element(std::string_view array, Fn&& fn) {
+        const char* ptr = array.data();
+        const char* end = ptr + array.size();
+
+        ptr = skip_whitespace(ptr, end);
+        if (ptr >= end || *ptr != '[') return false;
+        ++ptr;
+
+        while (true) {
+            ptr = skip_whitespace(ptr, end);
+            if (ptr >= end) return false;
+            if (*ptr == ']') return true;
+
+            const char* value_end = skip_value(ptr, end);
+            if (!value_end) return false;
+            if (!fn(std::string_view(ptr, value_end - ptr))) return true;
+
+            ptr = skip_whitespace(value_end, end);
+            if (ptr < end && *ptr == ',') {
+                ++ptr;
+            } else if (ptr < end && *ptr == ']') {
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+};
@@ -0,0 +1,203 @@
+#include "json_stage1.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;        // {}[]:,
+};
+
+#if defined(__SSE2__)
+inline uint64_t movemask16(__m128i v, int shift) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(v))) << shift;
+}
+
+inline BlockMasks classify(const char* block) {
+    BlockMasks masks{0, 0, 0};
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    // '{' '}' 与 '[' ']' 只差0x20位: 或上0x20后统一比较 '{' 和 '}'
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+
+    for (int i = 0; i < 4; ++i) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        __m128i folded = _mm_or_si128(chunk, case_bit);
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)),
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open_brace), _mm_cmpeq_epi8(folded, close_brace)));
+
+        masks.quote |= movemask16(_mm_cmpeq_epi8(chunk, quote), i * 16);
+        masks.backslash |= movemask16(_mm_cmpeq_epi8(chunk, backslash), i * 16);
+        masks.op |= movemask16(op, i * 16);
+    }
+    return masks;
+}
+#else
+inline BlockMasks classify(const char* block) {
+    BlockMasks masks{0, 0, 0};
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        switch (block[i]) {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': masks.op |= bit; break;
+            default: break;
+        }
+    }
+    return masks;
+}
+#endif
+
+// 被奇数个连续反斜杠转义的字符位置（simdjson 的 find_escaped 算法）
+inline uint64_t find_escaped(uint64_t backslash, uint64_t& next_is_escaped) {
+    constexpr uint64_t odd_bits = 0xAAAAAAAAAAAAAAAAull;
+
+    if (backslash == 0) {
+        uint64_t escaped = next_is_escaped;
+        next_is_escaped = 0;
+        return escaped;
+    }
+
+    uint64_t potential_escape = backslash & ~next_is_escaped;
+    uint64_t maybe_escaped = potential_escape << 1;
+    uint64_t maybe_escaped_and_odd_bits = maybe_escaped | odd_bits;
+    uint64_t even_series_codes_and_odd_bits = maybe_escaped_and_odd_bits - potential_escape;
+    uint64_t escape_and_terminal_code = even_series_codes_and_odd_bits ^ odd_bits;
+    uint64_t escaped = escape_and_terminal_code ^ (backslash | next_is_escaped);
+    uint64_t escape = escape_and_terminal_code & backslash;
+    next_is_escaped = escape >> 63;
+    return escaped;
+}
+
+// 前缀异或: 第i位为 0..i 位的异或，用于由引号位得到字符串内部掩码
+inline uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+}
+
+bool StructuralIndex::build(std::string_view json) {
+    json_ = json;
+    positions_.clear();
+    open_stack_.clear();
+    if (positions_.capacity() < json.size() / 2) {
+        positions_.reserve(json.size() / 2 + 64);
+    }
+
+    uint64_t next_is_escaped = 0;
+    uint64_t prev_in_string = 0;  // 全0或全1
+    const char* data = json.data();
+    size_t length = json.size();
+
+    for (size_t offset = 0; offset < length; offset += 64) {
+        const char* block = data + offset;
+        char padded[64];
+        if (length - offset < 64) {
+            memset(padded, ' ', sizeof(padded));
+            memcpy(padded, block, length - offset);
+            block = padded;
+        }
+
+        BlockMasks masks = classify(block);
+        uint64_t escaped = find_escaped(masks.backslash, next_is_escaped);
+        uint64_t quote = masks.quote & ~escaped;
+        uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        uint64_t structurals = (masks.op & ~in_string) | quote;
+        while (structurals) {
+            int bit = __builtin_ctzll(structurals);
+            positions_.push_back(static_cast<uint32_t>(offset + bit));
+            structurals &= structurals - 1;
+
+            // 顺带配对括号，和 skip_value 一样只按深度配对，不区分 {} 与 []
+            char c = static_cast<char>(block[bit] | 0x20);
+            if (c == '{') {
+                open_stack_.push_back(static_cast<uint32_t>(positions_.size() - 1));
+            } else if (c == '}' && !open_stack_.empty()) {
+                pair_close(static_cast<uint32_t>(positions_.size() - 1));
+            }
+        }
+    }
+
+    // 未闭合的开括号
+    for (uint32_t open : open_stack_) {
+        if (open < matches_.size()) matches_[open] = kUnmatched;
+    }
+    return prev_in_string == 0;
+}
+
+void StructuralIndex::pair_close(uint32_t close) {
+    uint32_t open = open_stack_.back();
+    open_stack_.pop_back();
+    if (matches_.size() <= open) {
+        matches_.resize(positions_.capacity());
+    }
+    matches_[open] = close;
+}
+
+size_t StructuralIndex::skip_container(size_t open) const {
+    if (open >= matches_.size() || matches_[open] == kUnmatched) return npos;
+    return matches_[open] + 1;
+}
+
+size_t StructuralIndex::skip_whitespace(size_t offset) const {
+    while (offset < json_.size() && (json_[offset] == ' ' || json_[offset] == '\t' ||
+                                     json_[offset] == '\n' || json_[offset] == '\r')) {
+        ++offset;
+    }
+    return offset;
+}
+
+size_t StructuralIndex::read_value(size_t i, size_t value_start, std::string_view& value, bool& is_string, size_t& value_index) const {
+    size_t n = positions_.size();
+    if (i >= n) return npos;
+
+    size_t start = skip_whitespace(value_start);
+    is_string = false;
+    value_index = npos;
+
+    if (pos(i) == start) {
+        char c = at(i);
+        if (c == '"') {
+            if (i + 1 >= n || at(i + 1) != '"') return npos;
+            value = json_.substr(start + 1, pos(i + 1) - start - 1);
+            is_string = true;
+            value_index = i;
+            return i + 2;
+        }
+        if (c == '{' || c == '[') {
+            size_t end = skip_container(i);
+            if (end == npos) return npos;
+            value = json_.substr(start, pos(end - 1) + 1 - start);
+            value_index = i;
+            return end;
+        }
+        return npos; // 分隔符之后没有值
+    }
+
+    // 数字/字面量: 到下一个结构字符为止，去掉尾部空白
+    size_t end = pos(i);
+    while (end > start && (json_[end - 1] == ' ' || json_[end - 1] == '\t' ||
+                           json_[end - 1] == '\n' || json_[end - 1] == '\r')) {
+        --end;
+    }
+    value = json_.substr(start, end - start);
+    return i;
+}
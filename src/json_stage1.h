@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// 仿 simdjson stage 1: 按64字节块用SIMD计算引号/转义/结构字符位掩码，
+// 得到字符串之外的结构字符 {}[]:, 和成对引号的位置索引。
+// stage 2 在索引上按深度遍历，key只与正确深度的成员精确匹配。
+class StructuralIndex {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // 构建索引，容量复用；字符串未闭合返回 false
+    bool build(std::string_view json);
+
+    size_t size() const { return positions_.size(); }
+    uint32_t pos(size_t i) const { return positions_[i]; }
+    char at(size_t i) const { return json_[positions_[i]]; }
+    std::string_view json() const { return json_; }
+
+    // 遍历 open 处对象的第一层成员: fn(key, value, is_string, value_index) 返回 false 时停止
+    // value_index 为值起始结构字符的下标（数字/字面量为 npos）；返回对象之后的下标，出错返回 npos
+    template <typename Fn>
+    size_t for_each_member(size_t open, Fn&& fn) const;
+
+    // 遍历 open 处数组的元素: fn(value, value_index) 返回 false 时停止
+    template <typename Fn>
+    size_t for_each_element(size_t open, Fn&& fn) const;
+
+    // open 处为 { 或 [，返回匹配的闭合括号之后的下标；build 时已配好括号，O(1)
+    size_t skip_container(size_t open) const;
+
+private:
+    static constexpr uint32_t kUnmatched = UINT32_MAX;
+
+    std::string_view json_;
+    std::vector<uint32_t> positions_;
+    // 开括号下标 -> 对应闭括号下标，跳过不需要的对象/数组时不必再逐个扫描结构字符
+    std::vector<uint32_t> matches_;
+    std::vector<uint32_t> open_stack_;
+
+    void pair_close(uint32_t close);
+
+    // 解析 i 处开始的值（冒号或逗号之后），返回值之后的结构下标
+    size_t read_value(size_t i, size_t value_start, std::string_view& value, bool& is_string, size_t& value_index) const;
+    size_t skip_whitespace(size_t offset) const;
+};
+
+template <typename Fn>
+size_t StructuralIndex::for_each_member(size_t open, Fn&& fn) const {
+    size_t n = positions_.size();
+    if (open >= n || at(open) != '{') return npos;
+
+    size_t i = open + 1;
+    if (i < n && at(i) == '}') return i + 1;
+
+    while (true) {
+        // "key" : 三个结构字符
+        if (i + 3 >= n || at(i) != '"' || at(i + 1) != '"' || at(i + 2) != ':') return npos;
+        std::string_view key = json_.substr(pos(i) + 1, pos(i + 1) - pos(i) - 1);
+
+        std::string_view value;
+        bool is_string;
+        size_t value_index;
+        size_t next = read_value(i + 3, pos(i + 2) + 1, value, is_string, value_index);
+        if (next == npos || next >= n) return npos;
+
+        if (!fn(key, value, is_string, value_index)) return next;
+
+        if (at(next) == '}') return next + 1;
+        if (at(next) != ',') return npos;
+        i = next + 1;
+    }
+}
+
+template <typename Fn>
+size_t StructuralIndex::for_each_element(size_t open, Fn&& fn) const {
+    size_t n = positions_.size();
+    if (open >= n || at(open) != '[') return npos;
+
+    size_t i = open + 1;
+    if (i < n && at(i) == ']') return i + 1;
+
+    while (true) {
+        if (i >= n) return npos;
+
+        std::string_view value;
+        bool is_string;
+        size_t value_index;
+        size_t next = read_value(i, pos(i - 1) + 1, value, is_string, value_index);
+        if (next == npos || next >= n) return npos;
+
+        if (!fn(value, value_index)) return next;
+
+        if (at(next) == ']') return next + 1;
+        if (at(next) != ',') return npos;
+        i = next + 1;
+    }
+}
@@ -0,0 +1,225 @@
+#include "json_validator.h"
+#include "json_scanner.h"
+#include <cstdint>
+
+bool JsonValidator::validate(std::string_view json, int max_depth) {
+    const char* ptr = json.data();
+    const char* end = ptr + json.size();
+
+    ptr = JsonScanner::skip_whitespace(ptr, end);
+    ptr = parse_value(ptr, end, max_depth);
+    if (!ptr) return false;
+
+    return JsonScanner::skip_whitespace(ptr, end) == end;
+}
+
+const char* JsonValidator::parse_value(const char* ptr, const char* end, int depth) {
+    if (ptr >= end || depth <= 0) return nullptr;
+
+    switch (*ptr) {
+        case '"':
+            return parse_string(ptr, end);
+
+        case '{': {
+            ptr = JsonScanner::skip_whitespace(ptr + 1, end);
+            if (ptr < end && *ptr == '}') return ptr + 1;
+            while (true) {
+                if (ptr >= end || *ptr != '"') return nullptr;
+                ptr = parse_string(ptr, end);
+                if (!ptr) return nullptr;
+                ptr = JsonScanner::skip_whitespace(ptr, end);
+                if (ptr >= end || *ptr != ':') return nullptr;
+                ptr = JsonScanner::skip_whitespace(ptr + 1, end);
+                ptr = parse_value(ptr, end, depth - 1);
+                if (!ptr) return nullptr;
+                ptr = JsonScanner::skip_whitespace(ptr, end);
+                if (ptr >= end) return nullptr;
+                if (*ptr == '}') return ptr + 1;
+                if (*ptr != ',') return nullptr;
+                ptr = JsonScanner::skip_whitespace(ptr + 1, end);
+            }
+        }
+
+        case '[': {
+            ptr = JsonScanner::skip_whitespace(ptr + 1, end);
+            if (ptr < end && *ptr == ']') return ptr + 1;
+            while (true) {
+                ptr = parse_value(ptr, end, depth - 1);
+                if (!ptr) return nullptr;
+                ptr = JsonScanner::skip_whitespace(ptr, end);
+                if (ptr >= end) return nullptr;
+                if (*ptr == ']') return ptr + 1;
+                if (*ptr != ',') return nullptr;
+                ptr = JsonScanner::skip_whitespace(ptr + 1, end);
+            }
+        }
+
+        case 't':
+            return parse_literal(ptr, end, "true");
+        case 'f':
+            return parse_literal(ptr, end, "false");
+        case 'n':
+            return parse_literal(ptr, end, "null");
+
+        default:
+            return parse_number(ptr, end);
+    }
+}
+
+static bool is_hex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+const char* JsonValidator::parse_string(const char* ptr, const char* end) {
+    ++ptr; // 跳过开引号
+    while (ptr < end) {
+        unsigned char c = static_cast<unsigned char>(*ptr);
+        if (c == '"') return ptr + 1;
+        if (c < 0x20) return nullptr; // 字符串内不允许未转义的控制字符
+
+        if (c == '\\') {
+            if (++ptr >= end) return nullptr;
+            switch (*ptr) {
+                case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                    break;
+                case 'u':
+                    if (end - ptr < 5) return nullptr;
+                    for (int i = 1; i <= 4; ++i) {
+                        if (!is_hex(ptr[i])) return nullptr;
+                    }
+                    ptr += 4;
+                    break;
+                default:
+                    return nullptr;
+            }
+        }
+        ++ptr;
+    }
+    return nullptr;
+}
+
+const char* JsonValidator::parse_number(const char* ptr, const char* end) {
+    auto is_digit = [&](const char* p) { return p < end && *p >= '0' && *p <= '9'; };
+
+    if (ptr < end && *ptr == '-') ++ptr;
+    if (!is_digit(ptr)) return nullptr;
+
+    // 不允许前导零
+    if (*ptr == '0') {
+        ++ptr;
+    } else {
+        while (is_digit(ptr)) ++ptr;
+    }
+
+    if (ptr < end && *ptr == '.') {
+        ++ptr;
+        if (!is_digit(ptr)) return nullptr;
+        while (is_digit(ptr)) ++ptr;
+    }
+
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+        ++ptr;
+        if (ptr < end && (*ptr == '+' || *ptr == '-')) ++ptr;
+        if (!is_digit(ptr)) return nullptr;
+        while (is_digit(ptr)) ++ptr;
+    }
+
+    return ptr;
+}
+
+const char* JsonValidator::parse_literal(const char* ptr, const char* end, std::string_view literal) {
+    if (static_cast<size_t>(end - ptr) < literal.size()) return nullptr;
+    if (std::string_view(ptr, literal.size()) != literal) return nullptr;
+    return ptr + literal.size();
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return c - 'A' + 10;
+}
+
+static bool read_hex4(const char*& ptr, const char* end, uint32_t& value) {
+    if (end - ptr < 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!is_hex(ptr[i])) return false;
+        value = (value << 4) | hex_value(ptr[i]);
+    }
+    ptr += 4;
+    return true;
+}
+
+size_t JsonValidator::unescape(std::string_view raw, char* out) {
+    const char* ptr = raw.data();
+    const char* end = ptr + raw.size();
+    char* dst = out;
+
+    while (ptr < end) {
+        char c = *ptr++;
+        if (c != '\\') {
+            *dst++ = c;
+            continue;
+        }
+
+        if (ptr >= end) return npos;
+        switch (*ptr++) {
+            case '"': *dst++ = '"'; break;
+            case '\\': *dst++ = '\\'; break;
+            case '/': *dst++ = '/'; break;
+            case 'b': *dst++ = '\b'; break;
+            case 'f': *dst++ = '\f'; break;
+            case 'n': *dst++ = '\n'; break;
+            case 'r': *dst++ = '\r'; break;
+            case 't': *dst++ = '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!read_hex4(ptr, end, code)) return npos;
+
+                // UTF-16 代理对
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    uint32_t low;
+                    if (end - ptr < 6 || ptr[0] != '\\' || ptr[1] != 'u') return npos;
+                    ptr += 2;
+                    if (!read_hex4(ptr, end, low) || low < 0xDC00 || low > 0xDFFF) return npos;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return npos;
+                }
+
+                // 转义序列至少6字节，UTF-8编码最多4字节，输出不会超过输入长度
+                if (code < 0x80) {
+                    *dst++ = static_cast<char>(code);
+                } else if (code < 0x800) {
+                    *dst++ = static_cast<char>(0xC0 | (code >> 6));
+                    *dst++ = static_cast<char>(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    *dst++ = static_cast<char>(0xE0 | (code >> 12));
+                    *dst++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    *dst++ = static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    *dst++ = static_cast<char>(0xF0 | (code >> 18));
+                    *dst++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    *dst++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    *dst++ = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return npos;
+        }
+    }
+
+    return dst - out;
+}
+
+bool JsonValidator::unescape(std::string_view raw, std::string& out) {
+    out.resize(raw.size());
+    size_t len = unescape(raw, out.data());
+    if (len == npos) {
+        out.clear();
+        return false;
+    }
+    out.resize(len);
+    return true;
+}
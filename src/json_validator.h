@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// 严格模式使用: 完整的 RFC 8259 结构校验和字符串反转义
+class JsonValidator {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // 整个输入必须恰好是一个合法JSON值（前后允许空白）
+    static bool validate(std::string_view json, int max_depth = 64);
+
+    // raw 为引号内的原始内容；out 至少 raw.size() 字节，返回写入长度，非法转义返回 npos
+    static size_t unescape(std::string_view raw, char* out);
+    static bool unescape(std::string_view raw, std::string& out);
+
+private:
+    static const char* parse_value(const char* ptr, const char* end, int depth);
+    static const char* parse_string(const char* ptr, const char* end);
+    static const char* parse_number(const char* ptr, const char* end);
+    static const char* parse_literal(const char* ptr, const char* end, std::string_view literal);
+};
@@ -0,0 +1,147 @@
+#include "latency_mode.h"
+#include <alloca.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// 读取 /proc 中 "Key:   123 kB" 形式的行
+size_t read_kb_field(const char* path, const std::string& key) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            return std::stoull(line.substr(key.size())) * 1024;
+        }
+    }
+    return 0;
+}
+
+}
+
+HotRegion::~HotRegion() {
+    unmap();
+}
+
+bool HotRegion::map(size_t bytes, HugePageMode mode, bool prefault, std::string& error) {
+    unmap();
+    if (bytes == 0) return false;
+
+    size_t huge_size = LatencyMode::huge_page_size();
+    size_t length = mode == HugePageMode::None ? round_up(bytes, LatencyMode::page_size()) : round_up(bytes, huge_size);
+    void* addr = MAP_FAILED;
+
+    if (mode == HugePageMode::Explicit) {
+        addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED) {
+            data_ = static_cast<char*>(addr);
+            size_ = mapped_ = length;
+            huge_ = true;
+        } else {
+            error = std::string("MAP_HUGETLB failed: ") + strerror(errno) + ", falling back to transparent huge pages";
+            mode = HugePageMode::Transparent;
+        }
+    }
+
+    if (!data_) {
+        // 透明大页要求区间按大页对齐，多映射一页后裁掉首尾
+        size_t extra = mode == HugePageMode::Transparent ? huge_size : 0;
+        addr = mmap(nullptr, length + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            error = std::string("mmap failed: ") + strerror(errno);
+            return false;
+        }
+        char* base = static_cast<char*>(addr);
+        char* aligned = base;
+        if (extra > 0) {
+            aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(base), huge_size));
+            if (aligned > base) munmap(base, aligned - base);
+            size_t tail = (base + length + extra) - (aligned + length);
+            if (tail > 0) munmap(aligned + length, tail);
+        }
+        data_ = aligned;
+        size_ = mapped_ = length;
+
+        if (mode == HugePageMode::Transparent) {
+#ifdef MADV_HUGEPAGE
+            if (madvise(data_, length, MADV_HUGEPAGE) == 0) {
+                huge_ = true;
+            } else {
+                error = std::string("MADV_HUGEPAGE failed: ") + strerror(errno);
+            }
+#else
+            error = "MADV_HUGEPAGE not supported";
+#endif
+        }
+    }
+
+    if (prefault) {
+        LatencyMode::prefault(data_, size_);
+    }
+    return true;
+}
+
+void HotRegion::unmap() {
+    if (data_) {
+        munmap(data_, mapped_);
+    }
+    data_ = nullptr;
+    size_ = mapped_ = 0;
+    huge_ = false;
+}
+
+size_t LatencyMode::page_size() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+size_t LatencyMode::huge_page_size() {
+    static const size_t size = [] {
+        size_t bytes = read_kb_field("/proc/meminfo", "Hugepagesize:");
+        return bytes > 0 ? bytes : size_t(2) << 20;
+    }();
+    return size;
+}
+
+size_t LatencyMode::prefault(void* ptr, size_t bytes) {
+    if (!ptr || bytes == 0) return 0;
+    // 写入而不是读取: 读只会映射共享零页，第一次写仍会缺页
+    volatile char* p = static_cast<volatile char*>(ptr);
+    size_t step = page_size();
+    for (size_t offset = 0; offset < bytes; offset += step) {
+        p[offset] = p[offset];
+    }
+    p[bytes - 1] = p[bytes - 1];
+    return bytes;
+}
+
+void LatencyMode::prefault_stack(size_t bytes) {
+    if (bytes == 0) return;
+    // 栈向下增长，在当前帧之下分配并逐页写入
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    size_t step = page_size();
+    for (size_t offset = 0; offset < bytes; offset += step) {
+        stack[offset] = 0;
+    }
+    stack[bytes - 1] = 0;
+}
+
+bool LatencyMode::lock_all(std::string& error) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        error = std::string("mlockall failed: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+size_t LatencyMode::locked_bytes() {
+    return read_kb_field("/proc/self/status", "VmLck:");
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// 延迟模式: connect() 时预分配并预触热路径内存，可选大页与 mlockall，
+// 避免开盘或重连后前几秒的缺页抖动
+
+enum class HugePageMode {
+    None,
+    Transparent,    // madvise(MADV_HUGEPAGE)，由内核决定是否合并
+    Explicit        // MAP_HUGETLB，需要预留 /proc/sys/vm/nr_hugepages；失败时退回 Transparent
+};
+
+struct LatencyConfig {
+    bool prefault = true;
+    HugePageMode huge_pages = HugePageMode::None;
+    bool lock_memory = false;               // mlockall(MCL_CURRENT | MCL_FUTURE)，需要 CAP_IPC_LOCK 或足够的 RLIMIT_MEMLOCK
+    size_t rx_buffer_bytes = 1 << 20;       // 分片消息重组缓冲区，超过的消息被丢弃
+    size_t parse_arena_bytes = 256 << 10;   // ticker 解析 arena
+    size_t expected_tickers = 256;          // 单条消息中的 ticker 数
+    size_t send_frames = 64;                // 预分配的发送帧
+    size_t frame_bytes = 1024;
+    size_t stack_bytes = 256 << 10;         // 服务线程栈
+};
+
+struct LatencyReport {
+    size_t reserved_bytes = 0;      // 预分配总量
+    size_t prefaulted_bytes = 0;
+    size_t huge_page_bytes = 0;     // 映射在大页（或已建议使用大页）上的部分
+    size_t locked_bytes = 0;        // mlockall 后进程的 VmLck
+    bool locked = false;
+    std::string huge_page_error;
+    std::string lock_error;
+};
+
+// mmap 得到的匿名内存区域，按需使用大页并预触
+class HotRegion {
+public:
+    HotRegion() = default;
+    ~HotRegion();
+    HotRegion(const HotRegion&) = delete;
+    HotRegion& operator=(const HotRegion&) = delete;
+
+    // 使用大页时长度向上取整到大页大小；大页失败时仍会映射普通页，并在 error 中说明
+    bool map(size_t bytes, HugePageMode mode, bool prefault, std::string& error);
+    void unmap();
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool huge() const { return huge_; }
+
+private:
+    char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t mapped_ = 0;
+    bool huge_ = false;
+};
+
+class LatencyMode {
+public:
+    static size_t page_size();
+    // /proc/meminfo 中的 Hugepagesize，读不到时为 2 MiB
+    static size_t huge_page_size();
+
+    // 每页写一次，让内核现在就分配物理页；返回触及的字节数
+    static size_t prefault(void* ptr, size_t bytes);
+    // 在调用线程的栈上预触 bytes
+    static void prefault_stack(size_t bytes);
+
+    static bool lock_all(std::string& error);
+    static size_t locked_bytes();
+};
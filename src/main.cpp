@@ -1,8 +1,10 @@
 #include "okx_websocket_client.h"
+#include "async_logger.h"
+#include "coro.h"
+#include "ticker_fields.h"
 #include <iostream>
 #include <csignal>
 #include <atomic>
-#include <thread>
 #include <chrono>
 
 std::atomic<bool> keep_running(true);
@@ -12,27 +14,60 @@ void signal_handler(int signal) {
     keep_running = false;
 }
 
+// 逐条消费单个交易对的 ticker，流关闭时结束
+Task<void> print_ticks(TickStream& stream) {
+    while (const TickerData* ticker = co_await stream.next()) {
+        OKX_LOG_INFO("🚀 [{}] Last: ${} | Bid: ${} | Ask: ${} | 24h Volume: {} | High: ${} | Low: ${}",
+                     ticker->inst_id, ticker->last, ticker->bid_px, ticker->ask_px,
+                     ticker->vol24h, ticker->high24h, ticker->low24h);
+    }
+}
+
+Task<void> run_strategy(OKXWebSocketClient& client, CoroExecutor& executor, std::atomic<bool>& done) {
+    if (!co_await client.connected()) {
+        std::cerr << "Connection not established" << std::endl;
+        done = true;
+        co_return;
+    }
+
+    for (const char* inst_id : {"BTC-USDT", "ETH-USDT"}) {
+        std::cout << "Subscribing to " << inst_id << " ticker..." << std::endl;
+        SubscribeAck ack = co_await client.subscribe("tickers", inst_id);
+        if (!ack.ok) {
+            std::cerr << "Subscribe " << inst_id << " failed: " << ack.code << " " << ack.msg << std::endl;
+            done = true;
+            co_return;
+        }
+        spawn(executor, print_ticks(client.ticks(inst_id)));
+    }
+    std::cout << "Listening for ticker data... (Press Ctrl+C to exit)" << std::endl;
+
+    co_await client.disconnected();
+    done = true;
+}
+
 int main() {
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
 
+    // 协程都在主线程上恢复
+    CoroExecutor executor;
     OKXWebSocketClient client;
-
-    client.set_ticker_callback([](const TickerData& ticker) {
-        std::cout << "🚀 [" << ticker.inst_id << "] "
-                  << "Last: $" << ticker.last
-                  << " | Bid: $" << ticker.bid_px
-                  << " | Ask: $" << ticker.ask_px
-                  << " | 24h Volume: " << ticker.vol24h
-                  << " | High: $" << ticker.high24h
-                  << " | Low: $" << ticker.low24h << std::endl;
-    });
+    client.set_executor(&executor);
+    client.set_ticker_callback(nullptr);
+    // 只解析打印用到的字段
+    client.set_ticker_fields(TickerField::Quote | TickerField::Vol24h | TickerField::High24h | TickerField::Low24h);
+    client.ticks("BTC-USDT");
+    client.ticks("ETH-USDT");
 
     // 代理设置示例 (如果需要代理，取消注释以下行)
     // client.set_http_proxy("127.0.0.1", 6152);  // HTTP代理
     // client.set_http_proxy("proxy.example.com", 8080, "username", "password");  // 带认证的HTTP代理
     // client.set_socks_proxy("127.0.0.1", 1080);  // SOCKS5代理
 
+    std::atomic<bool> done(false);
+    spawn(executor, run_strategy(client, executor, done));
+
     std::cout << "Connecting to OKX WebSocket..." << std::endl;
     if (!client.connect()) {
         std::cerr << "Failed to connect to OKX WebSocket" << std::endl;
@@ -42,27 +77,15 @@ int main() {
         return 1;
     }
 
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-
-    if (!client.is_connected()) {
-        std::cerr << "Connection not established" << std::endl;
-        return 1;
-    }
-
-    std::cout << "Subscribing to BTC-USDT ticker..." << std::endl;
-    client.subscribe_ticker("BTC-USDT");
-
-    std::cout << "Subscribing to ETH-USDT ticker..." << std::endl;
-    client.subscribe_ticker("ETH-USDT");
-
-    std::cout << "Listening for ticker data... (Press Ctrl+C to exit)" << std::endl;
-
-    while (keep_running && client.is_connected()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    while (keep_running && !done) {
+        executor.run_for(std::chrono::milliseconds(100));
     }
 
     std::cout << "Disconnecting..." << std::endl;
     client.disconnect();
+    // 处理断开后被唤醒的协程，让它们正常结束
+    executor.poll();
+    AsyncLogger::flush();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,317 @@
+#include "market_bus.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kMagic = 0x53554254584B4FULL;   // "OKXTBUS"
+constexpr uint32_t kLayoutVersion = 1;
+
+size_t mapping_size(uint64_t slot_count) {
+    return sizeof(MarketBusHeader) + slot_count * sizeof(MarketBusSlot);
+}
+
+int64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+double to_double(std::string_view value) {
+    double result = 0.0;
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return result;
+}
+
+void copy_text(char* dest, size_t capacity, std::string_view value) {
+    size_t n = std::min(value.size(), capacity - 1);
+    memcpy(dest, value.data(), n);
+    memset(dest + n, 0, capacity - n);
+}
+
+// 跨进程 futex，不能用 FUTEX_PRIVATE_FLAG
+void futex_wake_all(std::atomic<uint32_t>* word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, const timespec* timeout) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+#else
+    // 非Linux没有futex，退化为短睡眠轮询
+    (void)word;
+    (void)expected;
+    timespec nap{0, 50000};
+    if (timeout && (timeout->tv_sec < nap.tv_sec || (timeout->tv_sec == 0 && timeout->tv_nsec < nap.tv_nsec))) {
+        nap = *timeout;
+    }
+    nanosleep(&nap, nullptr);
+#endif
+}
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+}
+
+void MarketTick::assign(const TickerView& view) {
+    copy_text(inst_id, sizeof(inst_id), view.inst_id);
+    copy_text(inst_type, sizeof(inst_type), view.inst_type);
+    ts = 0;
+    std::from_chars(view.ts.data(), view.ts.data() + view.ts.size(), ts);
+    last = to_double(view.last);
+    last_sz = to_double(view.last_sz);
+    ask_px = to_double(view.ask_px);
+    ask_sz = to_double(view.ask_sz);
+    bid_px = to_double(view.bid_px);
+    bid_sz = to_double(view.bid_sz);
+    open24h = to_double(view.open24h);
+    high24h = to_double(view.high24h);
+    low24h = to_double(view.low24h);
+    vol_ccy24h = to_double(view.vol_ccy24h);
+    vol24h = to_double(view.vol24h);
+    sod_utc0 = to_double(view.sod_utc0);
+    sod_utc8 = to_double(view.sod_utc8);
+}
+
+MarketBusPublisher::~MarketBusPublisher() {
+    close();
+}
+
+bool MarketBusPublisher::create(const std::string& name, size_t slot_count, std::string& error) {
+    close();
+
+    uint64_t count = std::bit_ceil(std::max<uint64_t>(slot_count, 2));
+    size_t size = mapping_size(count);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0660);
+    if (fd < 0) {
+        error = "shm_open " + name + ": " + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    bool reuse = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == size;
+    if (!reuse) {
+        // 布局不同则清空重建
+        if (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            error = "ftruncate " + name + ": " + strerror(errno);
+            ::close(fd);
+            return false;
+        }
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error = "mmap " + name + ": " + strerror(errno);
+        return false;
+    }
+
+    header_ = static_cast<MarketBusHeader*>(addr);
+    slots_ = reinterpret_cast<MarketBusSlot*>(static_cast<char*>(addr) + sizeof(MarketBusHeader));
+    mask_ = count - 1;
+    mapped_size_ = size;
+    name_ = name;
+
+    if (!reuse || header_->magic != kMagic || header_->layout_version != kLayoutVersion ||
+        header_->slot_size != sizeof(MarketBusSlot) || header_->slot_count != count) {
+        memset(addr, 0, size);
+        header_->layout_version = kLayoutVersion;
+        header_->slot_size = sizeof(MarketBusSlot);
+        header_->slot_count = count;
+        // magic 最后写入，读者据此判断段已初始化
+        std::atomic_ref<uint64_t>(header_->magic).store(kMagic, std::memory_order_release);
+    }
+    return true;
+}
+
+void MarketBusPublisher::close() {
+    if (!header_) return;
+    munmap(header_, mapped_size_);
+    if (unlink_on_close_) {
+        shm_unlink(name_.c_str());
+    }
+    header_ = nullptr;
+    slots_ = nullptr;
+    mapped_size_ = 0;
+}
+
+void MarketBusPublisher::publish(const MarketTick& tick) {
+    if (!header_) return;
+
+    uint64_t seq = header_->write_seq.load(std::memory_order_relaxed);
+    MarketBusSlot& slot = slots_[seq & mask_];
+
+    slot.version.store(2 * seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.tick = tick;
+    slot.tick.publish_ns = monotonic_ns();
+    slot.version.store(2 * seq + 2, std::memory_order_release);
+
+    header_->write_seq.store(seq + 1, std::memory_order_release);
+
+    // 与读者登记 waiters 后再检查数据的顺序配对，保证不丢唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header_->waiters.load(std::memory_order_relaxed) > 0) {
+        header_->notify.fetch_add(1, std::memory_order_release);
+        futex_wake_all(&header_->notify);
+    }
+}
+
+void MarketBusPublisher::publish(const TickerView& view) {
+    scratch_.assign(view);
+    publish(scratch_);
+}
+
+uint64_t MarketBusPublisher::published() const {
+    return header_ ? header_->write_seq.load(std::memory_order_acquire) : 0;
+}
+
+MarketBusSubscriber::~MarketBusSubscriber() {
+    close();
+}
+
+bool MarketBusSubscriber::open(const std::string& name, std::string& error) {
+    close();
+
+    // 需要读写映射: 等待时要更新 waiters
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        error = "shm_open " + name + ": " + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(MarketBusHeader)) {
+        error = "market bus " + name + " is not initialized";
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error = "mmap " + name + ": " + strerror(errno);
+        return false;
+    }
+
+    auto* header = static_cast<MarketBusHeader*>(addr);
+    bool ready = std::atomic_ref<uint64_t>(header->magic).load(std::memory_order_acquire) == kMagic;
+    uint64_t count = header->slot_count;
+    if (!ready || header->layout_version != kLayoutVersion || header->slot_size != sizeof(MarketBusSlot) ||
+        !std::has_single_bit(count) || mapping_size(count) != size) {
+        error = "market bus " + name + " has an incompatible layout";
+        munmap(addr, size);
+        return false;
+    }
+
+    header_ = header;
+    slots_ = reinterpret_cast<const MarketBusSlot*>(static_cast<char*>(addr) + sizeof(MarketBusHeader));
+    mask_ = count - 1;
+    mapped_size_ = size;
+    cursor_ = header_->write_seq.load(std::memory_order_acquire);
+    dropped_ = 0;
+    return true;
+}
+
+void MarketBusSubscriber::close() {
+    if (!header_) return;
+    munmap(header_, mapped_size_);
+    header_ = nullptr;
+    slots_ = nullptr;
+    mapped_size_ = 0;
+}
+
+MarketBusSubscriber::ReadResult MarketBusSubscriber::poll(MarketTick& out) {
+    if (!header_) return ReadResult::Empty;
+
+    const MarketBusSlot& slot = slots_[cursor_ & mask_];
+    uint64_t expected = 2 * cursor_ + 2;
+
+    uint64_t before = slot.version.load(std::memory_order_acquire);
+    if (before < expected) {
+        // 还没写到（或正在写）
+        return ReadResult::Empty;
+    }
+
+    if (before == expected) {
+        out = slot.tick;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == expected) {
+            ++cursor_;
+            return ReadResult::Ok;
+        }
+    }
+
+    // 槽已被下一圈覆盖，跳到最新一条已发布的记录
+    uint64_t head = header_->write_seq.load(std::memory_order_acquire);
+    dropped_ += head - 1 - cursor_;
+    cursor_ = head - 1;
+    return ReadResult::Overrun;
+}
+
+MarketBusSubscriber::ReadResult MarketBusSubscriber::wait(MarketTick& out, int timeout_ms, uint32_t spin) {
+    for (uint32_t i = 0; i < spin; ++i) {
+        ReadResult result = poll(out);
+        if (result != ReadResult::Empty) return result;
+        cpu_relax();
+    }
+    if (!header_) return ReadResult::Empty;
+
+    int64_t deadline = timeout_ms >= 0 ? monotonic_ns() + int64_t(timeout_ms) * 1000000 : 0;
+
+    while (true) {
+        header_->waiters.fetch_add(1, std::memory_order_seq_cst);
+        uint32_t seen = header_->notify.load(std::memory_order_acquire);
+
+        ReadResult result = poll(out);
+        if (result != ReadResult::Empty) {
+            header_->waiters.fetch_sub(1, std::memory_order_relaxed);
+            return result;
+        }
+
+        timespec timeout;
+        timespec* timeout_ptr = nullptr;
+        if (timeout_ms >= 0) {
+            int64_t remaining = deadline - monotonic_ns();
+            if (remaining <= 0) {
+                header_->waiters.fetch_sub(1, std::memory_order_relaxed);
+                return ReadResult::Empty;
+            }
+            timeout.tv_sec = remaining / 1000000000;
+            timeout.tv_nsec = remaining % 1000000000;
+            timeout_ptr = &timeout;
+        }
+
+        futex_wait(&header_->notify, seen, timeout_ptr);
+        header_->waiters.fetch_sub(1, std::memory_order_relaxed);
+
+        result = poll(out);
+        if (result != ReadResult::Empty) return result;
+    }
+}
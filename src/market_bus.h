@@ -0,0 +1,115 @@
+#pragma once
+#include "ticker_batch.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// 定长行情记录，价格/数量已转为 double，可直接按值拷贝
+struct MarketTick {
+    char inst_id[32];
+    char inst_type[16];
+    int64_t ts;             // 交易所时间戳(ms)
+    int64_t publish_ns;     // 发布时 CLOCK_MONOTONIC(ns)，同机进程间可比较
+    double last;
+    double last_sz;
+    double ask_px;
+    double ask_sz;
+    double bid_px;
+    double bid_sz;
+    double open24h;
+    double high24h;
+    double low24h;
+    double vol_ccy24h;
+    double vol24h;
+    double sod_utc0;
+    double sod_utc8;
+
+    void assign(const TickerView& view);
+};
+
+static_assert(std::is_trivially_copyable_v<MarketTick>);
+
+// 共享内存布局: 头部 + 2^n 个槽，每个槽带序号（seqlock），单写多读无锁
+struct alignas(64) MarketBusSlot {
+    // 2*seq+1 写入中，2*seq+2 写完第 seq 条记录
+    std::atomic<uint64_t> version;
+    MarketTick tick;
+};
+
+struct alignas(64) MarketBusHeader {
+    uint64_t magic;
+    uint32_t layout_version;
+    uint32_t slot_size;
+    uint64_t slot_count;
+    alignas(64) std::atomic<uint64_t> write_seq;   // 下一条要发布的序号
+    alignas(64) std::atomic<uint32_t> notify;      // futex 字
+    std::atomic<uint32_t> waiters;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(sizeof(MarketBusSlot) % 64 == 0);
+
+// 发布端: 每台机器一个 feed handler 写入，读者不会阻塞写者
+class MarketBusPublisher {
+public:
+    MarketBusPublisher() = default;
+    ~MarketBusPublisher();
+    MarketBusPublisher(const MarketBusPublisher&) = delete;
+    MarketBusPublisher& operator=(const MarketBusPublisher&) = delete;
+
+    // name 形如 "/okx_tickers"；slot_count 向上取整为2的幂。
+    // 已存在且布局一致的段会沿用原序号，重启发布端时读者不需要重连。失败时原因写入 error
+    bool create(const std::string& name, size_t slot_count, std::string& error);
+    void close();
+    // 关闭时删除共享内存名字
+    void set_unlink_on_close(bool unlink) { unlink_on_close_ = unlink; }
+
+    void publish(const MarketTick& tick);
+    void publish(const TickerView& view);
+
+    bool is_open() const { return header_ != nullptr; }
+    uint64_t published() const;
+
+private:
+    std::string name_;
+    MarketBusHeader* header_ = nullptr;
+    MarketBusSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    size_t mapped_size_ = 0;
+    bool unlink_on_close_ = false;
+    MarketTick scratch_{};
+};
+
+// 订阅端: 其它进程打开同名段后忙轮询或 futex 等待
+class MarketBusSubscriber {
+public:
+    enum class ReadResult { Ok, Empty, Overrun };
+
+    MarketBusSubscriber() = default;
+    ~MarketBusSubscriber();
+    MarketBusSubscriber(const MarketBusSubscriber&) = delete;
+    MarketBusSubscriber& operator=(const MarketBusSubscriber&) = delete;
+
+    // 从当前最新位置开始读；失败时原因写入 error
+    bool open(const std::string& name, std::string& error);
+    void close();
+
+    // 非阻塞读取一条；被写者套圈时跳到最新一条记录并返回 Overrun
+    ReadResult poll(MarketTick& out);
+    // 先自旋 spin 次再 futex 等待，timeout_ms < 0 表示一直等
+    ReadResult wait(MarketTick& out, int timeout_ms = -1, uint32_t spin = 2000);
+
+    bool is_open() const { return header_ != nullptr; }
+    uint64_t cursor() const { return cursor_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    MarketBusHeader* header_ = nullptr;
+    const MarketBusSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    size_t mapped_size_ = 0;
+    uint64_t cursor_ = 0;
+    uint64_t dropped_ = 0;
+};
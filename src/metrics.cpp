@@ -0,0 +1,269 @@
+#include "metrics.h"
+#include "async_logger.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// 独占分片下标的分配表；归还经过互斥锁，新线程接手时能看到旧线程写入的分片值
+class SlotRegistry {
+public:
+    size_t acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            size_t slot = free_.back();
+            free_.pop_back();
+            return slot;
+        }
+        return next_ < MetricCounter::kExclusiveShards ? next_++ : MetricCounter::kExclusiveShards;
+    }
+
+    void release(size_t slot) {
+        if (slot >= MetricCounter::kExclusiveShards) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(slot);
+    }
+
+    // 不析构: 静态析构之后才退出的线程仍要归还
+    static SlotRegistry& instance() {
+        static SlotRegistry* registry = new SlotRegistry();
+        return *registry;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<size_t> free_;
+    size_t next_ = 0;
+};
+
+struct ThreadSlot {
+    size_t index = SlotRegistry::instance().acquire();
+    ~ThreadSlot() { SlotRegistry::instance().release(index); }
+};
+
+}
+
+size_t MetricCounter::thread_slot() {
+    thread_local ThreadSlot slot;
+    return slot.index;
+}
+
+uint64_t MetricCounter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(const std::string& name, const std::string& help, Kind kind,
+                                                 const std::string& labels) {
+    Family* family = nullptr;
+    for (auto& candidate : families_) {
+        if (candidate->name == name) {
+            family = candidate.get();
+            break;
+        }
+    }
+    if (!family) {
+        families_.push_back(std::make_unique<Family>(Family{name, help, kind, {}}));
+        family = families_.back().get();
+    }
+
+    for (auto& existing : family->series) {
+        if (existing.labels == labels) return existing;
+    }
+    family->series.push_back(Series{labels, nullptr, nullptr, nullptr});
+    return family->series.back();
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Kind::Counter, labels);
+    if (!entry.counter) entry.counter = std::make_unique<MetricCounter>();
+    return *entry.counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& entry = series(name, help, Kind::Gauge, labels);
+    if (!entry.gauge) entry.gauge = std::make_unique<MetricGauge>();
+    return *entry.gauge;
+}
+
+void MetricsRegistry::counter_fn(const std::string& name, const std::string& help, std::function<double()> fn,
+                                 const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    series(name, help, Kind::CounterFn, labels).fn = std::move(fn);
+}
+
+void MetricsRegistry::gauge_fn(const std::string& name, const std::string& help, std::function<double()> fn,
+                               const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    series(name, help, Kind::GaugeFn, labels).fn = std::move(fn);
+}
+
+double MetricsRegistry::read(const Series& entry) {
+    if (entry.counter) return static_cast<double>(entry.counter->value());
+    if (entry.gauge) return static_cast<double>(entry.gauge->value());
+    if (entry.fn) return entry.fn();
+    return 0.0;
+}
+
+bool MetricsRegistry::is_counter(Kind kind) {
+    return kind == Kind::Counter || kind == Kind::CounterFn;
+}
+
+std::vector<MetricSample> MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<MetricSample> samples;
+    for (const auto& family : families_) {
+        for (const auto& entry : family->series) {
+            samples.push_back({family->name, entry.labels, is_counter(family->kind) ? "counter" : "gauge", read(entry)});
+        }
+    }
+    return samples;
+}
+
+std::string MetricsRegistry::prometheus_text() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    char number[32];
+    for (const auto& family : families_) {
+        out += "# HELP " + family->name + " " + family->help + "\n";
+        out += "# TYPE " + family->name + (is_counter(family->kind) ? " counter\n" : " gauge\n");
+        for (const auto& entry : family->series) {
+            out += family->name;
+            if (!entry.labels.empty()) {
+                out += '{';
+                out += entry.labels;
+                out += '}';
+            }
+            snprintf(number, sizeof(number), " %.17g\n", read(entry));
+            out += number;
+        }
+    }
+    return out;
+}
+
+std::string MetricsRegistry::label(std::string_view key, std::string_view value) {
+    std::string out(key);
+    out += "=\"";
+    for (char c : value) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    out += '"';
+    return out;
+}
+
+MetricsServer::MetricsServer(const MetricsRegistry& registry)
+    : registry_(registry), listen_fd_(-1), port_(0), running_(false) {}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(int port, const std::string& bind_address) {
+    if (running_) return true;
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        OKX_LOG_ERROR("metrics: socket failed: {}", strerror(errno));
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1 ||
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 16) != 0) {
+        OKX_LOG_ERROR("metrics: cannot listen on {}:{}: {}", bind_address, port, strerror(errno));
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serve_loop, this);
+    OKX_LOG_INFO("Metrics endpoint on http://{}:{}/metrics", bind_address, port_);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close(listen_fd_);
+    listen_fd_ = -1;
+}
+
+void MetricsServer::serve_loop() {
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    while (running_) {
+        // 定时醒来检查停止标志
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        handle_connection(fd);
+        close(fd);
+    }
+}
+
+void MetricsServer::handle_connection(int fd) {
+    // 只读请求行和头部，最多等 1 秒
+    char request[4096];
+    size_t received = 0;
+    pollfd pfd{fd, POLLIN, 0};
+    while (received < sizeof(request) - 1 && poll(&pfd, 1, 1000) > 0) {
+        ssize_t n = recv(fd, request + received, sizeof(request) - 1 - received, 0);
+        if (n <= 0) break;
+        received += static_cast<size_t>(n);
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+    std::string_view line(request, received);
+
+    std::string body;
+    const char* status;
+    const char* content_type = "text/plain; version=0.0.4; charset=utf-8";
+    if (line.starts_with("GET /metrics ") || line.starts_with("GET / ")) {
+        status = "200 OK";
+        body = registry_.prometheus_text();
+    } else {
+        status = "404 Not Found";
+        body = "not found\n";
+    }
+
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += content_type;
+    response += "\r\nContent-Length: " + std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += static_cast<size_t>(n);
+    }
+}
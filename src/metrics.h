@@ -0,0 +1,128 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 计数器: 每个线程独占一个 cache line 分片，热路径只做 relaxed 读写，读取时求和
+class MetricCounter {
+public:
+    void add(uint64_t value = 1) {
+        size_t index = thread_slot();
+        if (index < kExclusiveShards) {
+            // 该分片只有本线程写，不需要 lock 前缀
+            auto& shard = shards_[index].value;
+            shard.store(shard.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        } else {
+            shards_[kExclusiveShards].value.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+    uint64_t value() const;
+
+    static constexpr size_t kExclusiveShards = 15;
+    // 当前线程的分片下标；线程退出时归还，供之后的线程复用，同时在世超过 15 个线程时才共享最后一片
+    static size_t thread_slot();
+
+private:
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    // 前 15 个线程各占一片，其余线程共享最后一片
+    std::array<Shard, kExclusiveShards + 1> shards_;
+};
+
+// 瞬时值（队列深度、连接状态），一般只有一个写者
+class MetricGauge {
+public:
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<int64_t> value_{0};
+};
+
+struct MetricSample {
+    std::string name;
+    std::string labels;     // 形如 inst_id="BTC-USDT"，可为空
+    std::string type;       // counter / gauge
+    double value;
+};
+
+// 注册表: 注册时加锁，返回的引用在注册表生命周期内有效；热路径只持有指针
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // 同名同标签重复注册返回同一个对象
+    MetricCounter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    MetricGauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    // 读取时调用 fn 取值，用于已有统计（日志丢弃数等）
+    void counter_fn(const std::string& name, const std::string& help, std::function<double()> fn, const std::string& labels = "");
+    void gauge_fn(const std::string& name, const std::string& help, std::function<double()> fn, const std::string& labels = "");
+
+    // 拉取接口
+    std::vector<MetricSample> snapshot() const;
+    // Prometheus 文本格式 0.0.4
+    std::string prometheus_text() const;
+
+    // 生成 key="value"，转义反斜杠、引号和换行
+    static std::string label(std::string_view key, std::string_view value);
+
+private:
+    enum class Kind { Counter, Gauge, CounterFn, GaugeFn };
+
+    struct Series {
+        std::string labels;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::function<double()> fn;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Kind kind;
+        std::vector<Series> series;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Family>> families_;
+
+    Series& series(const std::string& name, const std::string& help, Kind kind, const std::string& labels);
+    static double read(const Series& entry);
+    static bool is_counter(Kind kind);
+};
+
+// 本地 HTTP 端点，在独立线程上响应 GET /metrics
+class MetricsServer {
+public:
+    explicit MetricsServer(const MetricsRegistry& registry);
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // port 为 0 时由系统分配，实际端口见 port()
+    bool start(int port, const std::string& bind_address = "127.0.0.1");
+    void stop();
+    int port() const { return port_; }
+
+private:
+    const MetricsRegistry& registry_;
+    int listen_fd_;
+    int port_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    void serve_loop();
+    void handle_connection(int fd);
+};
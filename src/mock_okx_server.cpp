@@ -0,0 +1,610 @@
+#include "mock_okx_server.h"
+#include "json_scanner.h"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <unistd.h>
+
+namespace {
+
+// 为方便 ccinfo_.protocol 协商，协议名与客户端一致
+const struct lws_protocols protocols[] = {
+    {
+        .name = "okx-websocket",
+        .callback = MockOKXServer::callback_function,
+        .per_session_data_size = sizeof(void*),
+        .rx_buffer_size = 4096,
+        .id = 0,
+        .user = nullptr,
+        .tx_packet_size = 0
+    },
+    {
+        .name = nullptr,
+        .callback = nullptr,
+        .per_session_data_size = 0,
+        .rx_buffer_size = 0,
+        .id = 0,
+        .user = nullptr,
+        .tx_packet_size = 0
+    }
+};
+
+constexpr size_t kMaxFrame = 64 * 1024;
+
+}
+
+struct MockOKXServer::Session {
+    uint64_t id = 0;                     // 建立顺序，从 1 开始
+    std::vector<uint32_t> instruments;   // 已订阅的交易对下标
+    std::vector<std::string> replies;    // 待发送的订阅回执
+    uint64_t sent = 0;
+    uint32_t generation = 0;
+    size_t next = 0;
+    bool streaming = false;
+    bool logged_in = false;
+    std::vector<std::string> open_orders;  // 下单成功的 ordId
+};
+
+MockOKXServer::MockOKXServer(MockServerConfig config)
+    : config_(std::move(config)), context_(nullptr), running_(false),
+      rate_(config_.rate), frames_sent_(0), bytes_sent_(0), sessions_(0), logins_(0), login_failures_(0),
+      accepted_(0), drop_session_(0),
+      active_rate_(config_.rate), generation_(0), timeline_start_ns_(0), timeline_base_(0),
+      rng_(0x9E3779B97F4A7C15ULL), buffer_(LWS_PRE + kMaxFrame), next_order_id_(600000000) {
+    if (config_.tickers_per_frame == 0) {
+        config_.tickers_per_frame = 1;
+    }
+    for (uint32_t i = 0; i < config_.instruments; ++i) {
+        names_.push_back(instrument_name(i));
+        prices_.push_back(100.0 + i);
+    }
+    if (!config_.secret_key.empty()) {
+        signer_.set_key(config_.secret_key);
+    }
+}
+
+MockOKXServer::~MockOKXServer() {
+    stop();
+}
+
+std::string MockOKXServer::instrument_name(uint32_t index) {
+    return "MOCK" + std::to_string(index) + "-USDT";
+}
+
+int64_t MockOKXServer::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool MockOKXServer::start() {
+    if (running_) return true;
+
+    if (!config_.replay_file.empty() && !load_replay()) {
+        return false;
+    }
+    if (config_.use_ssl && !ensure_certificate()) {
+        return false;
+    }
+
+    struct lws_context_creation_info info;
+    memset(&info, 0, sizeof(info));
+    info.port = config_.port;
+    info.protocols = protocols;
+    info.gid = -1;
+    info.uid = -1;
+    info.user = this;
+#if !defined(LWS_WITHOUT_EXTENSIONS)
+    static const struct lws_extension extensions[] = {
+        {"permessage-deflate", lws_extension_callback_pm_deflate, "permessage-deflate"},
+        {nullptr, nullptr, nullptr}};
+    if (config_.deflate) {
+        info.extensions = extensions;
+    }
+#endif
+    if (config_.use_ssl) {
+        info.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+        info.ssl_cert_filepath = config_.cert_path.c_str();
+        info.ssl_private_key_filepath = config_.key_path.c_str();
+    }
+
+    context_ = lws_create_context(&info);
+    if (!context_) {
+        std::cerr << "Failed to create mock server context on port " << config_.port << std::endl;
+        return false;
+    }
+
+    timeline_start_ns_ = now_ns();
+    running_ = true;
+    service_thread_ = std::thread(&MockOKXServer::service_loop, this);
+
+    // lws_service 在 v4 中会阻塞到有事件为止，由节拍线程定时唤醒服务线程
+    pacer_thread_ = std::thread([this] {
+        while (running_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            lws_cancel_service(context_);
+        }
+    });
+
+    std::cout << "Mock OKX server listening on port " << config_.port
+              << (config_.use_ssl ? " (TLS)" : "") << (config_.deflate ? " (deflate)" : "") << std::endl;
+    return true;
+}
+
+void MockOKXServer::stop() {
+    if (!running_) return;
+    running_ = false;
+
+    if (pacer_thread_.joinable()) {
+        pacer_thread_.join();
+    }
+    if (context_) {
+        lws_cancel_service(context_);
+    }
+    if (service_thread_.joinable()) {
+        service_thread_.join();
+    }
+    if (context_) {
+        lws_context_destroy(context_);
+        context_ = nullptr;
+    }
+}
+
+void MockOKXServer::drop_session(uint64_t id) {
+    drop_session_ = id;
+    if (context_) {
+        lws_cancel_service(context_);
+    }
+}
+
+void MockOKXServer::set_rate(uint32_t rate) {
+    rate_ = rate;
+}
+
+MockServerStats MockOKXServer::stats() const {
+    return {frames_sent_.load(), bytes_sent_.load(), sessions_.load(), logins_.load(), login_failures_.load()};
+}
+
+void MockOKXServer::service_loop() {
+    while (running_) {
+        lws_service(context_, 0);
+    }
+}
+
+uint64_t MockOKXServer::frames_due(int64_t now) {
+    uint64_t due = timeline_base_ + static_cast<uint64_t>((now - timeline_start_ns_) * static_cast<double>(active_rate_) / 1e9);
+
+    uint32_t rate = rate_.load(std::memory_order_relaxed);
+    if (rate != active_rate_) {
+        // 改速率时重新起算，丢弃各连接的积压
+        timeline_base_ = due;
+        timeline_start_ns_ = now;
+        active_rate_ = rate;
+        ++generation_;
+    }
+    return due;
+}
+
+int MockOKXServer::callback_function(struct lws* wsi, enum lws_callback_reasons reason, void* user, void* in, size_t len) {
+    auto* server = static_cast<MockOKXServer*>(lws_context_user(lws_get_context(wsi)));
+    if (!server) return 0;
+
+    auto** slot = static_cast<Session**>(user);
+
+    switch (reason) {
+        case LWS_CALLBACK_ESTABLISHED:
+            *slot = new Session();
+            (*slot)->id = ++server->accepted_;
+            server->sessions_++;
+            break;
+
+        case LWS_CALLBACK_RECEIVE:
+            if (*slot && len > 0) {
+                server->on_receive(wsi, **slot, std::string_view(static_cast<const char*>(in), len));
+            }
+            break;
+
+        case LWS_CALLBACK_SERVER_WRITEABLE:
+            if (*slot) {
+                return server->on_writable(wsi, **slot);
+            }
+            break;
+
+        case LWS_CALLBACK_CLOSED:
+            if (*slot) {
+                delete *slot;
+                *slot = nullptr;
+                server->sessions_--;
+            }
+            break;
+
+        case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+            // 节拍到达: 让所有连接检查是否有到期的帧
+            lws_callback_on_writable_all_protocol(server->context_, &protocols[0]);
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+void MockOKXServer::on_receive(struct lws* wsi, Session& session, std::string_view message) {
+    if (message == "ping") {
+        session.replies.emplace_back("pong");
+        lws_callback_on_writable(wsi);
+        return;
+    }
+
+    std::string_view id;
+    std::string_view op;
+    std::string_view args;
+    JsonScanner::for_each_member(message, [&](std::string_view key, std::string_view value, bool is_string) {
+        if (key == "op" && is_string) op = value;
+        else if (key == "args") args = value;
+        else if (key == "id") id = value;
+        return true;
+    });
+    if (op == "login" && !args.empty()) {
+        session.logged_in = verify_login(args);
+        if (session.logged_in) {
+            logins_++;
+            session.replies.emplace_back(R"({"event":"login","code":"0","msg":"","connId":"mock"})");
+        } else {
+            login_failures_++;
+            session.replies.emplace_back(R"({"event":"error","code":"60009","msg":"Login failed.","connId":"mock"})");
+        }
+        lws_callback_on_writable(wsi);
+        return;
+    }
+    if ((op == "order" || op == "cancel-order" || op == "amend-order") && !args.empty()) {
+        session.replies.push_back(order_response(session, id, op, args));
+        lws_callback_on_writable(wsi);
+        return;
+    }
+    if ((op != "subscribe" && op != "unsubscribe") || args.empty()) {
+        session.replies.emplace_back(R"({"event":"error","code":"60012","msg":"Invalid request"})");
+        lws_callback_on_writable(wsi);
+        return;
+    }
+
+    JsonScanner::for_each_element(args, [&](std::string_view arg) {
+        std::string_view channel;
+        std::string_view inst_id;
+        std::string_view inst_type;
+        JsonScanner::for_each_member(arg, [&](std::string_view key, std::string_view value, bool) {
+            if (key == "channel") channel = value;
+            else if (key == "instId") inst_id = value;
+            else if (key == "instType") inst_type = value;
+            return true;
+        });
+
+        if (channel == "orders" || channel == "positions" || channel == "account") {
+            if (op == "subscribe") on_private_subscribe(session, channel, inst_type);
+            return true;
+        }
+
+        // 与 OKX 一致，请求带 id 时回执原样带回
+        std::string reply = "{";
+        if (!id.empty()) reply += R"("id":")" + std::string(id) + R"(",)";
+        reply += R"("event":")" + std::string(op) + R"(","arg":{"channel":")" + std::string(channel) +
+                 R"(","instId":")" + std::string(inst_id) + R"("},"connId":"mock"})";
+        session.replies.push_back(std::move(reply));
+        if (channel != "tickers") return true;
+
+        // 合成模式下未知交易对按需加入
+        uint32_t index = 0;
+        while (index < names_.size() && names_[index] != inst_id) ++index;
+        if (index == names_.size()) {
+            names_.emplace_back(inst_id);
+            prices_.push_back(100.0);
+        }
+
+        auto it = std::find(session.instruments.begin(), session.instruments.end(), index);
+        if (op == "subscribe" && it == session.instruments.end()) {
+            session.instruments.push_back(index);
+        } else if (op == "unsubscribe" && it != session.instruments.end()) {
+            session.instruments.erase(it);
+        }
+        return true;
+    });
+
+    bool streaming = !session.instruments.empty();
+    if (streaming && !session.streaming) {
+        // 从当前时间线开始推送，不补发历史
+        session.sent = frames_due(now_ns());
+        session.generation = generation_;
+    }
+    session.streaming = streaming;
+    lws_callback_on_writable(wsi);
+}
+
+bool MockOKXServer::verify_login(std::string_view args) {
+    std::string_view api_key;
+    std::string_view passphrase;
+    std::string_view timestamp;
+    std::string_view sign;
+    JsonScanner::for_each_element(args, [&](std::string_view arg) {
+        JsonScanner::for_each_member(arg, [&](std::string_view key, std::string_view value, bool) {
+            if (key == "apiKey") api_key = value;
+            else if (key == "passphrase") passphrase = value;
+            else if (key == "timestamp") timestamp = value;
+            else if (key == "sign") sign = value;
+            return true;
+        });
+        return false;
+    });
+
+    if (!signer_.has_key() || api_key != config_.api_key || passphrase != config_.passphrase) {
+        return false;
+    }
+
+    // 与 OKX 一样只接受 30 秒内的时间戳
+    long long seconds = atoll(std::string(timestamp).c_str());
+    if (std::llabs(static_cast<long long>(std::time(nullptr)) - seconds) > 30) {
+        return false;
+    }
+
+    std::string expected;
+    return signer_.sign_base64(HmacSigner::login_prehash(timestamp), expected) && expected == sign;
+}
+
+void MockOKXServer::on_private_subscribe(Session& session, std::string_view channel, std::string_view inst_type) {
+    if (!session.logged_in) {
+        session.replies.emplace_back(R"({"event":"error","code":"60011","msg":"Please log in.","connId":"mock"})");
+        return;
+    }
+
+    std::string arg = R"({"channel":")" + std::string(channel) + '"';
+    if (!inst_type.empty()) {
+        arg += R"(,"instType":")" + std::string(inst_type) + '"';
+    }
+    arg += R"(,"uid":"mock"})";
+    session.replies.push_back(R"({"event":"subscribe","arg":)" + arg + R"(,"connId":"mock"})");
+
+    // 订阅成功后推送一条合成快照，便于端到端验证解析
+    long long ts_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string ts = std::to_string(ts_ms);
+    std::string data;
+    if (channel == "orders") {
+        data = R"({"instType":"SPOT","instId":"BTC-USDT","ordId":"1000001","clOrdId":"mock1","px":"30000","sz":"0.01",)"
+               R"("ordType":"limit","side":"buy","tdMode":"cash","fillSz":"0","accFillSz":"0","state":"live",)"
+               R"("code":"0","msg":"","cTime":")" + ts + R"(","uTime":")" + ts + R"("})";
+    } else if (channel == "positions") {
+        data = R"({"instType":"SWAP","instId":"BTC-USDT-SWAP","posId":"2000001","posSide":"long","mgnMode":"cross",)"
+               R"("pos":"1","availPos":"1","avgPx":"30000","upl":"12.5","lever":"10","ccy":"USDT",)"
+               R"("cTime":")" + ts + R"(","uTime":")" + ts + R"(","pTime":")" + ts + R"("})";
+    } else {
+        data = R"({"totalEq":"10000","adjEq":"10000","imr":"0","mmr":"0","uTime":")" + ts + R"(",)"
+               R"("details":[{"ccy":"USDT","eq":"10000","cashBal":"10000","availBal":"10000","frozenBal":"0","uTime":")" + ts + R"("}]})";
+    }
+    session.replies.push_back(R"({"arg":)" + arg + R"(,"data":[)" + data + "]}");
+}
+
+std::string MockOKXServer::order_response(Session& session, std::string_view id, std::string_view op, std::string_view args) {
+    std::string_view ord_id;
+    std::string_view cl_ord_id;
+    std::string_view sz;
+    JsonScanner::for_each_element(args, [&](std::string_view arg) {
+        JsonScanner::for_each_member(arg, [&](std::string_view key, std::string_view value, bool) {
+            if (key == "ordId") ord_id = value;
+            else if (key == "clOrdId") cl_ord_id = value;
+            else if (key == "sz") sz = value;
+            return true;
+        });
+        return false;
+    });
+
+    std::string assigned(ord_id);
+    const char* s_code = "0";
+    const char* s_msg = "";
+    if (!session.logged_in) {
+        s_code = "50101";
+        s_msg = "Please log in.";
+    } else if (op == "order") {
+        if (sz.empty()) {
+            s_code = "51000";
+            s_msg = "Parameter sz error";
+        } else {
+            assigned = std::to_string(++next_order_id_);
+            session.open_orders.push_back(assigned);
+            s_msg = "Order placed";
+        }
+    } else {
+        auto it = std::find(session.open_orders.begin(), session.open_orders.end(), ord_id);
+        if (it == session.open_orders.end()) {
+            s_code = op == "cancel-order" ? "51400" : "51503";
+            s_msg = "Order does not exist";
+        } else if (op == "cancel-order") {
+            session.open_orders.erase(it);
+        }
+    }
+
+    long long now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    bool ok = strcmp(s_code, "0") == 0;
+    return R"({"id":")" + std::string(id) + R"(","op":")" + std::string(op) + R"(","data":[{"clOrdId":")" +
+           std::string(cl_ord_id) + R"(","ordId":")" + (ok ? assigned : std::string()) + R"(","tag":"","sCode":")" +
+           s_code + R"(","sMsg":")" + s_msg + R"("}],"code":")" + (ok ? "0" : "1") + R"(","msg":"","inTime":")" +
+           std::to_string(now_us) + R"(","outTime":")" + std::to_string(now_us) + R"("})";
+}
+
+int MockOKXServer::on_writable(struct lws* wsi, Session& session) {
+    unsigned char* payload = buffer_.data() + LWS_PRE;
+
+    if (session.id == drop_session_.load(std::memory_order_relaxed)) {
+        return -1;
+    }
+
+    // 每次 WRITEABLE 只写一帧，回执优先
+    if (!session.replies.empty()) {
+        const std::string& reply = session.replies.front();
+        memcpy(payload, reply.data(), reply.size());
+        if (lws_write(wsi, payload, reply.size(), LWS_WRITE_TEXT) < static_cast<int>(reply.size())) {
+            return -1;
+        }
+        session.replies.erase(session.replies.begin());
+        lws_callback_on_writable(wsi);
+        return 0;
+    }
+
+    if (!session.streaming) return 0;
+
+    int64_t now = now_ns();
+    uint64_t due = frames_due(now);
+    if (session.generation != generation_) {
+        session.sent = due;
+        session.generation = generation_;
+        return 0;
+    }
+    if (session.sent >= due) return 0;
+
+    size_t length = build_frame(session, now);
+    if (length == 0) return 0;
+
+    int written = lws_write(wsi, payload, length, LWS_WRITE_TEXT);
+    if (written < static_cast<int>(length)) {
+        std::cerr << "Mock server write failed" << std::endl;
+        return -1;
+    }
+
+    session.sent++;
+    frames_sent_.fetch_add(1, std::memory_order_relaxed);
+    bytes_sent_.fetch_add(length, std::memory_order_relaxed);
+
+    if (session.sent < due) {
+        lws_callback_on_writable(wsi);
+    }
+    return 0;
+}
+
+size_t MockOKXServer::build_frame(Session& session, int64_t send_ns) {
+    char* out = reinterpret_cast<char*>(buffer_.data() + LWS_PRE);
+
+    if (!replay_frames_.empty()) {
+        const std::string& frame = replay_frames_[session.next++ % replay_frames_.size()];
+        // 在第一个 ticker 对象开头插入发送时间戳
+        size_t at = frame.find("\"data\":[{");
+        if (at == std::string::npos) {
+            memcpy(out, frame.data(), frame.size());
+            return frame.size();
+        }
+        at += 9;
+        char stamp[48];
+        int stamp_len = snprintf(stamp, sizeof(stamp), "\"sendNs\":\"%lld\",", static_cast<long long>(send_ns));
+        memcpy(out, frame.data(), at);
+        memcpy(out + at, stamp, stamp_len);
+        memcpy(out + at + stamp_len, frame.data() + at, frame.size() - at);
+        return frame.size() + stamp_len;
+    }
+
+    size_t count = session.instruments.size();
+    uint32_t first = session.instruments[session.next % count];
+    int n = snprintf(out, kMaxFrame, R"({"arg":{"channel":"tickers","instId":"%s"},"data":[)", names_[first].c_str());
+    size_t length = static_cast<size_t>(n);
+
+    for (uint32_t i = 0; i < config_.tickers_per_frame; ++i) {
+        uint32_t instrument = session.instruments[session.next++ % count];
+        if (i > 0) out[length++] = ',';
+        size_t written = append_ticker(out + length, kMaxFrame - length - 2, instrument, send_ns);
+        if (written == 0) break;
+        length += written;
+    }
+    out[length++] = ']';
+    out[length++] = '}';
+    return length;
+}
+
+size_t MockOKXServer::append_ticker(char* out, size_t capacity, uint32_t instrument, int64_t send_ns) {
+    // 简单随机游走
+    rng_ = rng_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    double step = (static_cast<double>(rng_ >> 11) / 9007199254740992.0 - 0.5) * 0.001;
+    double last = prices_[instrument] *= 1.0 + step;
+
+    long long ts_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    int n = snprintf(out, capacity,
+        R"({"instType":"SPOT","instId":"%s","last":"%.4f","lastSz":"0.01","askPx":"%.4f","askSz":"1.5",)"
+        R"("bidPx":"%.4f","bidSz":"2.5","open24h":"%.4f","high24h":"%.4f","low24h":"%.4f",)"
+        R"("volCcy24h":"1000000","vol24h":"10000","sodUtc0":"%.4f","sodUtc8":"%.4f","ts":"%lld","sendNs":"%lld"})",
+        names_[instrument].c_str(), last, last * 1.0001, last * 0.9999, last, last * 1.01, last * 0.99,
+        last, last, ts_ms, static_cast<long long>(send_ns));
+    if (n < 0 || static_cast<size_t>(n) >= capacity) return 0;
+    return static_cast<size_t>(n);
+}
+
+bool MockOKXServer::load_replay() {
+    std::ifstream file(config_.replay_file);
+    if (!file) {
+        std::cerr << "Cannot open replay file " << config_.replay_file << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.size() + 64 < kMaxFrame) {
+            replay_frames_.push_back(line);
+        }
+    }
+    if (replay_frames_.empty()) {
+        std::cerr << "Replay file " << config_.replay_file << " has no frames" << std::endl;
+        return false;
+    }
+    std::cout << "Loaded " << replay_frames_.size() << " replay frames" << std::endl;
+    return true;
+}
+
+// 生成 P-256 自签名证书，写到临时目录
+bool MockOKXServer::ensure_certificate() {
+    if (!config_.cert_path.empty() && !config_.key_path.empty()) {
+        return true;
+    }
+
+    std::string prefix = "/tmp/okx_mock_" + std::to_string(getpid());
+    config_.cert_path = prefix + "_cert.pem";
+    config_.key_path = prefix + "_key.pem";
+
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    bool ok = key && cert;
+
+    if (ok) {
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 365L * 24 * 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0;
+    }
+
+    if (ok) {
+        FILE* cert_file = fopen(config_.cert_path.c_str(), "w");
+        FILE* key_file = fopen(config_.key_path.c_str(), "w");
+        ok = cert_file && key_file && PEM_write_X509(cert_file, cert) &&
+             PEM_write_PrivateKey(key_file, key, nullptr, nullptr, 0, nullptr, nullptr);
+        if (cert_file) fclose(cert_file);
+        if (key_file) fclose(key_file);
+    }
+
+    X509_free(cert);
+    EVP_PKEY_free(key);
+
+    if (!ok) {
+        std::cerr << "Failed to generate self-signed certificate" << std::endl;
+        return false;
+    }
+    std::cout << "Generated self-signed certificate " << config_.cert_path << std::endl;
+    return true;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "channel_schema.h"
+#include "hmac_signer.h"
+#include <libwebsockets.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 本地模拟 OKX 公共行情服务，用于离线压测完整接收路径
+struct MockServerConfig {
+    int port = 18443;
+    bool use_ssl = false;
+    // 为空且 use_ssl 时自动生成自签名证书
+    std::string cert_path;
+    std::string key_path;
+    uint32_t rate = 1000;           // 每个连接每秒推送的帧数
+    uint32_t instruments = 10;      // 合成行情的交易对数量
+    uint32_t tickers_per_frame = 1;
+    // 每行一帧的录制文件，非空时按顺序循环回放，忽略 instruments
+    std::string replay_file;
+    // 接受客户端的 permessage-deflate 协商
+    bool deflate = false;
+    // 私有频道登录凭证，为空时拒绝所有 login 请求；签名按 OKX 规则校验
+    std::string api_key;
+    std::string secret_key;
+    std::string passphrase;
+};
+
+struct MockServerStats {
+    uint64_t frames_sent;
+    uint64_t bytes_sent;
+    uint64_t sessions;
+    uint64_t logins;
+    uint64_t login_failures;
+};
+
+// 压测驱动使用的解码结构: 每个 ticker 带有服务端发送时刻 sendNs（CLOCK_MONOTONIC）
+struct MockTickerData {
+    std::string inst_id;
+    std::string last;
+    int64_t ts = 0;
+    int64_t send_ns = 0;
+};
+
+template <>
+struct ChannelSchema<MockTickerData> {
+    static constexpr std::string_view channel = "tickers";
+    static constexpr auto fields = std::make_tuple(
+        field("instId", &MockTickerData::inst_id),
+        field("last", &MockTickerData::last),
+        field("ts", &MockTickerData::ts),
+        field("sendNs", &MockTickerData::send_ns));
+};
+
+class MockOKXServer {
+public:
+    explicit MockOKXServer(MockServerConfig config = {});
+    ~MockOKXServer();
+
+    bool start();
+    void stop();
+
+    // 运行中调整推送速率，各连接未发完的积压会被丢弃
+    void set_rate(uint32_t rate);
+    uint32_t rate() const { return rate_.load(); }
+    MockServerStats stats() const;
+    // 在下一次可写时关闭第 id 个建立的连接（从 1 开始计数），用于测试断线与热备切换
+    void drop_session(uint64_t id);
+    const MockServerConfig& config() const { return config_; }
+
+    static std::string instrument_name(uint32_t index);
+    static int64_t now_ns();
+
+    static int callback_function(struct lws* wsi, enum lws_callback_reasons reason, void* user, void* in, size_t len);
+
+private:
+    struct Session;
+
+    MockServerConfig config_;
+    struct lws_context* context_;
+    std::thread service_thread_;
+    std::thread pacer_thread_;
+    std::atomic<bool> running_;
+
+    std::atomic<uint32_t> rate_;
+    std::atomic<uint64_t> frames_sent_;
+    std::atomic<uint64_t> bytes_sent_;
+    std::atomic<uint64_t> sessions_;
+    std::atomic<uint64_t> logins_;
+    std::atomic<uint64_t> login_failures_;
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> drop_session_;
+
+    // 推送时间线: due = base + rate * (now - start)，只在服务线程访问
+    uint32_t active_rate_;
+    uint32_t generation_;
+    int64_t timeline_start_ns_;
+    uint64_t timeline_base_;
+
+    std::vector<std::string> names_;
+    std::vector<double> prices_;
+    std::vector<std::string> replay_frames_;
+    uint64_t rng_;
+    std::vector<unsigned char> buffer_;
+    HmacSigner signer_;
+    uint64_t next_order_id_;
+
+    void service_loop();
+    uint64_t frames_due(int64_t now_ns);
+    void on_receive(struct lws* wsi, Session& session, std::string_view message);
+    int on_writable(struct lws* wsi, Session& session);
+    bool verify_login(std::string_view args);
+    void on_private_subscribe(Session& session, std::string_view channel, std::string_view inst_type);
+    // order/cancel-order/amend-order 应答，格式与 OKX 一致
+    std::string order_response(Session& session, std::string_view id, std::string_view op, std::string_view args);
+    size_t build_frame(Session& session, int64_t send_ns);
+    size_t append_ticker(char* out, size_t capacity, uint32_t instrument, int64_t send_ns);
+    bool load_replay();
+    bool ensure_certificate();
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include "channel_schema.h"
+#include "json_parser.h"
+
+// OKX 公共频道数据结构，解析器/序列化器由 ChannelSchema 生成
+// 价格类字段保持字符串以免丢失精度，时间戳解码为 int64_t 毫秒
+
+struct MarkPriceData {
+    std::string inst_type;
+    std::string inst_id;
+    std::string mark_px;
+    int64_t ts = 0;
+};
+
+struct FundingRateData {
+    std::string inst_type;
+    std::string inst_id;
+    std::string method;
+    std::string funding_rate;
+    std::string next_funding_rate;
+    int64_t funding_time = 0;
+    int64_t next_funding_time = 0;
+    std::string min_funding_rate;
+    std::string max_funding_rate;
+    std::string premium;
+    int64_t ts = 0;
+};
+
+struct IndexTickerData {
+    std::string inst_id;
+    std::string idx_px;
+    std::string open24h;
+    std::string high24h;
+    std::string low24h;
+    std::string sod_utc0;
+    std::string sod_utc8;
+    int64_t ts = 0;
+};
+
+struct OpenInterestData {
+    std::string inst_type;
+    std::string inst_id;
+    std::string oi;
+    std::string oi_ccy;
+    std::string oi_usd;
+    int64_t ts = 0;
+};
+
+// TickerData 与 TickerView 成员同名，共用一份字段表
+template <typename T>
+constexpr auto ticker_fields() {
+    return std::make_tuple(
+        field("instType", &T::inst_type),
+        field("instId", &T::inst_id),
+        field("last", &T::last),
+        field("lastSz", &T::last_sz),
+        field("askPx", &T::ask_px),
+        field("askSz", &T::ask_sz),
+        field("bidPx", &T::bid_px),
+        field("bidSz", &T::bid_sz),
+        field("open24h", &T::open24h),
+        field("high24h", &T::high24h),
+        field("low24h", &T::low24h),
+        field("volCcy24h", &T::vol_ccy24h),
+        field("vol24h", &T::vol24h),
+        field("sodUtc0", &T::sod_utc0),
+        field("sodUtc8", &T::sod_utc8),
+        field("ts", &T::ts));
+}
+
+template <>
+struct ChannelSchema<TickerData> {
+    static constexpr std::string_view channel = "tickers";
+    static constexpr auto fields = ticker_fields<TickerData>();
+};
+
+template <>
+struct ChannelSchema<TickerView> {
+    static constexpr std::string_view channel = "tickers";
+    static constexpr auto fields = ticker_fields<TickerView>();
+};
+
+template <>
+struct ChannelSchema<MarkPriceData> {
+    static constexpr std::string_view channel = "mark-price";
+    static constexpr auto fields = std::make_tuple(
+        field("instType", &MarkPriceData::inst_type),
+        field("instId", &MarkPriceData::inst_id),
+        field("markPx", &MarkPriceData::mark_px),
+        field("ts", &MarkPriceData::ts));
+};
+
+template <>
+struct ChannelSchema<FundingRateData> {
+    static constexpr std::string_view channel = "funding-rate";
+    static constexpr auto fields = std::make_tuple(
+        field("instType", &FundingRateData::inst_type),
+        field("instId", &FundingRateData::inst_id),
+        field("method", &FundingRateData::method),
+        field("fundingRate", &FundingRateData::funding_rate),
+        field("nextFundingRate", &FundingRateData::next_funding_rate),
+        field("fundingTime", &FundingRateData::funding_time),
+        field("nextFundingTime", &FundingRateData::next_funding_time),
+        field("minFundingRate", &FundingRateData::min_funding_rate),
+        field("maxFundingRate", &FundingRateData::max_funding_rate),
+        field("premium", &FundingRateData::premium),
+        field("ts", &FundingRateData::ts));
+};
+
+template <>
+struct ChannelSchema<IndexTickerData> {
+    static constexpr std::string_view channel = "index-tickers";
+    static constexpr auto fields = std::make_tuple(
+        field("instId", &IndexTickerData::inst_id),
+        field("idxPx", &IndexTickerData::idx_px),
+        field("open24h", &IndexTickerData::open24h),
+        field("high24h", &IndexTickerData::high24h),
+        field("low24h", &IndexTickerData::low24h),
+        field("sodUtc0", &IndexTickerData::sod_utc0),
+        field("sodUtc8", &IndexTickerData::sod_utc8),
+        field("ts", &IndexTickerData::ts));
+};
+
+template <>
+struct ChannelSchema<OpenInterestData> {
+    static constexpr std::string_view channel = "open-interest";
+    static constexpr auto fields = std::make_tuple(
+        field("instType", &OpenInterestData::inst_type),
+        field("instId", &OpenInterestData::inst_id),
+        field("oi", &OpenInterestData::oi),
+        field("oiCcy", &OpenInterestData::oi_ccy),
+        field("oiUsd", &OpenInterestData::oi_usd),
+        field("ts", &OpenInterestData::ts));
+};
@@ -0,0 +1,186 @@
+#pragma once
+#include "channel_schema.h"
+#include "json_scanner.h"
+
+// OKX 私有频道（需登录 /ws/v5/private）的零拷贝视图
+// 字符串字段指向接收缓冲区，只在回调期间有效；时间戳解码为 int64_t 毫秒
+
+struct OrderView {
+    std::string_view inst_type;
+    std::string_view inst_id;
+    std::string_view ord_id;
+    std::string_view cl_ord_id;
+    std::string_view tag;
+    std::string_view px;
+    std::string_view sz;
+    std::string_view ord_type;
+    std::string_view side;
+    std::string_view pos_side;
+    std::string_view td_mode;
+    std::string_view fill_px;
+    std::string_view trade_id;
+    std::string_view fill_sz;
+    int64_t fill_time = 0;
+    std::string_view acc_fill_sz;
+    std::string_view avg_px;
+    std::string_view state;
+    std::string_view lever;
+    std::string_view fee;
+    std::string_view fee_ccy;
+    std::string_view pnl;
+    std::string_view code;
+    std::string_view msg;
+    int64_t c_time = 0;
+    int64_t u_time = 0;
+};
+
+struct PositionView {
+    std::string_view inst_type;
+    std::string_view inst_id;
+    std::string_view pos_id;
+    std::string_view pos_side;
+    std::string_view mgn_mode;
+    std::string_view pos;
+    std::string_view avail_pos;
+    std::string_view avg_px;
+    std::string_view upl;
+    std::string_view upl_ratio;
+    std::string_view lever;
+    std::string_view liq_px;
+    std::string_view mark_px;
+    std::string_view margin;
+    std::string_view mgn_ratio;
+    std::string_view notional_usd;
+    std::string_view ccy;
+    int64_t c_time = 0;
+    int64_t u_time = 0;
+    int64_t p_time = 0;
+};
+
+struct AccountView {
+    std::string_view total_eq;
+    std::string_view iso_eq;
+    std::string_view adj_eq;
+    std::string_view imr;
+    std::string_view mmr;
+    std::string_view mgn_ratio;
+    std::string_view notional_usd;
+    std::string_view details;   // 原始 JSON 数组，用 for_each_account_detail 遍历
+    int64_t u_time = 0;
+};
+
+struct AccountDetailView {
+    std::string_view ccy;
+    std::string_view eq;
+    std::string_view cash_bal;
+    std::string_view avail_bal;
+    std::string_view frozen_bal;
+    std::string_view avail_eq;
+    std::string_view upl;
+    std::string_view eq_usd;
+    int64_t u_time = 0;
+};
+
+template <>
+struct ChannelSchema<OrderView> {
+    static constexpr std::string_view channel = "orders";
+    static constexpr auto fields = std::make_tuple(
+        field("instType", &OrderView::inst_type),
+        field("instId", &OrderView::inst_id),
+        field("ordId", &OrderView::ord_id),
+        field("clOrdId", &OrderView::cl_ord_id),
+        field("tag", &OrderView::tag),
+        field("px", &OrderView::px),
+        field("sz", &OrderView::sz),
+        field("ordType", &OrderView::ord_type),
+        field("side", &OrderView::side),
+        field("posSide", &OrderView::pos_side),
+        field("tdMode", &OrderView::td_mode),
+        field("fillPx", &OrderView::fill_px),
+        field("tradeId", &OrderView::trade_id),
+        field("fillSz", &OrderView::fill_sz),
+        field("fillTime", &OrderView::fill_time),
+        field("accFillSz", &OrderView::acc_fill_sz),
+        field("avgPx", &OrderView::avg_px),
+        field("state", &OrderView::state),
+        field("lever", &OrderView::lever),
+        field("fee", &OrderView::fee),
+        field("feeCcy", &OrderView::fee_ccy),
+        field("pnl", &OrderView::pnl),
+        field("code", &OrderView::code),
+        field("msg", &OrderView::msg),
+        field("cTime", &OrderView::c_time),
+        field("uTime", &OrderView::u_time));
+};
+
+template <>
+struct ChannelSchema<PositionView> {
+    static constexpr std::string_view channel = "positions";
+    static constexpr auto fields = std::make_tuple(
+        field("instType", &PositionView::inst_type),
+        field("instId", &PositionView::inst_id),
+        field("posId", &PositionView::pos_id),
+        field("posSide", &PositionView::pos_side),
+        field("mgnMode", &PositionView::mgn_mode),
+        field("pos", &PositionView::pos),
+        field("availPos", &PositionView::avail_pos),
+        field("avgPx", &PositionView::avg_px),
+        field("upl", &PositionView::upl),
+        field("uplRatio", &PositionView::upl_ratio),
+        field("lever", &PositionView::lever),
+        field("liqPx", &PositionView::liq_px),
+        field("markPx", &PositionView::mark_px),
+        field("margin", &PositionView::margin),
+        field("mgnRatio", &PositionView::mgn_ratio),
+        field("notionalUsd", &PositionView::notional_usd),
+        field("ccy", &PositionView::ccy),
+        field("cTime", &PositionView::c_time),
+        field("uTime", &PositionView::u_time),
+        field("pTime", &PositionView::p_time));
+};
+
+template <>
+struct ChannelSchema<AccountView> {
+    static constexpr std::string_view channel = "account";
+    static constexpr auto fields = std::make_tuple(
+        field("totalEq", &AccountView::total_eq),
+        field("isoEq", &AccountView::iso_eq),
+        field("adjEq", &AccountView::adj_eq),
+        field("imr", &AccountView::imr),
+        field("mmr", &AccountView::mmr),
+        field("mgnRatio", &AccountView::mgn_ratio),
+        field("notionalUsd", &AccountView::notional_usd),
+        field("details", &AccountView::details),
+        field("uTime", &AccountView::u_time));
+};
+
+// details 数组元素没有独立频道，channel 留空
+template <>
+struct ChannelSchema<AccountDetailView> {
+    static constexpr std::string_view channel = "";
+    static constexpr auto fields = std::make_tuple(
+        field("ccy", &AccountDetailView::ccy),
+        field("eq", &AccountDetailView::eq),
+        field("cashBal", &AccountDetailView::cash_bal),
+        field("availBal", &AccountDetailView::avail_bal),
+        field("frozenBal", &AccountDetailView::frozen_bal),
+        field("availEq", &AccountDetailView::avail_eq),
+        field("upl", &AccountDetailView::upl),
+        field("eqUsd", &AccountDetailView::eq_usd),
+        field("uTime", &AccountDetailView::u_time));
+};
+
+// 逐个币种解析 account.details，不分配内存: fn(const AccountDetailView&)
+template <typename Fn>
+inline size_t for_each_account_detail(const AccountView& account, Fn&& fn) {
+    size_t count = 0;
+    AccountDetailView detail;
+    JsonScanner::for_each_element(account.details, [&](std::string_view element) {
+        if (element.empty() || element.front() != '{') return true;
+        SchemaCodec<AccountDetailView>::parse_object(element, detail);
+        fn(static_cast<const AccountDetailView&>(detail));
+        ++count;
+        return true;
+    });
+    return count;
+}
@@ -1,8 +1,16 @@
 #include "okx_websocket_client.h"
-#include <iostream>
+#include "async_logger.h"
+#include "ticker_fields.h"
+#include "trace_probes.h"
+#include <algorithm>
+#include <charconv>
 #include <cstring>
 #include <chrono>
+#include <ctime>
 #include <openssl/ssl.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 static const struct lws_protocols protocols[] = {
     {
@@ -25,19 +33,81 @@ static const struct lws_protocols protocols[] = {
     }
 };
 
+// 热备连接的 wsi 以此为 opaque user data，提升为主连接时清除
+static char standby_tag;
+
+static int lws_log_mask() {
+    int mask = 0;
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_ERROR
+    mask |= LLL_ERR;
+#endif
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_WARN
+    mask |= LLL_WARN;
+#endif
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_INFO
+    mask |= LLL_USER | LLL_NOTICE;
+#endif
+#if OKX_LOG_LEVEL <= OKX_LOG_LEVEL_DEBUG
+    mask |= LLL_INFO | LLL_DEBUG;
+#endif
+    return mask;
+}
+
+static void lws_log_emit(int level, const char* line) {
+    std::string_view text(line);
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+
+    if (level & LLL_ERR) {
+        OKX_LOG_ERROR("lws: {}", text);
+    } else if (level & LLL_WARN) {
+        OKX_LOG_WARN("lws: {}", text);
+    } else if (level & (LLL_USER | LLL_NOTICE)) {
+        OKX_LOG_INFO("lws: {}", text);
+    } else {
+        OKX_LOG_DEBUG("lws: {}", text);
+    }
+}
+
 OKXWebSocketClient::OKXWebSocketClient()
-    : context_(nullptr), wsi_(nullptr), connected_(false), should_run_(false),
-      auto_reconnect_(true), ping_interval_(30), reconnect_attempts_(0),
-      proxy_port_(0), use_http_proxy_(false), use_socks_proxy_(false) {
+    : context_(nullptr), wsi_(nullptr), ticker_fields_(kAllFields), connected_(false), should_run_(false), instrument_stage_added_(false),
+      use_ssl_(true), transport_(Transport::Libwebsockets), uring_wake_fd_(-1), auto_reconnect_(true), ping_interval_(30), reconnect_attempts_(0), reconnect_pending_(false),
+      proxy_port_(0), use_http_proxy_(false), use_socks_proxy_(false),
+      staleness_enabled_(false), staleness_stage_added_(false), stale_action_(StaleAction::Notify), stale_pending_count_(0), checkpoint_sync_ms_(1000),
+      login_state_(LoginState::None),
+      executor_(nullptr), pending_ack_count_(0),
+      compression_enabled_(false), compression_window_bits_(15), compression_negotiated_(false),
+      compressed_bytes_(0), inflated_bytes_(0), inflate_ns_(0), inflate_calls_(0),
+      latency_enabled_(false), rx_length_(0), rx_overflow_(false), rx_timestamping_(false),
+      standby_enabled_(false), standby_wsi_(nullptr), standby_established_(false), standby_ready_(false),
+      standby_logged_in_(false), standby_pending_(0), standby_queued_(false), standby_failures_(0) {
 
     ticker_handler_ = std::make_unique<TickerHandler>([](const TickerData& ticker) {
-        std::cout << "[TICKER] " << ticker.inst_id
-                  << " Last: " << ticker.last
-                  << " Bid: " << ticker.bid_px
-                  << " Ask: " << ticker.ask_px
-                  << " Volume24h: " << ticker.vol24h << std::endl;
+        OKX_LOG_DEBUG("[TICKER] {} Last: {} Bid: {} Ask: {} Volume24h: {}",
+                     ticker.inst_id, ticker.last, ticker.bid_px, ticker.ask_px, ticker.vol24h);
     });
 
+    register_metrics();
+
+    order_entry_.set_sender([this](std::string_view frame) {
+        if (!connected_) return false;
+        send_message(frame);
+        return true;
+    });
+
+    staleness_monitor_.set_callback([this](const StaleEvent& event) {
+        if (stale_pending_count_ == stale_pending_.size()) {
+            stale_pending_.emplace_back();
+        }
+        PendingStale& pending = stale_pending_[stale_pending_count_++];
+        pending.inst_id.assign(event.inst_id);
+        pending.inst_type.assign(event.inst_type);
+        pending.age_ms = event.age_ms;
+        pending.consecutive = event.consecutive;
+    });
+
+    memset(extensions_, 0, sizeof(extensions_));
     memset(&info_, 0, sizeof(info_));
     info_.port = CONTEXT_PORT_NO_LISTEN;
     info_.protocols = protocols;
@@ -50,21 +120,73 @@ OKXWebSocketClient::OKXWebSocketClient()
     info_.ssl_cipher_list = "ECDHE+AESGCM:ECDHE+CHACHA20:DHE+AESGCM:DHE+CHACHA20:!aNULL:!MD5:!DSS";
     info_.ssl_ca_filepath = nullptr; // 不验证CA
 
-    lws_set_log_level(LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_INFO | LLL_DEBUG, nullptr);
+    // 标定放在连接之前，热路径只读计数器
+    TscClock::initialize();
+
+    // libwebsockets 日志按编译期级别过滤后经异步日志输出
+    lws_set_log_level(lws_log_mask(), lws_log_emit);
 }
 
 OKXWebSocketClient::~OKXWebSocketClient() {
+    stop_metrics_server();
     disconnect();
+    for (auto& [inst_id, stream] : tick_streams_) {
+        stream->close();
+    }
+    if (uring_wake_fd_ >= 0) {
+        ::close(uring_wake_fd_);
+    }
 }
 
-bool OKXWebSocketClient::connect(const std::string& host, int port, const std::string& path, bool use_ssl) {
+bool OKXWebSocketClient::connect(const std::string& host, int port, const std::string& path, bool use_ssl,
+                                 Transport transport) {
     host_ = host;
     port_ = port;
     path_ = path;
+    use_ssl_ = use_ssl;
+    transport_ = transport;
+    if (transport_ == Transport::IoUring) {
+        std::string error;
+        if (!UringTransport::available(error)) {
+            OKX_LOG_WARN("io_uring transport unavailable ({}), falling back to libwebsockets", error);
+            transport_ = Transport::Libwebsockets;
+        }
+    }
+
+    info_.extensions = compression_enabled_ ? extensions_ : nullptr;
+    compression_negotiated_ = false;
+
+    // context 和连接的缓冲区在这里分配，按服务线程的节点放置
+    ScopedMemoryBinding memory_binding(thread_config_.numa_node);
+    if (latency_enabled_) {
+        warm_up();
+    }
+    if (rx_timestamping_ && rx_timestamping_config_.hardware && !rx_timestamping_config_.interface.empty()) {
+        std::string error;
+        if (!RxTimestamper::enable_hardware(rx_timestamping_config_.interface, error)) {
+            OKX_LOG_WARN("Hardware rx timestamping unavailable: {}", error);
+        }
+    }
+
+    if (transport_ == Transport::IoUring) {
+        if (standby_enabled_ || compression_enabled_ || rx_timestamping_ || use_http_proxy_ || use_socks_proxy_) {
+            OKX_LOG_WARN("io_uring transport ignores standby, compression, rx timestamping and proxy settings");
+        }
+        if (uring_wake_fd_ < 0) {
+            uring_wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        }
+        if (!open_uring()) {
+            return false;
+        }
+        handle_connection_established();
+        should_run_ = true;
+        worker_thread_ = std::thread(&OKXWebSocketClient::worker_loop, this);
+        return true;
+    }
 
     context_ = lws_create_context(&info_);
     if (!context_) {
-        std::cerr << "Failed to create libwebsockets context" << std::endl;
+        OKX_LOG_ERROR("Failed to create libwebsockets context");
         return false;
     }
 
@@ -79,8 +201,6 @@ bool OKXWebSocketClient::connect(const std::string& host, int port, const std::s
 
     // 代理配置 - 使用环境变量（libwebsockets会自动检测）
     if (use_http_proxy_) {
-        std::cout << "设置HTTP代理环境变量: " << proxy_host_ << ":" << proxy_port_ << std::endl;
-
         std::string proxy_url = "http://";
         if (!proxy_username_.empty()) {
             proxy_url += proxy_username_ + ":" + proxy_password_ + "@";
@@ -92,11 +212,11 @@ bool OKXWebSocketClient::connect(const std::string& host, int port, const std::s
         setenv("HTTP_PROXY", proxy_url.c_str(), 1);
         setenv("HTTPS_PROXY", proxy_url.c_str(), 1);
 
-        std::cout << "代理URL: " << proxy_url << std::endl;
+        // 代理URL可能带密码，日志里只记主机和端口
+        OKX_LOG_INFO("Using HTTP proxy {}:{} via environment", proxy_host_, proxy_port_);
     } else if (use_socks_proxy_) {
-        std::cout << "建议使用proxychains进行SOCKS代理:" << std::endl;
-        std::cout << "  proxychains4 ./okx_client" << std::endl;
-        std::cout << "  参考: PROXYCHAINS_GUIDE.md" << std::endl;
+        OKX_LOG_WARN("SOCKS proxy {}:{} is not applied by libwebsockets, run under proxychains4 (see PROXYCHAINS_GUIDE.md)",
+                     proxy_host_, proxy_port_);
     }
     if (use_ssl) {
         ccinfo_.ssl_connection = LCCSCF_USE_SSL |
@@ -105,16 +225,16 @@ bool OKXWebSocketClient::connect(const std::string& host, int port, const std::s
                                 LCCSCF_ALLOW_EXPIRED |
                                 LCCSCF_ALLOW_INSECURE;
 
-        std::cout << "SSL配置: 允许自签名证书、跳过主机名验证、允许过期证书" << std::endl;
+        OKX_LOG_DEBUG("SSL: self-signed and expired certificates allowed, hostname check skipped");
     } else {
         ccinfo_.ssl_connection = 0;
-        std::cout << "使用非SSL连接" << std::endl;
+        OKX_LOG_DEBUG("Using non-SSL connection");
     }
     ccinfo_.userdata = this;
 
     wsi_ = lws_client_connect_via_info(&ccinfo_);
     if (!wsi_) {
-        std::cerr << "Failed to connect to WebSocket" << std::endl;
+        OKX_LOG_ERROR("Failed to connect to WebSocket");
         lws_context_destroy(context_);
         context_ = nullptr;
         return false;
@@ -143,27 +263,242 @@ void OKXWebSocketClient::disconnect() {
         lws_context_destroy(context_);
         context_ = nullptr;
     }
+    // 保留对象，断开后仍可读取统计
+    if (uring_) {
+        uring_->close();
+    }
+    standby_wsi_ = nullptr;
+    standby_ready_ = false;
 
     connected_ = false;
+    // 主动断开不会再有连接事件，唤醒所有等待者
+    wake_connection_waiters(true);
+    wake_connection_waiters(false);
+    fail_pending_acks("disconnected", "Client disconnected");
 }
 
 bool OKXWebSocketClient::subscribe_ticker(const std::string& inst_id) {
+    if (!subscribe_channel("tickers", inst_id)) {
+        return false;
+    }
+
+    if (staleness_enabled_) {
+        std::lock_guard<std::mutex> lock(staleness_mutex_);
+        staleness_monitor_.watch(inst_id, StalenessMonitor::now_ms());
+    }
+    return true;
+}
+
+bool OKXWebSocketClient::subscribe_channel(const std::string& channel, const std::string& inst_id) {
     if (!connected_) {
-        std::cerr << "Not connected to WebSocket" << std::endl;
+        OKX_LOG_ERROR("Cannot subscribe to {}: not connected", channel);
         return false;
     }
 
-    std::string subscription = JsonParser::create_subscription_message("tickers", inst_id);
+    std::string subscription = JsonParser::create_subscription_message(channel, inst_id);
     send_message(subscription);
+    remember_subscription(channel, inst_id);
+    return true;
+}
+
+TickStream& OKXWebSocketClient::ticks(const std::string& inst_id, size_t capacity) {
+    auto it = tick_streams_.find(inst_id);
+    if (it == tick_streams_.end()) {
+        // 服务线程在阶段里查这张表，运行中插入可能触发 rehash；已有的流运行中仍可取
+        if (should_run_) {
+            OKX_LOG_ERROR("Tick stream for {} must be created before connect() or after disconnect()", inst_id);
+            throw std::logic_error("ticks() for a new instrument called while the client is running");
+        }
+        // 第一次请求时才加阶段，未使用协程流时不要求解析全部字段
+        if (tick_streams_.empty()) {
+            ticker_handler_->add_stage([this](const TickerView& ticker) {
+                auto stream = tick_streams_.find(ticker.inst_id);
+                if (stream != tick_streams_.end()) {
+                    stream->second->push_with([&](TickerData& slot) { slot.assign(ticker); });
+                }
+            }, ticker_fields_, "tick_streams");
+        }
+        it = tick_streams_.emplace(inst_id, std::make_unique<TickStream>(executor_, capacity)).first;
+    }
+    return *it->second;
+}
+
+bool OKXWebSocketClient::add_connection_waiter(std::coroutine_handle<> handle, bool want_connected) {
+    std::lock_guard<std::mutex> lock(coro_mutex_);
+    // 加锁后再检查一次，避免与连接事件之间丢失唤醒
+    if (connected_ == want_connected) {
+        return false;
+    }
+    (want_connected ? connect_waiters_ : disconnect_waiters_).push_back(handle);
+    return true;
+}
+
+bool OKXWebSocketClient::begin_subscribe(SubscribeAwaiter& awaiter, std::coroutine_handle<> handle) {
+    if (!connected_) {
+        awaiter.result_.code = "disconnected";
+        awaiter.result_.msg = "Not connected to WebSocket";
+        return false;
+    }
+
+    if (awaiter.channel_ == "tickers" && staleness_enabled_) {
+        std::lock_guard<std::mutex> lock(staleness_mutex_);
+        staleness_monitor_.watch(awaiter.inst_id_, StalenessMonitor::now_ms());
+    }
+
+    uint64_t id = JsonParser::next_request_id();
+    std::string message = JsonParser::create_subscription_message(awaiter.channel_, awaiter.inst_id_, id);
+    {
+        std::lock_guard<std::mutex> lock(coro_mutex_);
+        pending_acks_.push_back({id, &awaiter, handle});
+        pending_ack_count_.store(pending_acks_.size(), std::memory_order_relaxed);
+    }
+    remember_subscription(awaiter.channel_, awaiter.inst_id_);
+    // 登记后回执可能在服务线程上立即恢复协程，此后不再访问 awaiter
+    send_message(message);
     return true;
 }
 
+bool OKXWebSocketClient::handle_subscribe_ack(std::string_view data) {
+    std::string_view event;
+    std::string_view id;
+    std::string_view code;
+    std::string_view msg;
+    std::string_view channel;
+    std::string_view inst_id;
+    JsonScanner::for_each_member(data, [&](std::string_view key, std::string_view value, bool) {
+        if (key == "event") event = value;
+        else if (key == "id") id = value;
+        else if (key == "code") code = value;
+        else if (key == "msg") msg = value;
+        else if (key == "arg") {
+            JsonScanner::for_each_member(value, [&](std::string_view arg_key, std::string_view arg_value, bool) {
+                if (arg_key == "channel") channel = arg_value;
+                else if (arg_key == "instId") inst_id = arg_value;
+                return true;
+            });
+        }
+        return true;
+    });
+    if (event != "subscribe" && event != "error") {
+        return false;
+    }
+
+    PendingAck ack{};
+    {
+        std::lock_guard<std::mutex> lock(coro_mutex_);
+        auto match = pending_acks_.end();
+        // 优先按请求 id 匹配；不带 id 的回执按频道匹配，error 归给最早的请求
+        for (auto it = pending_acks_.begin(); it != pending_acks_.end() && match == pending_acks_.end(); ++it) {
+            if (!id.empty()) {
+                uint64_t value = 0;
+                std::from_chars(id.data(), id.data() + id.size(), value);
+                if (value == it->id) match = it;
+            } else if (event == "subscribe") {
+                if (it->awaiter->channel_ == channel && it->awaiter->inst_id_ == inst_id) match = it;
+            } else {
+                match = it;
+            }
+        }
+        if (match == pending_acks_.end()) {
+            return false;
+        }
+        ack = *match;
+        pending_acks_.erase(match);
+        pending_ack_count_.store(pending_acks_.size(), std::memory_order_relaxed);
+    }
+
+    SubscribeAck& result = ack.awaiter->result_;
+    result.ok = event == "subscribe";
+    result.code = result.ok ? "0" : std::string(code);
+    result.msg = std::string(msg);
+    resume(ack.handle);
+    return true;
+}
+
+void OKXWebSocketClient::wake_connection_waiters(bool connected) {
+    std::vector<std::coroutine_handle<>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(coro_mutex_);
+        waiters.swap(connected ? connect_waiters_ : disconnect_waiters_);
+    }
+    for (auto handle : waiters) {
+        resume(handle);
+    }
+}
+
+void OKXWebSocketClient::fail_pending_acks(const char* code, const char* msg) {
+    std::vector<PendingAck> acks;
+    {
+        std::lock_guard<std::mutex> lock(coro_mutex_);
+        acks.swap(pending_acks_);
+        pending_ack_count_.store(0, std::memory_order_relaxed);
+    }
+    for (auto& ack : acks) {
+        ack.awaiter->result_.ok = false;
+        ack.awaiter->result_.code = code;
+        ack.awaiter->result_.msg = msg;
+        resume(ack.handle);
+    }
+}
+
+void OKXWebSocketClient::resume(std::coroutine_handle<> handle) {
+    if (executor_) executor_->post(handle);
+    else handle.resume();
+}
+
+bool OKXWebSocketClient::set_credentials(const std::string& api_key, const std::string& secret_key, const std::string& passphrase) {
+    if (api_key.empty() || secret_key.empty() || passphrase.empty()) {
+        OKX_LOG_ERROR("API key, secret key and passphrase are all required");
+        return false;
+    }
+    if (!signer_.set_key(secret_key)) {
+        return false;
+    }
+    api_key_ = api_key;
+    passphrase_ = passphrase;
+    return true;
+}
+
+bool OKXWebSocketClient::subscribe_private(const std::string& channel, const std::string& inst_type) {
+    if (api_key_.empty()) {
+        OKX_LOG_ERROR("Cannot subscribe to {}: credentials not set, call set_credentials() first", channel);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(private_mutex_);
+    private_subscriptions_.emplace_back(channel, inst_type);
+    // 未登录时先记下，登录成功后统一发送
+    if (is_logged_in()) {
+        send_message(JsonParser::create_private_subscription_message(channel, inst_type));
+    }
+    if (standby_logged_in_) {
+        standby_pending_++;
+        send_standby(JsonParser::create_private_subscription_message(channel, inst_type));
+    }
+    return true;
+}
+
+void OKXWebSocketClient::set_login_callback(LoginCallback callback) {
+    login_callback_ = std::move(callback);
+}
+
 void OKXWebSocketClient::set_ticker_callback(TickerHandler::TickerCallback callback) {
     if (ticker_handler_) {
         ticker_handler_->set_callback(std::move(callback));
     }
 }
 
+void OKXWebSocketClient::set_batch_callback(TickerHandler::BatchCallback on_batch,
+                                            TickerHandler::BatchEndCallback on_batch_end,
+                                            TickerHandler::BatchScope scope) {
+    ticker_handler_->set_batch_callback(std::move(on_batch), std::move(on_batch_end), scope);
+}
+
+void OKXWebSocketClient::set_ticker_fields(FieldMask fields) {
+    ticker_fields_ = fields;
+    ticker_handler_->set_field_mask(fields);
+}
+
 void OKXWebSocketClient::run() {
     if (worker_thread_.joinable()) {
         worker_thread_.join();
@@ -177,27 +512,47 @@ bool OKXWebSocketClient::is_connected() const {
 int OKXWebSocketClient::callback_function(struct lws* wsi, enum lws_callback_reasons reason, void* /* user */, void* in, size_t len) {
     auto* client = static_cast<OKXWebSocketClient*>(lws_context_user(lws_get_context(wsi)));
     if (!client) return 0;
+    if (lws_get_opaque_user_data(wsi) == &standby_tag) {
+        return client->handle_standby_event(wsi, reason, in, len);
+    }
 
     switch (reason) {
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
-            std::cerr << "WebSocket connection error: " << (in ? (char*)in : "unknown") << std::endl;
+            OKX_LOG_ERROR("WebSocket connection error: {}", in ? static_cast<const char*>(in) : "unknown");
             client->connected_ = false;
+            // co_await connected() 返回 false，由调用方决定是否重试
+            client->wake_connection_waiters(true);
+            // 重连途中的失败继续按退避重试；首次连接失败仍交给调用方
+            if (client->reconnect_attempts_ > 0) {
+                if (wsi == client->wsi_) client->wsi_ = nullptr;
+                if (client->auto_reconnect_ && client->should_reconnect()) {
+                    client->attempt_reconnect();
+                }
+            }
             break;
 
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
-            std::cout << "WebSocket connection established" << std::endl;
+            OKX_LOG_INFO("WebSocket connection established");
+            if (client->compression_enabled_) {
+                char extensions[128] = {0};
+                if (lws_hdr_copy(wsi, extensions, sizeof(extensions), WSI_TOKEN_EXTENSIONS) > 0 &&
+                    strstr(extensions, "permessage-deflate")) {
+                    client->compression_negotiated_ = true;
+                    OKX_LOG_INFO("Negotiated extensions: {}", static_cast<const char*>(extensions));
+                } else {
+                    OKX_LOG_WARN("Server did not accept permessage-deflate");
+                }
+            }
+            client->attach_rx_stamper(wsi, client->rx_stamper_);
             client->handle_connection_established();
             break;
 
         case LWS_CALLBACK_CLIENT_RECEIVE:
-            if (len > 0) {
-                std::string data(static_cast<char*>(in), len);
-                client->handle_receive(data);
-            }
+            client->handle_fragment(wsi, static_cast<const char*>(in), len);
             break;
 
         case LWS_CALLBACK_CLIENT_CLOSED:
-            std::cout << "WebSocket connection closed" << std::endl;
+            OKX_LOG_INFO("WebSocket connection closed");
             client->handle_connection_closed();
             break;
 
@@ -210,7 +565,10 @@ int OKXWebSocketClient::callback_function(struct lws* wsi, enum lws_callback_rea
             break;
 
         case LWS_CALLBACK_WSI_DESTROY:
-            client->connected_ = false;
+            // 热备提升后，旧主连接的销毁不影响连接状态
+            if (wsi == client->wsi_) {
+                client->connected_ = false;
+            }
             break;
 
         default:
@@ -220,45 +578,212 @@ int OKXWebSocketClient::callback_function(struct lws* wsi, enum lws_callback_rea
     return 0;
 }
 
-void OKXWebSocketClient::send_message(const std::string& message) {
+void OKXWebSocketClient::send_message(std::string_view message) {
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        send_queue_.push(message);
+        std::string frame;
+        if (!spare_frames_.empty()) {
+            frame = std::move(spare_frames_.back());
+            spare_frames_.pop_back();
+        }
+        frame.assign(message.data(), message.size());
+        send_queue_.push(std::move(frame));
+        send_queue_depth_->set(static_cast<int64_t>(send_queue_.size()));
+        OKX_PROBE2(send_enqueue, message.size(), send_queue_.size());
     }
     queue_cv_.notify_one();
     if (wsi_) {
         lws_callback_on_writable(wsi_);
+    } else if (uring_wake_fd_ >= 0 && transport_ == Transport::IoUring) {
+        uint64_t one = 1;
+        ssize_t written = ::write(uring_wake_fd_, &one, sizeof(one));
+        (void)written;
     }
 }
 
 void OKXWebSocketClient::handle_connection_established() {
+    bool reconnected = reconnect_attempts_ > 0;
     connected_ = true;
     reconnect_attempts_ = 0;
+    connected_gauge_->set(1);
     last_ping_ = std::chrono::steady_clock::now();
     last_pong_ = std::chrono::steady_clock::now();
-    std::cout << "Connection established successfully" << std::endl;
+    OKX_PROBE0(connected);
+    OKX_LOG_INFO("Connection established successfully");
+    wake_connection_waiters(true);
+
+    // 重连后重放公共订阅；私有订阅在登录成功后由 send_private_subscriptions 重放
+    if (reconnected) {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        for (const auto& [channel, inst_id] : subscriptions_) {
+            send_message(JsonParser::create_subscription_message(channel, inst_id));
+        }
+    }
+    // 断线期间入队的帧
+    if (wsi_ && transport_ == Transport::Libwebsockets) {
+        lws_callback_on_writable(wsi_);
+    }
+
+    if (signer_.has_key()) {
+        send_login();
+    }
 }
 
 void OKXWebSocketClient::handle_connection_closed() {
+    if (promote_standby()) {
+        return;
+    }
+
     connected_ = false;
-    std::cout << "Connection closed" << std::endl;
+    connected_gauge_->set(0);
+    login_state_ = LoginState::None;
+    rx_length_ = 0;
+    rx_overflow_ = false;
+    order_entry_.fail_all("disconnected", "Connection closed before response");
+    fail_pending_acks("disconnected", "Connection closed before response");
+    wake_connection_waiters(false);
+    OKX_PROBE0(disconnected);
+    OKX_LOG_INFO("Connection closed");
+    // 关闭中的 wsi 不能再请求可写；重连成功后换成新的 wsi
+    if (transport_ == Transport::Libwebsockets) {
+        wsi_ = nullptr;
+    }
 
     if (auto_reconnect_ && should_reconnect()) {
-        std::cout << "Attempting to reconnect..." << std::endl;
+        OKX_LOG_INFO("Attempting to reconnect...");
         attempt_reconnect();
     }
 }
 
-void OKXWebSocketClient::handle_receive(const std::string& data) {
+void OKXWebSocketClient::handle_fragment(struct lws* wsi, const char* data, size_t len) {
+    bool complete = lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0;
+    OKX_PROBE3(frame_received, data, len, complete);
+    // 整条消息一次送达时直接处理 lws 的缓冲区，不拷贝
+    if (complete && rx_length_ == 0) {
+        if (len > 0) {
+            stamp_receive();
+            handle_receive(std::string_view(data, len));
+        }
+        return;
+    }
+
+    if (rx_length_ == 0) {
+        stamp_receive();
+    }
+    if (!rx_region_.data()) {
+        std::string error;
+        rx_region_.map(latency_config_.rx_buffer_bytes, HugePageMode::None, false, error);
+    }
+    if (rx_length_ + len > rx_region_.size()) {
+        rx_overflow_ = true;
+    } else if (!rx_overflow_) {
+        memcpy(rx_region_.data() + rx_length_, data, len);
+    }
+    rx_length_ += len;
+    if (!complete) {
+        return;
+    }
+
+    if (rx_overflow_) {
+        rx_oversize_->add();
+        OKX_LOG_ERROR("Dropped {} byte message larger than rx buffer ({} bytes)", rx_length_, rx_region_.size());
+    } else {
+        handle_receive(std::string_view(rx_region_.data(), rx_length_));
+    }
+    rx_length_ = 0;
+    rx_overflow_ = false;
+}
+
+void OKXWebSocketClient::stamp_receive() {
+    rx_timestamps_.receive = TscClock::now();
+    if (rx_stamper_) {
+        // 最近一次 recvmsg 的时间；TLS 记录被 OpenSSL 预读时可能早于本条消息所在的报文段
+        rx_timestamps_.kernel_ns = rx_stamper_->software_ns();
+        rx_timestamps_.hardware_ns = rx_stamper_->hardware_ns();
+    }
+}
+
+void OKXWebSocketClient::handle_receive(std::string_view data) {
+    rx_timestamps_.dispatch = TscClock::now();
+    OKX_PROBE2(message, data.data(), data.size());
+    messages_received_->add();
+    bytes_received_->add(data.size());
+
+    // 登录回执只在等待期间检查，登录后不增加热路径开销
+    if (login_state_.load(std::memory_order_relaxed) == LoginState::Pending && handle_login_response(data)) {
+        return;
+    }
+    if (order_entry_.in_flight() > 0 && order_entry_.handle_response(data)) {
+        return;
+    }
+    if (pending_ack_count_.load(std::memory_order_relaxed) > 0 && handle_subscribe_ack(data)) {
+        return;
+    }
+
+    if (!channel_handlers_.empty() && dispatch_channel(data)) {
+        return;
+    }
+
     if (ticker_handler_) {
-        ticker_handler_->handle_message(data);
+        TickerHandler::Result result = ticker_handler_->handle_message(data);
+        if (result == TickerHandler::Result::ParseError) {
+            parse_failures_->add();
+        } else if (result == TickerHandler::Result::Ignored) {
+            unhandled_messages_->add();
+        }
     }
+    // 一条消息中收线的K线一次交付
+    if (bar_aggregator_) {
+        bar_aggregator_->flush();
+    }
+}
+
+bool OKXWebSocketClient::dispatch_channel(std::string_view message) {
+    // 只扫描一遍顶层: 取 arg.channel 查表，未注册的频道（如 tickers）在 arg 处就停下交给后面的路径
+    std::function<void(std::string_view)>* handler = nullptr;
+    std::string_view payload;
+    bool unknown = false;
+    JsonScanner::for_each_member(message, [&](std::string_view key, std::string_view value, bool is_string) {
+        if (key == "arg" && !is_string) {
+            JsonScanner::for_each_member(value, [&](std::string_view arg_key, std::string_view arg_value, bool) {
+                if (arg_key != "channel") return true;
+                auto it = channel_handlers_.find(arg_value);
+                if (it != channel_handlers_.end()) handler = &it->second;
+                return false;
+            });
+            unknown = !handler;
+        } else if (key == "data" && !is_string) {
+            payload = value;
+        }
+        return !unknown && !(handler && !payload.empty());
+    });
+
+    // 订阅回执等没有 data 的消息继续往后走
+    if (!handler || payload.empty()) {
+        return false;
+    }
+    (*handler)(payload);
+    return true;
 }
 
 void OKXWebSocketClient::worker_loop() {
+    if (!thread_config_.empty() && !ThreadPlacement::apply(thread_config_)) {
+        OKX_LOG_WARN("Service thread placement partially applied");
+    }
+    if (latency_enabled_ && latency_config_.prefault) {
+        LatencyMode::prefault_stack(latency_config_.stack_bytes);
+    }
+    if (transport_ == Transport::IoUring) {
+        uring_loop();
+        return;
+    }
+    // lws v4 中非负超时会阻塞到下一个事件，负数表示只轮询一次不等待
+    int service_timeout = thread_config_.busy_poll ? -1 : 50;
+
     while (should_run_) {
         if (context_) {
-            lws_service(context_, 50);
+            lws_service(context_, service_timeout);
+            ticker_handler_->flush_batch();
 
             auto now = std::chrono::steady_clock::now();
             if (connected_ && std::chrono::duration_cast<std::chrono::seconds>(now - last_ping_).count() >= ping_interval_) {
@@ -266,36 +791,173 @@ void OKXWebSocketClient::worker_loop() {
             }
 
             if (connected_ && std::chrono::duration_cast<std::chrono::seconds>(now - last_pong_).count() > ping_interval_ * 2) {
-                std::cerr << "Ping timeout, connection may be dead" << std::endl;
+                OKX_LOG_WARN("Ping timeout, connection may be dead");
                 lws_close_reason(wsi_, LWS_CLOSE_STATUS_ABNORMAL_CLOSE, nullptr, 0);
+                // 关闭原因只在下次写时发出，静默断开的连接需要直接关掉，才能触发热备提升或重连
+                lws_set_timeout(wsi_, PENDING_TIMEOUT_USER_OK, LWS_TO_KILL_ASYNC);
+                last_pong_ = now;
+            }
+
+            if (reconnect_pending_ && now >= reconnect_at_) {
+                reopen_connection();
             }
+
+            if (standby_enabled_) {
+                service_standby(now);
+            }
+
+            poll_monitors();
         } else {
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
         }
     }
 }
 
+void OKXWebSocketClient::poll_monitors() {
+    if (connected_ && staleness_enabled_) {
+        StaleAction action = StaleAction::Notify;
+        StalenessMonitor::StaleCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(staleness_mutex_);
+            staleness_monitor_.poll(StalenessMonitor::now_ms());
+            if (stale_pending_count_ > 0) {
+                action = stale_action_;
+                callback = stale_callback_;
+            }
+        }
+        for (size_t i = 0; i < stale_pending_count_; ++i) {
+            const PendingStale& pending = stale_pending_[i];
+            handle_stale(StaleEvent{pending.inst_id, pending.inst_type, pending.age_ms, pending.consecutive}, action, callback);
+        }
+        stale_pending_count_ = 0;
+    }
+
+    if (bar_aggregator_) {
+        bar_aggregator_->poll(BarAggregator::now_ms());
+        bar_aggregator_->flush();
+    }
+
+    if (checkpoint_) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - checkpoint_synced_ >= std::chrono::milliseconds(checkpoint_sync_ms_)) {
+            checkpoint_->sync();
+            checkpoint_synced_ = now;
+        }
+    }
+
+    TscClock::maybe_recalibrate();
+}
+
+bool OKXWebSocketClient::open_uring() {
+    uring_ = std::make_unique<UringTransport>(uring_config_);
+    uring_->set_message_handler([this](std::string_view payload) {
+        OKX_PROBE3(frame_received, payload.data(), payload.size(), true);
+        stamp_receive();
+        handle_receive(payload);
+    });
+    uring_->set_pong_handler([this] {
+        last_pong_ = std::chrono::steady_clock::now();
+    });
+    uring_->set_wake_fd(uring_wake_fd_);
+
+    std::string error;
+    if (!uring_->connect(host_, port_, path_, use_ssl_, error)) {
+        OKX_LOG_ERROR("io_uring connect to {}:{} failed: {}", host_, port_, error);
+        return false;
+    }
+    UringStats stats = uring_->stats();
+    OKX_LOG_INFO("io_uring transport connected (kTLS rx: {}, tx: {}, buffer ring: {})",
+                 stats.ktls_rx, stats.ktls_tx, stats.buffer_ring);
+    return true;
+}
+
+void OKXWebSocketClient::uring_loop() {
+    // 忙轮询时只读完成队列，不进内核；否则最多阻塞 50ms，发送由 eventfd 唤醒
+    int poll_timeout = thread_config_.busy_poll ? 0 : 50;
+
+    while (should_run_) {
+        if (!connected_) {
+            if (auto_reconnect_ && should_reconnect()) {
+                attempt_reconnect();
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            continue;
+        }
+
+        bool open = uring_->poll(poll_timeout);
+        ticker_handler_->flush_batch();
+        if (!open) {
+            OKX_LOG_WARN("io_uring connection lost: {}", uring_->error());
+            handle_connection_closed();
+            continue;
+        }
+        process_send_queue();
+
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration_cast<std::chrono::seconds>(now - last_ping_).count() >= ping_interval_) {
+            send_ping();
+        }
+        if (std::chrono::duration_cast<std::chrono::seconds>(now - last_pong_).count() > ping_interval_ * 2) {
+            OKX_LOG_WARN("Ping timeout, connection may be dead");
+            uring_->close();
+            handle_connection_closed();
+            continue;
+        }
+
+        poll_monitors();
+    }
+}
+
+UringStats OKXWebSocketClient::uring_stats() const {
+    return uring_ ? uring_->stats() : UringStats{};
+}
+
 void OKXWebSocketClient::process_send_queue() {
     std::lock_guard<std::mutex> lock(queue_mutex_);
 
     while (!send_queue_.empty() && connected_) {
-        const std::string& message = send_queue_.front();
+        std::string& message = send_queue_.front();
+
+        if (uring_ && transport_ == Transport::IoUring) {
+            bool sent = uring_->send_text(message);
+            OKX_PROBE2(write, message.size(), sent ? static_cast<int>(message.size()) : -1);
+            if (!sent) {
+                OKX_LOG_ERROR("Failed to send message: {}", uring_->error());
+                send_failures_->add();
+                break;
+            }
+            if (spare_frames_.size() < kMaxSpareFrames) {
+                spare_frames_.push_back(std::move(message));
+            }
+            send_queue_.pop();
+            messages_sent_->add();
+            send_queue_depth_->set(static_cast<int64_t>(send_queue_.size()));
+            continue;
+        }
 
         size_t message_len = message.length();
-        unsigned char* buf = new unsigned char[LWS_PRE + message_len];
-        memcpy(&buf[LWS_PRE], message.c_str(), message_len);
-
-        int n = lws_write(wsi_, &buf[LWS_PRE], message_len, LWS_WRITE_TEXT);
+        if (write_buffer_.size() < LWS_PRE + message_len) {
+            write_buffer_.resize(LWS_PRE + message_len);
+        }
+        memcpy(&write_buffer_[LWS_PRE], message.data(), message_len);
 
-        delete[] buf;
+        int n = lws_write(wsi_, &write_buffer_[LWS_PRE], message_len, LWS_WRITE_TEXT);
+        OKX_PROBE2(write, message_len, n);
 
         if (n < 0) {
-            std::cerr << "Failed to send message" << std::endl;
+            OKX_LOG_ERROR("Failed to send message");
+            send_failures_->add();
             break;
         }
 
+        OKX_LOG_DEBUG("Sent: {}", message);
+        if (spare_frames_.size() < kMaxSpareFrames) {
+            spare_frames_.push_back(std::move(message));
+        }
         send_queue_.pop();
-        std::cout << "Sent: " << message << std::endl;
+        messages_sent_->add();
+        send_queue_depth_->set(static_cast<int64_t>(send_queue_.size()));
     }
 }
 
@@ -307,32 +969,769 @@ void OKXWebSocketClient::set_ping_interval(int seconds) {
     ping_interval_ = seconds;
 }
 
+void OKXWebSocketClient::enable_staleness_detection(bool enable, StaleAction action) {
+    // 阶段在第一次启用时才挂上，未启用的客户端每个tick不付锁和查表的开销，也不解析 instType
+    if (enable && !staleness_stage_added_) {
+        // 流水线只在服务线程遍历，运行中不能再加阶段
+        if (should_run_) {
+            OKX_LOG_WARN("Staleness detection must be enabled before connect()");
+            return;
+        }
+        ticker_handler_->add_stage([this](const TickerView& ticker) {
+            if (!staleness_enabled_) return;
+            std::lock_guard<std::mutex> lock(staleness_mutex_);
+            staleness_monitor_.on_tick(ticker.inst_id, ticker.inst_type, StalenessMonitor::now_ms());
+        }, TickerField::InstId | TickerField::InstType, "staleness");
+        staleness_stage_added_ = true;
+    }
+
+    std::lock_guard<std::mutex> lock(staleness_mutex_);
+    stale_action_ = action;
+    staleness_enabled_ = enable;
+}
+
+void OKXWebSocketClient::set_stale_threshold(const std::string& inst_type, int threshold_ms) {
+    std::lock_guard<std::mutex> lock(staleness_mutex_);
+    staleness_monitor_.set_threshold(inst_type, threshold_ms);
+}
+
+void OKXWebSocketClient::set_default_stale_threshold(int threshold_ms) {
+    std::lock_guard<std::mutex> lock(staleness_mutex_);
+    staleness_monitor_.set_default_threshold(threshold_ms);
+}
+
+void OKXWebSocketClient::set_stale_callback(StalenessMonitor::StaleCallback callback) {
+    std::lock_guard<std::mutex> lock(staleness_mutex_);
+    stale_callback_ = std::move(callback);
+}
+
+void OKXWebSocketClient::register_metrics() {
+    messages_received_ = &metrics_.counter("okx_messages_received_total", "WebSocket messages received");
+    bytes_received_ = &metrics_.counter("okx_bytes_received_total", "Payload bytes received after inflate");
+    parse_failures_ = &metrics_.counter("okx_parse_failures_total", "Ticker pushes that failed to parse");
+    unhandled_messages_ = &metrics_.counter("okx_unhandled_messages_total", "Messages not handled by any channel (events, acks)");
+    messages_sent_ = &metrics_.counter("okx_messages_sent_total", "Messages written to the socket");
+    send_failures_ = &metrics_.counter("okx_send_failures_total", "lws_write failures");
+    reconnects_ = &metrics_.counter("okx_reconnects_total", "Reconnect attempts");
+    stale_events_ = &metrics_.counter("okx_stale_events_total", "Per-instrument staleness events");
+    send_queue_depth_ = &metrics_.gauge("okx_send_queue_depth", "Messages waiting in the send queue");
+    connected_gauge_ = &metrics_.gauge("okx_connected", "1 while the WebSocket is established");
+    login_failures_ = &metrics_.counter("okx_login_failures_total", "Private channel login rejections");
+    rx_oversize_ = &metrics_.counter("okx_rx_oversize_total", "Fragmented messages dropped for exceeding the rx buffer");
+    failovers_ = &metrics_.counter("okx_failovers_total", "Standby connections promoted after the primary closed");
+    failover_missed_ = &metrics_.counter("okx_failover_missed_updates_total",
+                                         "Ticker updates seen only on the standby before it was promoted");
+    failover_duplicates_ = &metrics_.counter("okx_failover_duplicates_total",
+                                             "Ticker updates dropped because the primary already dispatched them");
+    standby_gauge_ = &metrics_.gauge("okx_standby_ready", "1 while a subscribed standby connection is ready");
+    metrics_.counter_fn("okx_orders_sent_total", "Order entry requests sent",
+                        [this] { return static_cast<double>(order_entry_.stats().sent); });
+    metrics_.counter_fn("okx_order_rejects_total", "Order entry requests rejected or failed",
+                        [this] { return static_cast<double>(order_entry_.stats().rejected); });
+    metrics_.gauge_fn("okx_orders_in_flight", "Order entry requests awaiting a response",
+                      [this] { return static_cast<double>(order_entry_.in_flight()); });
+
+    metrics_.counter_fn("okx_log_records_dropped_total", "Log records dropped because a log ring was full",
+                        [] { return static_cast<double>(AsyncLogger::dropped()); });
+    metrics_.counter_fn("okx_inflate_input_bytes_total", "Compressed bytes fed to permessage-deflate",
+                        [this] { return static_cast<double>(compressed_bytes_.load()); });
+    metrics_.counter_fn("okx_inflate_ns_total", "Time spent inflating (ns)",
+                        [this] { return static_cast<double>(inflate_ns_.load()); });
+    metrics_.gauge_fn("okx_hot_memory_bytes", "Hot-path memory reserved by latency mode",
+                      [this] { return static_cast<double>(latency_report_.reserved_bytes); });
+    metrics_.gauge_fn("okx_market_bus_published", "Ticks published to the shared-memory bus",
+                      [this] { return market_bus_ ? static_cast<double>(market_bus_->published()) : 0.0; });
+}
+
+MetricCounter& OKXWebSocketClient::instrument_counter(std::string_view inst_id) {
+    auto it = instrument_updates_.find(inst_id);
+    if (it != instrument_updates_.end()) {
+        return *it->second;
+    }
+    // 每个交易对只在第一次出现时注册
+    MetricCounter& counter = metrics_.counter("okx_ticker_updates_total", "Ticker updates per instrument",
+                                              MetricsRegistry::label("inst_id", inst_id));
+    instrument_updates_.emplace(std::string(inst_id), &counter);
+    return counter;
+}
+
+void OKXWebSocketClient::enable_instrument_metrics() {
+    if (instrument_stage_added_) return;
+    // 流水线只在服务线程遍历，运行中不能再加阶段
+    if (should_run_) {
+        OKX_LOG_WARN("Per-instrument metrics must be enabled before connect()");
+        return;
+    }
+    ticker_handler_->add_stage([this](const TickerView& ticker) {
+        instrument_counter(ticker.inst_id).add();
+    }, TickerField::InstId, "instrument_counter");
+    instrument_stage_added_ = true;
+}
+
+bool OKXWebSocketClient::start_metrics_server(int port, const std::string& bind_address) {
+    enable_instrument_metrics();
+    if (!metrics_server_) {
+        metrics_server_ = std::make_unique<MetricsServer>(metrics_);
+    }
+    return metrics_server_->start(port, bind_address);
+}
+
+void OKXWebSocketClient::stop_metrics_server() {
+    if (metrics_server_) {
+        metrics_server_->stop();
+    }
+}
+
+void OKXWebSocketClient::set_thread_config(const ThreadConfig& config) {
+    thread_config_ = config;
+}
+
+void OKXWebSocketClient::enable_compression(bool enable, int window_bits) {
+#if defined(LWS_WITHOUT_EXTENSIONS)
+    if (enable) {
+        OKX_LOG_WARN("libwebsockets was built without extensions, permessage-deflate unavailable");
+    }
+    compression_enabled_ = false;
+    (void)window_bits;
+#else
+    compression_enabled_ = enable;
+    compression_window_bits_ = std::clamp(window_bits, 9, 15);
+
+    // 限制服务端窗口即限制本端解压窗口内存；不带 no_context_takeover，解压状态跨消息复用
+    compression_offer_ = "permessage-deflate; client_max_window_bits";
+    if (compression_window_bits_ < 15) {
+        compression_offer_ += "; server_max_window_bits=" + std::to_string(compression_window_bits_);
+    }
+
+    extensions_[0].name = "permessage-deflate";
+    extensions_[0].callback = &OKXWebSocketClient::extension_callback;
+    extensions_[0].client_offer = compression_offer_.c_str();
+    extensions_[1] = {};
+#endif
+}
+
+CompressionStats OKXWebSocketClient::compression_stats() const {
+    return {compression_negotiated_.load(), compressed_bytes_.load(), inflated_bytes_.load(),
+            inflate_ns_.load(), inflate_calls_.load()};
+}
+
+// 包装 lws 自带的 permessage-deflate 回调，在解压处计量字节数和耗时
+int OKXWebSocketClient::extension_callback(struct lws_context* context, const struct lws_extension* ext, struct lws* wsi,
+                                           enum lws_extension_callback_reasons reason, void* user, void* in, size_t len) {
+#if defined(LWS_WITHOUT_EXTENSIONS)
+    (void)context; (void)ext; (void)wsi; (void)reason; (void)user; (void)in; (void)len;
+    return 0;
+#else
+    if (reason != LWS_EXT_CB_PAYLOAD_RX || !in) {
+        return lws_extension_callback_pm_deflate(context, ext, wsi, reason, user, in, len);
+    }
+
+    auto* buffers = static_cast<struct lws_ext_pm_deflate_rx_ebufs*>(in);
+    int input = buffers->eb_in.len;
+
+    uint64_t start = TscClock::now();
+    int result = lws_extension_callback_pm_deflate(context, ext, wsi, reason, user, in, len);
+    int64_t elapsed = TscClock::ticks_to_ns(TscClock::now_ordered() - start);
+
+    auto* client = static_cast<OKXWebSocketClient*>(lws_context_user(context));
+    if (client) {
+        // 回调返回后 eb_in 指向未消费的输入
+        int remaining = buffers->eb_in.len;
+        int consumed = remaining >= 0 && remaining <= input ? input - remaining : input;
+        client->compressed_bytes_.fetch_add(static_cast<uint64_t>(consumed), std::memory_order_relaxed);
+        if (buffers->eb_out.len > 0) {
+            client->inflated_bytes_.fetch_add(static_cast<uint64_t>(buffers->eb_out.len), std::memory_order_relaxed);
+        }
+        client->inflate_ns_.fetch_add(static_cast<uint64_t>(elapsed), std::memory_order_relaxed);
+        client->inflate_calls_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+#endif
+}
+
+bool OKXWebSocketClient::enable_market_bus(const std::string& name, size_t slot_count) {
+    // 服务线程会在发布阶段里访问映射，运行中重建可能让它写到已解除映射的内存
+    if (should_run_) {
+        OKX_LOG_ERROR("Market bus must be enabled before connect() or after disconnect()");
+        return false;
+    }
+    std::string error;
+    if (market_bus_) {
+        if (!market_bus_->create(name, slot_count, error)) {
+            OKX_LOG_ERROR("Failed to create market bus: {}", error);
+            return false;
+        }
+        return true;
+    }
+
+    auto bus = std::make_unique<MarketBusPublisher>();
+    if (!bus->create(name, slot_count, error)) {
+        OKX_LOG_ERROR("Failed to create market bus: {}", error);
+        return false;
+    }
+    market_bus_ = std::move(bus);
+
+    // 发布阶段直接读取batch中的视图，不经过 TickerData
+    ticker_handler_->add_stage([bus = market_bus_.get()](const TickerView& ticker) {
+        bus->publish(ticker);
+    }, kAllFields, "market_bus");
+    OKX_LOG_INFO("Market bus enabled: {}", name);
+    return true;
+}
+
+bool OKXWebSocketClient::enable_checkpoint(const std::string& path, size_t capacity, int sync_interval_ms) {
+    // 流水线和 checkpoint_ 只在服务线程读取，运行中不能再加阶段
+    if (should_run_) {
+        OKX_LOG_WARN("Checkpoint must be enabled before connect()");
+        return false;
+    }
+    if (checkpoint_) {
+        OKX_LOG_WARN("Checkpoint already enabled");
+        return false;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    auto checkpoint = std::make_unique<TickCheckpoint>();
+    std::string error;
+    if (!checkpoint->open(path, capacity, error)) {
+        OKX_LOG_ERROR("Failed to open checkpoint: {}", error);
+        return false;
+    }
+    checkpoint_ = std::move(checkpoint);
+    checkpoint_sync_ms_ = sync_interval_ms;
+    checkpoint_synced_ = std::chrono::steady_clock::now();
+
+    ticker_handler_->add_stage([checkpoint = checkpoint_.get()](const TickerView& ticker) {
+        checkpoint->record(ticker);
+    }, kAllFields, "checkpoint");
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    OKX_LOG_INFO("Checkpoint {} restored {} instruments in {}us", path, checkpoint_->restored(), elapsed.count());
+    return true;
+}
+
+void OKXWebSocketClient::set_latency_mode(const LatencyConfig& config) {
+    latency_enabled_ = true;
+    latency_config_ = config;
+}
+
+void OKXWebSocketClient::enable_rx_timestamping(const RxTimestampingConfig& config) {
+    rx_timestamping_ = true;
+    rx_timestamping_config_ = config;
+}
+
+RxTimestampingStatus OKXWebSocketClient::rx_timestamping_status() const {
+    return rx_stamper_ ? rx_stamper_->status() : RxTimestampingStatus{};
+}
+
+void OKXWebSocketClient::attach_rx_stamper(struct lws* wsi, std::unique_ptr<RxTimestamper>& stamper) {
+    if (!rx_timestamping_) return;
+    // 上一条连接已关闭，其 SSL 连同读 BIO 已释放
+    stamper = std::make_unique<RxTimestamper>();
+    if (!stamper->attach(lws_get_socket_fd(wsi), lws_get_ssl(wsi), rx_timestamping_config_)) {
+        OKX_LOG_WARN("Rx timestamping disabled for this connection: {}", stamper->status().error);
+    } else if (!stamper->status().attached) {
+        OKX_LOG_WARN("Rx timestamping needs a TLS connection; plain ws:// frames carry no kernel timestamp");
+    }
+}
+
+void OKXWebSocketClient::warm_up() {
+    const LatencyConfig& config = latency_config_;
+    LatencyReport report;
+
+    if (rx_region_.size() < config.rx_buffer_bytes || rx_region_.huge() != (config.huge_pages != HugePageMode::None)) {
+        rx_region_.map(config.rx_buffer_bytes, config.huge_pages, config.prefault, report.huge_page_error);
+    } else if (config.prefault) {
+        LatencyMode::prefault(rx_region_.data(), rx_region_.size());
+    }
+    report.reserved_bytes += rx_region_.size();
+    if (config.prefault) report.prefaulted_bytes += rx_region_.size();
+    if (rx_region_.huge()) report.huge_page_bytes += rx_region_.size();
+
+    // arena 新块由 make_unique 清零，申请即已触及
+    size_t parse_bytes = ticker_handler_->reserve(config.parse_arena_bytes, config.expected_tickers);
+    report.reserved_bytes += parse_bytes;
+    report.prefaulted_bytes += parse_bytes;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        size_t frames = std::min(config.send_frames, kMaxSpareFrames);
+        for (auto& frame : spare_frames_) {
+            if (frame.capacity() < config.frame_bytes) frame.reserve(config.frame_bytes);
+        }
+        while (spare_frames_.size() < frames) {
+            // resize 写入整个缓冲区，clear 后容量保留
+            std::string frame(config.frame_bytes, '\0');
+            frame.clear();
+            spare_frames_.push_back(std::move(frame));
+        }
+        if (write_buffer_.size() < LWS_PRE + config.frame_bytes) {
+            write_buffer_.resize(LWS_PRE + config.frame_bytes);
+        }
+        size_t send_bytes = spare_frames_.size() * config.frame_bytes + write_buffer_.size();
+        report.reserved_bytes += send_bytes;
+        report.prefaulted_bytes += send_bytes;
+    }
+
+    // 服务线程栈在线程启动时预触，这里只计入
+    if (config.prefault) {
+        report.reserved_bytes += config.stack_bytes;
+        report.prefaulted_bytes += config.stack_bytes;
+    }
+
+    if (config.lock_memory) {
+        report.locked = LatencyMode::lock_all(report.lock_error);
+        report.locked_bytes = LatencyMode::locked_bytes();
+    }
+
+    latency_report_ = report;
+    OKX_LOG_INFO("Latency mode: reserved {} bytes, prefaulted {} bytes, huge pages {} bytes, locked {} bytes",
+                 report.reserved_bytes, report.prefaulted_bytes, report.huge_page_bytes, report.locked_bytes);
+    if (!report.huge_page_error.empty()) {
+        OKX_LOG_WARN("Latency mode: {}", report.huge_page_error);
+    }
+    if (!report.lock_error.empty()) {
+        OKX_LOG_WARN("Latency mode: {}", report.lock_error);
+    }
+}
+
+bool OKXWebSocketClient::enable_bar_aggregation(std::vector<int64_t> intervals_ms, BarAggregator::BarCallback callback, int64_t grace_ms) {
+    // 服务线程遍历流水线并执行K线回调，运行中既不能加阶段也不能换回调
+    if (should_run_) {
+        OKX_LOG_ERROR("Bar aggregation must be enabled before connect()");
+        return false;
+    }
+    // 周期和宽限期决定了状态数组的布局，不支持部分重配
+    if (bar_aggregator_) {
+        OKX_LOG_ERROR("Bar aggregation already enabled, reconfiguration is not supported");
+        return false;
+    }
+
+    bar_aggregator_ = std::make_unique<BarAggregator>(std::move(intervals_ms), grace_ms);
+    bar_aggregator_->set_callback(std::move(callback));
+    ticker_handler_->add_stage([bars = bar_aggregator_.get()](const TickerView& ticker) {
+        bars->on_tick(ticker);
+    }, TickerField::InstId | TickerField::Last | TickerField::Vol24h | TickerField::Ts, "bar_aggregator");
+    return true;
+}
+
+void OKXWebSocketClient::handle_stale(const StaleEvent& event, StaleAction action, const StalenessMonitor::StaleCallback& callback) {
+    stale_events_->add();
+    OKX_LOG_WARN("Stale ticker: {} no update for {}ms", event.inst_id, event.age_ms);
+
+    // 只对该交易对重新订阅，不影响其它行情
+    if (action == StaleAction::Resubscribe) {
+        std::string inst_id(event.inst_id);
+        send_message(JsonParser::create_unsubscription_message("tickers", inst_id));
+        send_message(JsonParser::create_subscription_message("tickers", inst_id));
+    }
+
+    if (callback) {
+        callback(event);
+    }
+}
+
+void OKXWebSocketClient::send_login() {
+    // OKX 要求 Unix 秒级时间戳，与服务器时间相差 30 秒内
+    std::string timestamp = std::to_string(std::time(nullptr));
+    std::string sign;
+    if (!signer_.sign_base64(HmacSigner::login_prehash(timestamp), sign)) {
+        OKX_LOG_ERROR("Failed to sign login request");
+        login_state_ = LoginState::Failed;
+        return;
+    }
+    login_state_ = LoginState::Pending;
+    send_message(JsonParser::create_login_message(api_key_, passphrase_, timestamp, sign));
+}
+
+bool OKXWebSocketClient::handle_login_response(std::string_view data) {
+    std::string_view event;
+    std::string_view code;
+    std::string_view msg;
+    JsonScanner::for_each_member(data, [&](std::string_view key, std::string_view value, bool) {
+        if (key == "event") event = value;
+        else if (key == "code") code = value;
+        else if (key == "msg") msg = value;
+        return true;
+    });
+
+    // 登录失败时 OKX 回 event=error
+    if (event != "login" && event != "error") {
+        return false;
+    }
+
+    bool success = event == "login" && code == "0";
+    if (success) {
+        OKX_LOG_INFO("Logged in to private channels");
+        send_private_subscriptions();
+    } else {
+        login_state_ = LoginState::Failed;
+        login_failures_->add();
+        OKX_LOG_ERROR("Login failed: code={} msg={}", code, msg);
+    }
+
+    if (login_callback_) {
+        login_callback_(success, std::string(code), std::string(msg));
+    }
+    return true;
+}
+
+void OKXWebSocketClient::send_private_subscriptions() {
+    // 与 subscribe_private 同锁切换状态，避免同一订阅发送两次
+    std::lock_guard<std::mutex> lock(private_mutex_);
+    login_state_ = LoginState::LoggedIn;
+    for (const auto& [channel, inst_type] : private_subscriptions_) {
+        send_message(JsonParser::create_private_subscription_message(channel, inst_type));
+    }
+}
+
+void OKXWebSocketClient::enable_standby(bool enable) {
+    if (enable && !standby_enabled_) {
+        // 过滤器只在服务线程上调用，运行中不能替换
+        if (should_run_) {
+            OKX_LOG_WARN("Standby must be enabled before connect()");
+            return;
+        }
+        // 记录主连接每个交易对最后分发的 ts，切换时据此统计漏掉的更新；
+        // 热备若落后于旧主连接，提升后会再收到已分发过的更新，在这里丢弃
+        ticker_handler_->set_filter([this](const TickerView& ticker) {
+            int64_t ts = 0;
+            std::from_chars(ticker.ts.data(), ticker.ts.data() + ticker.ts.size(), ts);
+            if (gap_counter_.on_primary(ticker.inst_id, ts)) return true;
+            failover_duplicates_->add();
+            return false;
+        }, TickerField::InstId | TickerField::Ts);
+    }
+    standby_enabled_ = enable;
+}
+
+void OKXWebSocketClient::remember_subscription(const std::string& channel, const std::string& inst_id) {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    for (const auto& [known_channel, known_inst] : subscriptions_) {
+        if (known_channel == channel && known_inst == inst_id) return;
+    }
+    subscriptions_.emplace_back(channel, inst_id);
+    // 热备已重放过订阅记录，之后的新订阅同步发给它
+    if (standby_established_) {
+        standby_pending_++;
+        send_standby(JsonParser::create_subscription_message(channel, inst_id));
+    }
+}
+
+void OKXWebSocketClient::send_standby(std::string message) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        standby_queue_.push_back(std::move(message));
+    }
+    // 服务线程在下一轮循环中请求可写
+    standby_queued_ = true;
+}
+
+void OKXWebSocketClient::open_standby() {
+    ccinfo_.opaque_user_data = &standby_tag;
+    standby_wsi_ = lws_client_connect_via_info(&ccinfo_);
+    ccinfo_.opaque_user_data = nullptr;
+    if (!standby_wsi_) {
+        OKX_LOG_WARN("Failed to open standby connection");
+        standby_lost();
+    }
+}
+
+void OKXWebSocketClient::service_standby(std::chrono::steady_clock::time_point now) {
+    if (!standby_wsi_) {
+        if (connected_ && now >= standby_retry_at_) {
+            open_standby();
+        }
+        return;
+    }
+    if (standby_queued_.exchange(false)) {
+        lws_callback_on_writable(standby_wsi_);
+    }
+
+    bool established;
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        established = standby_established_;
+    }
+    if (!established) return;
+
+    if (std::chrono::duration_cast<std::chrono::seconds>(now - standby_last_ping_).count() >= ping_interval_) {
+        unsigned char ping_payload[LWS_PRE + 1];
+        if (lws_write(standby_wsi_, &ping_payload[LWS_PRE], 0, LWS_WRITE_PING) >= 0) {
+            standby_last_ping_ = now;
+        }
+    }
+    if (std::chrono::duration_cast<std::chrono::seconds>(now - standby_last_pong_).count() > ping_interval_ * 2) {
+        OKX_LOG_WARN("Standby ping timeout, replacing standby connection");
+        lws_set_timeout(standby_wsi_, PENDING_TIMEOUT_USER_OK, LWS_TO_KILL_ASYNC);
+        standby_last_pong_ = now;
+    }
+}
+
+int OKXWebSocketClient::handle_standby_event(struct lws* wsi, enum lws_callback_reasons reason, void* in, size_t len) {
+    switch (reason) {
+        case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+            OKX_LOG_WARN("Standby connection error: {}", in ? static_cast<const char*>(in) : "unknown");
+            if (wsi == standby_wsi_) standby_lost();
+            break;
+
+        case LWS_CALLBACK_CLIENT_ESTABLISHED:
+            handle_standby_established();
+            break;
+
+        case LWS_CALLBACK_CLIENT_RECEIVE: {
+            // 热备不在热路径上，分片直接拼到字符串里
+            standby_rx_.append(static_cast<const char*>(in), len);
+            if (lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0) {
+                handle_standby_message(standby_rx_);
+                standby_rx_.clear();
+            }
+            break;
+        }
+
+        case LWS_CALLBACK_CLIENT_WRITEABLE:
+            process_standby_queue();
+            break;
+
+        case LWS_CALLBACK_CLIENT_RECEIVE_PONG:
+            standby_last_pong_ = std::chrono::steady_clock::now();
+            break;
+
+        case LWS_CALLBACK_CLIENT_CLOSED:
+        case LWS_CALLBACK_WSI_DESTROY:
+            if (wsi == standby_wsi_) {
+                OKX_LOG_INFO("Standby connection closed");
+                standby_lost();
+            }
+            break;
+
+        default:
+            break;
+    }
+    return 0;
+}
+
+void OKXWebSocketClient::handle_standby_established() {
+    OKX_LOG_INFO("Standby connection established");
+    attach_rx_stamper(standby_wsi_, standby_stamper_);
+    standby_failures_ = 0;
+    standby_last_ping_ = standby_last_pong_ = std::chrono::steady_clock::now();
+    standby_rx_.clear();
+
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    standby_established_ = true;
+    standby_pending_ = static_cast<int>(subscriptions_.size());
+    for (const auto& [channel, inst_id] : subscriptions_) {
+        send_standby(JsonParser::create_subscription_message(channel, inst_id));
+    }
+    if (signer_.has_key()) {
+        std::string timestamp = std::to_string(std::time(nullptr));
+        std::string sign;
+        if (signer_.sign_base64(HmacSigner::login_prehash(timestamp), sign)) {
+            standby_pending_++;
+            send_standby(JsonParser::create_login_message(api_key_, passphrase_, timestamp, sign));
+        }
+    }
+    if (standby_pending_ == 0) {
+        standby_ready_ = true;
+        standby_gauge_->set(1);
+    }
+}
+
+void OKXWebSocketClient::handle_standby_message(std::string_view data) {
+    // 只跟踪 ticker 的 instId/ts，其余字段不解析
+    if (JsonParser::parse_ticker_fields_into<TickerField::InstId | TickerField::Ts>(data, standby_batch_)) {
+        for (const TickerView& ticker : standby_batch_) {
+            int64_t ts = 0;
+            std::from_chars(ticker.ts.data(), ticker.ts.data() + ticker.ts.size(), ts);
+            gap_counter_.on_standby(ticker.inst_id, ts);
+        }
+        return;
+    }
+    if (standby_ready_) return;
+
+    std::string_view event;
+    std::string_view code;
+    std::string_view msg;
+    JsonScanner::for_each_member(data, [&](std::string_view key, std::string_view value, bool) {
+        if (key == "event") event = value;
+        else if (key == "code") code = value;
+        else if (key == "msg") msg = value;
+        return true;
+    });
+    if (event == "login") {
+        if (code == "0") {
+            std::lock_guard<std::mutex> lock(private_mutex_);
+            standby_logged_in_ = true;
+            standby_pending_ += static_cast<int>(private_subscriptions_.size());
+            for (const auto& [channel, inst_type] : private_subscriptions_) {
+                send_standby(JsonParser::create_private_subscription_message(channel, inst_type));
+            }
+        } else {
+            OKX_LOG_ERROR("Standby login failed: code={} msg={}", code, msg);
+        }
+    } else if (event == "error") {
+        OKX_LOG_ERROR("Standby request failed: code={} msg={}", code, msg);
+    } else if (event != "subscribe") {
+        return;
+    }
+    // 失败的请求同样计入，热备仍可提升，只是少了对应的订阅
+    if (--standby_pending_ <= 0) {
+        standby_ready_ = true;
+        standby_gauge_->set(1);
+        OKX_LOG_INFO("Standby connection ready");
+    }
+}
+
+void OKXWebSocketClient::process_standby_queue() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    for (const std::string& message : standby_queue_) {
+        if (write_buffer_.size() < LWS_PRE + message.size()) {
+            write_buffer_.resize(LWS_PRE + message.size());
+        }
+        memcpy(&write_buffer_[LWS_PRE], message.data(), message.size());
+        if (lws_write(standby_wsi_, &write_buffer_[LWS_PRE], message.size(), LWS_WRITE_TEXT) < 0) {
+            // 没发出的订阅收不到回执，热备永远不会就绪，关掉后按退避重开
+            OKX_LOG_ERROR("Failed to send on standby connection, replacing standby");
+            send_failures_->add();
+            lws_set_timeout(standby_wsi_, PENDING_TIMEOUT_USER_OK, LWS_TO_KILL_ASYNC);
+            break;
+        }
+    }
+    standby_queue_.clear();
+}
+
+void OKXWebSocketClient::standby_lost() {
+    standby_wsi_ = nullptr;
+    standby_ready_ = false;
+    standby_logged_in_ = false;
+    standby_gauge_->set(0);
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        standby_established_ = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        standby_queue_.clear();
+    }
+    standby_rx_.clear();
+    gap_counter_.clear_standby();
+
+    // 与主连接重连相同的退避，避免服务端拒绝时反复建连
+    int delay = std::min(1000 * (1 << std::min(standby_failures_, 5)), 30000);
+    standby_failures_++;
+    standby_retry_at_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+}
+
+bool OKXWebSocketClient::promote_standby() {
+    if (!standby_ready_ || !standby_wsi_ || !should_run_) {
+        return false;
+    }
+
+    uint64_t missed = gap_counter_.promote();
+    lws_set_opaque_user_data(standby_wsi_, nullptr);
+    wsi_ = standby_wsi_;
+    standby_wsi_ = nullptr;
+    // 旧主连接的 BIO 在其 SSL 释放前仍会用到，留在 standby_stamper_ 里，下一条热备建立时才替换
+    std::swap(rx_stamper_, standby_stamper_);
+    standby_ready_ = false;
+    standby_gauge_->set(0);
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        standby_established_ = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        // 热备还没写出的订阅（提升前刚发起的 subscribe）改由新主连接发送，否则这些订阅会丢失
+        for (std::string& message : standby_queue_) {
+            send_queue_.push(std::move(message));
+        }
+        standby_queue_.clear();
+        standby_queued_ = false;
+        standby_pending_ = 0;
+        send_queue_depth_->set(static_cast<int64_t>(send_queue_.size()));
+        // 新主连接发送队列里旧连接没写出的帧
+        if (!send_queue_.empty()) lws_callback_on_writable(wsi_);
+    }
+    login_state_ = standby_logged_in_.exchange(false) ? LoginState::LoggedIn : LoginState::None;
+    last_ping_ = standby_last_ping_;
+    last_pong_ = standby_last_pong_;
+    // 热备收到一半的消息接到主连接的缓冲区里，后续分片照常拼接，切换点上的消息不会被截断丢弃
+    rx_length_ = standby_rx_.size();
+    rx_overflow_ = false;
+    if (rx_length_ > 0) {
+        if (!rx_region_.data()) {
+            std::string error;
+            rx_region_.map(latency_config_.rx_buffer_bytes, HugePageMode::None, false, error);
+        }
+        rx_overflow_ = rx_length_ > rx_region_.size();
+        if (!rx_overflow_) memcpy(rx_region_.data(), standby_rx_.data(), rx_length_);
+        standby_rx_.clear();
+    }
+
+    // 旧连接上的在途请求结果未知，按断线处理；连接状态不变，不唤醒断线等待者
+    order_entry_.fail_all("disconnected", "Connection closed before response");
+    fail_pending_acks("disconnected", "Connection closed before response");
+
+    failovers_->add();
+    failover_missed_->add(missed);
+    OKX_PROBE1(failover, missed);
+    OKX_LOG_WARN("Primary connection closed, promoted standby ({} updates missed)", missed);
+
+    // 立即在后台补一条新的热备
+    standby_failures_ = 0;
+    standby_retry_at_ = std::chrono::steady_clock::now();
+    return true;
+}
+
 void OKXWebSocketClient::attempt_reconnect() {
+    if (reconnect_pending_) {
+        return;
+    }
     if (reconnect_attempts_ >= max_reconnect_attempts_) {
-        std::cerr << "Max reconnection attempts reached. Giving up." << std::endl;
+        OKX_LOG_ERROR("Max reconnection attempts reached. Giving up.");
         return;
     }
 
     reconnect_attempts_++;
+    reconnects_->add();
     int delay = std::min(1000 * (1 << (reconnect_attempts_ - 1)), 30000);
-    std::cout << "Reconnect attempt " << reconnect_attempts_ << " in " << delay << "ms..." << std::endl;
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(delay));
-
-    if (wsi_) {
-        lws_close_reason(wsi_, LWS_CLOSE_STATUS_NORMAL, nullptr, 0);
-        wsi_ = nullptr;
+    OKX_LOG_INFO("Reconnect attempt {} in {}ms...", reconnect_attempts_, delay);
+    OKX_PROBE2(reconnect, reconnect_attempts_, delay);
+
+    // io_uring 在服务线程内原地重连
+    if (transport_ == Transport::IoUring) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        if (should_run_ && open_uring()) {
+            handle_connection_established();
+        }
+        return;
     }
 
-    if (context_) {
-        lws_context_destroy(context_);
-        context_ = nullptr;
-    }
+    // 这里在 lws 回调里，不能阻塞，也不能销毁正在服务的 context；
+    // 到期后由服务循环在同一个 context 上用 connect() 保存的 ccinfo_（地址、路径、TLS 选项）重新连接
+    reconnect_at_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+    reconnect_pending_ = true;
+}
 
-    connect(host_, port_, path_);
+void OKXWebSocketClient::reopen_connection() {
+    reconnect_pending_ = false;
+    wsi_ = lws_client_connect_via_info(&ccinfo_);
+    // 同步失败时 lws 可能已经通过 CONNECTION_ERROR 排好了下一次重连
+    if (!wsi_ && !reconnect_pending_) {
+        OKX_LOG_ERROR("Failed to reconnect to WebSocket");
+        if (auto_reconnect_ && should_reconnect()) {
+            attempt_reconnect();
+        }
+    }
 }
 
 void OKXWebSocketClient::send_ping() {
+    if (uring_ && transport_ == Transport::IoUring) {
+        if (connected_ && uring_->send_ping()) {
+            last_ping_ = std::chrono::steady_clock::now();
+        }
+        return;
+    }
     if (wsi_ && connected_) {
         unsigned char ping_payload[LWS_PRE + 125];
         memset(&ping_payload[LWS_PRE], 0, 125);
@@ -356,11 +1755,7 @@ void OKXWebSocketClient::set_http_proxy(const std::string& proxy_host, int proxy
     use_http_proxy_ = true;
     use_socks_proxy_ = false;
 
-    std::cout << "设置HTTP代理: " << proxy_host << ":" << proxy_port;
-    if (!username.empty()) {
-        std::cout << " (认证: " << username << ")";
-    }
-    std::cout << std::endl;
+    OKX_LOG_INFO("HTTP proxy set to {}:{}{}", proxy_host, proxy_port, username.empty() ? "" : " with authentication");
 }
 
 void OKXWebSocketClient::set_socks_proxy(const std::string& proxy_host, int proxy_port, const std::string& username, const std::string& password) {
@@ -371,11 +1766,7 @@ void OKXWebSocketClient::set_socks_proxy(const std::string& proxy_host, int prox
     use_socks_proxy_ = true;
     use_http_proxy_ = false;
 
-    std::cout << "设置SOCKS代理: " << proxy_host << ":" << proxy_port;
-    if (!username.empty()) {
-        std::cout << " (认证: " << username << ")";
-    }
-    std::cout << std::endl;
+    OKX_LOG_INFO("SOCKS proxy set to {}:{}{}", proxy_host, proxy_port, username.empty() ? "" : " with authentication");
 }
 
 void OKXWebSocketClient::clear_proxy() {
@@ -391,5 +1782,5 @@ void OKXWebSocketClient::clear_proxy() {
     unsetenv("https_proxy");
     unsetenv("ALL_PROXY");
 
-    std::cout << "清除代理设置" << std::endl;
+    OKX_LOG_INFO("Proxy settings cleared");
 }
\ No newline at end of file
@@ -1,35 +1,206 @@
 #pragma once
 #include "ticker_handler.h"
+#include "staleness_monitor.h"
+#include "market_bus.h"
+#include "tick_checkpoint.h"
+#include "bar_aggregator.h"
+#include "thread_config.h"
+#include "latency_mode.h"
+#include "tsc_clock.h"
+#include "metrics.h"
+#include "okx_channels.h"
+#include "okx_private_channels.h"
+#include "hmac_signer.h"
+#include "order_entry.h"
+#include "coro.h"
+#include "failover_gap.h"
+#include "rx_timestamping.h"
+#include "uring_transport.h"
 #include <libwebsockets.h>
 #include <memory>
 #include <string>
 #include <atomic>
 #include <thread>
 #include <queue>
+#include <unordered_map>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
 
+// permessage-deflate 统计: 解压前后字节数和解压耗时
+struct CompressionStats {
+    bool negotiated;
+    uint64_t compressed_bytes;
+    uint64_t inflated_bytes;
+    uint64_t inflate_ns;
+    uint64_t inflate_calls;
+
+    double ratio() const { return compressed_bytes ? double(inflated_bytes) / double(compressed_bytes) : 0.0; }
+};
+
+// co_await client.subscribe(...) 的结果
+struct SubscribeAck {
+    bool ok = false;
+    std::string code;   // 失败时为 OKX 错误码或 "disconnected"
+    std::string msg;
+};
+
+using TickStream = AsyncQueue<TickerData>;
+
 class OKXWebSocketClient {
 public:
+    enum class StaleAction { Notify, Resubscribe };
+    enum class LoginState { None, Pending, LoggedIn, Failed };
+    // IoUring: 见 uring_transport.h；不支持代理、permessage-deflate、热备和内核收包时间戳，
+    // 内核不允许 io_uring 或编译时未启用 OKX_WITH_IO_URING 时退回 libwebsockets
+    enum class Transport { Libwebsockets, IoUring };
+    // 登录结果: success, code, msg（OKX 错误码，如 60009）
+    using LoginCallback = std::function<void(bool, const std::string&, const std::string&)>;
+
     OKXWebSocketClient();
     ~OKXWebSocketClient();
 
-    bool connect(const std::string& host = "ws.okx.com", int port = 8443, const std::string& path = "/ws/v5/public", bool use_ssl = true);
+    bool connect(const std::string& host = "ws.okx.com", int port = 8443, const std::string& path = "/ws/v5/public", bool use_ssl = true,
+                 Transport transport = Transport::Libwebsockets);
     void disconnect();
     bool subscribe_ticker(const std::string& inst_id);
+    bool subscribe_channel(const std::string& channel, const std::string& inst_id);
     void set_ticker_callback(TickerHandler::TickerCallback callback);
+    // 批量交付: ServicePass 时一轮 lws_service / io_uring poll 收到的所有 ticker 在该轮结束后一次交付，
+    // Message 时每条消息一次。读取的字段同 set_ticker_fields()，需在 connect() 之前调用
+    void set_batch_callback(TickerHandler::BatchCallback on_batch, TickerHandler::BatchEndCallback on_batch_end = {},
+                            TickerHandler::BatchScope scope = TickerHandler::BatchScope::ServicePass);
+    // ticker 回调和协程 ticker 流读取的字段（TickerField::Quote 等），其余字段不解析、为空；
+    // 内部阶段（K线、共享内存总线等）各自声明所需字段。需在 ticks() 和 connect() 之前调用
+    void set_ticker_fields(FieldMask fields);
+
+    // 私有频道: 设置 API 凭证后，每次连接建立都会自动登录；HMAC 密钥在这里预先计算
+    // 私有频道订阅在登录成功后发送，重连后重新登录并重发
+    bool set_credentials(const std::string& api_key, const std::string& secret_key, const std::string& passphrase);
+    bool subscribe_private(const std::string& channel, const std::string& inst_type = "ANY");
+    void set_login_callback(LoginCallback callback);
+    LoginState login_state() const { return login_state_.load(); }
+    bool is_logged_in() const { return login_state_.load() == LoginState::LoggedIn; }
+    // WebSocket 下单/撤单/改单，登录后使用；断线时在途请求以 code "disconnected" 完成
+    OrderEntry& order_entry() { return order_entry_; }
+
+    // 协程接口: 等待者在 set_executor 指定的执行器线程上恢复，未设置时在服务线程上直接恢复
+    class ConnectionAwaiter {
+    public:
+        ConnectionAwaiter(OKXWebSocketClient& client, bool want_connected) : client_(client), want_connected_(want_connected) {}
+        bool await_ready() const { return client_.connected_ == want_connected_; }
+        bool await_suspend(std::coroutine_handle<> handle) { return client_.add_connection_waiter(handle, want_connected_); }
+        // 等到期望状态返回 true；被 disconnect() 或连接失败唤醒时返回 false
+        bool await_resume() const { return client_.connected_ == want_connected_; }
+
+    private:
+        OKXWebSocketClient& client_;
+        bool want_connected_;
+    };
+
+    class SubscribeAwaiter {
+    public:
+        SubscribeAwaiter(OKXWebSocketClient& client, std::string channel, std::string inst_id)
+            : client_(client), channel_(std::move(channel)), inst_id_(std::move(inst_id)) {}
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) { return client_.begin_subscribe(*this, handle); }
+        SubscribeAck await_resume() { return std::move(result_); }
+
+    private:
+        friend class OKXWebSocketClient;
+        OKXWebSocketClient& client_;
+        std::string channel_;
+        std::string inst_id_;
+        SubscribeAck result_;
+    };
+
+    void set_executor(CoroExecutor* executor) { executor_ = executor; }
+    // co_await connected(): 已连接立即返回，否则等到下一次连接建立（包括自动重连）
+    ConnectionAwaiter connected() { return ConnectionAwaiter(*this, true); }
+    ConnectionAwaiter disconnected() { return ConnectionAwaiter(*this, false); }
+    // co_await subscribe(): 发送订阅并等待对应的 subscribe/error 回执
+    SubscribeAwaiter subscribe(const std::string& channel, const std::string& inst_id) {
+        return SubscribeAwaiter(*this, channel, inst_id);
+    }
+    // 单交易对 ticker 流: while (auto* tick = co_await stream.next()) {...}
+    // 满时丢弃最旧的 ticker；新交易对的流需在 connect() 之前创建，运行中创建抛 std::logic_error；客户端析构时关闭
+    TickStream& ticks(const std::string& inst_id, size_t capacity = 256);
+
+    // 为声明了 ChannelSchema 的频道注册回调，同一频道再次设置会替换；需在 connect() 之前调用
+    template <typename T>
+    void set_channel_callback(std::function<void(const T&)> callback);
     void run();
     bool is_connected() const;
     void enable_auto_reconnect(bool enable = true);
     void set_ping_interval(int seconds = 30);
 
+    // 热备连接: 主连接建立后再开一条连接，重放全部订阅（私有端点先登录）并保持 ping，但不分发它的数据；
+    // 主连接断开时直接提升热备，不走退避重连，随后在后台补一条新的热备。需在 connect() 之前调用
+    void enable_standby(bool enable = true);
+    // 热备已完成订阅/登录，可随时提升
+    bool standby_ready() const { return standby_ready_.load(); }
+
+    // 单交易对行情新鲜度检测；第一次启用会给 ticker 流水线加一个阶段，需在 connect() 之前调用
+    void enable_staleness_detection(bool enable = true, StaleAction action = StaleAction::Notify);
+    void set_stale_threshold(const std::string& inst_type, int threshold_ms);
+    void set_default_stale_threshold(int threshold_ms);
+    void set_stale_callback(StalenessMonitor::StaleCallback callback);
+
+    // 运行指标，拉取接口；start_metrics_server 在独立线程上提供 Prometheus 文本格式
+    MetricsRegistry& metrics() { return metrics_; }
+    // 按交易对计数 okx_ticker_updates_total{inst_id}，给 ticker 流水线加一个阶段；start_metrics_server 会自动启用
+    // 需在 connect() 之前调用
+    void enable_instrument_metrics();
+    bool start_metrics_server(int port, const std::string& bind_address = "127.0.0.1");
+    void stop_metrics_server();
+
+    // 当前消息的接收/分发时间戳（TscClock 读数），只在服务线程的回调中有效
+    const RxTimestamps& rx_timestamps() const { return rx_timestamps_; }
+
+    // 内核收包时间戳（SO_TIMESTAMPING），填入 rx_timestamps() 的 kernel_ns/hardware_ns，
+    // 用于区分网络延迟与 TLS/lws 处理耗时。只有 TLS 连接能取到时间戳；需在 connect() 之前调用
+    void enable_rx_timestamping(const RxTimestampingConfig& config = {});
+    // 当前主连接的时间戳状态，在服务线程回调中或 disconnect() 之后读取
+    RxTimestampingStatus rx_timestamping_status() const;
+
+    // 服务线程的绑核/调度/NUMA/忙轮询设置，需在 connect() 之前调用
+    void set_thread_config(const ThreadConfig& config);
+    const ThreadConfig& thread_config() const { return thread_config_; }
+
+    // 延迟模式: connect() 时预分配并预触重组缓冲区、解析 arena、发送帧和服务线程栈，
+    // 可选大页与 mlockall；需在 connect() 之前调用，结果见 latency_report()
+    void set_latency_mode(const LatencyConfig& config);
+    const LatencyReport& latency_report() const { return latency_report_; }
+
+    // io_uring 传输的环大小与接收缓冲区，需在 connect() 之前调用
+    void set_uring_config(const UringTransportConfig& config) { uring_config_ = config; }
+    Transport transport() const { return transport_; }
+    // io_uring 传输的收包统计，在服务线程回调中或 disconnect() 之后读取
+    UringStats uring_stats() const;
+
+    // 协商 permessage-deflate，window_bits 限制服务端压缩窗口(9-15)，需在 connect() 之前调用
+    void enable_compression(bool enable = true, int window_bits = 15);
+    CompressionStats compression_stats() const;
+
+    // 把每条ticker写入共享内存环，供同机其它进程通过 MarketBusSubscriber 读取
+    // 需在 connect() 之前调用；连接期间调用返回 false，再次调用会按新参数重建共享内存段
+    bool enable_market_bus(const std::string& name, size_t slot_count = 4096);
+    // 每个品种的最新 ticker 写入 mmap 检查点文件，启动时立即从文件恢复，恢复的记录在收到实时更新前标记为陈旧；
+    // 每 sync_interval_ms 异步回写一次脏页。需在 connect() 之前调用，运行中调用返回 false
+    bool enable_checkpoint(const std::string& path, size_t capacity = 4096, int sync_interval_ms = 1000);
+    const TickCheckpoint* checkpoint() const { return checkpoint_.get(); }
+    // 在服务线程上把 ticker 聚合为多周期K线，每条消息处理完后成批回调；需在 connect() 之前调用，
+    // 只能启用一次，运行中或重复调用返回 false，不改动已有配置
+    bool enable_bar_aggregation(std::vector<int64_t> intervals_ms, BarAggregator::BarCallback callback, int64_t grace_ms = 250);
+
     // 代理设置
     void set_http_proxy(const std::string& proxy_host, int proxy_port, const std::string& username = "", const std::string& password = "");
     void set_socks_proxy(const std::string& proxy_host, int proxy_port, const std::string& username = "", const std::string& password = "");
     void clear_proxy();
 
     static int callback_function(struct lws* wsi, enum lws_callback_reasons reason, void* user, void* in, size_t len);
+    static int extension_callback(struct lws_context* context, const struct lws_extension* ext, struct lws* wsi,
+                                  enum lws_extension_callback_reasons reason, void* user, void* in, size_t len);
 
 private:
     struct lws_context* context_;
@@ -38,17 +209,55 @@ private:
     struct lws_client_connect_info ccinfo_;
 
     std::unique_ptr<TickerHandler> ticker_handler_;
+    FieldMask ticker_fields_;
     std::atomic<bool> connected_;
     std::atomic<bool> should_run_;
     std::thread worker_thread_;
+    ThreadConfig thread_config_;
+    RxTimestamps rx_timestamps_;
+
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+    };
+
+    // 注册表先于端点构造，端点先析构
+    MetricsRegistry metrics_;
+    std::unique_ptr<MetricsServer> metrics_server_;
+    MetricCounter* messages_received_;
+    MetricCounter* bytes_received_;
+    MetricCounter* parse_failures_;
+    MetricCounter* unhandled_messages_;
+    MetricCounter* messages_sent_;
+    MetricCounter* send_failures_;
+    MetricCounter* reconnects_;
+    MetricCounter* stale_events_;
+    MetricGauge* send_queue_depth_;
+    MetricGauge* connected_gauge_;
+    bool instrument_stage_added_;
+    // 每个交易对的更新计数，只在服务线程访问
+    std::unordered_map<std::string, MetricCounter*, StringHash, std::equal_to<>> instrument_updates_;
+    // arg.channel -> 处理 data 数组的回调，每条消息只取一次频道名再查表
+    std::unordered_map<std::string, std::function<void(std::string_view)>, StringHash, std::equal_to<>> channel_handlers_;
 
     std::queue<std::string> send_queue_;
+    // 已发送帧的字符串回收复用，稳态下入队不分配内存
+    std::vector<std::string> spare_frames_;
     std::mutex queue_mutex_;
+    // 只在服务线程使用，带 LWS_PRE 头部空间
+    std::vector<unsigned char> write_buffer_;
     std::condition_variable queue_cv_;
 
     std::string host_;
     int port_;
     std::string path_;
+    bool use_ssl_;
+    Transport transport_;
+
+    // io_uring 传输，只在服务线程使用；发送队列入队后写 eventfd 唤醒服务线程
+    UringTransportConfig uring_config_;
+    std::unique_ptr<UringTransport> uring_;
+    int uring_wake_fd_;
 
     bool auto_reconnect_;
     int ping_interval_;
@@ -56,6 +265,10 @@ private:
     std::chrono::steady_clock::time_point last_pong_;
     int reconnect_attempts_;
     static constexpr int max_reconnect_attempts_ = 10;
+    // libwebsockets 下的重连由服务循环在到期后发起，回调里只记下时间
+    bool reconnect_pending_;
+    std::chrono::steady_clock::time_point reconnect_at_;
+    static constexpr size_t kMaxSpareFrames = 64;
 
     // 代理配置
     std::string proxy_host_;
@@ -65,13 +278,154 @@ private:
     bool use_http_proxy_;
     bool use_socks_proxy_;
 
-    void send_message(const std::string& message);
+    // 新鲜度检测，时间轮只在持锁时访问
+    StalenessMonitor staleness_monitor_;
+    std::mutex staleness_mutex_;
+    std::atomic<bool> staleness_enabled_;
+    bool staleness_stage_added_;
+    StaleAction stale_action_;
+    StalenessMonitor::StaleCallback stale_callback_;
+    // poll 持锁期间到期的事件先拷贝到这里，解锁后再交付，回调里可以调用上面的设置接口
+    struct PendingStale {
+        std::string inst_id;
+        std::string inst_type;
+        int64_t age_ms = 0;
+        uint32_t consecutive = 0;
+    };
+    std::vector<PendingStale> stale_pending_;
+    size_t stale_pending_count_;
+
+    std::unique_ptr<MarketBusPublisher> market_bus_;
+    std::unique_ptr<TickCheckpoint> checkpoint_;
+    int checkpoint_sync_ms_;
+    std::chrono::steady_clock::time_point checkpoint_synced_;
+    std::unique_ptr<BarAggregator> bar_aggregator_;
+
+    // 私有频道登录，signer_ 只在服务线程使用
+    std::string api_key_;
+    std::string passphrase_;
+    HmacSigner signer_;
+    std::atomic<LoginState> login_state_;
+    LoginCallback login_callback_;
+    std::mutex private_mutex_;
+    std::vector<std::pair<std::string, std::string>> private_subscriptions_;  // channel, instType
+    MetricCounter* login_failures_;
+    OrderEntry order_entry_;
+
+    // 协程等待者
+    struct PendingAck {
+        uint64_t id;
+        SubscribeAwaiter* awaiter;
+        std::coroutine_handle<> handle;
+    };
+    CoroExecutor* executor_;
+    std::mutex coro_mutex_;
+    std::vector<std::coroutine_handle<>> connect_waiters_;
+    std::vector<std::coroutine_handle<>> disconnect_waiters_;
+    std::vector<PendingAck> pending_acks_;
+    std::atomic<size_t> pending_ack_count_;
+    std::unordered_map<std::string, std::unique_ptr<TickStream>, StringHash, std::equal_to<>> tick_streams_;
+
+    // permessage-deflate，解压状态由 lws 按连接保留（context takeover）
+    bool compression_enabled_;
+    int compression_window_bits_;
+    std::string compression_offer_;
+    struct lws_extension extensions_[2];
+    std::atomic<bool> compression_negotiated_;
+    std::atomic<uint64_t> compressed_bytes_;
+    std::atomic<uint64_t> inflated_bytes_;
+    std::atomic<uint64_t> inflate_ns_;
+    std::atomic<uint64_t> inflate_calls_;
+
+    // 分片消息重组，只在服务线程使用；未开启延迟模式时首次收到分片才映射
+    bool latency_enabled_;
+    LatencyConfig latency_config_;
+    LatencyReport latency_report_;
+    HotRegion rx_region_;
+    size_t rx_length_;
+    bool rx_overflow_;
+    MetricCounter* rx_oversize_;
+
+    // 每条连接一个时间戳读 BIO，热备提升时随连接交换
+    bool rx_timestamping_;
+    RxTimestampingConfig rx_timestamping_config_;
+    std::unique_ptr<RxTimestamper> rx_stamper_;
+    std::unique_ptr<RxTimestamper> standby_stamper_;
+    void attach_rx_stamper(struct lws* wsi, std::unique_ptr<RxTimestamper>& stamper);
+    void stamp_receive();
+
+    // 公共频道订阅记录，热备连接建立时按此重放
+    std::mutex subscriptions_mutex_;
+    std::vector<std::pair<std::string, std::string>> subscriptions_;  // channel, instId
+
+    // 热备连接，除标注外只在服务线程访问；发送队列由 queue_mutex_ 保护
+    bool standby_enabled_;
+    struct lws* standby_wsi_;
+    bool standby_established_;              // subscriptions_mutex_ 保护
+    std::atomic<bool> standby_ready_;
+    std::atomic<bool> standby_logged_in_;   // private_mutex_ 下切换
+    std::atomic<int> standby_pending_;      // 尚未收到回执的订阅/登录请求
+    std::vector<std::string> standby_queue_;
+    std::atomic<bool> standby_queued_;
+    std::string standby_rx_;
+    TickerBatch standby_batch_;
+    FailoverGapCounter gap_counter_;
+    int standby_failures_;
+    std::chrono::steady_clock::time_point standby_retry_at_;
+    std::chrono::steady_clock::time_point standby_last_ping_;
+    std::chrono::steady_clock::time_point standby_last_pong_;
+    MetricCounter* failovers_;
+    MetricCounter* failover_missed_;
+    MetricCounter* failover_duplicates_;
+    MetricGauge* standby_gauge_;
+
+    void send_message(std::string_view message);
     void handle_connection_established();
     void handle_connection_closed();
-    void handle_receive(const std::string& data);
+    void handle_fragment(struct lws* wsi, const char* data, size_t len);
+    void handle_receive(std::string_view data);
+    bool dispatch_channel(std::string_view message);
+    void warm_up();
     void worker_loop();
+    void uring_loop();
+    bool open_uring();
+    void poll_monitors();
     void process_send_queue();
     void attempt_reconnect();
+    void reopen_connection();
     void send_ping();
+    void remember_subscription(const std::string& channel, const std::string& inst_id);
+    void send_standby(std::string message);
+    void open_standby();
+    void service_standby(std::chrono::steady_clock::time_point now);
+    int handle_standby_event(struct lws* wsi, enum lws_callback_reasons reason, void* in, size_t len);
+    void handle_standby_established();
+    void handle_standby_message(std::string_view data);
+    void process_standby_queue();
+    void standby_lost();
+    bool promote_standby();
     bool should_reconnect() const;
-};
\ No newline at end of file
+    void handle_stale(const StaleEvent& event, StaleAction action, const StalenessMonitor::StaleCallback& callback);
+    bool add_connection_waiter(std::coroutine_handle<> handle, bool want_connected);
+    bool begin_subscribe(SubscribeAwaiter& awaiter, std::coroutine_handle<> handle);
+    bool handle_subscribe_ack(std::string_view data);
+    void wake_connection_waiters(bool connected);
+    void fail_pending_acks(const char* code, const char* msg);
+    void resume(std::coroutine_handle<> handle);
+    void send_login();
+    bool handle_login_response(std::string_view data);
+    void send_private_subscriptions();
+    void register_metrics();
+    MetricCounter& instrument_counter(std::string_view inst_id);
+};
+
+template <typename T>
+void OKXWebSocketClient::set_channel_callback(std::function<void(const T&)> callback) {
+    channel_handlers_[std::string(SchemaCodec<T>::channel())] =
+        [callback = std::move(callback), items = std::vector<T>()](std::string_view data) mutable {
+            SchemaCodec<T>::parse_data(data, items);
+            for (const auto& item : items) {
+                callback(item);
+            }
+        };
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "order_entry.h"
+#include "json_parser.h"
+#include "json_scanner.h"
+#include "tsc_clock.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// 在固定缓冲区上顺序拼接，越界或字段值非法后不再写入，finish() 返回 0
+class FrameWriter {
+public:
+    FrameWriter(char* out, size_t capacity) : out_(out), capacity_(capacity), length_(0), failed_(false) {}
+
+    void append(std::string_view text) {
+        if (failed_ || text.size() > capacity_ - length_) {
+            failed_ = true;
+            return;
+        }
+        memcpy(out_ + length_, text.data(), text.size());
+        length_ += text.size();
+    }
+
+    void append(uint64_t value) {
+        char digits[20];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(std::string_view(digits, result.ptr - digits));
+    }
+
+    // 调用方给的字段值不转义，直接写在引号内；OKX 的 id、价格、数量都只用字母数字和 -._，
+    // 含引号、反斜杠或控制字符的值会破坏帧或注入额外字段，整帧作废
+    void value(std::string_view text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+                failed_ = true;
+                return;
+            }
+        }
+        append(text);
+    }
+
+    // 可选字段: 值为空时整段省略
+    void optional(std::string_view key_fragment, std::string_view text) {
+        if (text.empty()) return;
+        append(key_fragment);
+        value(text);
+        append("\"");
+    }
+
+    size_t finish() const { return failed_ ? 0 : length_; }
+
+private:
+    char* out_;
+    size_t capacity_;
+    size_t length_;
+    bool failed_;
+};
+
+bool parse_op(std::string_view op, OrderOp& out) {
+    if (op == "order") out = OrderOp::Place;
+    else if (op == "cancel-order") out = OrderOp::Cancel;
+    else if (op == "amend-order") out = OrderOp::Amend;
+    else return false;
+    return true;
+}
+
+}
+
+InFlightTable::InFlightTable(size_t capacity) : limit_(capacity > 0 ? capacity : 1), size_(0) {
+    size_t slots = 2;
+    while (slots < limit_ * 2) slots <<= 1;
+    slots_.resize(slots);
+    mask_ = slots - 1;
+}
+
+bool InFlightTable::insert(uint64_t id, OrderOp op, uint64_t sent_ticks) {
+    if (id == 0 || size_ >= limit_) return false;
+    size_t index = home(id);
+    while (slots_[index].id != 0) {
+        if (slots_[index].id == id) return false;
+        index = (index + 1) & mask_;
+    }
+    slots_[index] = {id, sent_ticks, op};
+    ++size_;
+    return true;
+}
+
+bool InFlightTable::remove(uint64_t id, Entry& out) {
+    if (id == 0) return false;
+    size_t index = home(id);
+    while (slots_[index].id != id) {
+        if (slots_[index].id == 0) return false;
+        index = (index + 1) & mask_;
+    }
+    out = slots_[index];
+
+    // 回移: 后继元素的理想槽位不在 (空洞, 当前] 区间内时前移填洞
+    size_t hole = index;
+    size_t next = (index + 1) & mask_;
+    while (slots_[next].id != 0) {
+        size_t ideal = home(slots_[next].id);
+        bool stays = hole <= next ? (hole < ideal && ideal <= next) : (hole < ideal || ideal <= next);
+        if (!stays) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+        next = (next + 1) & mask_;
+    }
+    slots_[hole] = Entry{};
+    --size_;
+    return true;
+}
+
+OrderEntry::OrderEntry(size_t max_in_flight)
+    : table_(max_in_flight), in_flight_(0), sent_(0), succeeded_(0), rejected_(0), send_failures_(0), unmatched_(0) {}
+
+size_t OrderEntry::serialize(uint64_t id, const OrderRequest& request, char* out, size_t capacity) {
+    FrameWriter frame(out, capacity);
+    frame.append("{\"id\":\"");
+    frame.append(id);
+    frame.append("\",\"op\":\"order\",\"args\":[{\"instId\":\"");
+    frame.value(request.inst_id);
+    frame.append("\",\"tdMode\":\"");
+    frame.value(request.td_mode);
+    frame.append("\",\"side\":\"");
+    frame.value(request.side);
+    frame.append("\",\"ordType\":\"");
+    frame.value(request.ord_type);
+    frame.append("\",\"sz\":\"");
+    frame.value(request.sz);
+    frame.append("\"");
+    frame.optional(",\"px\":\"", request.px);
+    frame.optional(",\"clOrdId\":\"", request.cl_ord_id);
+    frame.optional(",\"posSide\":\"", request.pos_side);
+    frame.optional(",\"tag\":\"", request.tag);
+    if (request.reduce_only) frame.append(",\"reduceOnly\":true");
+    frame.append("}]}");
+    return frame.finish();
+}
+
+size_t OrderEntry::serialize(uint64_t id, const CancelRequest& request, char* out, size_t capacity) {
+    FrameWriter frame(out, capacity);
+    frame.append("{\"id\":\"");
+    frame.append(id);
+    frame.append("\",\"op\":\"cancel-order\",\"args\":[{\"instId\":\"");
+    frame.value(request.inst_id);
+    frame.append("\"");
+    frame.optional(",\"ordId\":\"", request.ord_id);
+    frame.optional(",\"clOrdId\":\"", request.cl_ord_id);
+    frame.append("}]}");
+    return frame.finish();
+}
+
+size_t OrderEntry::serialize(uint64_t id, const AmendRequest& request, char* out, size_t capacity) {
+    FrameWriter frame(out, capacity);
+    frame.append("{\"id\":\"");
+    frame.append(id);
+    frame.append("\",\"op\":\"amend-order\",\"args\":[{\"instId\":\"");
+    frame.value(request.inst_id);
+    frame.append("\"");
+    frame.optional(",\"ordId\":\"", request.ord_id);
+    frame.optional(",\"clOrdId\":\"", request.cl_ord_id);
+    frame.optional(",\"newSz\":\"", request.new_sz);
+    frame.optional(",\"newPx\":\"", request.new_px);
+    frame.append("}]}");
+    return frame.finish();
+}
+
+uint64_t OrderEntry::place(const OrderRequest& request) {
+    return submit(OrderOp::Place, request);
+}
+
+uint64_t OrderEntry::cancel(const CancelRequest& request) {
+    return submit(OrderOp::Cancel, request);
+}
+
+uint64_t OrderEntry::amend(const AmendRequest& request) {
+    return submit(OrderOp::Amend, request);
+}
+
+template <typename Request>
+uint64_t OrderEntry::submit(OrderOp op, const Request& request) {
+    uint64_t id = JsonParser::next_request_id();
+    char frame[kMaxFrame];
+    size_t length = serialize(id, request, frame, sizeof(frame));
+    if (length == 0 || !sender_) {
+        send_failures_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    // 先登记再发送，应答不会早于登记到达
+    {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        if (!table_.insert(id, op, TscClock::now())) {
+            send_failures_.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        in_flight_.store(table_.size(), std::memory_order_relaxed);
+    }
+
+    if (!sender_(std::string_view(frame, length))) {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        InFlightTable::Entry entry;
+        table_.remove(id, entry);
+        in_flight_.store(table_.size(), std::memory_order_relaxed);
+        send_failures_.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+bool OrderEntry::handle_response(std::string_view message) {
+    // OKX 的下单应答以 id 开头，行情推送以 arg 开头，先按前缀快速排除
+    if (!message.starts_with("{\"id\":\"")) return false;
+
+    std::string_view id_text;
+    std::string_view op_text;
+    std::string_view data;
+    OrderResult result{};
+    JsonScanner::for_each_member(message, [&](std::string_view key, std::string_view value, bool) {
+        if (key == "id") id_text = value;
+        else if (key == "op") op_text = value;
+        else if (key == "code") result.code = value;
+        else if (key == "msg") result.msg = value;
+        else if (key == "data") data = value;
+        return true;
+    });
+
+    // 带 id 的订阅回执没有 op
+    if (!parse_op(op_text, result.op)) return false;
+
+    uint64_t id = 0;
+    std::from_chars(id_text.data(), id_text.data() + id_text.size(), id);
+
+    InFlightTable::Entry entry;
+    bool found;
+    {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        found = table_.remove(id, entry);
+        in_flight_.store(table_.size(), std::memory_order_relaxed);
+    }
+    if (!found) {
+        unmatched_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 单笔请求只取第一个元素
+    JsonScanner::for_each_element(data, [&](std::string_view element) {
+        JsonScanner::for_each_member(element, [&](std::string_view key, std::string_view value, bool) {
+            if (key == "ordId") result.ord_id = value;
+            else if (key == "clOrdId") result.cl_ord_id = value;
+            else if (key == "sCode") result.s_code = value;
+            else if (key == "sMsg") result.s_msg = value;
+            return true;
+        });
+        return false;
+    });
+
+    result.request_id = id;
+    result.success = result.code == "0" && (result.s_code.empty() || result.s_code == "0");
+    result.rtt_ns = TscClock::ticks_to_ns(TscClock::now() - entry.sent_ticks);
+    complete(result);
+    return true;
+}
+
+void OrderEntry::fail_all(std::string_view code, std::string_view msg) {
+    std::vector<InFlightTable::Entry> pending;
+    {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        table_.drain([&](const InFlightTable::Entry& entry) { pending.push_back(entry); });
+        in_flight_.store(0, std::memory_order_relaxed);
+    }
+
+    // 回调在锁外调用，允许在回调里重新下单
+    uint64_t now = TscClock::now();
+    for (const auto& entry : pending) {
+        OrderResult result{};
+        result.request_id = entry.id;
+        result.op = entry.op;
+        result.success = false;
+        result.code = code;
+        result.msg = msg;
+        result.rtt_ns = TscClock::ticks_to_ns(now - entry.sent_ticks);
+        complete(result);
+    }
+}
+
+void OrderEntry::complete(const OrderResult& result) {
+    (result.success ? succeeded_ : rejected_).fetch_add(1, std::memory_order_relaxed);
+    if (completion_) {
+        completion_(result);
+    }
+}
+
+OrderEntryStats OrderEntry::stats() const {
+    return {sent_.load(), succeeded_.load(), rejected_.load(), send_failures_.load(), unmatched_.load()};
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// WebSocket 下单/撤单/改单（需先登录 /ws/v5/private）
+// 请求帧由固定模板片段拼接，只填入可变字段；应答按请求 id 匹配并测量往返时间
+
+enum class OrderOp : uint8_t { Place, Cancel, Amend };
+
+// 字段按 OKX 原样传递，不做转义；可选字段为空时不发送
+struct OrderRequest {
+    std::string_view inst_id;
+    std::string_view td_mode = "cash";
+    std::string_view side;
+    std::string_view ord_type;
+    std::string_view sz;
+    std::string_view px;
+    std::string_view cl_ord_id;
+    std::string_view pos_side;
+    std::string_view tag;
+    bool reduce_only = false;
+};
+
+// ord_id 与 cl_ord_id 二选一
+struct CancelRequest {
+    std::string_view inst_id;
+    std::string_view ord_id;
+    std::string_view cl_ord_id;
+};
+
+struct AmendRequest {
+    std::string_view inst_id;
+    std::string_view ord_id;
+    std::string_view cl_ord_id;
+    std::string_view new_sz;
+    std::string_view new_px;
+};
+
+// 应答结果，字符串字段指向接收缓冲区，只在回调期间有效
+struct OrderResult {
+    uint64_t request_id;
+    OrderOp op;
+    bool success;               // code 与 sCode 均为 "0"
+    std::string_view code;      // 请求级错误码
+    std::string_view msg;
+    std::string_view s_code;    // 单笔订单错误码，如 51008 余额不足
+    std::string_view s_msg;
+    std::string_view ord_id;
+    std::string_view cl_ord_id;
+    int64_t rtt_ns;             // 入队到收到应答
+};
+
+struct OrderEntryStats {
+    uint64_t sent;
+    uint64_t succeeded;
+    uint64_t rejected;
+    uint64_t send_failures;     // 未连接、在途表已满或字段含引号/反斜杠/控制字符
+    uint64_t unmatched;         // 未找到对应请求的应答
+};
+
+// 固定容量开放寻址表: 线性探测，删除时回移后继元素，不留墓碑
+class InFlightTable {
+public:
+    struct Entry {
+        uint64_t id = 0;        // 0 表示空槽
+        uint64_t sent_ticks = 0;
+        OrderOp op = OrderOp::Place;
+    };
+
+    // capacity 为最多在途数；槽位数取不小于其两倍的 2 的幂，装载率不超过一半
+    explicit InFlightTable(size_t capacity);
+
+    bool insert(uint64_t id, OrderOp op, uint64_t sent_ticks);
+    bool remove(uint64_t id, Entry& out);
+    template <typename Fn>
+    void drain(Fn&& fn);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return limit_; }
+
+private:
+    std::vector<Entry> slots_;
+    size_t mask_;
+    size_t limit_;
+    size_t size_;
+
+    size_t home(uint64_t id) const { return ((id * 0x9E3779B97F4A7C15ULL) >> 32) & mask_; }
+};
+
+template <typename Fn>
+void InFlightTable::drain(Fn&& fn) {
+    for (auto& slot : slots_) {
+        if (slot.id != 0) {
+            fn(static_cast<const Entry&>(slot));
+            slot = Entry{};
+        }
+    }
+    size_ = 0;
+}
+
+class OrderEntry {
+public:
+    using Sender = std::function<bool(std::string_view)>;
+    using Completion = std::function<void(const OrderResult&)>;
+
+    static constexpr size_t kMaxFrame = 1024;
+
+    explicit OrderEntry(size_t max_in_flight = 1024);
+
+    // sender 把帧交给发送路径，返回 false 表示未连接
+    void set_sender(Sender sender) { sender_ = std::move(sender); }
+    void set_completion(Completion completion) { completion_ = std::move(completion); }
+
+    // 返回请求 id，失败返回 0；可在任意线程调用
+    uint64_t place(const OrderRequest& request);
+    uint64_t cancel(const CancelRequest& request);
+    uint64_t amend(const AmendRequest& request);
+
+    // 服务线程: 是下单应答则完成对应请求并返回 true
+    bool handle_response(std::string_view message);
+    // 连接断开时以 code 完成所有在途请求
+    void fail_all(std::string_view code, std::string_view msg);
+
+    size_t in_flight() const { return in_flight_.load(std::memory_order_relaxed); }
+    OrderEntryStats stats() const;
+
+    // 把请求写入 out，返回长度；超出 capacity 或字段值含需要 JSON 转义的字符时返回 0
+    static size_t serialize(uint64_t id, const OrderRequest& request, char* out, size_t capacity);
+    static size_t serialize(uint64_t id, const CancelRequest& request, char* out, size_t capacity);
+    static size_t serialize(uint64_t id, const AmendRequest& request, char* out, size_t capacity);
+
+private:
+    Sender sender_;
+    Completion completion_;
+
+    std::mutex table_mutex_;
+    InFlightTable table_;
+    std::atomic<size_t> in_flight_;
+
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> succeeded_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<uint64_t> send_failures_;
+    std::atomic<uint64_t> unmatched_;
+
+    template <typename Request>
+    uint64_t submit(OrderOp op, const Request& request);
+    void complete(const OrderResult& result);
+};
@@ -0,0 +1,243 @@
+#include "replay_engine.h"
+#include "ticker_fields.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+// 只读映射整个文件
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() {
+        if (data_) munmap(const_cast<char*>(data_), size_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Cannot open replay file " << path << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                std::cerr << "Cannot map replay file " << path << ": " << strerror(errno) << std::endl;
+                ok = false;
+            } else {
+                data_ = static_cast<const char*>(addr);
+                size_ = st.st_size;
+                // 块内顺序读
+                madvise(addr, size_, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    std::string_view view() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+struct Chunk {
+    uint32_t file;
+    size_t begin;
+    size_t end;
+};
+
+// 有序交付时用来重新定位一条 ticker
+struct TickRef {
+    int64_t ts;
+    uint64_t offset;        // 行首在文件中的位置
+    uint32_t length;
+    uint32_t file;
+    uint32_t index;         // 行内第几个 ticker
+    uint32_t padding;
+};
+
+bool operator<(const TickRef& a, const TickRef& b) {
+    if (a.ts != b.ts) return a.ts < b.ts;
+    if (a.file != b.file) return a.file < b.file;
+    if (a.offset != b.offset) return a.offset < b.offset;
+    return a.index < b.index;
+}
+
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+};
+
+using RefMap = std::unordered_map<std::string, std::vector<TickRef>, StringHash, std::equal_to<>>;
+
+struct alignas(64) WorkerState {
+    TickerBatch batch;
+    RefMap refs;
+    uint64_t messages = 0;
+    uint64_t tickers = 0;
+    uint64_t skipped = 0;
+    uint64_t ordered = 0;
+};
+
+// 在 limit 之后的第一个换行处结束，保证块只含完整的行
+std::vector<Chunk> split(uint32_t file, std::string_view data, size_t chunk_bytes) {
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    while (begin < data.size()) {
+        size_t end = std::min(data.size(), begin + std::max<size_t>(chunk_bytes, 1));
+        if (end < data.size()) {
+            size_t newline = data.find('\n', end - 1);
+            end = newline == std::string_view::npos ? data.size() : newline + 1;
+        }
+        chunks.push_back({file, begin, end});
+        begin = end;
+    }
+    return chunks;
+}
+
+template <typename Fn>
+void for_each_line(std::string_view data, size_t begin, size_t end, Fn&& fn) {
+    while (begin < end) {
+        size_t newline = data.find('\n', begin);
+        size_t line_end = newline == std::string_view::npos || newline > end ? end : newline;
+        std::string_view line = data.substr(begin, line_end - begin);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) fn(begin, line);
+        begin = line_end + 1;
+    }
+}
+
+int64_t parse_ts(std::string_view ts) {
+    int64_t value = 0;
+    std::from_chars(ts.data(), ts.data() + ts.size(), value);
+    return value;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+ReplayEngine::ReplayEngine(ReplayConfig config)
+    : config_(std::move(config)), pool_(config_.threads, config_.cpus), stats_{} {}
+
+void ReplayEngine::add_handler(Handler handler, bool ordered) {
+    (ordered ? ordered_handlers_ : handlers_).push_back(std::move(handler));
+}
+
+bool ReplayEngine::run(const std::vector<std::string>& files) {
+    stats_ = ReplayStats{};
+    stats_.threads = pool_.size();
+    stats_.files = files.size();
+
+    std::vector<std::unique_ptr<MappedFile>> mapped;
+    std::vector<Chunk> chunks;
+    for (const auto& path : files) {
+        auto file = std::make_unique<MappedFile>();
+        if (!file->open(path)) return false;
+        auto file_chunks = split(static_cast<uint32_t>(mapped.size()), file->view(), config_.chunk_bytes);
+        chunks.insert(chunks.end(), file_chunks.begin(), file_chunks.end());
+        stats_.bytes += file->view().size();
+        mapped.push_back(std::move(file));
+    }
+    stats_.chunks = chunks.size();
+
+    bool ordered = !ordered_handlers_.empty();
+    FieldMask fields = ordered ? config_.fields | TickerField::Ts : config_.fields;
+    std::vector<std::unique_ptr<WorkerState>> workers;
+    for (size_t i = 0; i < pool_.size(); ++i) workers.push_back(std::make_unique<WorkerState>());
+    uint64_t steals_before = pool_.stats().stolen;
+
+    // 第一阶段: 按块并行解析，无序 handler 直接处理，有序的只记位置
+    auto parse_start = std::chrono::steady_clock::now();
+    std::vector<WorkStealingPool::Job> jobs;
+    jobs.reserve(chunks.size());
+    for (const Chunk& chunk : chunks) {
+        jobs.push_back([&, chunk](size_t worker) {
+            WorkerState& state = *workers[worker];
+            std::string_view data = mapped[chunk.file]->view();
+            for_each_line(data, chunk.begin, chunk.end, [&](size_t offset, std::string_view line) {
+                state.messages++;
+                if (!JsonParser::parse_ticker_data_into(line, state.batch, config_.mode, fields)) {
+                    state.skipped++;
+                    return;
+                }
+                for (uint32_t i = 0; i < state.batch.size(); ++i) {
+                    const TickerView& ticker = state.batch[i];
+                    for (const auto& handler : handlers_) handler(ticker, worker);
+                    if (!ordered) continue;
+                    auto it = state.refs.find(ticker.inst_id);
+                    if (it == state.refs.end()) it = state.refs.emplace(std::string(ticker.inst_id), std::vector<TickRef>{}).first;
+                    it->second.push_back({parse_ts(ticker.ts), offset, static_cast<uint32_t>(line.size()), chunk.file, i, 0});
+                    state.ordered++;
+                }
+                state.tickers += state.batch.size();
+            });
+        });
+    }
+    pool_.run(std::move(jobs));
+    stats_.parse_seconds = seconds_since(parse_start);
+
+    // 第二阶段: 每个交易对一个任务，合并各 worker 的记录后排序交付
+    auto merge_start = std::chrono::steady_clock::now();
+    if (ordered) {
+        RefMap merged;
+        for (auto& state : workers) {
+            for (auto& [inst_id, refs] : state->refs) {
+                auto& target = merged[inst_id];
+                if (target.empty()) target = std::move(refs);
+                else target.insert(target.end(), refs.begin(), refs.end());
+            }
+            state->refs.clear();
+        }
+
+        jobs.clear();
+        for (auto& entry : merged) {
+            jobs.push_back([&, refs = &entry.second, inst_id = std::string_view(entry.first)](size_t worker) {
+                std::sort(refs->begin(), refs->end());
+                TickerBatch& batch = workers[worker]->batch;
+                const TickRef* parsed = nullptr;
+                for (const TickRef& ref : *refs) {
+                    // 同一行的多个 ticker 只解析一次
+                    if (!parsed || parsed->file != ref.file || parsed->offset != ref.offset) {
+                        std::string_view line = mapped[ref.file]->view().substr(ref.offset, ref.length);
+                        JsonParser::parse_ticker_data_into(line, batch, config_.mode, fields);
+                        parsed = &ref;
+                    }
+                    if (ref.index >= batch.size() || batch[ref.index].inst_id != inst_id) continue;
+                    for (const auto& handler : ordered_handlers_) handler(batch[ref.index], worker);
+                }
+            });
+        }
+        pool_.run(std::move(jobs));
+    }
+    stats_.merge_seconds = seconds_since(merge_start);
+
+    for (const auto& state : workers) {
+        stats_.messages += state->messages;
+        stats_.tickers += state->tickers;
+        stats_.skipped += state->skipped;
+        stats_.ordered_ticks += state->ordered;
+    }
+    stats_.steals = pool_.stats().stolen - steals_before;
+    double total = stats_.parse_seconds + stats_.merge_seconds;
+    stats_.messages_per_sec = total > 0 ? stats_.messages / total : 0;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "json_parser.h"
+#include "work_stealing_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 多文件并行回放: 抓包文件每行一帧（与 MockServerConfig::replay_file 相同格式），
+// 文件按行边界切块后交给工作窃取线程池解析；解析器无共享状态，吞吐随核数线性增长
+
+struct ReplayConfig {
+    size_t threads = 0;                 // 0 取硬件线程数
+    std::vector<int> cpus;              // worker i 绑到 cpus[i % cpus.size()]，空表示不绑
+    size_t chunk_bytes = 4 << 20;       // 切块大小，块是窃取的最小单位
+    ParseMode mode = ParseMode::Fast;
+    FieldMask fields = kAllFields;      // 有有序 handler 时自动加上 ts
+};
+
+struct ReplayStats {
+    size_t threads;
+    size_t files;
+    size_t chunks;
+    uint64_t bytes;
+    uint64_t messages;          // 非空行
+    uint64_t tickers;
+    uint64_t skipped;           // 不含 ticker 的行（订阅回执、其他频道、格式错误）
+    uint64_t ordered_ticks;     // 缓存下来按交易对排序交付的 ticker
+    uint64_t steals;
+    double parse_seconds;
+    double merge_seconds;
+    double messages_per_sec;    // messages / (parse + merge)，即所有核合计的吞吐
+};
+
+class ReplayEngine {
+public:
+    // 视图只在调用期间有效；worker 为 [0, threads())，可用来索引每线程状态而不加锁
+    using Handler = std::function<void(const TickerView& ticker, size_t worker)>;
+
+    explicit ReplayEngine(ReplayConfig config = {});
+
+    // 无序 handler 在解析线程上直接调用，不同 worker 并发。
+    // 有序 handler 在全部文件解析完后按交易对交付: 同一交易对按 (ts, 文件顺序, 文件内位置) 排序、
+    // 在同一个 worker 上串行调用，不同交易对并发。解析阶段只记录每条 ticker 的位置（32 字节），
+    // 交付时从映射的文件中重新解析，内存不随字段数增长
+    void add_handler(Handler handler, bool ordered = false);
+
+    // 文件按传入顺序编号，作为相同 ts 的次序；有文件打不开时返回 false，不做任何回放
+    bool run(const std::vector<std::string>& files);
+
+    size_t threads() const { return pool_.size(); }
+    ReplayStats stats() const { return stats_; }
+
+private:
+    ReplayConfig config_;
+    WorkStealingPool pool_;
+    std::vector<Handler> handlers_;
+    std::vector<Handler> ordered_handlers_;
+    ReplayStats stats_;
+};
@@ -0,0 +1,184 @@
+#include "rx_timestamping.h"
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <openssl/bio.h>
+#include <openssl/ssl.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t to_ns(const timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int bio_read(BIO* bio, char* out, int length) {
+    auto* stamper = static_cast<RxTimestamper*>(BIO_get_data(bio));
+    BIO_clear_retry_flags(bio);
+    ssize_t n = stamper->receive(out, static_cast<size_t>(length));
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        BIO_set_retry_read(bio);
+    }
+    return static_cast<int>(n);
+}
+
+// SSL 的写方向仍用 lws 的 socket BIO，这里只为完整性提供
+int bio_write(BIO* bio, const char* data, int length) {
+    auto* stamper = static_cast<RxTimestamper*>(BIO_get_data(bio));
+    BIO_clear_retry_flags(bio);
+    ssize_t n = send(stamper->fd(), data, static_cast<size_t>(length), MSG_NOSIGNAL);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        BIO_set_retry_write(bio);
+    }
+    return static_cast<int>(n);
+}
+
+long bio_ctrl(BIO* bio, int command, long, void* ptr) {
+    switch (command) {
+        case BIO_C_GET_FD: {
+            // SSL_get_fd 经由读 BIO 取套接字
+            int fd = static_cast<RxTimestamper*>(BIO_get_data(bio))->fd();
+            if (ptr) *static_cast<int*>(ptr) = fd;
+            return fd;
+        }
+        case BIO_CTRL_FLUSH:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int bio_create(BIO* bio) {
+    BIO_set_init(bio, 1);
+    return 1;
+}
+
+const BIO_METHOD* bio_method() {
+    static BIO_METHOD* method = [] {
+        BIO_METHOD* m = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK | BIO_TYPE_DESCRIPTOR, "okx-rx-timestamp");
+        BIO_meth_set_read(m, bio_read);
+        BIO_meth_set_write(m, bio_write);
+        BIO_meth_set_ctrl(m, bio_ctrl);
+        BIO_meth_set_create(m, bio_create);
+        return m;
+    }();
+    return method;
+}
+
+}
+
+bool RxTimestamper::attach(int fd, ssl_st* ssl, const RxTimestampingConfig& config) {
+    fd_ = fd;
+    software_ns_ = hardware_ns_ = 0;
+    attached_ = false;
+    enabled_ = enable_socket(fd, config, error_);
+    if (!enabled_ || !ssl) {
+        return enabled_;
+    }
+
+    BIO* bio = BIO_new(bio_method());
+    if (!bio) {
+        error_ = "BIO_new failed";
+        return false;
+    }
+    BIO_set_data(bio, this);
+    // 写方向不变；旧的读 BIO 与写 BIO 是同一个对象时只释放读方向的引用
+    SSL_set0_rbio(ssl, bio);
+    attached_ = true;
+    return true;
+}
+
+RxTimestampingStatus RxTimestamper::status() const {
+    RxTimestampingStatus status;
+    status.enabled = enabled_;
+    status.attached = attached_;
+    status.reads = reads_.load(std::memory_order_relaxed);
+    status.stamped_reads = stamped_reads_.load(std::memory_order_relaxed);
+    status.error = error_;
+    return status;
+}
+
+ssize_t RxTimestamper::receive(void* buffer, size_t length) {
+    iovec iov{buffer, length};
+    alignas(cmsghdr) char control[256];
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n = recvmsg(fd_, &msg, 0);
+    if (n > 0) {
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        if (parse_control(msg, software_ns_, hardware_ns_)) {
+            stamped_reads_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return n;
+}
+
+bool RxTimestamper::enable_socket(int fd, const RxTimestampingConfig& config, std::string& error) {
+    int flags = 0;
+    if (config.software) flags |= SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (config.hardware) flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    if (flags == 0) {
+        error = "neither software nor hardware timestamps requested";
+        return false;
+    }
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0) {
+        error = std::string("SO_TIMESTAMPING failed: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool RxTimestamper::enable_hardware(const std::string& interface, std::string& error) {
+    if (interface.empty() || interface.size() >= IFNAMSIZ) {
+        error = "invalid interface name '" + interface + "'";
+        return false;
+    }
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        error = std::string("socket failed: ") + strerror(errno);
+        return false;
+    }
+
+    hwtstamp_config config{};
+    config.tx_type = HWTSTAMP_TX_OFF;
+    config.rx_filter = HWTSTAMP_FILTER_ALL;
+    ifreq request{};
+    memcpy(request.ifr_name, interface.data(), interface.size());
+    request.ifr_data = reinterpret_cast<char*>(&config);
+
+    bool ok = ioctl(sock, SIOCSHWTSTAMP, &request) == 0;
+    if (!ok) {
+        error = "SIOCSHWTSTAMP on " + interface + " failed: " + strerror(errno);
+    } else if (config.rx_filter == HWTSTAMP_FILTER_NONE) {
+        // 驱动可以把请求的过滤器改成它支持的；NONE 表示不支持接收时间戳
+        error = interface + " does not timestamp received packets";
+        ok = false;
+    }
+    close(sock);
+    return ok;
+}
+
+bool RxTimestamper::parse_control(const msghdr& msg, int64_t& software_ns, int64_t& hardware_ns) {
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&msg), cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SO_TIMESTAMPING) continue;
+        // scm_timestamping: ts[0] 软件时间戳，ts[2] 网卡原始时间戳，未提供的为 0
+        timespec stamps[3];
+        memcpy(stamps, CMSG_DATA(cmsg), sizeof(stamps));
+        int64_t software = to_ns(stamps[0]);
+        int64_t hardware = to_ns(stamps[2]);
+        if (software == 0 && hardware == 0) return false;
+        software_ns = software;
+        hardware_ns = hardware;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+struct ssl_st;
+struct msghdr;
+
+// 内核收包时间戳（SO_TIMESTAMPING）。lws 自己从套接字读数据，拿不到 recvmsg 的控制消息，
+// 所以 TLS 连接的读 BIO 换成 recvmsg 实现；明文连接只开启套接字选项，读不到时间戳
+
+struct RxTimestampingConfig {
+    bool software = true;       // 协议栈收包时间，CLOCK_REALTIME
+    bool hardware = false;      // 网卡时间戳，需要网卡支持
+    std::string interface;      // 非空时在该网卡上开启接收硬件时间戳（SIOCSHWTSTAMP，需要 CAP_NET_ADMIN）
+};
+
+struct RxTimestampingStatus {
+    bool enabled = false;       // SO_TIMESTAMPING 已设置
+    bool attached = false;      // TLS 读方向已换成 recvmsg
+    uint64_t reads = 0;         // 读到数据的 recvmsg 次数
+    uint64_t stamped_reads = 0; // 其中带软件或硬件时间戳的次数
+    std::string error;
+};
+
+// 每条连接一个，在连接建立后于服务线程上 attach
+class RxTimestamper {
+public:
+    RxTimestamper() = default;
+    RxTimestamper(const RxTimestamper&) = delete;
+    RxTimestamper& operator=(const RxTimestamper&) = delete;
+
+    // ssl 为空（明文连接）时只设置套接字选项；BIO 由 ssl 持有，本对象需比 ssl 活得久
+    bool attach(int fd, ssl_st* ssl, const RxTimestampingConfig& config);
+
+    // 最近一次读到数据时的时间戳，0 表示没有；TCP 报告的是本次读到的最后一个报文段的时间
+    int64_t software_ns() const { return software_ns_; }
+    int64_t hardware_ns() const { return hardware_ns_; }
+    RxTimestampingStatus status() const;
+    int fd() const { return fd_; }
+
+    // recvmsg 并记下时间戳，语义同 recv(fd, buffer, length, 0)
+    ssize_t receive(void* buffer, size_t length);
+
+    static bool enable_socket(int fd, const RxTimestampingConfig& config, std::string& error);
+    static bool enable_hardware(const std::string& interface, std::string& error);
+    // 从控制消息中取 SCM_TIMESTAMPING，没有时返回 false
+    static bool parse_control(const msghdr& msg, int64_t& software_ns, int64_t& hardware_ns);
+
+private:
+    int fd_ = -1;
+    int64_t software_ns_ = 0;
+    int64_t hardware_ns_ = 0;
+    bool enabled_ = false;
+    bool attached_ = false;
+    std::string error_;
+    std::atomic<uint64_t> reads_{0};
+    std::atomic<uint64_t> stamped_reads_{0};
+};
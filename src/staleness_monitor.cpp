@@ -0,0 +1,123 @@
+#include "staleness_monitor.h"
+
+StalenessMonitor::StalenessMonitor(int64_t resolution_ms)
+    : resolution_ms_(resolution_ms > 0 ? resolution_ms : 1),
+      default_threshold_ms_(5000),
+      wheel_(to_tick(now_ms())) {}
+
+void StalenessMonitor::set_callback(StaleCallback callback) {
+    callback_ = std::move(callback);
+}
+
+void StalenessMonitor::set_default_threshold(int64_t threshold_ms) {
+    default_threshold_ms_ = threshold_ms;
+}
+
+void StalenessMonitor::set_threshold(const std::string& inst_type, int64_t threshold_ms) {
+    thresholds_[inst_type] = threshold_ms;
+
+    // 已登记的同类型交易对立即生效
+    for (auto& entry : entries_) {
+        if (entry.active && entry.inst_type == inst_type) {
+            entry.threshold_ms = threshold_ms;
+        }
+    }
+}
+
+void StalenessMonitor::watch(std::string_view inst_id, int64_t now_ms) {
+    if (index_.find(inst_id) != index_.end()) return;
+
+    uint32_t id = acquire(inst_id);
+    Entry& entry = entries_[id];
+    entry.threshold_ms = default_threshold_ms_;
+    entry.last_update_ms = now_ms;
+    arm(id, now_ms + entry.threshold_ms);
+}
+
+void StalenessMonitor::unwatch(std::string_view inst_id) {
+    auto it = index_.find(inst_id);
+    if (it == index_.end()) return;
+
+    uint32_t id = it->second;
+    wheel_.cancel(id);
+    entries_[id].active = false;
+    index_.erase(it);
+    free_ids_.push_back(id);
+}
+
+void StalenessMonitor::on_tick(std::string_view inst_id, std::string_view inst_type, int64_t now_ms) {
+    uint32_t id;
+    auto it = index_.find(inst_id);
+    if (it != index_.end()) {
+        id = it->second;
+    } else {
+        id = acquire(inst_id);
+    }
+
+    Entry& entry = entries_[id];
+    if (entry.inst_type != inst_type) {
+        entry.inst_type.assign(inst_type.data(), inst_type.size());
+        entry.threshold_ms = threshold_for(inst_type);
+    }
+    entry.last_update_ms = now_ms;
+    entry.consecutive = 0;
+    arm(id, now_ms + entry.threshold_ms);
+}
+
+void StalenessMonitor::poll(int64_t now_ms) {
+    wheel_.advance(to_tick(now_ms), [&](uint32_t id) {
+        Entry& entry = entries_[id];
+        if (!entry.active) return;
+
+        entry.consecutive++;
+        // 持续无更新时按阈值周期重复触发
+        arm(id, now_ms + entry.threshold_ms);
+
+        if (callback_) {
+            callback_(StaleEvent{entry.inst_id, entry.inst_type, now_ms - entry.last_update_ms, entry.consecutive});
+        }
+    });
+}
+
+bool StalenessMonitor::is_stale(std::string_view inst_id) const {
+    auto it = index_.find(inst_id);
+    return it != index_.end() && entries_[it->second].consecutive > 0;
+}
+
+int64_t StalenessMonitor::now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+}
+
+uint32_t StalenessMonitor::acquire(std::string_view inst_id) {
+    uint32_t id;
+    if (!free_ids_.empty()) {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    } else {
+        id = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+
+    Entry& entry = entries_[id];
+    entry.inst_id.assign(inst_id.data(), inst_id.size());
+    entry.inst_type.clear();
+    entry.threshold_ms = default_threshold_ms_;
+    entry.consecutive = 0;
+    entry.active = true;
+    index_.emplace(entry.inst_id, id);
+    return id;
+}
+
+int64_t StalenessMonitor::threshold_for(std::string_view inst_type) const {
+    auto it = thresholds_.find(inst_type);
+    return it != thresholds_.end() ? it->second : default_threshold_ms_;
+}
+
+void StalenessMonitor::arm(uint32_t id, int64_t deadline_ms) {
+    // 向上取整，保证不会早于阈值触发
+    wheel_.schedule(id, to_tick(deadline_ms + resolution_ms_ - 1));
+}
+
+uint64_t StalenessMonitor::to_tick(int64_t ms) const {
+    return ms > 0 ? static_cast<uint64_t>(ms / resolution_ms_) : 0;
+}
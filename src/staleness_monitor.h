@@ -0,0 +1,70 @@
+#pragma once
+#include "timer_wheel.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct StaleEvent {
+    std::string_view inst_id;
+    std::string_view inst_type;
+    int64_t age_ms;          // 距离上次更新的时间
+    uint32_t consecutive;    // 连续触发次数（恢复更新后清零）
+};
+
+// 按交易对跟踪行情新鲜度，每个tick都会在时间轮上re-arm
+class StalenessMonitor {
+public:
+    using StaleCallback = std::function<void(const StaleEvent&)>;
+    using Clock = std::chrono::steady_clock;
+
+    explicit StalenessMonitor(int64_t resolution_ms = 10);
+
+    void set_callback(StaleCallback callback);
+    void set_default_threshold(int64_t threshold_ms);
+    void set_threshold(const std::string& inst_type, int64_t threshold_ms);
+
+    // 订阅时登记，保证从未推送过的交易对也会被检测
+    void watch(std::string_view inst_id, int64_t now_ms);
+    void unwatch(std::string_view inst_id);
+
+    void on_tick(std::string_view inst_id, std::string_view inst_type, int64_t now_ms);
+    void poll(int64_t now_ms);
+
+    bool is_stale(std::string_view inst_id) const;
+    size_t watched_count() const { return index_.size(); }
+
+    static int64_t now_ms();
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+    };
+
+    struct Entry {
+        std::string inst_id;
+        std::string inst_type;
+        int64_t threshold_ms = 0;
+        int64_t last_update_ms = 0;
+        uint32_t consecutive = 0;
+        bool active = false;
+    };
+
+    int64_t resolution_ms_;
+    int64_t default_threshold_ms_;
+    StaleCallback callback_;
+    TimerWheel wheel_;
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_ids_;
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> index_;
+    std::unordered_map<std::string, int64_t, StringHash, std::equal_to<>> thresholds_;
+
+    uint32_t acquire(std::string_view inst_id);
+    int64_t threshold_for(std::string_view inst_type) const;
+    void arm(uint32_t id, int64_t deadline_ms);
+    uint64_t to_tick(int64_t ms) const;
+};
@@ -0,0 +1,141 @@
+#include "thread_config.h"
+#include "async_logger.h"
+#include <pthread.h>
+#include <cerrno>
+#include <cstring>
+
+#ifdef OKX_WITH_NUMA
+#include <numa.h>
+#endif
+
+bool ThreadPlacement::apply(const ThreadConfig& config) {
+    bool ok = true;
+    if (!config.name.empty()) {
+        ok = set_name(config.name) && ok;
+    }
+    // 先绑内存节点，未指定CPU时顺带限制在该节点上运行
+    if (config.numa_node >= 0) {
+        ok = bind_memory(config.numa_node, config.cpus.empty()) && ok;
+    }
+    if (!config.cpus.empty()) {
+        ok = set_affinity(config.cpus) && ok;
+    }
+    if (config.sched_policy != SCHED_OTHER || config.sched_priority != 0) {
+        ok = set_scheduler(config.sched_policy, config.sched_priority) && ok;
+    }
+    return ok;
+}
+
+bool ThreadPlacement::set_affinity(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            OKX_LOG_WARN("Invalid CPU index {}", cpu);
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        OKX_LOG_WARN("pthread_setaffinity_np failed: {}", strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+bool ThreadPlacement::set_scheduler(int policy, int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    int rc = pthread_setschedparam(pthread_self(), policy, &param);
+    if (rc != 0) {
+        // 常见原因: 没有 CAP_SYS_NICE 或 RLIMIT_RTPRIO 为0
+        OKX_LOG_WARN("pthread_setschedparam(policy={}, priority={}) failed: {}", policy, priority, strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+bool ThreadPlacement::set_name(const std::string& name) {
+    std::string truncated = name.substr(0, 15);
+    int rc = pthread_setname_np(pthread_self(), truncated.c_str());
+    if (rc != 0) {
+        OKX_LOG_WARN("pthread_setname_np failed: {}", strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+bool ThreadPlacement::bind_memory(int node, bool run_on_node) {
+#ifdef OKX_WITH_NUMA
+    if (!numa_supported() || node > numa_max_node()) {
+        OKX_LOG_WARN("NUMA node {} not available", node);
+        return false;
+    }
+
+    struct bitmask* mask = numa_allocate_nodemask();
+    numa_bitmask_setbit(mask, static_cast<unsigned>(node));
+    numa_set_membind(mask);
+    numa_free_nodemask(mask);
+
+    // numa_set_membind 不返回错误，回读确认
+    struct bitmask* current = numa_get_membind();
+    bool bound = numa_bitmask_isbitset(current, static_cast<unsigned>(node));
+    numa_bitmask_free(current);
+    if (!bound) {
+        OKX_LOG_WARN("Failed to bind memory to NUMA node {}", node);
+        return false;
+    }
+
+    if (run_on_node && numa_run_on_node(node) != 0) {
+        OKX_LOG_WARN("numa_run_on_node({}) failed: {}", node, strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    (void)run_on_node;
+    OKX_LOG_WARN("NUMA binding to node {} requested but built without libnuma", node);
+    return false;
+#endif
+}
+
+bool ThreadPlacement::numa_supported() {
+#ifdef OKX_WITH_NUMA
+    return numa_available() >= 0;
+#else
+    return false;
+#endif
+}
+
+int ThreadPlacement::numa_node_of_cpu(int cpu) {
+#ifdef OKX_WITH_NUMA
+    return numa_supported() ? ::numa_node_of_cpu(cpu) : -1;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+int ThreadPlacement::current_cpu() {
+    return sched_getcpu();
+}
+
+ScopedMemoryBinding::ScopedMemoryBinding(int node) : previous_(nullptr) {
+#ifdef OKX_WITH_NUMA
+    if (node < 0 || !ThreadPlacement::numa_supported()) return;
+    previous_ = numa_get_membind();
+    ThreadPlacement::bind_memory(node, false);
+#else
+    (void)node;
+#endif
+}
+
+ScopedMemoryBinding::~ScopedMemoryBinding() {
+#ifdef OKX_WITH_NUMA
+    if (!previous_) return;
+    auto* previous = static_cast<struct bitmask*>(previous_);
+    numa_set_membind(previous);
+    numa_bitmask_free(previous);
+#endif
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <sched.h>
+#include <string>
+#include <vector>
+
+// 线程放置: 绑核、实时调度、线程名、NUMA 内存节点、忙轮询
+struct ThreadConfig {
+    std::vector<int> cpus;              // 允许运行的CPU，空表示不限制
+    int sched_policy = SCHED_OTHER;     // SCHED_FIFO / SCHED_RR 需要 CAP_SYS_NICE
+    int sched_priority = 0;
+    std::string name;                   // 超过15字符会被截断
+    int numa_node = -1;                 // >= 0 时该线程之后的内存分配绑定到此节点
+    bool busy_poll = false;             // 服务循环不阻塞等待事件
+
+    bool empty() const {
+        return cpus.empty() && sched_policy == SCHED_OTHER && name.empty() && numa_node < 0 && !busy_poll;
+    }
+};
+
+class ThreadPlacement {
+public:
+    // 作用于调用线程；逐项尝试，任一项失败返回 false 并记录日志，其余项仍会生效
+    static bool apply(const ThreadConfig& config);
+
+    static bool set_affinity(const std::vector<int>& cpus);
+    static bool set_scheduler(int policy, int priority);
+    static bool set_name(const std::string& name);
+    // 需要 OKX_WITH_NUMA（libnuma）；cpus 为空时同时把线程限制在该节点的CPU上
+    static bool bind_memory(int node, bool run_on_node);
+
+    static bool numa_supported();
+    static int numa_node_of_cpu(int cpu);
+    static int current_cpu();
+};
+
+// 在作用域内把调用线程的内存分配绑定到指定节点，析构时恢复原策略
+class ScopedMemoryBinding {
+public:
+    explicit ScopedMemoryBinding(int node);
+    ~ScopedMemoryBinding();
+    ScopedMemoryBinding(const ScopedMemoryBinding&) = delete;
+    ScopedMemoryBinding& operator=(const ScopedMemoryBinding&) = delete;
+
+private:
+    void* previous_;
+};
@@ -0,0 +1,208 @@
+#include "tick_checkpoint.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t kMagic = 0x54504B43584B4FULL;   // "OKXCKPT"
+constexpr uint32_t kLayoutVersion = 1;
+
+size_t mapping_size(uint64_t slot_count) {
+    return sizeof(CheckpointHeader) + slot_count * sizeof(CheckpointSlot);
+}
+
+int64_t realtime_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+std::string_view slot_inst_id(const MarketTick& tick) {
+    return std::string_view(tick.inst_id, strnlen(tick.inst_id, sizeof(tick.inst_id)));
+}
+
+}
+
+TickCheckpoint::~TickCheckpoint() {
+    close();
+}
+
+bool TickCheckpoint::open(const std::string& path, size_t capacity, std::string& error) {
+    close();
+
+    uint64_t count = std::max<size_t>(capacity, 1);
+    size_t size = mapping_size(count);
+
+    int fd = ::open(path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = "open " + path + ": " + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    bool reuse = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == size;
+    if (!reuse && (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+        error = "ftruncate " + path + ": " + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error = "mmap " + path + ": " + strerror(errno);
+        return false;
+    }
+
+    header_ = static_cast<CheckpointHeader*>(addr);
+    slots_ = reinterpret_cast<CheckpointSlot*>(static_cast<char*>(addr) + sizeof(CheckpointHeader));
+    capacity_ = count;
+    mapped_size_ = size;
+    dropped_ = 0;
+
+    if (reuse && header_->magic == kMagic && header_->layout_version == kLayoutVersion &&
+        header_->slot_size == sizeof(CheckpointSlot) && header_->slot_count == count) {
+        restored_ = restore();
+    } else {
+        memset(addr, 0, size);
+        header_->magic = kMagic;
+        header_->layout_version = kLayoutVersion;
+        header_->slot_size = sizeof(CheckpointSlot);
+        header_->slot_count = count;
+        restored_ = 0;
+    }
+    return true;
+}
+
+size_t TickCheckpoint::restore() {
+    // 丢弃写到一半的槽和重复的品种，其余前移压实，并全部标记为陈旧
+    uint64_t used = std::min<uint64_t>(header_->used.load(std::memory_order_acquire), capacity_);
+    uint32_t kept = 0;
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    for (uint64_t i = 0; i < used; ++i) {
+        CheckpointSlot& slot = slots_[i];
+        uint64_t version = slot.version.load(std::memory_order_relaxed);
+        std::string_view inst_id = slot_inst_id(slot.tick);
+        if ((version & 1) != 0 || inst_id.empty() || index_.contains(inst_id)) {
+            continue;
+        }
+
+        CheckpointSlot& target = slots_[kept];
+        if (kept != i) {
+            target.saved_ns = slot.saved_ns;
+            target.tick = slot.tick;
+        }
+        target.stale = 1;
+        target.version.store(version + 2, std::memory_order_relaxed);
+        index_.emplace(std::string(slot_inst_id(target.tick)), kept);
+        ++kept;
+    }
+    for (uint64_t i = kept; i < used; ++i) {
+        memset(static_cast<void*>(&slots_[i]), 0, sizeof(CheckpointSlot));
+    }
+    header_->used.store(kept, std::memory_order_release);
+    return kept;
+}
+
+void TickCheckpoint::close() {
+    if (!header_) return;
+    munmap(header_, mapped_size_);
+    header_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    mapped_size_ = 0;
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    index_.clear();
+}
+
+bool TickCheckpoint::record(const TickerView& view) {
+    if (!header_ || view.inst_id.empty()) return false;
+
+    uint32_t index;
+    auto it = index_.find(view.inst_id);
+    if (it != index_.end()) {
+        index = it->second;
+    } else {
+        uint64_t used = header_->used.load(std::memory_order_relaxed);
+        if (used >= capacity_) {
+            ++dropped_;
+            return false;
+        }
+        index = static_cast<uint32_t>(used);
+        {
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            index_.emplace(std::string(view.inst_id), index);
+        }
+    }
+
+    CheckpointSlot& slot = slots_[index];
+    uint64_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.tick.assign(view);
+    slot.tick.publish_ns = 0;
+    slot.saved_ns = realtime_ns();
+    slot.stale = 0;
+    slot.version.store(version + 2, std::memory_order_release);
+
+    // 槽写完再计入，重启时不会看到未初始化的槽
+    if (index == header_->used.load(std::memory_order_relaxed)) {
+        header_->used.store(index + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+void TickCheckpoint::sync() {
+    if (header_) {
+        msync(header_, mapped_size_, MS_ASYNC);
+    }
+}
+
+size_t TickCheckpoint::size() const {
+    return header_ ? header_->used.load(std::memory_order_acquire) : 0;
+}
+
+bool TickCheckpoint::read_slot(const CheckpointSlot& slot, CheckpointedTick& out) {
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        uint64_t before = slot.version.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        out.tick = slot.tick;
+        out.saved_ns = slot.saved_ns;
+        out.stale = slot.stale != 0;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == before) {
+            return before != 0;
+        }
+    }
+    return false;
+}
+
+bool TickCheckpoint::get(std::string_view inst_id, CheckpointedTick& out) const {
+    uint32_t index;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        auto it = index_.find(inst_id);
+        if (it == index_.end()) return false;
+        index = it->second;
+    }
+    return read_slot(slots_[index], out);
+}
+
+std::vector<CheckpointedTick> TickCheckpoint::snapshot() const {
+    std::vector<CheckpointedTick> result;
+    size_t used = size();
+    result.reserve(used);
+    CheckpointedTick entry;
+    for (size_t i = 0; i < used; ++i) {
+        if (read_slot(slots_[i], entry)) {
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
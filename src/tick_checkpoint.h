@@ -0,0 +1,86 @@
+#pragma once
+#include "market_bus.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 每个品种最新一笔 ticker 的检查点文件: 头部 + 定长槽数组，直接 mmap 读写，没有序列化步骤。
+// 写入经页缓存，进程崩溃或重启后仍在；重启时映射同一文件即可恢复，恢复的记录标记为陈旧，直到收到实时更新
+
+struct alignas(64) CheckpointSlot {
+    // 奇数表示写入中；写者中途退出留下的奇数槽在下次打开时丢弃
+    std::atomic<uint64_t> version;
+    int64_t saved_ns;       // 写入时 CLOCK_REALTIME(ns)，跨重启可比较
+    uint32_t stale;         // 从上一次运行恢复，本次运行还没收到更新
+    MarketTick tick;
+};
+
+struct alignas(64) CheckpointHeader {
+    uint64_t magic;
+    uint32_t layout_version;
+    uint32_t slot_size;
+    uint64_t slot_count;
+    std::atomic<uint64_t> used;     // 已分配的槽数，槽按首次出现的顺序分配
+};
+
+static_assert(sizeof(CheckpointSlot) % 64 == 0);
+
+struct CheckpointedTick {
+    MarketTick tick;
+    int64_t saved_ns;
+    bool stale;
+};
+
+// 单写多读: record() 只在服务线程调用，get()/snapshot() 可在任意线程调用
+class TickCheckpoint {
+public:
+    TickCheckpoint() = default;
+    ~TickCheckpoint();
+    TickCheckpoint(const TickCheckpoint&) = delete;
+    TickCheckpoint& operator=(const TickCheckpoint&) = delete;
+
+    // 打开或创建检查点文件。布局一致的已有文件原样沿用，其中的记录全部标记为陈旧；
+    // 布局不一致（容量或版本改变）时清空重建
+    bool open(const std::string& path, size_t capacity, std::string& error);
+    void close();
+
+    // 写入一个品种的最新状态并清除陈旧标记；槽已用完时返回 false
+    bool record(const TickerView& view);
+    // 异步回写脏页，只为机器掉电时少丢数据；进程重启不需要
+    void sync();
+
+    bool get(std::string_view inst_id, CheckpointedTick& out) const;
+    std::vector<CheckpointedTick> snapshot() const;
+
+    bool is_open() const { return header_ != nullptr; }
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+    size_t restored() const { return restored_; }       // open() 时从文件恢复的品种数
+    uint64_t dropped() const { return dropped_; }       // 槽已满未能记录的更新
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const { return std::hash<std::string_view>{}(value); }
+    };
+
+    CheckpointHeader* header_ = nullptr;
+    CheckpointSlot* slots_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mapped_size_ = 0;
+    size_t restored_ = 0;
+    uint64_t dropped_ = 0;
+
+    // 只有写者修改；写者查找不加锁，插入和其它线程的查找持锁
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> index_;
+    mutable std::mutex index_mutex_;
+
+    size_t restore();
+    static bool read_slot(const CheckpointSlot& slot, CheckpointedTick& out);
+};
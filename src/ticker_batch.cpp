@@ -0,0 +1,89 @@
+#include "ticker_batch.h"
+#include "okx_channels.h"
+#include <algorithm>
+#include <cstring>
+
+MonotonicArena::MonotonicArena(size_t block_size)
+    : block_size_(block_size > 0 ? block_size : 4096), current_(0), offset_(0), used_before_current_(0) {}
+
+char* MonotonicArena::allocate(size_t size) {
+    while (current_ < blocks_.size()) {
+        Block& block = blocks_[current_];
+        if (block.size - offset_ >= size) {
+            char* ptr = block.data.get() + offset_;
+            offset_ += size;
+            return ptr;
+        }
+        // 当前块不够，切到下一个已有块
+        used_before_current_ += offset_;
+        ++current_;
+        offset_ = 0;
+    }
+
+    // 所有块都用完才向系统申请，新块按倍数增长
+    size_t last_size = blocks_.empty() ? block_size_ : blocks_.back().size * 2;
+    size_t new_size = std::max(last_size, size);
+    blocks_.push_back(Block{std::make_unique<char[]>(new_size), new_size});
+    current_ = blocks_.size() - 1;
+    offset_ = size;
+    return blocks_.back().data.get();
+}
+
+std::string_view MonotonicArena::store(std::string_view value) {
+    if (value.empty()) return {};
+    char* ptr = allocate(value.size());
+    memcpy(ptr, value.data(), value.size());
+    return {ptr, value.size()};
+}
+
+void MonotonicArena::reset() {
+    current_ = 0;
+    offset_ = 0;
+    used_before_current_ = 0;
+}
+
+void MonotonicArena::reserve(size_t bytes) {
+    size_t total = capacity();
+    if (total >= bytes) return;
+    size_t new_size = bytes - total;
+    blocks_.push_back(Block{std::make_unique<char[]>(new_size), new_size});
+}
+
+size_t MonotonicArena::capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) {
+        total += block.size;
+    }
+    return total;
+}
+
+size_t MonotonicArena::used() const {
+    return used_before_current_ + offset_;
+}
+
+TickerBatch::TickerBatch(size_t arena_bytes, size_t expected_tickers) : arena_(arena_bytes) {
+    views_.reserve(expected_tickers);
+}
+
+void TickerBatch::clear() {
+    arena_.reset();
+    views_.clear();
+}
+
+void TickerBatch::append(const TickerView& view) {
+    // 字段表与解析共用，新增字段不用再改这里
+    TickerView& copy = views_.emplace_back(view);
+    SchemaCodec<TickerView>::for_each_field(copy, [&](std::string_view, std::string_view& value) {
+        value = arena_.store(value);
+    });
+}
+
+size_t TickerBatch::reserve(size_t arena_bytes, size_t expected_tickers) {
+    arena_.reserve(arena_bytes);
+    // resize 会写入每个元素，清空后容量保留
+    if (views_.empty()) {
+        views_.resize(expected_tickers);
+        views_.clear();
+    }
+    return arena_.capacity() + views_.capacity() * sizeof(TickerView);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// 字段指向 TickerBatch 的 arena，生命周期到下一次 clear()/解析为止
+struct TickerView {
+    std::string_view inst_type;
+    std::string_view inst_id;
+    std::string_view last;
+    std::string_view last_sz;
+    std::string_view ask_px;
+    std::string_view ask_sz;
+    std::string_view bid_px;
+    std::string_view bid_sz;
+    std::string_view open24h;
+    std::string_view high24h;
+    std::string_view low24h;
+    std::string_view vol_ccy24h;
+    std::string_view vol24h;
+    std::string_view sod_utc0;
+    std::string_view sod_utc8;
+    std::string_view ts;
+};
+
+// 单调分配器: reset() 只回退游标，已申请的块全部保留复用
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t block_size = 4096);
+
+    char* allocate(size_t size);
+    std::string_view store(std::string_view value);
+    void reset();
+    // 预先申请到至少 bytes 容量（新块已清零，页已触及）
+    void reserve(size_t bytes);
+
+    size_t capacity() const;
+    size_t used() const;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t current_;
+    size_t offset_;
+    size_t used_before_current_;
+};
+
+// 调用方持有、可复用的批量解析结果，稳态下解析不产生堆分配
+class TickerBatch {
+public:
+    explicit TickerBatch(size_t arena_bytes = 4096, size_t expected_tickers = 16);
+
+    void clear();
+    // 把视图各字段拷贝进 arena 后追加，用于跨消息累积（原消息缓冲区随后会失效）
+    void append(const TickerView& view);
+    // 返回预留后的总字节数
+    size_t reserve(size_t arena_bytes, size_t expected_tickers);
+
+    std::span<const TickerView> tickers() const { return views_; }
+    size_t size() const { return views_.size(); }
+    bool empty() const { return views_.empty(); }
+    const TickerView& operator[](size_t i) const { return views_[i]; }
+    auto begin() const { return views_.cbegin(); }
+    auto end() const { return views_.cend(); }
+
+    MonotonicArena& arena() { return arena_; }
+    const MonotonicArena& arena() const { return arena_; }
+
+    // 去掉 pred 为真的视图，保持顺序，返回去掉的个数；arena 中已拷贝的字段不回收
+    template <typename Pred>
+    size_t remove_if(Pred&& pred) { return std::erase_if(views_, pred); }
+
+private:
+    friend class JsonParser;
+
+    MonotonicArena arena_;
+    std::vector<TickerView> views_;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "okx_channels.h"
+#include "json_stage1.h"
+
+// ticker 字段掩码: 只解析、拷贝掩码内的字段，其余保持为空
+// 运行期: JsonParser::parse_ticker_data_into(json, batch, mode, mask) / TickerHandler::set_field_mask
+// 编译期: JsonParser::parse_ticker_fields_into<mask>(json, batch)，掩码为常量，分发分支可被折叠
+
+struct TickerField {
+    using Codec = SchemaCodec<TickerView>;
+
+    static constexpr FieldMask InstType = Codec::mask_of("instType");
+    static constexpr FieldMask InstId = Codec::mask_of("instId");
+    static constexpr FieldMask Last = Codec::mask_of("last");
+    static constexpr FieldMask LastSz = Codec::mask_of("lastSz");
+    static constexpr FieldMask AskPx = Codec::mask_of("askPx");
+    static constexpr FieldMask AskSz = Codec::mask_of("askSz");
+    static constexpr FieldMask BidPx = Codec::mask_of("bidPx");
+    static constexpr FieldMask BidSz = Codec::mask_of("bidSz");
+    static constexpr FieldMask Open24h = Codec::mask_of("open24h");
+    static constexpr FieldMask High24h = Codec::mask_of("high24h");
+    static constexpr FieldMask Low24h = Codec::mask_of("low24h");
+    static constexpr FieldMask VolCcy24h = Codec::mask_of("volCcy24h");
+    static constexpr FieldMask Vol24h = Codec::mask_of("vol24h");
+    static constexpr FieldMask SodUtc0 = Codec::mask_of("sodUtc0");
+    static constexpr FieldMask SodUtc8 = Codec::mask_of("sodUtc8");
+    static constexpr FieldMask Ts = Codec::mask_of("ts");
+
+    static constexpr FieldMask All = Codec::full_mask();
+    // 多数策略只读的报价字段
+    static constexpr FieldMask Quote = InstId | BidPx | AskPx | Last | Ts;
+};
+
+template <FieldMask Wanted>
+bool JsonParser::parse_ticker_fields_into(std::string_view json, TickerBatch& batch) {
+    static_assert((Wanted & ~TickerField::All) == 0, "unknown ticker field bits");
+    constexpr FieldMask wanted = Wanted | TickerField::InstId;
+
+    batch.clear();
+    visit_ticker_objects(json, [](void* context, const StructuralIndex& index, size_t object) {
+        TickerView view;
+        FieldMask present = 0;
+        size_t expected = 0;
+        index.for_each_member(object, [&](std::string_view key, std::string_view value, bool, size_t) {
+            return TickerField::Codec::decode_member(key, value, view, present, wanted, expected);
+        });
+        if (!view.inst_id.empty()) {
+            store_ticker(*static_cast<TickerBatch*>(context), view);
+        }
+    }, &batch);
+    return !batch.empty();
+}
@@ -1,23 +1,108 @@
 #include "ticker_handler.h"
+#include "trace_probes.h"
 #include <iostream>
 
-TickerHandler::TickerHandler(TickerCallback callback) : callback_(std::move(callback)) {}
+TickerHandler::TickerHandler(TickerCallback callback)
+    : callback_(std::move(callback)), callback_fields_(kAllFields), stage_fields_(0), filter_fields_(0), wanted_(0),
+      batch_scope_(BatchScope::Message), pending_count_(0) {
+    update_field_mask();
+}
 
-void TickerHandler::handle_message(const std::string& message) {
-    auto ticker_data = JsonParser::parse_ticker_data(message);
-    if (ticker_data) {
-        process_ticker_data(*ticker_data);
+TickerHandler::Result TickerHandler::handle_message(std::string_view message) {
+    OKX_PROBE1(parse_start, message.size());
+    bool parsed = JsonParser::parse_ticker_data_into(message, batch_, ParseMode::Fast, wanted_);
+    OKX_PROBE2(parse_end, parsed ? batch_.size() : 0, parsed);
+    if (parsed) {
+        if (filter_) {
+            batch_.remove_if([this](const TickerView& ticker) { return !filter_(ticker); });
+        }
+        process_ticker_data(batch_);
+        return Result::Dispatched;
     }
+    // 只在失败路径上区分: 带 data 数组的 tickers 推送却没解析出结果才算解析错误
+    bool is_ticker_push = message.find("\"tickers\"") != std::string_view::npos &&
+                          message.find("\"data\"") != std::string_view::npos;
+    return is_ticker_push ? Result::ParseError : Result::Ignored;
 }
 
 void TickerHandler::set_callback(TickerCallback callback) {
     callback_ = std::move(callback);
+    update_field_mask();
+}
+
+void TickerHandler::set_batch_callback(BatchCallback on_batch, BatchEndCallback on_batch_end, BatchScope scope) {
+    on_batch_ = std::move(on_batch);
+    on_batch_end_ = std::move(on_batch_end);
+    batch_scope_ = scope;
+    pending_.clear();
+    pending_count_ = 0;
+    update_field_mask();
+}
+
+void TickerHandler::flush_batch() {
+    if (pending_count_ == 0) return;
+    deliver_batch(pending_.tickers());
+    pending_.clear();
+    pending_count_ = 0;
 }
 
-void TickerHandler::process_ticker_data(const std::vector<TickerData>& tickers) {
-    if (!callback_) return;
+void TickerHandler::deliver_batch(std::span<const TickerView> tickers) {
+    OKX_PROBE1(batch, tickers.size());
+    if (on_batch_) {
+        on_batch_(tickers);
+    }
+    if (on_batch_end_) {
+        on_batch_end_();
+    }
+}
+
+void TickerHandler::add_stage(TickerViewCallback stage, FieldMask fields, const char* name) {
+    stages_.push_back({std::move(stage), name});
+    stage_fields_ |= fields;
+    update_field_mask();
+}
 
-    for (const auto& ticker : tickers) {
-        callback_(ticker);
+void TickerHandler::set_filter(TickerFilter filter, FieldMask fields) {
+    filter_ = std::move(filter);
+    filter_fields_ = filter_ ? fields : 0;
+    update_field_mask();
+}
+
+void TickerHandler::set_field_mask(FieldMask fields) {
+    callback_fields_ = fields;
+    update_field_mask();
+}
+
+void TickerHandler::update_field_mask() {
+    wanted_ = stage_fields_ | filter_fields_ | (callback_ || on_batch_ ? callback_fields_ : 0);
+}
+
+void TickerHandler::process_ticker_data(const TickerBatch& batch) {
+    for (const auto& ticker : batch) {
+        // 相邻两个探针之间即上一阶段的耗时
+        for (const auto& stage : stages_) {
+            OKX_PROBE1(stage, stage.name);
+            stage.callback(ticker);
+        }
+        if (callback_) {
+            OKX_PROBE2(callback, ticker.inst_id.data(), ticker.inst_id.size());
+            // scratch_ 复用字符串容量，稳态下不分配
+            scratch_.assign(ticker);
+            callback_(scratch_);
+        }
+    }
+    OKX_PROBE1(dispatch_end, batch.size());
+
+    if ((!on_batch_ && !on_batch_end_) || batch.empty()) return;
+    if (batch_scope_ == BatchScope::Message) {
+        deliver_batch(batch.tickers());
+        return;
+    }
+    // 只需要批次边界时不拷贝
+    if (on_batch_) {
+        for (const auto& ticker : batch) {
+            pending_.append(ticker);
+        }
     }
+    pending_count_ += batch.size();
 }
\ No newline at end of file
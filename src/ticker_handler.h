@@ -2,17 +2,67 @@
 #include "json_parser.h"
 #include <functional>
 #include <memory>
+#include <span>
+#include <vector>
 
 class TickerHandler {
 public:
     using TickerCallback = std::function<void(const TickerData&)>;
+    using TickerViewCallback = std::function<void(const TickerView&)>;
+    using BatchCallback = std::function<void(std::span<const TickerView>)>;
+    using BatchEndCallback = std::function<void()>;
+    using TickerFilter = std::function<bool(const TickerView&)>;
+
+    // Message: 一条消息的 data 数组为一批，直接交付解析结果，不拷贝；
+    // ServicePass: 跨消息累积到可复用缓冲区，调用方在一轮收包结束后 flush_batch()
+    enum class BatchScope { Message, ServicePass };
+
+    // Ignored: 不是 ticker 推送（事件回执、其它频道）; ParseError: 是 ticker 推送但解析失败
+    enum class Result { Dispatched, Ignored, ParseError };
 
     TickerHandler(TickerCallback callback);
 
-    void handle_message(const std::string& message);
+    Result handle_message(std::string_view message);
     void set_callback(TickerCallback callback);
+    // 批量交付: 一批 ticker 在各阶段和逐条回调之后一次交给 on_batch，然后调用 on_batch_end。
+    // 只设置 on_batch_end 时也会在每批结束时调用，给逐条回调一个批次边界；span 只在回调期间有效
+    void set_batch_callback(BatchCallback on_batch, BatchEndCallback on_batch_end = {}, BatchScope scope = BatchScope::Message);
+    // 交付 ServicePass 模式下累积的一批，没有待交付的 ticker 时不回调
+    void flush_batch();
+    // 内部处理阶段，在用户回调之前按注册顺序执行，直接读取batch中的视图
+    // fields 为该阶段读取的字段（见 ticker_fields.h）；name 由 okx:stage 探针上报，用于区分各阶段耗时
+    void add_stage(TickerViewCallback stage, FieldMask fields = kAllFields, const char* name = "stage");
+    // 过滤器在各阶段之前执行，返回 false 的 ticker 不进入阶段、回调和批次；fields 同 add_stage
+    void set_filter(TickerFilter filter, FieldMask fields = kAllFields);
+    // 用户回调读取的字段，默认全部；解析掩码为它与各阶段字段的并集，其余字段跳过且为空
+    void set_field_mask(FieldMask fields);
+    FieldMask field_mask() const { return wanted_; }
+    // 预分配解析用的 arena 与视图数组，返回字节数
+    size_t reserve(size_t arena_bytes, size_t expected_tickers) { return batch_.reserve(arena_bytes, expected_tickers); }
 
 private:
+    struct Stage {
+        TickerViewCallback callback;
+        const char* name;
+    };
+
     TickerCallback callback_;
-    void process_ticker_data(const std::vector<TickerData>& tickers);
+    std::vector<Stage> stages_;
+    TickerFilter filter_;
+    FieldMask callback_fields_;
+    FieldMask stage_fields_;
+    FieldMask filter_fields_;
+    FieldMask wanted_;
+    TickerBatch batch_;
+    TickerData scratch_;
+
+    BatchCallback on_batch_;
+    BatchEndCallback on_batch_end_;
+    BatchScope batch_scope_;
+    TickerBatch pending_;           // ServicePass 累积的 ticker，clear() 后复用 arena
+    size_t pending_count_;
+
+    void process_ticker_data(const TickerBatch& batch);
+    void deliver_batch(std::span<const TickerView> tickers);
+    void update_field_mask();
 };
\ No newline at end of file
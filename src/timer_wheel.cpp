@@ -0,0 +1,87 @@
+#include "timer_wheel.h"
+
+TimerWheel::TimerWheel(uint64_t start_tick) : current_(start_tick), armed_(0) {
+    heads_.fill(npos);
+}
+
+void TimerWheel::schedule(uint32_t id, uint64_t expiry_tick) {
+    ensure_node(id);
+    if (nodes_[id].slot != npos) {
+        unlink(id);
+    } else {
+        ++armed_;
+    }
+
+    // 已过期的定时器在下一个tick触发
+    nodes_[id].expiry = expiry_tick > current_ ? expiry_tick : current_ + 1;
+    link(id);
+}
+
+void TimerWheel::cancel(uint32_t id) {
+    if (id >= nodes_.size() || nodes_[id].slot == npos) return;
+    unlink(id);
+    --armed_;
+}
+
+bool TimerWheel::is_armed(uint32_t id) const {
+    return id < nodes_.size() && nodes_[id].slot != npos;
+}
+
+void TimerWheel::ensure_node(uint32_t id) {
+    if (id >= nodes_.size()) {
+        nodes_.resize(static_cast<size_t>(id) + 1);
+    }
+}
+
+void TimerWheel::link(uint32_t id) {
+    Node& node = nodes_[id];
+
+    uint64_t max_delta = (1ull << (kSlotBits * kLevels)) - 1;
+    if (node.expiry - current_ > max_delta) {
+        node.expiry = current_ + max_delta;
+    }
+
+    uint64_t delta = node.expiry - current_;
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (1ull << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+
+    uint32_t slot = level * kSlots + ((node.expiry >> (kSlotBits * level)) & kSlotMask);
+    node.slot = slot;
+    node.prev = npos;
+    node.next = heads_[slot];
+    if (node.next != npos) {
+        nodes_[node.next].prev = id;
+    }
+    heads_[slot] = id;
+}
+
+void TimerWheel::unlink(uint32_t id) {
+    Node& node = nodes_[id];
+    if (node.prev != npos) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != npos) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = node.next = node.slot = npos;
+}
+
+uint32_t TimerWheel::detach_slot(uint32_t slot) {
+    uint32_t head = heads_[slot];
+    heads_[slot] = npos;
+    return head;
+}
+
+void TimerWheel::cascade(int level) {
+    uint32_t slot = level * kSlots + ((current_ >> (kSlotBits * level)) & kSlotMask);
+    uint32_t id = detach_slot(slot);
+    while (id != npos) {
+        uint32_t next = nodes_[id].next;
+        link(id);
+        id = next;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 分层时间轮: 4层 x 64槽，arm/re-arm/cancel 均为 O(1)
+class TimerWheel {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    explicit TimerWheel(uint64_t start_tick = 0);
+
+    // 为 id 设置到期 tick，已挂载的定时器会先摘除（re-arm）
+    void schedule(uint32_t id, uint64_t expiry_tick);
+    void cancel(uint32_t id);
+    bool is_armed(uint32_t id) const;
+
+    // 推进到 now_tick，对每个到期定时器调用 on_expire(id)；回调内可以重新 schedule
+    template <typename Fn>
+    void advance(uint64_t now_tick, Fn&& on_expire);
+
+    uint64_t current_tick() const { return current_; }
+    size_t armed_count() const { return armed_; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+
+    struct Node {
+        uint64_t expiry = 0;
+        uint32_t prev = npos;
+        uint32_t next = npos;
+        uint32_t slot = npos;
+    };
+
+    std::vector<Node> nodes_;
+    std::array<uint32_t, kLevels * kSlots> heads_;
+    uint64_t current_;
+    size_t armed_;
+
+    void ensure_node(uint32_t id);
+    void link(uint32_t id);
+    void unlink(uint32_t id);
+    uint32_t detach_slot(uint32_t slot);
+    void cascade(int level);
+};
+
+template <typename Fn>
+void TimerWheel::advance(uint64_t now_tick, Fn&& on_expire) {
+    while (current_ < now_tick) {
+        if (armed_ == 0) {
+            current_ = now_tick;
+            return;
+        }
+
+        ++current_;
+
+        // 低层转完一圈时，把上层对应槽的定时器下放
+        for (int level = 1; level < kLevels; ++level) {
+            if ((current_ >> (kSlotBits * level)) << (kSlotBits * level) != current_) break;
+            cascade(level);
+        }
+
+        uint32_t id = detach_slot(current_ & kSlotMask);
+        while (id != npos) {
+            uint32_t next = nodes_[id].next;
+            nodes_[id].prev = nodes_[id].next = nodes_[id].slot = npos;
+            --armed_;
+            on_expire(id);
+            id = next;
+        }
+    }
+}
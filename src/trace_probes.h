@@ -0,0 +1,17 @@
+#pragma once
+
+// USDT 静态探针，provider 为 okx，可用 bpftrace/perf 在运行中的进程上挂载（示例见 scripts/bpftrace/）。
+// 以 OKX_WITH_USDT 编译且有 <sys/sdt.h> 时每个探针是一条 nop，参数位置记录在 .note.stapsdt 中，未挂载时只多这条 nop；
+// 否则展开为空，参数不求值。参数只用指针和整数，不要在参数里做计算
+#if defined(OKX_WITH_USDT) && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define OKX_PROBE0(name) DTRACE_PROBE(okx, name)
+#define OKX_PROBE1(name, a) DTRACE_PROBE1(okx, name, a)
+#define OKX_PROBE2(name, a, b) DTRACE_PROBE2(okx, name, a, b)
+#define OKX_PROBE3(name, a, b, c) DTRACE_PROBE3(okx, name, a, b, c)
+#else
+#define OKX_PROBE0(name) ((void)0)
+#define OKX_PROBE1(name, a) ((void)0)
+#define OKX_PROBE2(name, a, b) ((void)0)
+#define OKX_PROBE3(name, a, b, c) ((void)0)
+#endif
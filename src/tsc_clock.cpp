@@ -0,0 +1,185 @@
+#include "tsc_clock.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+std::mutex calibration_mutex;
+// 第一次标定的样本，重标定时用长基线求频率
+uint64_t origin_ticks = 0;
+int64_t origin_ns = 0;
+
+constexpr double kFixedOne = 4294967296.0;   // 2^32
+// 重标定时每个周期最多调整的斜率，避免时间跳变
+constexpr double kMaxSlew = 0.0005;
+
+}
+
+const bool TscClock::use_tsc_ = TscClock::detect_invariant_tsc();
+
+std::atomic<uint64_t> TscClock::version_{0};
+std::atomic<uint64_t> TscClock::base_ticks_{0};
+std::atomic<int64_t> TscClock::base_ns_{0};
+std::atomic<uint64_t> TscClock::mult_{uint64_t(1) << 32};
+std::atomic<int64_t> TscClock::realtime_offset_ns_{0};
+std::atomic<int64_t> TscClock::last_calibration_ns_{0};
+std::atomic<bool> TscClock::calibrated_{false};
+
+bool TscClock::detect_invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    // CPUID 80000007H EDX[8]: invariant TSC
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8))) {
+        return true;
+    }
+    // 虚拟机常隐藏该位，内核选用 tsc 作为时钟源时同样可信
+    std::ifstream source("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+    std::string name;
+    return source >> name && name == "tsc";
+#elif defined(__aarch64__)
+    // 通用计时器频率恒定
+    return true;
+#else
+    return false;
+#endif
+}
+
+int64_t TscClock::monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int64_t TscClock::realtime_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+TscClock::Sample TscClock::sample() {
+    // 取夹住 clock_gettime 的两次读数间隔最小的一组，读数取中点
+    Sample best{};
+    uint64_t best_window = UINT64_MAX;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t before = now_ordered();
+        int64_t mono = monotonic_ns();
+        uint64_t after = now_ordered();
+        int64_t real = realtime_ns();
+        if (after - before < best_window) {
+            best_window = after - before;
+            best = {before + (after - before) / 2, mono, real};
+        }
+    }
+    return best;
+}
+
+void TscClock::store(uint64_t base_ticks, int64_t base_ns, uint64_t mult, int64_t realtime_offset) {
+    uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_ticks_.store(base_ticks, std::memory_order_relaxed);
+    base_ns_.store(base_ns, std::memory_order_relaxed);
+    mult_.store(mult, std::memory_order_relaxed);
+    realtime_offset_ns_.store(realtime_offset, std::memory_order_relaxed);
+    version_.store(version + 2, std::memory_order_release);
+}
+
+void TscClock::calibrate(int calibration_ms) {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+
+    if (!use_tsc_) {
+        // 读数本身就是纳秒
+        Sample now = sample();
+        store(0, 0, uint64_t(1) << 32, now.real_ns - now.mono_ns);
+        last_calibration_ns_ = now.mono_ns;
+        calibrated_.store(true, std::memory_order_release);
+        return;
+    }
+
+    Sample start = sample();
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::max(calibration_ms, 1)));
+    Sample end = sample();
+
+    double ticks_per_ns = double(end.ticks - start.ticks) / double(end.mono_ns - start.mono_ns);
+    uint64_t mult = static_cast<uint64_t>(kFixedOne / ticks_per_ns + 0.5);
+
+    origin_ticks = start.ticks;
+    origin_ns = start.mono_ns;
+    store(end.ticks, end.mono_ns, mult, end.real_ns - end.mono_ns);
+    last_calibration_ns_ = end.mono_ns;
+    calibrated_.store(true, std::memory_order_release);
+}
+
+void TscClock::maybe_recalibrate(int64_t interval_ns) {
+    if (!use_tsc_ || !calibrated_.load(std::memory_order_acquire)) return;
+
+    int64_t mono = monotonic_ns();
+    if (mono - last_calibration_ns_.load(std::memory_order_relaxed) < interval_ns) return;
+
+    std::unique_lock<std::mutex> lock(calibration_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return;
+
+    Sample now = sample();
+    // 从旧参数下的当前值继续，只调整斜率，在下一个周期内追平与 CLOCK_MONOTONIC 的偏差
+    int64_t current = to_ns(now.ticks);
+    int64_t error = now.mono_ns - current;
+    if (error > 1000000) {
+        // 落后太多（如挂起恢复）直接向前跳，仍保持单调
+        current = now.mono_ns;
+        error = 0;
+    }
+
+    double ticks_per_ns = double(now.ticks - origin_ticks) / double(now.mono_ns - origin_ns);
+    double correction = std::clamp(double(error) / double(interval_ns), -kMaxSlew, kMaxSlew);
+    uint64_t mult = static_cast<uint64_t>(kFixedOne * (1.0 + correction) / ticks_per_ns + 0.5);
+
+    store(now.ticks, current, mult, now.real_ns - now.mono_ns);
+    last_calibration_ns_.store(now.mono_ns, std::memory_order_relaxed);
+}
+
+void TscClock::initialize() {
+    if (calibrated_.load(std::memory_order_acquire)) return;
+    static std::once_flag once;
+    std::call_once(once, [] { calibrate(); });
+}
+
+int64_t TscClock::to_ns(uint64_t ticks) {
+    initialize();
+
+    uint64_t base_ticks, mult, before, after;
+    int64_t base_ns;
+    do {
+        before = version_.load(std::memory_order_acquire);
+        base_ticks = base_ticks_.load(std::memory_order_relaxed);
+        base_ns = base_ns_.load(std::memory_order_relaxed);
+        mult = mult_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = version_.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    // 允许读数早于基点（重标定前取的时间戳）
+    __int128 delta = static_cast<int64_t>(ticks - base_ticks);
+    return base_ns + static_cast<int64_t>((delta * mult) >> 32);
+}
+
+int64_t TscClock::to_realtime_ns(uint64_t ticks) {
+    return to_ns(ticks) + realtime_offset_ns_.load(std::memory_order_relaxed);
+}
+
+int64_t TscClock::ticks_to_ns(uint64_t delta) {
+    initialize();
+    return static_cast<int64_t>((static_cast<unsigned __int128>(delta) * mult_.load(std::memory_order_relaxed)) >> 32);
+}
+
+double TscClock::ticks_per_ns() {
+    initialize();
+    return kFixedOne / double(mult_.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 热路径时钟: 只读时间戳计数器，换算成纳秒放到热路径之外。
+// 启动时对 CLOCK_MONOTONIC 标定，之后定期重标定；不支持 invariant TSC 时退化为 clock_gettime
+class TscClock {
+public:
+    // 不带序列化的读数，约 10 个周期
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_expect(use_tsc_, 1)) return __rdtsc();
+#elif defined(__aarch64__)
+        if (__builtin_expect(use_tsc_, 1)) {
+            uint64_t value;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+            return value;
+        }
+#endif
+        return monotonic_ns();
+    }
+
+    // 等之前的指令执行完再读，用于区间测量的结束点
+    static uint64_t now_ordered() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_expect(use_tsc_, 1)) {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+#elif defined(__aarch64__)
+        if (__builtin_expect(use_tsc_, 1)) {
+            uint64_t value;
+            asm volatile("isb; mrs %0, cntvct_el0" : "=r"(value) : : "memory");
+            return value;
+        }
+#endif
+        return monotonic_ns();
+    }
+
+    // 读数换算到 CLOCK_MONOTONIC / CLOCK_REALTIME 纳秒，重标定时保持连续
+    static int64_t to_ns(uint64_t ticks);
+    static int64_t to_realtime_ns(uint64_t ticks);
+    // 读数差换算成纳秒
+    static int64_t ticks_to_ns(uint64_t delta);
+
+    // 首次换算前自动标定，阻塞约 10ms；可以在启动时提前调用
+    static void initialize();
+    static void calibrate(int calibration_ms = 10);
+    // 距上次标定超过 interval_ns 才重标定，服务循环中调用
+    static void maybe_recalibrate(int64_t interval_ns = 1000000000);
+
+    static bool uses_tsc() { return use_tsc_; }
+    static double ticks_per_ns();
+    static int64_t monotonic_ns();
+    static int64_t realtime_ns();
+
+private:
+    struct Sample {
+        uint64_t ticks;
+        int64_t mono_ns;
+        int64_t real_ns;
+    };
+
+    static const bool use_tsc_;
+
+    // 换算参数: ns = base_ns + ((ticks - base_ticks) * mult) >> 32，用 seqlock 保护
+    static std::atomic<uint64_t> version_;
+    static std::atomic<uint64_t> base_ticks_;
+    static std::atomic<int64_t> base_ns_;
+    static std::atomic<uint64_t> mult_;
+    static std::atomic<int64_t> realtime_offset_ns_;
+    static std::atomic<int64_t> last_calibration_ns_;
+    static std::atomic<bool> calibrated_;
+
+    static bool detect_invariant_tsc();
+    static Sample sample();
+    static void store(uint64_t base_ticks, int64_t base_ns, uint64_t mult, int64_t realtime_offset);
+};
+
+// 每条消息的时间戳，TscClock 读数
+struct RxTimestamps {
+    uint64_t receive = 0;    // 进入 LWS_CALLBACK_CLIENT_RECEIVE
+    uint64_t dispatch = 0;   // 交给频道处理器之前
+    // 开启 SO_TIMESTAMPING 时内核的收包时间（CLOCK_REALTIME 纳秒，可与 TscClock::to_realtime_ns 比较），
+    // 和网卡 PHC 时间；未开启或没有时间戳时为 0
+    int64_t kernel_ns = 0;
+    int64_t hardware_ns = 0;
+};
@@ -0,0 +1,744 @@
+#include "uring_transport.h"
+
+#ifdef OKX_WITH_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <linux/io_uring.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/ssl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t kReceiveTag = 1;
+constexpr uint64_t kWakeTag = 2;
+constexpr uint64_t kProvideTag = 3;
+constexpr uint16_t kBufferGroup = 0;
+// 注册文件表中的下标
+constexpr int kSocketSlot = 0;
+constexpr int kWakeSlot = 1;
+
+int uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uring_enter(int fd, unsigned submit, unsigned min_complete, unsigned flags, void* arg, size_t size) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, arg, size));
+}
+
+int uring_register(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+template <typename T>
+T load_acquire(T* ptr) {
+    return std::atomic_ref<T>(*ptr).load(std::memory_order_acquire);
+}
+
+template <typename T>
+void store_release(T* ptr, T value) {
+    std::atomic_ref<T>(*ptr).store(value, std::memory_order_release);
+}
+
+bool ktls_ulp_available() {
+    std::ifstream file("/proc/sys/net/ipv4/tcp_available_ulp");
+    std::string ulp;
+    while (file >> ulp) {
+        if (ulp == "tls") return true;
+    }
+    return false;
+}
+
+std::string ssl_error() {
+    unsigned long code = ERR_get_error();
+    if (code == 0) return errno ? strerror(errno) : "unknown error";
+    char buffer[256];
+    ERR_error_string_n(code, buffer, sizeof(buffer));
+    return buffer;
+}
+
+std::string base64(const unsigned char* data, size_t length) {
+    std::string out(4 * ((length + 2) / 3), '\0');
+    int n = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()), data, static_cast<int>(length));
+    out.resize(static_cast<size_t>(n));
+    return out;
+}
+
+// 不区分大小写查找响应头的值
+std::string header_value(std::string_view headers, std::string_view name) {
+    size_t at = 0;
+    while ((at = headers.find("\r\n", at)) != std::string_view::npos) {
+        at += 2;
+        if (headers.size() - at > name.size() && strncasecmp(headers.data() + at, name.data(), name.size()) == 0 &&
+            headers[at + name.size()] == ':') {
+            size_t start = headers.find_first_not_of(' ', at + name.size() + 1);
+            size_t end = headers.find("\r\n", start);
+            return std::string(headers.substr(start, end - start));
+        }
+    }
+    return "";
+}
+
+}
+
+// 提交队列/完成队列的共享内存映射与内核缓冲区环
+struct UringTransport::Ring {
+    int fd = -1;
+    io_uring_params params{};
+    void* sq_map = MAP_FAILED;
+    size_t sq_map_size = 0;
+    void* cq_map = MAP_FAILED;
+    size_t cq_map_size = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_size = 0;
+
+    unsigned* sq_flags = nullptr;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned pending = 0;               // 已填写未提交的 SQE
+    std::atomic<uint64_t>* enter_count = nullptr;
+
+    // 内核缓冲区环可用时归还缓冲区只写共享内存；否则每次归还提交一个 IORING_OP_PROVIDE_BUFFERS
+    bool ring_mapped = false;
+    io_uring_buf_ring* buffer_ring = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    size_t buffer_ring_size = 0;
+    uint16_t buffer_tail = 0;
+    unsigned buffer_mask = 0;
+
+    ~Ring() {
+        if (buffer_ring != MAP_FAILED) munmap(buffer_ring, buffer_ring_size);
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        if (cq_map != MAP_FAILED && cq_map != sq_map) munmap(cq_map, cq_map_size);
+        if (sq_map != MAP_FAILED) munmap(sq_map, sq_map_size);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool setup(unsigned entries, std::string& error) {
+        // 完成项的收尾工作不再靠 IPI 打断服务线程，而是在 SQ 标志里提示，由 poll() 进内核时处理；老内核不认识时退回默认
+        params.flags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+        fd = uring_setup(entries, &params);
+        if (fd < 0 && errno == EINVAL) {
+            params = {};
+            fd = uring_setup(entries, &params);
+        }
+        if (fd < 0) {
+            error = std::string("io_uring_setup failed: ") + strerror(errno);
+            return false;
+        }
+        if (!(params.features & IORING_FEAT_EXT_ARG)) {
+            error = "kernel lacks IORING_FEAT_EXT_ARG (needs >= 5.11)";
+            return false;
+        }
+
+        sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_map_size = cq_map_size = std::max(sq_map_size, cq_map_size);
+        }
+        sq_map = mmap(nullptr, sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_map == MAP_FAILED) {
+            error = std::string("mmap SQ ring failed: ") + strerror(errno);
+            return false;
+        }
+        cq_map = (params.features & IORING_FEAT_SINGLE_MMAP)
+                     ? sq_map
+                     : mmap(nullptr, cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(
+            mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (cq_map == MAP_FAILED || sqes == MAP_FAILED) {
+            error = std::string("mmap io_uring rings failed: ") + strerror(errno);
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sq_map);
+        sq_flags = reinterpret_cast<unsigned*>(sq + params.sq_off.flags);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cq_map);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // 注册 count 个缓冲区的提供缓冲区环，内核为每次接收从中挑一个
+    bool map_buffer_ring(unsigned count, std::string& error) {
+        buffer_ring_size = count * sizeof(io_uring_buf);
+        buffer_ring = static_cast<io_uring_buf_ring*>(
+            mmap(nullptr, buffer_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+        if (buffer_ring == MAP_FAILED) {
+            error = std::string("mmap buffer ring failed: ") + strerror(errno);
+            return false;
+        }
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(buffer_ring);
+        reg.ring_entries = count;
+        reg.bgid = kBufferGroup;
+        if (uring_register(fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+            error = std::string("IORING_REGISTER_PBUF_RING failed (needs >= 5.19): ") + strerror(errno);
+            return false;
+        }
+        buffer_mask = count - 1;
+        ring_mapped = true;
+        return true;
+    }
+
+    void provide(char* buffer, unsigned length, uint16_t id) {
+        if (!ring_mapped) {
+            io_uring_sqe* sqe = next_sqe();
+            sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+            sqe->fd = 1;
+            sqe->addr = reinterpret_cast<uint64_t>(buffer);
+            sqe->len = length;
+            sqe->buf_group = kBufferGroup;
+            sqe->off = id;
+            sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+            sqe->user_data = kProvideTag;
+            return;
+        }
+        io_uring_buf* slot = &buffer_ring->bufs[buffer_tail & buffer_mask];
+        slot->addr = reinterpret_cast<uint64_t>(buffer);
+        slot->len = length;
+        slot->bid = id;
+        buffer_tail++;
+        store_release(&buffer_ring->tail, buffer_tail);
+    }
+
+    // 提交队列满时先把已填写的提交掉
+    io_uring_sqe* next_sqe() {
+        if (*sq_tail + pending - load_acquire(sq_head) >= params.sq_entries) {
+            enter(0);
+        }
+        unsigned tail = *sq_tail + pending;
+        if (tail - load_acquire(sq_head) >= params.sq_entries) return nullptr;
+        io_uring_sqe* sqe = &sqes[tail & sq_mask];
+        memset(sqe, 0, sizeof(*sqe));
+        sq_array[tail & sq_mask] = tail & sq_mask;
+        pending++;
+        return sqe;
+    }
+
+    // 内核有待运行的完成工作，需要进一次内核才会出现在完成队列里
+    bool task_work_pending() const {
+        return load_acquire(sq_flags) & IORING_SQ_TASKRUN;
+    }
+
+    // 发布已填写的 SQE；wait_ms > 0 时至少等一个完成项或超时
+    int enter(int wait_ms) {
+        unsigned submit = pending;
+        if (submit) {
+            store_release(sq_tail, *sq_tail + submit);
+            pending = 0;
+        }
+        unsigned flags = IORING_ENTER_GETEVENTS;
+        unsigned min_complete = 0;
+        __kernel_timespec timeout{};
+        io_uring_getevents_arg arg{};
+        if (wait_ms > 0) {
+            timeout.tv_sec = wait_ms / 1000;
+            timeout.tv_nsec = (wait_ms % 1000) * 1000000LL;
+            arg.ts = reinterpret_cast<uint64_t>(&timeout);
+            flags |= IORING_ENTER_EXT_ARG;
+            min_complete = 1;
+        }
+        bool wait = flags & IORING_ENTER_EXT_ARG;
+        if (enter_count) enter_count->fetch_add(1, std::memory_order_relaxed);
+        int result = uring_enter(fd, submit, min_complete, flags, wait ? &arg : nullptr, wait ? sizeof(arg) : 0);
+        if (result < 0 && (errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY)) return 0;
+        return result;
+    }
+};
+
+namespace {
+
+// 注册缓冲区环成功并不代表可用（有的内核上带 IOSQE_BUFFER_SELECT 的接收总是 -ENOBUFS），
+// 用一对 UNIX 套接字实际收一个字节来确认，结果缓存
+bool buffer_ring_works() {
+    static const bool works = [] {
+        UringTransport::Ring ring;
+        std::string error;
+        int pair[2];
+        if (!ring.setup(4, error) || !ring.map_buffer_ring(2, error) ||
+            socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) != 0) {
+            return false;
+        }
+        char buffers[2][64];
+        ring.provide(buffers[0], sizeof(buffers[0]), 0);
+        ring.provide(buffers[1], sizeof(buffers[1]), 1);
+        bool ok = write(pair[1], "x", 1) == 1;
+        io_uring_sqe* sqe = ring.next_sqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = pair[0];
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        ok = ok && ring.enter(1000) >= 0 && load_acquire(ring.cq_tail) != *ring.cq_head &&
+             ring.cqes[*ring.cq_head & ring.cq_mask].res == 1;
+        ::close(pair[0]);
+        ::close(pair[1]);
+        return ok;
+    }();
+    return works;
+}
+
+}
+
+UringTransport::UringTransport(const UringTransportConfig& config) : config_(config) {}
+
+UringTransport::~UringTransport() {
+    close();
+}
+
+bool UringTransport::available(std::string& error) {
+    Ring ring;
+    return ring.setup(4, error);
+}
+
+bool UringTransport::connect(const std::string& host, int port, const std::string& path, bool use_ssl, std::string& error) {
+    close();
+    error_.clear();
+    if (config_.buffer_count == 0 || (config_.buffer_count & (config_.buffer_count - 1)) != 0 || config_.buffer_count > 32768) {
+        error = "buffer_count must be a power of two <= 32768";
+        return false;
+    }
+
+    std::string leftover;
+    if (!open_socket(host, port, error) || (use_ssl && !handshake_tls(host, error)) ||
+        !upgrade(host, port, path, leftover, error)) {
+        close();
+        return false;
+    }
+
+    if (ssl_ && !ktls_rx_) {
+        // 握手期间由套接字 BIO 读；之后密文由 io_uring 收进来写入内存 BIO
+        cipher_in_ = BIO_new(BIO_s_mem());
+        BIO_set_mem_eof_return(cipher_in_, -1);
+        SSL_set0_rbio(ssl_, cipher_in_);
+    }
+
+    decoder_.reset();
+    decoder_.set_message_handler([this](std::string_view payload, bool) {
+        messages_.fetch_add(1, std::memory_order_relaxed);
+        if (on_message_) on_message_(payload);
+    });
+    decoder_.set_control_handler([this](WsOpcode opcode, std::string_view payload) {
+        if (opcode == WsOpcode::Ping) {
+            send_frame(WsOpcode::Pong, payload);
+        } else if (opcode == WsOpcode::Pong) {
+            if (on_pong_) on_pong_();
+        } else {
+            // 回应关闭帧（原样带回状态码），连接在本轮 poll 结束后视为断开
+            send_frame(WsOpcode::Close, payload.substr(0, 2));
+            fail("server closed the connection");
+        }
+    });
+
+    if (!start_ring(error)) {
+        close();
+        return false;
+    }
+    open_ = true;
+    if (!leftover.empty() && !decoder_.feed(leftover.data(), leftover.size())) {
+        // 升级响应后面紧跟的帧，已是明文
+        fail("WebSocket protocol error: " + decoder_.error());
+    }
+    return open_;
+}
+
+bool UringTransport::open_socket(const std::string& host, int port, std::string& error) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result);
+    if (rc != 0) {
+        error = "getaddrinfo " + host + ": " + gai_strerror(rc);
+        return false;
+    }
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        socket_ = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (socket_ < 0) continue;
+        if (::connect(socket_, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        ::close(socket_);
+        socket_ = -1;
+    }
+    freeaddrinfo(result);
+    if (socket_ < 0) {
+        error = "connect to " + host + ":" + std::to_string(port) + " failed: " + strerror(errno);
+        return false;
+    }
+    int one = 1;
+    setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return true;
+}
+
+bool UringTransport::handshake_tls(const std::string& host, std::string& error) {
+    ssl_ctx_ = SSL_CTX_new(TLS_client_method());
+    if (!ssl_ctx_) {
+        error = "SSL_CTX_new failed: " + ssl_error();
+        return false;
+    }
+    // 与 libwebsockets 路径的证书策略一致（允许自签名）
+    SSL_CTX_set_verify(ssl_ctx_, SSL_VERIFY_NONE, nullptr);
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    if (config_.ktls && ktls_ulp_available()) {
+        SSL_CTX_set_options(ssl_ctx_, SSL_OP_ENABLE_KTLS);
+        SSL_CTX_set_max_proto_version(ssl_ctx_, TLS1_2_VERSION);
+    }
+#endif
+
+    ssl_ = SSL_new(ssl_ctx_);
+    SSL_set_tlsext_host_name(ssl_, host.c_str());
+    SSL_set_fd(ssl_, socket_);
+    if (SSL_connect(ssl_) != 1) {
+        error = "TLS handshake failed: " + ssl_error();
+        return false;
+    }
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    ktls_rx_ = BIO_get_ktls_recv(SSL_get_rbio(ssl_)) == 1;
+    ktls_tx_ = BIO_get_ktls_send(SSL_get_wbio(ssl_)) == 1;
+#endif
+    return true;
+}
+
+bool UringTransport::upgrade(const std::string& host, int port, const std::string& path, std::string& leftover,
+                             std::string& error) {
+    unsigned char nonce[16];
+    RAND_bytes(nonce, sizeof(nonce));
+    RAND_bytes(reinterpret_cast<unsigned char*>(&mask_state_), sizeof(mask_state_));
+    mask_state_ |= 1;   // xorshift 状态不能为 0
+    std::string key = base64(nonce, sizeof(nonce));
+
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: " + host + ":" + std::to_string(port) +
+                          "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key +
+                          "\r\nSec-WebSocket-Version: 13\r\nOrigin: origin\r\n\r\n";
+    if (!write_all(request.data(), request.size())) {
+        error = "sending upgrade request failed: " + error_;
+        return false;
+    }
+
+    std::string response;
+    char buffer[16 * 1024];
+    size_t end;
+    while ((end = response.find("\r\n\r\n")) == std::string::npos) {
+        long n = read_some(buffer, sizeof(buffer));
+        if (n <= 0 || response.size() > 64 * 1024) {
+            error = "no WebSocket upgrade response";
+            return false;
+        }
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    std::string_view headers(response.data(), end + 2);
+    if (!headers.starts_with("HTTP/1.1 101")) {
+        error = "upgrade rejected: " + std::string(headers.substr(0, headers.find("\r\n")));
+        return false;
+    }
+
+    std::string accept_source = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length = 0;
+    EVP_Digest(accept_source.data(), accept_source.size(), digest, &digest_length, EVP_sha1(), nullptr);
+    if (header_value(headers, "Sec-WebSocket-Accept") != base64(digest, digest_length)) {
+        error = "bad Sec-WebSocket-Accept";
+        return false;
+    }
+    if (!header_value(headers, "Sec-WebSocket-Extensions").empty()) {
+        error = "server negotiated an extension that this transport does not implement";
+        return false;
+    }
+    leftover = response.substr(end + 4);
+    return true;
+}
+
+bool UringTransport::start_ring(std::string& error) {
+    ring_ = std::make_unique<Ring>();
+    ring_->enter_count = &enters_;
+    if (!ring_->setup(config_.ring_entries, error) ||
+        (buffer_ring_works() && !ring_->map_buffer_ring(config_.buffer_count, error))) {
+        return false;
+    }
+    if (!buffers_.data()) {
+        std::string map_error;
+        if (!buffers_.map(config_.buffer_count * config_.buffer_size, config_.huge_pages, true, map_error) &&
+            !buffers_.data()) {
+            error = "mapping receive buffers failed: " + map_error;
+            return false;
+        }
+    }
+    if (ring_->ring_mapped) {
+        for (unsigned id = 0; id < config_.buffer_count; ++id) {
+            ring_->provide(buffers_.data() + id * config_.buffer_size, static_cast<unsigned>(config_.buffer_size),
+                           static_cast<uint16_t>(id));
+        }
+    } else {
+        // 一次提供全部连续缓冲区，id 从 0 开始
+        io_uring_sqe* sqe = ring_->next_sqe();
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = static_cast<int>(config_.buffer_count);
+        sqe->addr = reinterpret_cast<uint64_t>(buffers_.data());
+        sqe->len = static_cast<unsigned>(config_.buffer_size);
+        sqe->buf_group = kBufferGroup;
+        sqe->off = 0;
+        sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+        sqe->user_data = kProvideTag;
+    }
+
+    // 注册文件免去每次操作的 fd 查找
+    int files[2] = {socket_, wake_fd_};
+    if (uring_register(ring_->fd, IORING_REGISTER_FILES, files, 2) != 0) {
+        error = std::string("IORING_REGISTER_FILES failed: ") + strerror(errno);
+        return false;
+    }
+
+    arm_receive();
+    if (wake_fd_ >= 0) {
+        io_uring_sqe* sqe = ring_->next_sqe();
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = kWakeSlot;
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->len = IORING_POLL_ADD_MULTI;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data = kWakeTag;
+    }
+    if (ring_->enter(0) < 0) {
+        error = std::string("io_uring_enter failed: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void UringTransport::arm_receive() {
+    io_uring_sqe* sqe = ring_->next_sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = kSocketSlot;
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = kReceiveTag;
+}
+
+void UringTransport::close() {
+    if (open_ && (ssl_ || socket_ >= 0)) {
+        // 尽力发送关闭帧，1000 正常关闭
+        send_frame(WsOpcode::Close, std::string_view("\x03\xe8", 2));
+    }
+    open_ = false;
+    ring_.reset();
+    if (ssl_) {
+        SSL_free(ssl_);     // 同时释放内存 BIO 与套接字 BIO
+        ssl_ = nullptr;
+        cipher_in_ = nullptr;
+    }
+    if (ssl_ctx_) {
+        SSL_CTX_free(ssl_ctx_);
+        ssl_ctx_ = nullptr;
+    }
+    if (socket_ >= 0) {
+        ::close(socket_);
+        socket_ = -1;
+    }
+    ktls_rx_ = ktls_tx_ = false;
+}
+
+void UringTransport::fail(std::string message) {
+    if (error_.empty()) error_ = std::move(message);
+    open_ = false;
+}
+
+bool UringTransport::poll(int timeout_ms) {
+    if (!open_) return false;
+    size_t handled = reap();
+    // 有待提交的重新挂载、内核提示有待运行的完成工作，或者完成队列为空且允许等待时才进内核
+    if (open_ && (ring_->pending > 0 || ring_->task_work_pending() || (handled == 0 && timeout_ms > 0))) {
+        if (ring_->enter(handled == 0 ? timeout_ms : 0) < 0) {
+            fail(std::string("io_uring_enter failed: ") + strerror(errno));
+            return false;
+        }
+        reap();
+    }
+    return open_;
+}
+
+size_t UringTransport::reap() {
+    unsigned head = *ring_->cq_head;
+    unsigned tail = load_acquire(ring_->cq_tail);
+    size_t count = 0;
+    for (; head != tail && open_; ++head, ++count) {
+        const io_uring_cqe& cqe = ring_->cqes[head & ring_->cq_mask];
+        if (cqe.user_data == kWakeTag) {
+            uint64_t value;
+            if (read(wake_fd_, &value, sizeof(value)) < 0) {
+                // 其它线程已读走，忽略
+            }
+            continue;
+        }
+        if (cqe.user_data == kProvideTag) {
+            fail("providing receive buffers failed: " + std::string(strerror(-cqe.res)));
+            continue;
+        }
+        if (cqe.user_data != kReceiveTag) continue;
+
+        if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+            auto id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            char* data = buffers_.data() + id * config_.buffer_size;
+            completions_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(static_cast<uint64_t>(cqe.res), std::memory_order_relaxed);
+            // 帧解码期间直接引用这块缓冲区，处理完才还给内核
+            on_receive(data, static_cast<size_t>(cqe.res));
+            ring_->provide(data, static_cast<unsigned>(config_.buffer_size), id);
+        } else if (cqe.res == 0) {
+            fail("connection closed by peer");
+        } else if (cqe.res == -ENOBUFS) {
+            // 处理速度跟不上: 缓冲区全部在用，多发接收已终止，下面重新挂载
+            buffer_exhausted_.fetch_add(1, std::memory_order_relaxed);
+        } else if (cqe.res < 0) {
+            fail(std::string("recv failed: ") + strerror(-cqe.res) +
+                 (ktls_rx_ && cqe.res == -EIO ? " (non-data TLS record on kTLS socket)" : ""));
+        }
+        if (!(cqe.flags & IORING_CQE_F_MORE) && open_) {
+            rearms_.fetch_add(1, std::memory_order_relaxed);
+            arm_receive();
+        }
+    }
+    // 连接在处理中途断开时剩余的完成项也一并丢弃
+    store_release(ring_->cq_head, tail);
+    decoder_copied_.store(decoder_.copied_bytes(), std::memory_order_relaxed);
+    return count;
+}
+
+void UringTransport::on_receive(char* data, size_t length) {
+    if (!cipher_in_) {
+        // 明文或 kTLS: 帧载荷直接指向接收缓冲区
+        if (!decoder_.feed(data, length)) fail("WebSocket protocol error: " + decoder_.error());
+        return;
+    }
+
+    BIO_write(cipher_in_, data, static_cast<int>(length));
+    if (plain_.size() < 64 * 1024) plain_.resize(64 * 1024);
+    while (open_) {
+        int n = SSL_read(ssl_, plain_.data(), static_cast<int>(plain_.size()));
+        if (n > 0) {
+            decrypted_bytes_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+            if (!decoder_.feed(plain_.data(), static_cast<size_t>(n))) {
+                fail("WebSocket protocol error: " + decoder_.error());
+            }
+            continue;
+        }
+        int code = SSL_get_error(ssl_, n);
+        if (code == SSL_ERROR_WANT_READ) break;
+        fail(code == SSL_ERROR_ZERO_RETURN ? "TLS connection closed by peer" : "TLS read failed: " + ssl_error());
+    }
+}
+
+bool UringTransport::send_text(std::string_view payload) {
+    return open_ && send_frame(WsOpcode::Text, payload);
+}
+
+bool UringTransport::send_ping() {
+    return open_ && send_frame(WsOpcode::Ping, {});
+}
+
+bool UringTransport::send_frame(WsOpcode opcode, std::string_view payload) {
+    if (send_buffer_.size() < payload.size() + WsFrameDecoder::kMaxHeader) {
+        send_buffer_.resize(payload.size() + WsFrameDecoder::kMaxHeader);
+    }
+    // 掩码只需不可预测到不被中间代理利用，xorshift 足够
+    mask_state_ ^= mask_state_ << 13;
+    mask_state_ ^= mask_state_ >> 17;
+    mask_state_ ^= mask_state_ << 5;
+    size_t length = WsFrameDecoder::encode(opcode, payload, mask_state_, send_buffer_.data(), send_buffer_.size());
+    return write_all(send_buffer_.data(), length);
+}
+
+bool UringTransport::write_all(const char* data, size_t length) {
+    // 发送只有订阅、下单和 ping，频率低，阻塞写；接收路径不受影响
+    while (length > 0) {
+        long n;
+        if (ssl_ && !ktls_tx_) {
+            n = SSL_write(ssl_, data, static_cast<int>(length));
+            if (n <= 0) {
+                fail("TLS write failed: " + ssl_error());
+                return false;
+            }
+        } else {
+            n = send(socket_, data, length, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                fail(std::string("send failed: ") + strerror(errno));
+                return false;
+            }
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+long UringTransport::read_some(char* buffer, size_t length) {
+    if (ssl_) return SSL_read(ssl_, buffer, static_cast<int>(length));
+    return recv(socket_, buffer, length, 0);
+}
+
+UringStats UringTransport::stats() const {
+    UringStats stats;
+    stats.ktls_rx = ktls_rx_;
+    stats.ktls_tx = ktls_tx_;
+    stats.buffer_ring = ring_ && ring_->ring_mapped;
+    stats.enters = enters_.load(std::memory_order_relaxed);
+    stats.completions = completions_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.messages = messages_.load(std::memory_order_relaxed);
+    stats.rearms = rearms_.load(std::memory_order_relaxed);
+    stats.buffer_exhausted = buffer_exhausted_.load(std::memory_order_relaxed);
+    stats.copied_bytes = decoder_copied_.load(std::memory_order_relaxed) + decrypted_bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#else
+
+// 未启用 OKX_WITH_IO_URING: 保留接口，连接总是失败，客户端会退回 libwebsockets
+
+struct UringTransport::Ring {};
+
+UringTransport::UringTransport(const UringTransportConfig& config) : config_(config) {}
+UringTransport::~UringTransport() = default;
+
+bool UringTransport::available(std::string& error) {
+    error = "built without OKX_WITH_IO_URING";
+    return false;
+}
+
+bool UringTransport::connect(const std::string&, int, const std::string&, bool, std::string& error) {
+    error = "built without OKX_WITH_IO_URING";
+    return false;
+}
+
+void UringTransport::close() {}
+bool UringTransport::poll(int) { return false; }
+bool UringTransport::send_text(std::string_view) { return false; }
+bool UringTransport::send_ping() { return false; }
+UringStats UringTransport::stats() const { return {}; }
+
+#endif
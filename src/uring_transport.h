@@ -0,0 +1,122 @@
+#pragma once
+#include "latency_mode.h"
+#include "ws_frame.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+struct ssl_st;
+struct ssl_ctx_st;
+struct bio_st;
+
+// io_uring 传输: 不经过 libwebsockets 的 poll 循环。接收用多发 recv + 内核提供缓冲区（缓冲区环不可用时退回 PROVIDE_BUFFERS），
+// 一次提交后每个到达的报文段只产生一个完成项，忙轮询时直接读共享内存中的完成队列，不进内核；
+// TLS 握手仍由 OpenSSL 完成，内核支持 tls ULP 时交给 kTLS 解密，收到的就是明文，帧载荷直接从接收缓冲区交给解析器。
+// 需要 OKX_WITH_IO_URING 编译且内核 >= 6.0
+
+struct UringTransportConfig {
+    unsigned ring_entries = 64;
+    unsigned buffer_count = 64;         // 接收缓冲区个数，2 的幂
+    size_t buffer_size = 64 * 1024;
+    HugePageMode huge_pages = HugePageMode::None;
+    // 让 OpenSSL 在握手后开启 kTLS（SSL_OP_ENABLE_KTLS）。OpenSSL 3.0 只支持 TLS 1.2 的内核接收，
+    // 所以内核有 tls ULP 时会把协议上限设为 TLS 1.2；否则不改变协商，在用户态解密
+    bool ktls = true;
+};
+
+struct UringStats {
+    bool ktls_rx;
+    bool ktls_tx;
+    bool buffer_ring;           // 缓冲区经内核缓冲区环归还；否则每次归还提交 IORING_OP_PROVIDE_BUFFERS
+    uint64_t enters;            // io_uring_enter 调用次数
+    uint64_t completions;       // 带数据的接收完成项
+    uint64_t bytes;             // 从套接字收到的字节
+    uint64_t messages;          // 交给回调的数据消息
+    uint64_t rearms;            // 多发接收终止后重新提交
+    uint64_t buffer_exhausted;  // 缓冲区环用尽（-ENOBUFS）
+    uint64_t copied_bytes;      // 帧跨缓冲区、分片重组或用户态解密时的拷贝
+};
+
+class UringTransport {
+public:
+    using MessageHandler = std::function<void(std::string_view)>;
+    using PongHandler = std::function<void()>;
+
+    explicit UringTransport(const UringTransportConfig& config = {});
+    ~UringTransport();
+    UringTransport(const UringTransport&) = delete;
+    UringTransport& operator=(const UringTransport&) = delete;
+
+    // 能否创建 io_uring（容器里常被 seccomp 或 io_uring_disabled 禁用）
+    static bool available(std::string& error);
+
+    void set_message_handler(MessageHandler handler) { on_message_ = std::move(handler); }
+    void set_pong_handler(PongHandler handler) { on_pong_ = std::move(handler); }
+    // 其它线程向此 eventfd 写入即可唤醒阻塞在 poll() 中的线程；由调用方持有，需在 connect() 之前设置
+    void set_wake_fd(int fd) { wake_fd_ = fd; }
+
+    // 阻塞完成 TCP 连接、TLS 握手和 WebSocket 升级，然后提交多发接收
+    bool connect(const std::string& host, int port, const std::string& path, bool use_ssl, std::string& error);
+    void close();
+
+    // 处理已完成的接收并分发消息，最多等待 timeout_ms；为 0 时只检查完成队列，没有需要提交的请求就不进内核。
+    // 连接已断开返回 false，原因见 error()
+    bool poll(int timeout_ms);
+
+    // 服务线程调用；帧带掩码，同步写出
+    bool send_text(std::string_view payload);
+    bool send_ping();
+
+    bool is_open() const { return open_; }
+    const std::string& error() const { return error_; }
+    UringStats stats() const;
+
+    // io_uring 映射，实现细节
+    struct Ring;
+
+private:
+    UringTransportConfig config_;
+    std::unique_ptr<Ring> ring_;
+    HotRegion buffers_;
+    int socket_ = -1;
+    int wake_fd_ = -1;
+    ssl_ctx_st* ssl_ctx_ = nullptr;
+    ssl_st* ssl_ = nullptr;
+    bio_st* cipher_in_ = nullptr;       // 未开启 kTLS 接收时，密文写入此内存 BIO 再由 SSL_read 解密
+    bool ktls_rx_ = false;
+    bool ktls_tx_ = false;
+    bool open_ = false;
+    std::string error_;
+
+    WsFrameDecoder decoder_;
+    std::string plain_;                 // 用户态解密输出
+    std::string send_buffer_;
+    uint32_t mask_state_ = 0;
+    MessageHandler on_message_;
+    PongHandler on_pong_;
+
+    std::atomic<uint64_t> enters_{0};
+    std::atomic<uint64_t> completions_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> rearms_{0};
+    std::atomic<uint64_t> buffer_exhausted_{0};
+    std::atomic<uint64_t> decrypted_bytes_{0};
+    std::atomic<uint64_t> decoder_copied_{0};
+
+    bool open_socket(const std::string& host, int port, std::string& error);
+    bool handshake_tls(const std::string& host, std::string& error);
+    bool upgrade(const std::string& host, int port, const std::string& path, std::string& leftover, std::string& error);
+    bool start_ring(std::string& error);
+    void arm_receive();
+    size_t reap();
+    void on_receive(char* data, size_t length);
+    void fail(std::string message);
+    bool send_frame(WsOpcode opcode, std::string_view payload);
+    bool write_all(const char* data, size_t length);
+    long read_some(char* buffer, size_t length);
+};
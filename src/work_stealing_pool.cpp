@@ -0,0 +1,106 @@
+#include "work_stealing_pool.h"
+#include "thread_config.h"
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(size_t threads, std::vector<int> cpus) : cpus_(std::move(cpus)) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) workers_.push_back(std::make_unique<Worker>());
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) threads_.emplace_back([this, i] { worker_main(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+void WorkStealingPool::run(std::vector<Job> jobs) {
+    if (jobs.empty()) return;
+
+    size_t count = workers_.size();
+    pending_.store(jobs.size(), std::memory_order_relaxed);
+    for (size_t w = 0; w < count; ++w) {
+        size_t begin = jobs.size() * w / count;
+        size_t end = jobs.size() * (w + 1) / count;
+        std::lock_guard<std::mutex> lock(workers_[w]->mutex);
+        for (size_t i = begin; i < end; ++i) workers_[w]->jobs.push_back(std::move(jobs[i]));
+    }
+
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    ++generation_;
+    wake_cv_.notify_all();
+    done_cv_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+void WorkStealingPool::worker_main(size_t self) {
+    // 绑核只影响 worker 线程，不改变调用线程；线程常驻，只需设置一次
+    if (!cpus_.empty()) {
+        ThreadConfig config;
+        config.cpus = {cpus_[self % cpus_.size()]};
+        ThreadPlacement::apply(config);
+    }
+
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(park_mutex_);
+            wake_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        work(self);
+    }
+}
+
+void WorkStealingPool::work(size_t self) {
+    // 任务只在 run() 开始时入队，自己的队列和别人的队列都空说明没有可取的任务了，
+    // 剩下的正在其他 worker 上执行，直接回去等下一轮，不空转
+    Job job;
+    while (pop(self, job) || steal(self, job)) {
+        job(self);
+        job = nullptr;
+        workers_[self]->executed++;
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            done_cv_.notify_all();
+        }
+    }
+}
+
+bool WorkStealingPool::pop(size_t self, Job& job) {
+    Worker& worker = *workers_[self];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.jobs.empty()) return false;
+    job = std::move(worker.jobs.front());
+    worker.jobs.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t self, Job& job) {
+    size_t count = workers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(self + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) continue;
+        job = std::move(victim.jobs.back());
+        victim.jobs.pop_back();
+        workers_[self]->stolen++;
+        return true;
+    }
+    return false;
+}
+
+WorkStealingPool::Stats WorkStealingPool::stats() const {
+    Stats stats{0, 0};
+    for (const auto& worker : workers_) {
+        stats.executed += worker->executed;
+        stats.stolen += worker->stolen;
+    }
+    return stats;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 批量任务的工作窃取线程池: 每个 worker 一个双端队列，
+// 自己从队头顺序取（相邻任务通常读相邻数据），空闲时从其他 worker 的队尾偷。
+// worker 线程在构造时创建并绑核，两次 run() 之间停在条件变量上，不占 CPU
+class WorkStealingPool {
+public:
+    using Job = std::function<void(size_t worker)>;
+
+    struct Stats {
+        uint64_t executed;
+        uint64_t stolen;
+    };
+
+    // threads 为 0 时取硬件线程数；cpus 非空时 worker i 绑到 cpus[i % cpus.size()]
+    explicit WorkStealingPool(size_t threads = 0, std::vector<int> cpus = {});
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // 按连续区间把任务分给各 worker，唤醒它们并阻塞到全部完成；worker 参数为 [0, size())，可用来索引每线程状态
+    // 同一时刻只能有一个线程调用
+    void run(std::vector<Job> jobs);
+
+    // 累计值，跨多次 run()
+    Stats stats() const;
+
+private:
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<int> cpus_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> pending_{0};
+
+    // generation_ 每次 run() 加一唤醒 worker；最后一个任务完成时唤醒 run()
+    std::mutex park_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+
+    void worker_main(size_t self);
+    void work(size_t self);
+    bool pop(size_t self, Job& job);
+    bool steal(size_t self, Job& job);
+};
@@ -0,0 +1,167 @@
+#include "ws_frame.h"
+#include <cstring>
+
+WsFrameDecoder::WsFrameDecoder(size_t max_message) : max_message_(max_message) {}
+
+void WsFrameDecoder::reset() {
+    pending_.clear();
+    message_.clear();
+    in_message_ = false;
+    error_.clear();
+}
+
+bool WsFrameDecoder::fail(std::string message) {
+    error_ = std::move(message);
+    return false;
+}
+
+bool WsFrameDecoder::feed(char* data, size_t length) {
+    if (!error_.empty()) return false;
+
+    if (!pending_.empty()) {
+        // 先凑齐上一次留下的半帧；之后的帧仍从输入中直接解码
+        size_t before = pending_.size();
+        pending_.append(data, length);
+        copied_bytes_ += length;
+        size_t used = decode_one(pending_.data(), pending_.size());
+        if (used == SIZE_MAX) return false;
+        if (used == 0) return true;
+        size_t from_input = used - before;
+        pending_.clear();
+        data += from_input;
+        length -= from_input;
+    }
+
+    while (length > 0) {
+        size_t used = decode_one(data, length);
+        if (used == SIZE_MAX) return false;
+        if (used == 0) {
+            if (length > max_message_ + kMaxHeader) return fail("frame exceeds maximum message size");
+            pending_.assign(data, length);
+            copied_bytes_ += length;
+            return true;
+        }
+        data += used;
+        length -= used;
+    }
+    return true;
+}
+
+size_t WsFrameDecoder::decode_one(char* data, size_t length) {
+    if (length < 2) return 0;
+    auto* bytes = reinterpret_cast<unsigned char*>(data);
+    bool fin = bytes[0] & 0x80;
+    if (bytes[0] & 0x70) {
+        fail("reserved bits set (no extensions negotiated)");
+        return SIZE_MAX;
+    }
+    auto opcode = static_cast<WsOpcode>(bytes[0] & 0x0F);
+    bool masked = bytes[1] & 0x80;
+    uint64_t payload = bytes[1] & 0x7F;
+    size_t header = 2;
+    if (payload == 126) {
+        if (length < 4) return 0;
+        payload = (uint64_t(bytes[2]) << 8) | bytes[3];
+        header = 4;
+    } else if (payload == 127) {
+        if (length < 10) return 0;
+        payload = 0;
+        for (int i = 0; i < 8; ++i) payload = (payload << 8) | bytes[2 + i];
+        header = 10;
+    }
+    if (payload > max_message_) {
+        fail("frame of " + std::to_string(payload) + " bytes exceeds maximum message size");
+        return SIZE_MAX;
+    }
+    size_t mask_at = header;
+    if (masked) header += 4;
+    if (length < header + payload) return 0;
+
+    char* body = data + header;
+    if (masked) {
+        for (size_t i = 0; i < payload; ++i) body[i] ^= data[mask_at + (i & 3)];
+    }
+    std::string_view view(body, static_cast<size_t>(payload));
+    frames_++;
+
+    switch (opcode) {
+        case WsOpcode::Text:
+        case WsOpcode::Binary:
+            if (in_message_) {
+                fail("new data frame inside a fragmented message");
+                return SIZE_MAX;
+            }
+            if (fin) {
+                if (on_message_) on_message_(view, opcode == WsOpcode::Binary);
+            } else {
+                in_message_ = true;
+                message_binary_ = opcode == WsOpcode::Binary;
+                message_.assign(view);
+                copied_bytes_ += view.size();
+            }
+            break;
+
+        case WsOpcode::Continuation:
+            if (!in_message_) {
+                fail("continuation frame without a message");
+                return SIZE_MAX;
+            }
+            if (message_.size() + view.size() > max_message_) {
+                fail("fragmented message exceeds maximum message size");
+                return SIZE_MAX;
+            }
+            message_.append(view);
+            copied_bytes_ += view.size();
+            if (fin) {
+                in_message_ = false;
+                if (on_message_) on_message_(message_, message_binary_);
+                message_.clear();
+            }
+            break;
+
+        case WsOpcode::Close:
+        case WsOpcode::Ping:
+        case WsOpcode::Pong:
+            // 控制帧可以插在分片消息中间，但自身不能分片
+            if (!fin || payload > 125) {
+                fail("invalid control frame");
+                return SIZE_MAX;
+            }
+            if (on_control_) on_control_(opcode, view);
+            break;
+
+        default:
+            fail("unknown opcode " + std::to_string(static_cast<int>(opcode)));
+            return SIZE_MAX;
+    }
+    return header + static_cast<size_t>(payload);
+}
+
+size_t WsFrameDecoder::encode(WsOpcode opcode, std::string_view payload, uint32_t mask, char* out, size_t capacity) {
+    size_t header = payload.size() < 126 ? 6 : payload.size() <= 0xFFFF ? 8 : 14;
+    if (capacity < header + payload.size()) return 0;
+
+    auto* bytes = reinterpret_cast<unsigned char*>(out);
+    bytes[0] = 0x80 | static_cast<unsigned char>(opcode);
+    size_t at = 2;
+    if (payload.size() < 126) {
+        bytes[1] = 0x80 | static_cast<unsigned char>(payload.size());
+    } else if (payload.size() <= 0xFFFF) {
+        bytes[1] = 0x80 | 126;
+        bytes[2] = static_cast<unsigned char>(payload.size() >> 8);
+        bytes[3] = static_cast<unsigned char>(payload.size());
+        at = 4;
+    } else {
+        bytes[1] = 0x80 | 127;
+        for (int i = 0; i < 8; ++i) bytes[2 + i] = static_cast<unsigned char>(uint64_t(payload.size()) >> (56 - 8 * i));
+        at = 10;
+    }
+    unsigned char key[4] = {static_cast<unsigned char>(mask >> 24), static_cast<unsigned char>(mask >> 16),
+                            static_cast<unsigned char>(mask >> 8), static_cast<unsigned char>(mask)};
+    memcpy(out + at, key, 4);
+    at += 4;
+    for (size_t i = 0; i < payload.size(); ++i) {
+        out[at + i] = static_cast<char>(payload[i] ^ key[i & 3]);
+    }
+    return at + payload.size();
+}
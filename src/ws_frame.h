@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// 精简 WebSocket 帧编解码（RFC 6455），供 io_uring 传输使用；不支持扩展（permessage-deflate）
+
+enum class WsOpcode : uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA,
+};
+
+// 服务端到客户端方向的帧解码: 完整落在输入中的单帧消息直接以指向输入的视图交出，不拷贝；
+// 跨输入的帧和分片消息在内部缓冲区重组
+class WsFrameDecoder {
+public:
+    // 数据消息（Text/Binary），payload 只在回调期间有效
+    using MessageHandler = std::function<void(std::string_view payload, bool binary)>;
+    // 控制帧（Close/Ping/Pong）
+    using ControlHandler = std::function<void(WsOpcode opcode, std::string_view payload)>;
+
+    explicit WsFrameDecoder(size_t max_message = 16 * 1024 * 1024);
+
+    void set_message_handler(MessageHandler handler) { on_message_ = std::move(handler); }
+    void set_control_handler(ControlHandler handler) { on_control_ = std::move(handler); }
+
+    // 带掩码的帧在原地去掩码，所以输入可写；协议错误返回 false，之后的输入都被拒绝
+    bool feed(char* data, size_t length);
+    void reset();
+
+    const std::string& error() const { return error_; }
+    uint64_t frames() const { return frames_; }
+    uint64_t copied_bytes() const { return copied_bytes_; }   // 因跨输入或分片而拷贝的字节数
+
+    // 客户端帧必须带掩码；out 至少 payload.size() + kMaxHeader 字节，返回帧长度，空间不足返回 0
+    static constexpr size_t kMaxHeader = 14;
+    static size_t encode(WsOpcode opcode, std::string_view payload, uint32_t mask, char* out, size_t capacity);
+
+private:
+    MessageHandler on_message_;
+    ControlHandler on_control_;
+    size_t max_message_;
+    std::string pending_;           // 不完整的帧
+    std::string message_;           // 分片消息
+    bool in_message_ = false;
+    bool message_binary_ = false;
+    std::string error_;
+    uint64_t frames_ = 0;
+    uint64_t copied_bytes_ = 0;
+
+    // 解析 [data, data+length) 开头的帧，返回消耗的字节数；不完整返回 0，出错返回 SIZE_MAX
+    size_t decode_one(char* data, size_t length);
+    bool fail(std::string message);
+};
@@ -0,0 +1,103 @@
+#include "../src/json_parser.h"
+#include "test_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// 全局分配计数钩子，只在 counting 打开时统计
+static std::atomic<size_t> allocation_count{0};
+static std::atomic<bool> counting{false};
+
+void* operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+static std::string make_message(int ticker_count) {
+    std::string json = R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[)";
+    for (int i = 0; i < ticker_count; ++i) {
+        if (i > 0) json += ",";
+        json += R"({"instType":"SPOT","instId":"INST)" + std::to_string(i) +
+                R"(-USDT","last":"43250.5","lastSz":"0.1234","askPx":"43251.0","askSz":"1.5","bidPx":"43249.5","bidSz":"2.3","open24h":"42000.0","high24h":"43500.0","low24h":"41500.0","volCcy24h":"1234567.89","vol24h":"29.456","sodUtc0":"42100.0","sodUtc8":"42150.0","ts":"1703073600000"})";
+    }
+    json += "]}";
+    return json;
+}
+
+int main() {
+    std::cout << "🧮 批量解析堆分配测试" << std::endl;
+
+    std::vector<std::string> messages;
+    for (int count : {1, 3, 50, 7, 200, 2}) {
+        messages.push_back(make_message(count));
+    }
+
+    TickerBatch batch;
+    TickerData scratch;
+
+    // 预热: 让arena和视图数组增长到最大消息所需的容量
+    for (const auto& message : messages) {
+        JsonParser::parse_ticker_data_into(message, batch);
+        for (const auto& view : batch) {
+            scratch.assign(view);
+        }
+    }
+
+    size_t parsed = 0;
+    counting = true;
+    for (int round = 0; round < 1000; ++round) {
+        for (const auto& message : messages) {
+            if (JsonParser::parse_ticker_data_into(message, batch)) {
+                parsed += batch.size();
+                for (const auto& view : batch) {
+                    scratch.assign(view);
+                }
+            }
+        }
+    }
+    counting = false;
+
+    std::cout << "  解析ticker数: " << parsed << std::endl;
+    std::cout << "  稳态堆分配次数: " << allocation_count.load() << std::endl;
+    std::cout << "  arena容量: " << batch.arena().capacity() << " 字节" << std::endl;
+
+    check(parsed == 1000u * (1 + 3 + 50 + 7 + 200 + 2), "解析数量正确");
+    check(allocation_count.load() == 0, "稳态解析无堆分配");
+
+    // batch内容不依赖输入缓冲区
+    std::string temp = make_message(2);
+    JsonParser::parse_ticker_data_into(temp, batch);
+    temp.assign(temp.size(), 'x');
+    check(batch.size() == 2 && batch[1].inst_id == "INST1-USDT" && batch[1].last == "43250.5",
+          "batch视图内容不依赖输入缓冲区");
+
+    return test_summary();
+}
@@ -0,0 +1,161 @@
+#include "../src/async_logger.h"
+#include "test_util.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+static int evaluated = 0;
+
+static int side_effect() {
+    return ++evaluated;
+}
+
+static std::vector<std::string> read_lines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void test_formatting_and_filtering(const std::string& path) {
+    std::string_view view = "ETH-USDT";
+    std::string text = "subscribe";
+    OKX_LOG_INFO("tick {} last={} size={} ok={} side={} op={}", "BTC-USDT", 43250.5, uint64_t(42), true, 'B', text);
+    OKX_LOG_WARN("stale {} for {}ms", view, int64_t(-7));
+    OKX_LOG_ERROR("no args");
+    // 编译期级别高于 DEBUG 时，DEBUG 调用的参数不会被求值
+    OKX_LOG_DEBUG("debug {}", side_effect());
+
+    AsyncLogger::set_level(LogLevel::Warn);
+    OKX_LOG_INFO("filtered at runtime {}", 1);
+    AsyncLogger::set_level(LogLevel::Debug);
+    AsyncLogger::flush();
+
+    constexpr bool debug_compiled = OKX_LOG_LEVEL <= OKX_LOG_LEVEL_DEBUG;
+    auto lines = read_lines(path);
+    check(lines.size() == (debug_compiled ? 4u : 3u), "编译期和运行期过滤生效");
+    check(evaluated == (debug_compiled ? 1 : 0), "被编译期过滤的DEBUG参数不求值");
+    if (lines.size() >= 3) {
+        check(lines[0].find("INFO  [T") != std::string::npos &&
+              lines[0].find("] tick BTC-USDT last=43250.5 size=42 ok=true side=B op=subscribe") != std::string::npos,
+              "二进制参数在后台线程格式化");
+        check(lines[1].find("WARN ") != std::string::npos && lines[1].find("stale ETH-USDT for -7ms") != std::string::npos,
+              "string_view和有符号整数");
+        check(lines[2].find("ERROR") != std::string::npos && lines[2].ends_with("no args"), "无参数记录");
+        check(lines[0].size() > 26 && lines[0][4] == '-' && lines[0][19] == '.', "带微秒时间戳");
+    }
+}
+
+static void test_multithreaded(const std::string& path) {
+    constexpr int threads = 4;
+    constexpr int per_thread = 20000;
+    size_t before = read_lines(path).size();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([t] {
+            for (int i = 0; i < per_thread; ++i) {
+                OKX_LOG_INFO("worker {} seq {}", t, i);
+                if (i % 1000 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    AsyncLogger::flush();
+
+    auto lines = read_lines(path);
+    std::set<std::string> seen;
+    for (size_t i = before; i < lines.size(); ++i) {
+        size_t at = lines[i].find("worker ");
+        if (at != std::string::npos) seen.insert(lines[i].substr(at));
+    }
+    uint64_t dropped = AsyncLogger::dropped();
+    check(seen.size() + dropped == threads * per_thread, "多线程写入: 写出+丢弃=调用次数");
+    check(dropped == 0, "1MB环在该负载下不丢日志");
+}
+
+static void test_ring_full() {
+    // 小环 + 不让后台线程跟上: 满了直接丢弃而不是阻塞
+    LogRing ring(4096);
+    size_t accepted = 0;
+    for (int i = 0; i < 1000; ++i) {
+        if (char* out = ring.reserve(40)) {
+            memset(out, i & 0xff, 40);
+            ring.commit();
+            ++accepted;
+        }
+    }
+    check(accepted == 4096 / 48, "环满时reserve返回空");
+
+    size_t drained = ring.drain([](const char*, size_t size) { (void)size; });
+    check(drained == accepted && ring.empty(), "消费端取完全部记录");
+
+    // 回绕: 填充记录被跳过
+    bool intact = true;
+    size_t total = 0;
+    for (int round = 0; round < 200; ++round) {
+        size_t size = 24 + (round * 37) % 400;
+        char* out = ring.reserve(size);
+        if (!out) { intact = false; break; }
+        memset(out, round & 0xff, size);
+        ring.commit();
+        ring.drain([&](const char* payload, size_t length) {
+            for (size_t i = 0; i < size; ++i) {
+                if (static_cast<unsigned char>(payload[i]) != (round & 0xff)) intact = false;
+            }
+            if (length < size) intact = false;
+            ++total;
+        });
+    }
+    check(intact && total == 200, "跨环尾回绕的记录完整");
+}
+
+static void benchmark_hot_path() {
+    // 一批1万条放得进1MB环，测的是调用方开销而不是后台线程的吞吐
+    constexpr int batch = 10000;
+    constexpr int rounds = 20;
+    std::string_view inst_id = "BTC-USDT";
+    int64_t best = INT64_MAX;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batch; ++i) {
+            OKX_LOG_INFO("bench {} {} {}", inst_id, 43250.5 + i, i);
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        best = std::min<int64_t>(best, ns);
+        AsyncLogger::flush();
+    }
+    std::cout << "⚡ 热路径写日志: " << best / batch << " ns/条" << std::endl;
+}
+
+int main() {
+    std::cout << "📝 异步日志测试" << std::endl;
+
+    std::string path = "/tmp/okx_async_logger_test_" + std::to_string(getpid()) + ".log";
+    if (!AsyncLogger::open_file(path)) {
+        std::cerr << "❌ 无法打开日志文件" << std::endl;
+        return 1;
+    }
+
+    test_formatting_and_filtering(path);
+    test_multithreaded(path);
+    test_ring_full();
+    benchmark_hot_path();
+
+    AsyncLogger::shutdown();
+    unlink(path.c_str());
+
+    return test_summary();
+}
@@ -0,0 +1,142 @@
+#include "../src/bar_aggregator.h"
+#include "test_util.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 回调中的 inst_id 指向聚合器内部，这里拷贝出来
+struct Closed {
+    std::string inst_id;
+    Bar bar;
+};
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-9;
+}
+
+static void test_event_time() {
+    BarAggregator bars({1000, 60000});
+    std::vector<Closed> closed;
+    std::vector<size_t> batches;
+    bars.set_callback([&](std::span<const Bar> batch) {
+        batches.push_back(batch.size());
+        for (const Bar& bar : batch) closed.push_back({std::string(bar.inst_id), bar});
+    });
+
+    int64_t base = 1700000040000;   // 整分钟
+    bars.on_tick("BTC-USDT", 100, 5000, base + 100);
+    bars.on_tick("BTC-USDT", 103, 5002, base + 400);
+    bars.on_tick("BTC-USDT", 99, 5003.5, base + 900);
+    bars.on_tick("BTC-USDT", 101, 5003, base + 950);   // 24h 窗口滑出，负差值记 0
+    bars.flush();
+    check(closed.empty(), "周期未结束不收线");
+
+    bars.on_tick("BTC-USDT", 102, 5004, base + 1200);
+    bars.flush();
+    check(closed.size() == 1 && batches.back() == 1, "跨秒时收掉 1s K线");
+    const Bar& bar = closed[0].bar;
+    check(closed[0].inst_id == "BTC-USDT" && bar.interval_ms == 1000 && bar.start_ms == base, "周期与对齐的开始时间");
+    check(near(bar.open, 100) && near(bar.high, 103) && near(bar.low, 99) && near(bar.close, 101) && bar.ticks == 4, "OHLC");
+    check(near(bar.volume, 3.5), "成交量为 vol24h 正差值之和: " + std::to_string(bar.volume));
+
+    // 跳过整分钟: 1s 和 1m 同时收线，同一批交付
+    bars.on_tick("BTC-USDT", 110, 5010, base + 60000 + 5);
+    bars.flush();
+    check(closed.size() == 3 && batches.back() == 2, "跨分钟时多个周期同批交付");
+    check(closed[2].bar.interval_ms == 60000 && near(closed[2].bar.high, 103) && closed[2].bar.ticks == 5 &&
+          near(closed[2].bar.volume, 4.5), "1m K线包含全部 tick");
+
+    // 乱序: ts 落在已收线的秒内
+    bars.on_tick("BTC-USDT", 1, 5010, base + 1500);
+    check(bars.stats().late_ticks == 1, "迟到 tick 计数并丢弃");
+    check(bars.stats().ticks == 7 && bars.stats().bars_closed == 3, "统计");
+}
+
+static void test_instruments_and_timer() {
+    BarAggregator bars({1000}, 200, 10);
+    std::vector<Closed> closed;
+    bars.set_callback([&](std::span<const Bar> batch) {
+        for (const Bar& bar : batch) closed.push_back({std::string(bar.inst_id), bar});
+    });
+
+    int64_t now = BarAggregator::now_ms();
+    int64_t start = now - now % 1000;
+    for (int i = 0; i < 50; ++i) {
+        bars.on_tick("INST-" + std::to_string(i), 10 + i, 0, start + 10);
+    }
+    check(bars.instrument_count() == 50, "按交易对分配平铺状态");
+
+    // 无新 tick: 周期结束 + grace 之前不收，之后由时间轮收线
+    bars.poll(start + 1000 + 150);
+    bars.flush();
+    check(closed.empty(), "grace 期间不收线");
+    bars.poll(start + 1000 + 260);
+    bars.flush();
+    check(closed.size() == 50 && bars.stats().timer_closes == 50, "停顿的交易对由时间轮收线");
+    bool matched = true;
+    for (const Closed& c : closed) {
+        matched &= near(c.bar.close, 10 + std::stoi(c.inst_id.substr(5)));
+    }
+    check(matched, "交易对名称与价格对应");
+
+    // 收线后晚到的同一秒 tick 视为迟到
+    bars.on_tick("INST-0", 1, 0, start + 999);
+    check(bars.stats().late_ticks == 1, "时间轮收线后的迟到 tick");
+}
+
+static void test_ticker_view() {
+    BarAggregator bars({1000});
+    std::vector<Closed> closed;
+    bars.set_callback([&](std::span<const Bar> batch) {
+        for (const Bar& bar : batch) closed.push_back({std::string(bar.inst_id), bar});
+    });
+    TickerView view{};
+    view.inst_id = "ETH-USDT";
+    view.last = "2000.5";
+    view.vol24h = "10";
+    view.ts = "1700000000100";
+    bars.on_tick(view);
+    view.last = "bad";
+    bars.on_tick(view);
+    view.last = "2001";
+    view.vol24h = "12.25";
+    view.ts = "1700000001100";
+    bars.on_tick(view);
+    bars.flush();
+    check(closed.size() == 1 && near(closed[0].bar.open, 2000.5) && closed[0].bar.ticks == 1, "从 TickerView 解析，无效价格忽略");
+}
+
+static void benchmark() {
+    BarAggregator bars({1000, 60000, 300000});
+    size_t closed = 0;
+    bars.set_callback([&](std::span<const Bar> batch) { closed += batch.size(); });
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i) names.push_back("INST-" + std::to_string(i));
+
+    const int iterations = 2000000;
+    int64_t ts = 1700000000000;
+    double vol = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        vol += 0.5;
+        ts += 1;
+        bars.on_tick(names[i % names.size()], 100.0 + (i & 15), vol, ts);
+        if ((i & 63) == 0) bars.flush();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+    std::cout << "  3 个周期 x 200 交易对: " << ns << " 纳秒/tick, 收线 " << closed << " 根" << std::endl;
+}
+
+int main() {
+    std::cout << "📊 K线聚合测试" << std::endl;
+
+    test_event_time();
+    test_instruments_and_timer();
+    test_ticker_view();
+    benchmark();
+
+    return test_summary();
+}
@@ -0,0 +1,208 @@
+#include "../src/ticker_fields.h"
+#include "../src/ticker_handler.h"
+#include "test_util.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 批量交付: 按消息和按服务轮次成批、批次结束回调、跨消息累积后视图仍有效、过滤器，以及按批重算信号与逐条重算的开销对比
+
+static std::string make_message(int first, int count) {
+    std::string message = R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[)";
+    for (int i = 0; i < count; ++i) {
+        int seq = first + i;
+        if (i > 0) message += ",";
+        message += R"({"instType":"SPOT","instId":"INST-)" + std::to_string(seq % 100) + R"(","last":")" +
+                   std::to_string(100 + seq) + R"(","lastSz":"1","askPx":"1","askSz":"1","bidPx":")" + std::to_string(99 + seq) +
+                   R"(","bidSz":"1","open24h":"1","high24h":"1","low24h":"1","volCcy24h":"1","vol24h":"1",)"
+                   R"("sodUtc0":"1","sodUtc8":"1","ts":")" + std::to_string(1703073600000LL + seq) + R"("})";
+    }
+    return message + "]}";
+}
+
+static void test_message_scope() {
+    std::vector<std::string> events;
+    TickerHandler handler([&](const TickerData& ticker) { events.push_back("tick " + ticker.inst_id); });
+    size_t batch_size = 0;
+    handler.set_batch_callback([&](std::span<const TickerView> tickers) {
+        batch_size = tickers.size();
+        events.push_back("batch");
+    }, [&] { events.push_back("end"); });
+
+    handler.handle_message(make_message(0, 3));
+    check(batch_size == 3, "Message: 一条消息的 3 个 ticker 一次交付");
+    check(events.size() == 5 && events[2] == "tick INST-2" && events[3] == "batch" && events[4] == "end",
+          "逐条回调在前，随后 on_batch 与批次结束回调");
+
+    events.clear();
+    handler.handle_message(R"({"event":"subscribe","arg":{"channel":"tickers","instId":"BTC-USDT"}})");
+    check(events.empty(), "非 ticker 消息不产生批次");
+}
+
+static void test_service_pass_scope() {
+    TickerHandler handler(nullptr);
+    std::vector<std::string> inst_ids;
+    std::vector<std::string> lasts;
+    int batches = 0;
+    int ends = 0;
+    handler.set_batch_callback([&](std::span<const TickerView> tickers) {
+        batches++;
+        for (const auto& ticker : tickers) {
+            inst_ids.emplace_back(ticker.inst_id);
+            lasts.emplace_back(ticker.last);
+        }
+    }, [&] { ends++; }, TickerHandler::BatchScope::ServicePass);
+
+    for (int message = 0; message < 3; ++message) {
+        // 每条消息的缓冲区在交付前就已释放，批次里的视图必须指向拷贝
+        std::string frame = make_message(message * 2, 2);
+        handler.handle_message(frame);
+        frame.assign(frame.size(), 'x');
+    }
+    check(batches == 0 && ends == 0, "ServicePass: flush 之前不交付");
+
+    handler.flush_batch();
+    check(batches == 1 && ends == 1 && inst_ids.size() == 6, "一轮 3 条消息合成一批 6 个 ticker");
+    check(inst_ids[0] == "INST-0" && inst_ids[5] == "INST-5" && lasts[3] == "103", "累积的视图在原消息释放后仍有效");
+
+    handler.flush_batch();
+    check(batches == 1 && ends == 1, "没有新 ticker 时 flush 不回调");
+
+    handler.handle_message(make_message(10, 1));
+    handler.flush_batch();
+    check(batches == 2 && inst_ids.size() == 7 && inst_ids[6] == "INST-10", "缓冲区复用后下一轮正常交付");
+}
+
+static void test_end_hook_only() {
+    int ticks = 0;
+    int ends = 0;
+    TickerHandler handler([&](const TickerData&) { ticks++; });
+    handler.set_batch_callback(nullptr, [&] { ends++; }, TickerHandler::BatchScope::ServicePass);
+
+    handler.handle_message(make_message(0, 4));
+    handler.handle_message(make_message(4, 4));
+    handler.flush_batch();
+    check(ticks == 8 && ends == 1, "只设批次结束回调: 逐条回调 8 次，结束回调 1 次");
+}
+
+static void test_field_mask() {
+    TickerHandler handler(nullptr);
+    handler.set_field_mask(TickerField::Quote);
+    bool quote_only = false;
+    handler.set_batch_callback([&](std::span<const TickerView> tickers) {
+        quote_only = tickers.size() == 2 && !tickers[1].bid_px.empty() && tickers[1].vol24h.empty() && tickers[1].inst_type.empty();
+    }, {}, TickerHandler::BatchScope::ServicePass);
+    handler.handle_message(make_message(0, 2));
+    handler.flush_batch();
+    check(quote_only, "批量回调按 set_field_mask 只解析请求的字段");
+}
+
+static void test_filter() {
+    std::vector<std::string> stage_ids;
+    std::vector<std::string> tick_ids;
+    std::vector<std::string> batch_ids;
+    TickerHandler handler([&](const TickerData& ticker) { tick_ids.push_back(ticker.inst_id); });
+    handler.add_stage([&](const TickerView& ticker) { stage_ids.emplace_back(ticker.inst_id); }, TickerField::InstId);
+    handler.set_field_mask(TickerField::Last);
+    handler.set_batch_callback([&](std::span<const TickerView> tickers) {
+        for (const auto& ticker : tickers) batch_ids.emplace_back(ticker.inst_id);
+    });
+    // 只放行 ts 为偶数的 ticker
+    handler.set_filter([](const TickerView& ticker) { return (ticker.ts.back() - '0') % 2 == 0; },
+                       TickerField::InstId | TickerField::Ts);
+
+    handler.handle_message(make_message(0, 4));
+    check(stage_ids == std::vector<std::string>{"INST-0", "INST-2"} && tick_ids == stage_ids && batch_ids == stage_ids,
+          "过滤掉的 ticker 不进入阶段、逐条回调和批次");
+    check(handler.field_mask() & TickerField::Ts, "过滤器读取的字段计入解析掩码");
+
+    stage_ids.clear();
+    handler.handle_message(make_message(1, 1));
+    check(stage_ids.empty() && batch_ids.size() == 2, "整条消息都被过滤时不产生批次");
+}
+
+// 策略在每次回调后重算一次信号（这里是对 1000 个品种的中间价做一遍统计）
+struct Strategy {
+    std::vector<double> mids = std::vector<double>(1000, 0.0);
+    double strategy_us = 0.0;
+    double signal = 0.0;
+    uint64_t recomputes = 0;
+
+    void update(const TickerView& ticker) {
+        size_t index = 0;
+        for (char c : ticker.inst_id.substr(5)) index = index * 10 + static_cast<size_t>(c - '0');
+        mids[index % mids.size()] = std::stod(std::string(ticker.bid_px));
+    }
+
+    void recompute() {
+        double sum = 0.0, squares = 0.0;
+        for (double mid : mids) {
+            sum += mid;
+            squares += mid * mid;
+        }
+        double mean = sum / static_cast<double>(mids.size());
+        signal = std::sqrt(squares / static_cast<double>(mids.size()) - mean * mean);
+        recomputes++;
+    }
+};
+
+static void test_recompute_cost() {
+    const int passes = 2000;
+    const int burst = 32;   // 一轮服务收到的 ticker 数（4 条消息，每条 8 个）
+    std::vector<std::string> frames;
+    for (int i = 0; i < 4; ++i) frames.push_back(make_message(i * 8, 8));
+
+    Strategy per_tick;
+    TickerHandler tick_handler(nullptr);
+    tick_handler.add_stage([&](const TickerView& ticker) {
+        auto start = std::chrono::steady_clock::now();
+        per_tick.update(ticker);
+        per_tick.recompute();
+        per_tick.strategy_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    });
+
+    Strategy batched;
+    TickerHandler batch_handler(nullptr);
+    batch_handler.set_batch_callback([&](std::span<const TickerView> tickers) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& ticker : tickers) batched.update(ticker);
+        batched.recompute();
+        batched.strategy_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }, {}, TickerHandler::BatchScope::ServicePass);
+
+    auto run = [&](TickerHandler& handler) {
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (const auto& frame : frames) handler.handle_message(frame);
+            handler.flush_batch();
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / passes;
+    };
+    double tick_us = run(tick_handler);
+    double batch_us = run(batch_handler);
+
+    // 总耗时含解析、拷贝与两种方式相同的 stod；策略耗时只计回调内部
+    std::cout << "  每轮 " << burst << " 个 ticker: 逐条重算 " << per_tick.recomputes / passes << " 次, 策略 "
+              << per_tick.strategy_us / passes << " us/轮, 总计 " << tick_us << " us/轮" << std::endl;
+    std::cout << "  按批重算 " << batched.recomputes / passes << " 次, 策略 " << batched.strategy_us / passes
+              << " us/轮, 总计 " << batch_us << " us/轮" << std::endl;
+    check(per_tick.recomputes == static_cast<uint64_t>(passes) * burst && batched.recomputes == static_cast<uint64_t>(passes),
+          "按批重算次数降为每轮一次");
+    check(per_tick.signal == batched.signal, "两种方式得到相同的信号");
+    check(batched.strategy_us < per_tick.strategy_us, "按批重算的策略耗时更低");
+}
+
+int main() {
+    std::cout << "📦 批量交付测试" << std::endl;
+
+    test_message_scope();
+    test_service_pass_scope();
+    test_end_hook_only();
+    test_field_mask();
+    test_filter();
+    test_recompute_cost();
+
+    return test_summary();
+}
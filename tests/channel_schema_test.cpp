@@ -0,0 +1,127 @@
+#include "../src/okx_channels.h"
+#include "test_util.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 字段掩码在编译期生成
+static_assert(SchemaCodec<TickerData>::field_count == 16);
+static_assert(SchemaCodec<TickerData>::mask_of("instType") == 1);
+static_assert(SchemaCodec<TickerData>::mask_of("ts") == (FieldMask(1) << 15));
+static_assert(SchemaCodec<MarkPriceData>::full_mask() == 0xF);
+static_assert(SchemaCodec<FundingRateData>::channel() == "funding-rate");
+
+static void test_perfect_hash() {
+    bool ok = true;
+    for (size_t i = 0; i < SchemaCodec<TickerData>::field_count; ++i) {
+        ok = ok && SchemaCodec<TickerData>::lookup(SchemaCodec<TickerData>::key_at(i)) == i;
+    }
+    check(ok, "完美哈希: 每个key映射到自身下标");
+    check(SchemaCodec<TickerData>::lookup("vol24") == SchemaCodec<TickerData>::field_count &&
+          SchemaCodec<TickerData>::lookup("instIdx") == SchemaCodec<TickerData>::field_count,
+          "完美哈希: 未知key被拒绝");
+}
+
+static void test_channel_messages() {
+    std::vector<MarkPriceData> marks;
+    bool parsed = SchemaCodec<MarkPriceData>::parse_message(
+        R"({"arg":{"channel":"mark-price","instId":"BTC-USDT-SWAP"},"data":[{"instType":"SWAP","instId":"BTC-USDT-SWAP","markPx":"43250.1","ts":"1703073600000"}]})",
+        marks);
+    check(parsed && marks.size() == 1 && marks[0].mark_px == "43250.1" && marks[0].ts == 1703073600000,
+          "mark-price 解析，ts解码为int64");
+
+    std::vector<FundingRateData> rates;
+    parsed = SchemaCodec<FundingRateData>::parse_message(
+        R"({"arg":{"channel":"funding-rate","instId":"BTC-USDT-SWAP"},"data":[{"fundingRate":"0.0001","fundingTime":"1703088000000","instId":"BTC-USDT-SWAP","instType":"SWAP","method":"current_period","nextFundingRate":"","nextFundingTime":"1703116800000","premium":"0.0002","ts":"1703073600000"}]})",
+        rates);
+    check(parsed && rates.size() == 1 && rates[0].funding_rate == "0.0001" &&
+          rates[0].next_funding_time == 1703116800000 && rates[0].next_funding_rate.empty(),
+          "funding-rate 解析，字段顺序无关");
+
+    std::vector<OpenInterestData> interest;
+    parsed = SchemaCodec<OpenInterestData>::parse_message(
+        R"({"arg":{"channel":"mark-price","instId":"BTC-USDT-SWAP"},"data":[{"instId":"BTC-USDT-SWAP","oi":"1"}]})",
+        interest);
+    check(!parsed && interest.empty(), "频道不匹配时不解析");
+
+    std::vector<IndexTickerData> index;
+    parsed = SchemaCodec<IndexTickerData>::parse_message(
+        R"({"arg":{"channel":"index-tickers","instId":"BTC-USDT"},"data":[{"instId":"BTC-USDT","idxPx":"43000","ts":"1"},{"instId":"ETH-USDT","idxPx":"2200","ts":"2"}]})",
+        index);
+    check(parsed && index.size() == 2 && index[1].idx_px == "2200", "index-tickers 多条数据");
+
+    // 客户端按 arg.channel 分发后只把 data 数组交给解析器
+    std::vector<IndexTickerData> direct;
+    bool data_parsed = SchemaCodec<IndexTickerData>::parse_data(R"([{"instId":"BTC-USDT","idxPx":"43000","ts":"1"},{"instId":"ETH-USDT","idxPx":"2200","ts":"2"}])", direct);
+    check(data_parsed && direct.size() == 2 && direct[0].idx_px == "43000" && direct[1].ts == 2, "parse_data 直接解析 data 数组");
+
+    // 复用时上一条消息的字段不能残留
+    SchemaCodec<IndexTickerData>::parse_message(
+        R"({"arg":{"channel":"index-tickers"},"data":[{"instId":"BTC-USDT","ts":"3"}]})", index);
+    check(index.size() == 1 && index[0].idx_px.empty() && index[0].ts == 3, "复用元素时缺失字段被重置");
+}
+
+static void test_exact_keys() {
+    // 嵌套对象里的同名key和值里的 "ts": 都不应命中
+    TickerData ticker;
+    FieldMask present = SchemaCodec<TickerData>::parse_object(
+        R"({"extra":{"ts":"999","last":"1"},"instId":"BTC-USDT","note":"\"ts\":\"888\"","volCcy24h":"100","vol24h":"5","ts":"42"})",
+        ticker);
+    check(ticker.ts == "42" && ticker.last.empty() && ticker.vol24h == "5" && ticker.vol_ccy24h == "100",
+          "只匹配第一层的完整key");
+    check(present == (SchemaCodec<TickerData>::mask_of("instId") | SchemaCodec<TickerData>::mask_of("volCcy24h") |
+                      SchemaCodec<TickerData>::mask_of("vol24h") | SchemaCodec<TickerData>::mask_of("ts")),
+          "返回字段出现掩码");
+}
+
+static void test_round_trip() {
+    FundingRateData rate;
+    rate.inst_type = "SWAP";
+    rate.inst_id = "ETH-USDT-SWAP";
+    rate.method = "next_period";
+    rate.funding_rate = "-0.00005";
+    rate.funding_time = 1703088000000;
+    rate.premium = "say \"hi\"";
+    rate.ts = 1703073600123;
+
+    std::string json = SchemaCodec<FundingRateData>::serialize(rate);
+    FundingRateData parsed;
+    SchemaCodec<FundingRateData>::parse_object(json, parsed);
+    check(parsed.inst_id == rate.inst_id && parsed.funding_rate == rate.funding_rate &&
+          parsed.funding_time == rate.funding_time && parsed.ts == rate.ts,
+          "序列化后再解析保持一致: " + json);
+}
+
+static void test_escape_round_trip() {
+    FundingRateData rate;
+    rate.inst_id = "BTC-USDT-SWAP";
+    rate.method = "quote \" backslash \\ slash /";
+    rate.premium = std::string("tab\tnewline\ncr\rnul") + '\0' + "\x01\x1f end";
+
+    std::string json = SchemaCodec<FundingRateData>::serialize(rate);
+    bool raw_control = false;
+    for (char c : json) raw_control |= static_cast<unsigned char>(c) < 0x20;
+    check(!raw_control && json.find("\\u0009") != std::string::npos && json.find("\\u0000") != std::string::npos &&
+          json.find("\\u001f") != std::string::npos, "控制字符序列化为 \\u00XX");
+    check(JsonValidator::validate(json), "转义后的输出是合法JSON");
+
+    FundingRateData parsed;
+    SchemaCodec<FundingRateData>::parse_object(json, parsed);
+    check(parsed.method == rate.method && parsed.premium == rate.premium && parsed.inst_id == rate.inst_id,
+          "引号、反斜杠和控制字符往返一致");
+
+    SchemaCodec<FundingRateData>::parse_object(R"({"method":"a\u00e9\/b","premium":"\q"})", parsed);
+    check(parsed.method == "a\xc3\xa9/b" && parsed.premium == "\\q", "解码时反转义，非法转义保留原文");
+}
+
+int main() {
+    std::cout << "📐 频道字段表测试" << std::endl;
+
+    test_perfect_hash();
+    test_channel_messages();
+    test_exact_keys();
+    test_round_trip();
+    test_escape_round_trip();
+
+    return test_summary();
+}
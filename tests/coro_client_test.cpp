@@ -0,0 +1,101 @@
+#include "../src/okx_websocket_client.h"
+#include "../src/mock_okx_server.h"
+#include "../src/coro.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// 对本地模拟服务用协程走完 连接 -> 订阅回执 -> 逐条消费 ticker -> 断开
+
+struct Observed {
+    bool early_subscribe_failed = false;
+    bool connected = false;
+    bool subscribed = false;
+    int ticks = 0;
+    bool right_instrument = true;
+    bool on_executor_thread = true;
+    bool disconnected = false;
+    bool stream_closed = false;
+};
+
+static Task<void> consume(TickStream& stream, Observed& seen, std::thread::id executor_thread) {
+    while (const TickerData* ticker = co_await stream.next()) {
+        seen.right_instrument &= ticker->inst_id == "BTC-USDT" && !ticker->last.empty();
+        seen.on_executor_thread &= std::this_thread::get_id() == executor_thread;
+        seen.ticks++;
+    }
+    seen.stream_closed = true;
+}
+
+static Task<void> strategy(OKXWebSocketClient& client, CoroExecutor& executor, Observed& seen) {
+    SubscribeAck early = co_await client.subscribe("tickers", "BTC-USDT");
+    seen.early_subscribe_failed = !early.ok && early.code == "disconnected";
+
+    seen.connected = co_await client.connected();
+    if (!seen.connected) co_return;
+
+    SubscribeAck ack = co_await client.subscribe("tickers", "BTC-USDT");
+    seen.subscribed = ack.ok;
+    spawn(executor, consume(client.ticks("BTC-USDT"), seen, std::this_thread::get_id()));
+
+    seen.disconnected = !co_await client.disconnected();
+}
+
+int main() {
+    std::cout << "🔁 协程客户端测试" << std::endl;
+
+    MockServerConfig config;
+    config.port = 18446;
+    config.rate = 2000;
+    MockOKXServer server(config);
+    if (!server.start()) {
+        std::cerr << "❌ 模拟服务启动失败" << std::endl;
+        return 1;
+    }
+
+    CoroExecutor executor;
+    Observed seen;
+    {
+        OKXWebSocketClient client;
+        client.enable_auto_reconnect(false);
+        client.set_executor(&executor);
+        client.set_ticker_callback(nullptr);
+        client.ticks("BTC-USDT", 64);
+
+        spawn(executor, strategy(client, executor, seen));
+        executor.poll();
+        check(client.connect("127.0.0.1", config.port, "/ws/v5/public", false), "连接模拟服务");
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (seen.ticks < 100 && std::chrono::steady_clock::now() < deadline) {
+            executor.run_for(std::chrono::milliseconds(10));
+        }
+
+        // 运行中为新交易对建流会与服务线程的查表竞争，直接拒绝
+        bool rejected = false;
+        try {
+            client.ticks("ETH-USDT");
+        } catch (const std::logic_error&) {
+            rejected = true;
+        }
+        check(rejected && &client.ticks("BTC-USDT") != nullptr, "运行中不能新建 ticker 流，已有的流仍可取");
+        client.disconnect();
+        executor.poll();
+    }
+    executor.poll();
+    server.stop();
+
+    check(seen.early_subscribe_failed, "未连接时订阅立即返回 disconnected");
+    check(seen.connected, "co_await connected()");
+    check(seen.subscribed, "co_await subscribe() 收到回执");
+    check(seen.ticks >= 100 && seen.right_instrument, "逐条收到 ticker: " + std::to_string(seen.ticks));
+    check(seen.on_executor_thread, "ticker 协程在执行器线程上恢复");
+    check(seen.disconnected, "disconnect() 唤醒 disconnected() 等待者");
+    check(seen.stream_closed, "客户端析构时关闭 ticker 流");
+
+    return test_summary();
+}
@@ -0,0 +1,140 @@
+#include "../src/coro.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static Task<int> add(int a, int b) {
+    co_return a + b;
+}
+
+static Task<int> sum_to(int n) {
+    int total = 0;
+    for (int i = 1; i <= n; ++i) total = co_await add(total, i);
+    co_return total;
+}
+
+static Task<int> throws() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+static void test_tasks() {
+    CoroExecutor executor;
+    int result = 0;
+    std::string error;
+    auto body = [&]() -> Task<void> {
+        result = co_await sum_to(100);
+        try {
+            co_await throws();
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+    };
+    spawn(executor, body());
+    check(result == 0, "spawn 后在 poll 之前不执行");
+    executor.poll();
+    check(result == 5050, "嵌套任务返回值");
+    check(error == "boom", "异常传回等待者");
+}
+
+static void test_frame_pool() {
+    CoroExecutor executor;
+    // 预热后同尺寸的帧全部复用
+    for (int i = 0; i < 10; ++i) {
+        spawn(executor, [](int n) -> Task<void> { co_await sum_to(n); }(10));
+        executor.poll();
+    }
+    uint64_t before = FramePool::fresh_allocations();
+    for (int i = 0; i < 100000; ++i) {
+        spawn(executor, [](int n) -> Task<void> { co_await sum_to(n); }(10));
+        executor.poll();
+    }
+    check(FramePool::fresh_allocations() == before, "稳态下协程帧不再分配");
+
+    void* a = FramePool::allocate(100);
+    FramePool::deallocate(a, 100);
+    void* b = FramePool::allocate(120);
+    check(a == b, "同级尺寸复用同一块内存");
+    FramePool::deallocate(b, 120);
+    void* big = FramePool::allocate(FramePool::kMaxPooledSize + 1);
+    FramePool::deallocate(big, FramePool::kMaxPooledSize + 1);
+}
+
+static void test_queue() {
+    CoroExecutor executor;
+    AsyncQueue<std::string> queue(&executor, 4);
+    std::vector<std::string> received;
+    bool finished = false;
+    auto consumer = [&]() -> Task<void> {
+        while (const std::string* value = co_await queue.next()) received.push_back(*value);
+        finished = true;
+    };
+    spawn(executor, consumer());
+    executor.poll();
+    check(received.empty() && !finished, "空队列上挂起");
+
+    for (int i = 0; i < 6; ++i) {
+        queue.push_with([i](std::string& slot) { slot = "tick-" + std::to_string(i); });
+    }
+    check(queue.dropped() == 2 && queue.size() == 4, "满时覆盖最旧元素并计数");
+    executor.poll();
+    check(received.size() == 4 && received.front() == "tick-2" && received.back() == "tick-5", "按顺序取出最新的 4 个");
+
+    queue.close();
+    executor.poll();
+    check(finished, "关闭后 next() 返回 nullptr");
+}
+
+static void test_cross_thread() {
+    CoroExecutor executor;
+    AsyncQueue<int> queue(&executor, 1024);
+    const int count = 200000;
+    std::thread::id consumer_thread;
+    bool same_thread = true;
+    long long sum = 0;
+    int seen = 0;
+    auto consumer = [&]() -> Task<void> {
+        while (const int* value = co_await queue.next()) {
+            same_thread &= std::this_thread::get_id() == consumer_thread;
+            sum += *value;
+            seen++;
+        }
+        executor.stop();
+    };
+    consumer_thread = std::this_thread::get_id();
+    spawn(executor, consumer());
+
+    std::thread producer([&] {
+        for (int i = 1; i <= count; ++i) {
+            queue.push_with([i](int& slot) { slot = i; });
+        }
+        queue.close();
+    });
+    auto start = std::chrono::steady_clock::now();
+    executor.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    producer.join();
+
+    check(same_thread, "协程始终在执行器线程上恢复");
+    check(seen + static_cast<int>(queue.dropped()) == count, "收到 + 丢弃 = 发送 (" + std::to_string(seen) + " + " +
+          std::to_string(queue.dropped()) + ")");
+    check(queue.dropped() > 0 || sum == static_cast<long long>(count) * (count + 1) / 2, "无丢弃时数据完整");
+    std::cout << "  跨线程传递: " << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / count
+              << " 纳秒/条" << std::endl;
+}
+
+int main() {
+    std::cout << "🔁 协程接口测试" << std::endl;
+
+    test_tasks();
+    test_frame_pool();
+    test_queue();
+    test_cross_thread();
+
+    return test_summary();
+}
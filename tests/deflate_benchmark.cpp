@@ -0,0 +1,154 @@
+#include "../src/json_parser.h"
+#include <zlib.h>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// permessage-deflate 的带宽/CPU 取舍: 按 RFC 7692 的方式逐条压缩（raw deflate + SYNC_FLUSH，
+// 去掉末尾 00 00 ff ff），再用复用的 z_stream 解压，与解析耗时对比
+struct DeflateResult {
+    uint64_t raw_bytes;
+    uint64_t wire_bytes;
+    double inflate_ns;
+    bool ok;
+};
+
+static std::vector<std::string> load_frames(const char* path) {
+    std::vector<std::string> frames;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) frames.push_back(line);
+    }
+    return frames;
+}
+
+// 没有录制文件时合成与 OKX 推送相近的 ticker 帧（多交易对、价格随机游走）
+static std::vector<std::string> synthesize_frames(size_t count) {
+    std::vector<std::string> frames;
+    frames.reserve(count);
+    const char* names[] = {"BTC-USDT", "ETH-USDT", "SOL-USDT", "XRP-USDT", "DOGE-USDT", "OKB-USDT", "LTC-USDT", "ADA-USDT"};
+    double prices[] = {43250.5, 2250.12, 98.431, 0.6123, 0.09123, 52.31, 72.15, 0.5931};
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    int64_t ts = 1703073600000;
+    char buffer[1024];
+
+    for (size_t i = 0; i < count; ++i) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        size_t k = rng % 8;
+        prices[k] *= 1.0 + (static_cast<double>(rng % 2001) - 1000.0) * 1e-7;
+        ts += static_cast<int64_t>(rng % 50);
+        double p = prices[k];
+        snprintf(buffer, sizeof(buffer),
+                 R"({"arg":{"channel":"tickers","instId":"%s"},"data":[{"instType":"SPOT","instId":"%s","last":"%.6g","lastSz":"%.4f","askPx":"%.6g","askSz":"%.4f","bidPx":"%.6g","bidSz":"%.4f","open24h":"%.6g","high24h":"%.6g","low24h":"%.6g","volCcy24h":"%.2f","vol24h":"%.3f","sodUtc0":"%.6g","sodUtc8":"%.6g","ts":"%lld"}]})",
+                 names[k], names[k], p, (rng % 10000) / 1000.0, p * 1.0001, (rng % 7000) / 1000.0, p * 0.9999,
+                 (rng % 9000) / 1000.0, p * 0.98, p * 1.02, p * 0.97, p * 1234.5, 1234.5 + (rng % 100),
+                 p * 0.99, p * 0.995, static_cast<long long>(ts));
+        frames.emplace_back(buffer);
+    }
+    return frames;
+}
+
+static DeflateResult run(const std::vector<std::string>& frames, int window_bits, bool takeover) {
+    DeflateResult result{0, 0, 0.0, true};
+
+    // 压缩端（服务端）
+    z_stream deflater{};
+    deflateInit2(&deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -window_bits, 8, Z_DEFAULT_STRATEGY);
+    std::vector<std::string> wire;
+    wire.reserve(frames.size());
+    std::vector<unsigned char> out(64 * 1024);
+
+    for (const auto& frame : frames) {
+        if (!takeover) deflateReset(&deflater);
+        deflater.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(frame.data()));
+        deflater.avail_in = static_cast<uInt>(frame.size());
+        deflater.next_out = out.data();
+        deflater.avail_out = static_cast<uInt>(out.size());
+        deflate(&deflater, Z_SYNC_FLUSH);
+        size_t produced = out.size() - deflater.avail_out;
+        // 去掉 SYNC_FLUSH 的空存储块尾 00 00 ff ff
+        if (produced >= 4) produced -= 4;
+        wire.emplace_back(reinterpret_cast<char*>(out.data()), produced);
+        result.raw_bytes += frame.size();
+        result.wire_bytes += produced;
+    }
+    deflateEnd(&deflater);
+
+    // 解压端（客户端）: z_stream 只初始化一次，关闭上下文接管时每条 inflateReset
+    static const unsigned char tail[4] = {0x00, 0x00, 0xff, 0xff};
+    z_stream inflater{};
+    inflateInit2(&inflater, -window_bits);
+    std::vector<unsigned char> plain(64 * 1024);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < wire.size(); ++i) {
+        if (!takeover) inflateReset(&inflater);
+        inflater.next_out = plain.data();
+        inflater.avail_out = static_cast<uInt>(plain.size());
+
+        inflater.next_in = reinterpret_cast<Bytef*>(wire[i].data());
+        inflater.avail_in = static_cast<uInt>(wire[i].size());
+        inflate(&inflater, Z_SYNC_FLUSH);
+        inflater.next_in = const_cast<Bytef*>(tail);
+        inflater.avail_in = 4;
+        inflate(&inflater, Z_SYNC_FLUSH);
+
+        size_t length = plain.size() - inflater.avail_out;
+        if (length != frames[i].size() || memcmp(plain.data(), frames[i].data(), length) != 0) {
+            result.ok = false;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    inflateEnd(&inflater);
+
+    result.inflate_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)wire.size();
+    return result;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> frames = argc > 1 ? load_frames(argv[1]) : synthesize_frames(20000);
+    if (frames.empty()) {
+        std::cerr << "❌ 没有可用的帧" << std::endl;
+        return 1;
+    }
+
+    std::cout << "🗜️ permessage-deflate 带宽/CPU 基准" << std::endl;
+    std::cout << "帧数: " << frames.size() << (argc > 1 ? " (录制文件)" : " (合成ticker)") << std::endl;
+
+    // 基线: 每条消息的解析耗时
+    TickerBatch batch;
+    auto parse_start = std::chrono::high_resolution_clock::now();
+    for (const auto& frame : frames) {
+        JsonParser::parse_ticker_data_into(frame, batch);
+    }
+    auto parse_end = std::chrono::high_resolution_clock::now();
+    double parse_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(parse_end - parse_start).count() / (double)frames.size();
+    std::cout << "解析: " << parse_ns << " 纳秒/消息" << std::endl << std::endl;
+
+    bool ok = true;
+    for (bool takeover : {true, false}) {
+        std::cout << (takeover ? "上下文接管 (默认):" : "no_context_takeover:") << std::endl;
+        for (int bits : {9, 10, 12, 15}) {
+            DeflateResult r = run(frames, bits, takeover);
+            ok = ok && r.ok;
+            double ratio = r.wire_bytes ? r.raw_bytes / (double)r.wire_bytes : 0.0;
+            double mb_per_s = r.inflate_ns > 0 ? (r.raw_bytes / (double)frames.size()) / r.inflate_ns * 1000.0 : 0.0;
+            // inflate 滑动窗口 2^bits 字节 + 约7KB 固定状态
+            std::cout << "  window " << bits << ": 压缩比 " << ratio << "x, 解压 " << r.inflate_ns
+                      << " 纳秒/消息 (" << mb_per_s << " MB/s, 解析的 " << r.inflate_ns / parse_ns
+                      << "x), 窗口内存 " << ((1u << bits) + 7 * 1024) / 1024 << " KB"
+                      << (r.ok ? "" : " ❌ 解压结果不符") << std::endl;
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "❌ Test FAILED: 解压结果与原始帧不一致" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ ALL TESTS PASSED!" << std::endl;
+    return 0;
+}
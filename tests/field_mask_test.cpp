@@ -0,0 +1,81 @@
+#include "../src/ticker_fields.h"
+#include "../src/ticker_handler.h"
+#include "test_util.h"
+#include <iostream>
+#include <string>
+
+static const std::string kTicker =
+    R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[)"
+    R"({"instType":"SPOT","instId":"BTC-USDT","last":"43250.5","lastSz":"0.1234","askPx":"43251.0","askSz":"1.5","bidPx":"43249.5","bidSz":"2.3","open24h":"42000.0","high24h":"43500.0","low24h":"41500.0","volCcy24h":"1234567.89","vol24h":"29.456","sodUtc0":"42100.0","sodUtc8":"42150.0","ts":"1703073600000"},)"
+    R"({"instType":"SPOT","instId":"ETH-USDT","last":"2250.1","lastSz":"1","askPx":"2250.2","askSz":"3","bidPx":"2250.0","bidSz":"4","open24h":"2200","high24h":"2300","low24h":"2100","volCcy24h":"5","vol24h":"6","sodUtc0":"2201","sodUtc8":"2202","ts":"1703073600001"}]})";
+
+static bool only_quote_fields(const TickerView& view) {
+    return !view.inst_id.empty() && !view.bid_px.empty() && !view.ask_px.empty() && !view.last.empty() && !view.ts.empty() &&
+           view.inst_type.empty() && view.last_sz.empty() && view.ask_sz.empty() && view.bid_sz.empty() &&
+           view.open24h.empty() && view.high24h.empty() && view.low24h.empty() && view.vol_ccy24h.empty() &&
+           view.vol24h.empty() && view.sod_utc0.empty() && view.sod_utc8.empty();
+}
+
+static void test_masks() {
+    static_assert(TickerField::All == 0xFFFF);
+    static_assert(TickerField::Quote == (TickerField::InstId | TickerField::BidPx | TickerField::AskPx | TickerField::Last | TickerField::Ts));
+
+    TickerBatch full;
+    check(JsonParser::parse_ticker_data_into(kTicker, full) && full.size() == 2 && full[1].sod_utc8 == "2202", "默认解析全部字段");
+
+    TickerBatch batch;
+    check(JsonParser::parse_ticker_data_into(kTicker, batch, ParseMode::Fast, TickerField::Quote) && batch.size() == 2,
+          "运行期掩码解析出两个 ticker");
+    check(only_quote_fields(batch[0]) && only_quote_fields(batch[1]), "运行期掩码: 只有请求的字段有值");
+    check(batch[0].bid_px == "43249.5" && batch[1].ts == "1703073600001", "请求的字段值正确");
+    check(batch.arena().used() < full.arena().used() / 2, "掩码外的字段不拷贝: arena " + std::to_string(batch.arena().used()) +
+          " / " + std::to_string(full.arena().used()) + " 字节");
+
+    TickerBatch compiled;
+    check(JsonParser::parse_ticker_fields_into<TickerField::Quote>(kTicker, compiled) && compiled.size() == 2 &&
+          only_quote_fields(compiled[0]) && compiled[0].last == "43250.5", "编译期掩码结果一致");
+
+    TickerBatch strict;
+    check(JsonParser::parse_ticker_data_into(kTicker, strict, ParseMode::Strict, TickerField::Quote) &&
+          only_quote_fields(strict[1]), "严格模式同样按掩码跳过");
+
+    TickerBatch ts_only;
+    check(JsonParser::parse_ticker_data_into(kTicker, ts_only, ParseMode::Fast, TickerField::Ts) &&
+          ts_only[0].inst_id == "BTC-USDT" && ts_only[0].last.empty(), "instId 总会解析");
+}
+
+static void test_early_stop() {
+    // 请求的字段都在前面时，后面的成员不再解码；未请求的重复 key 不会覆盖
+    std::string json = R"({"arg":{"channel":"tickers"},"data":[{"instId":"A","last":"1","ts":"2","last":"999","bidPx":"3"}]})";
+    TickerBatch batch;
+    JsonParser::parse_ticker_data_into(json, batch, ParseMode::Fast, TickerField::InstId | TickerField::Last | TickerField::Ts);
+    check(batch.size() == 1 && batch[0].last == "1" && batch[0].bid_px.empty(), "字段找齐后停止扫描对象");
+}
+
+static void test_handler_mask() {
+    TickerHandler handler([](const TickerData&) {});
+    check(handler.field_mask() == kAllFields, "默认回调需要全部字段");
+
+    handler.set_field_mask(TickerField::Quote);
+    handler.add_stage([](const TickerView&) {}, TickerField::InstId | TickerField::Vol24h);
+    check(handler.field_mask() == (TickerField::Quote | TickerField::Vol24h), "解析掩码为回调与阶段字段的并集");
+
+    TickerData seen;
+    handler.set_callback([&](const TickerData& ticker) { seen = ticker; });
+    handler.handle_message(kTicker);
+    check(seen.inst_id == "ETH-USDT" && seen.vol24h == "6" && seen.bid_px == "2250.0" && seen.high24h.empty(),
+          "回调只看到掩码内的字段");
+
+    handler.set_callback(nullptr);
+    check(handler.field_mask() == (TickerField::InstId | TickerField::Vol24h), "没有回调时只按阶段字段解析");
+}
+
+int main() {
+    std::cout << "🎭 字段掩码解析测试" << std::endl;
+
+    test_masks();
+    test_early_stop();
+    test_handler_mask();
+
+    return test_summary();
+}
@@ -0,0 +1,114 @@
+#include "../src/latency_mode.h"
+#include "../src/ticker_batch.h"
+#include "test_util.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <vector>
+
+static long minor_faults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+static size_t resident_pages(const HotRegion& region) {
+    size_t pages = region.size() / LatencyMode::page_size();
+    std::vector<unsigned char> vec(pages);
+    if (mincore(region.data(), region.size(), vec.data()) != 0) return 0;
+    size_t resident = 0;
+    for (unsigned char v : vec) resident += v & 1;
+    return resident;
+}
+
+// 第一次写入各页的耗时与缺页数
+static void touch(HotRegion& region, long& faults, double& ns_per_page) {
+    size_t step = LatencyMode::page_size();
+    long before = minor_faults();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t offset = 0; offset < region.size(); offset += step) region.data()[offset] = 1;
+    auto end = std::chrono::high_resolution_clock::now();
+    faults = minor_faults() - before;
+    ns_per_page = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() /
+                  (double)(region.size() / step);
+}
+
+static void test_prefault() {
+    const size_t bytes = 16 << 20;
+    std::string error;
+
+    HotRegion cold;
+    check(cold.map(bytes, HugePageMode::None, false, error) && cold.size() == bytes, "映射普通页");
+    check(resident_pages(cold) == 0, "未预触时没有驻留页");
+    long cold_faults;
+    double cold_ns;
+    touch(cold, cold_faults, cold_ns);
+
+    HotRegion hot;
+    hot.map(bytes, HugePageMode::None, true, error);
+    size_t pages = bytes / LatencyMode::page_size();
+    check(resident_pages(hot) == pages, "预触后全部驻留");
+    long hot_faults;
+    double hot_ns;
+    touch(hot, hot_faults, hot_ns);
+
+    check(cold_faults >= static_cast<long>(pages) / 2, "冷内存首次写入缺页: " + std::to_string(cold_faults));
+    check(hot_faults < static_cast<long>(pages) / 100, "预触后写入几乎不缺页: " + std::to_string(hot_faults));
+    std::cout << "  首次写入: 冷 " << cold_ns << " 纳秒/页, 预触后 " << hot_ns << " 纳秒/页" << std::endl;
+}
+
+static void test_huge_pages() {
+    std::string error;
+    HotRegion thp;
+    bool mapped = thp.map(1 << 20, HugePageMode::Transparent, true, error);
+    check(mapped && thp.size() % LatencyMode::huge_page_size() == 0 &&
+          reinterpret_cast<uintptr_t>(thp.data()) % LatencyMode::huge_page_size() == 0,
+          "透明大页: 长度与地址按大页对齐");
+
+    // 多数环境没有预留大页，应退回透明大页并说明原因，而不是失败
+    error.clear();
+    HotRegion explicit_pages;
+    mapped = explicit_pages.map(1 << 20, HugePageMode::Explicit, true, error);
+    check(mapped && explicit_pages.data() != nullptr, "显式大页映射成功或回退");
+    std::cout << "  显式大页: " << (error.empty() ? "MAP_HUGETLB" : error) << std::endl;
+}
+
+static void test_arena_reserve() {
+    TickerBatch batch(4096, 16);
+    size_t reserved = batch.reserve(256 << 10, 256);
+    check(batch.arena().capacity() >= (256 << 10) && reserved >= (256 << 10), "arena 预留容量");
+    size_t capacity = batch.arena().capacity();
+    for (int i = 0; i < 1000; ++i) batch.arena().allocate(200);
+    check(batch.arena().capacity() == capacity, "预留范围内不再申请新块");
+    batch.clear();
+    check(batch.arena().used() == 0 && batch.arena().capacity() == capacity, "clear 后容量保留");
+}
+
+static void test_stack_and_lock() {
+    LatencyMode::prefault_stack(256 << 10);
+    check(true, "预触栈不越界");
+
+    std::string error;
+    if (LatencyMode::lock_all(error)) {
+        // sanitizer 会把 mlockall 替换为空操作，这里只打印 VmLck
+        std::cout << "  mlockall 成功, VmLck: " << LatencyMode::locked_bytes() << " 字节" << std::endl;
+        munlockall();
+    } else {
+        // 非特权进程受 RLIMIT_MEMLOCK 限制，失败时应给出原因
+        check(!error.empty(), "mlockall 失败时报告原因: " + error);
+    }
+}
+
+int main() {
+    std::cout << "🧊 延迟模式测试" << std::endl;
+
+    test_prefault();
+    test_huge_pages();
+    test_arena_reserve();
+    test_stack_and_lock();
+
+    return test_summary();
+}
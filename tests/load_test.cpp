@@ -0,0 +1,264 @@
+#include "../src/okx_websocket_client.h"
+#include "../src/mock_okx_server.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// 本地模拟服务 + 真实客户端: 逐级提升推送速率，统计端到端延迟，
+// 找出客户端跟不上（发送受阻、漏收或延迟堆积）之前的最大速率
+struct StepResult {
+    uint32_t rate;
+    uint64_t sent;
+    uint64_t received;
+    int64_t p50_us;
+    int64_t p99_us;
+    int64_t p999_us;
+    int64_t max_us;
+    int64_t client_p99_us;   // 客户端内部: 进入接收回调到用户回调
+    int64_t kernel_p99_us;   // --rx-timestamps: 内核收包到用户回调（TLS 解密 + lws + 解析）
+    bool sustained;
+};
+
+class LatencyRecorder {
+public:
+    void record(int64_t latency_ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.push_back(latency_ns);
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.clear();
+    }
+
+    std::vector<int64_t> take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<int64_t> result;
+        result.swap(samples_);
+        samples_.reserve(result.capacity());
+        return result;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<int64_t> samples_;
+};
+
+static int64_t percentile_us(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * p));
+    return sorted[index] / 1000;
+}
+
+static std::vector<uint32_t> parse_rates(const std::string& text) {
+    std::vector<uint32_t> rates;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        rates.push_back(static_cast<uint32_t>(atoi(item.c_str())));
+    }
+    return rates;
+}
+
+int main(int argc, char** argv) {
+    MockServerConfig config;
+    config.port = 18443;
+    config.instruments = 20;
+    std::vector<uint32_t> rates = {1000, 5000, 10000, 25000, 50000, 100000, 200000};
+    int seconds = 3;
+    int64_t max_p99_us = 5000;
+    ThreadConfig thread_config;
+    thread_config.name = "okx-service";
+    bool latency_mode = false;
+    LatencyConfig latency_config;
+    bool rx_timestamps = false;
+    bool uring = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--port" && has_value) config.port = atoi(argv[++i]);
+        else if (arg == "--ssl") config.use_ssl = true;
+        else if (arg == "--instruments" && has_value) config.instruments = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--per-frame" && has_value) config.tickers_per_frame = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--replay" && has_value) config.replay_file = argv[++i];
+        else if (arg == "--deflate") config.deflate = true;
+        else if (arg == "--rates" && has_value) rates = parse_rates(argv[++i]);
+        else if (arg == "--seconds" && has_value) seconds = atoi(argv[++i]);
+        else if (arg == "--max-p99-us" && has_value) max_p99_us = atoll(argv[++i]);
+        else if (arg == "--client-cpu" && has_value) thread_config.cpus = {atoi(argv[++i])};
+        else if (arg == "--fifo" && has_value) {
+            thread_config.sched_policy = SCHED_FIFO;
+            thread_config.sched_priority = atoi(argv[++i]);
+        }
+        else if (arg == "--busy-poll") thread_config.busy_poll = true;
+        else if (arg == "--rx-timestamps") rx_timestamps = true;
+        else if (arg == "--uring") uring = true;
+        else if (arg == "--latency-mode") latency_mode = true;
+        else if (arg == "--hugepages") {
+            latency_mode = true;
+            latency_config.huge_pages = HugePageMode::Transparent;
+        }
+        else if (arg == "--mlock") {
+            latency_mode = true;
+            latency_config.lock_memory = true;
+        }
+        else {
+            std::cout << "Usage: " << argv[0] << " [--port N] [--ssl] [--instruments N] [--per-frame N] [--replay FILE]"
+                      << " [--deflate] [--rates 1000,5000,...] [--seconds N] [--max-p99-us N]"
+                      << " [--client-cpu N] [--fifo PRIO] [--busy-poll] [--latency-mode] [--hugepages] [--mlock]"
+                      << " [--rx-timestamps] [--uring]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "🚀 模拟服务端到端压测" << std::endl;
+
+    config.rate = 0;
+    MockOKXServer server(config);
+    if (!server.start()) {
+        std::cerr << "❌ Test FAILED: Could not start mock server" << std::endl;
+        return 1;
+    }
+
+    LatencyRecorder recorder;
+    LatencyRecorder client_recorder;
+    LatencyRecorder kernel_recorder;
+    std::atomic<uint64_t> received(0);
+
+    OKXWebSocketClient client;
+    client.enable_auto_reconnect(false);
+    client.enable_compression(config.deflate);
+    client.set_thread_config(thread_config);
+    if (latency_mode) {
+        client.set_latency_mode(latency_config);
+    }
+    if (rx_timestamps) {
+        if (!config.use_ssl) {
+            std::cout << "⚠️  --rx-timestamps 需要 --ssl，明文连接没有内核时间戳" << std::endl;
+        }
+        client.enable_rx_timestamping();
+    }
+    client.set_channel_callback<MockTickerData>([&](const MockTickerData& ticker) {
+        recorder.record(MockOKXServer::now_ns() - ticker.send_ns);
+        client_recorder.record(TscClock::ticks_to_ns(TscClock::now() - client.rx_timestamps().receive));
+        if (client.rx_timestamps().kernel_ns != 0) {
+            kernel_recorder.record(TscClock::realtime_ns() - client.rx_timestamps().kernel_ns);
+        }
+        received.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    auto transport = uring ? OKXWebSocketClient::Transport::IoUring : OKXWebSocketClient::Transport::Libwebsockets;
+    if (!client.connect("127.0.0.1", config.port, "/ws/v5/public", config.use_ssl, transport)) {
+        std::cerr << "❌ Test FAILED: Could not connect to mock server" << std::endl;
+        return 1;
+    }
+    for (int i = 0; i < 50 && !client.is_connected(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (!client.is_connected()) {
+        std::cerr << "❌ Test FAILED: Connection to mock server not established" << std::endl;
+        return 1;
+    }
+    if (latency_mode) {
+        const LatencyReport& report = client.latency_report();
+        std::cout << "  延迟模式: 预留 " << report.reserved_bytes << " 字节, 预触 " << report.prefaulted_bytes
+                  << " 字节, 大页 " << report.huge_page_bytes << " 字节, 锁定 " << report.locked_bytes << " 字节" << std::endl;
+    }
+
+    for (uint32_t i = 0; i < config.instruments; ++i) {
+        client.subscribe_ticker(MockOKXServer::instrument_name(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::vector<StepResult> results;
+    for (uint32_t rate : rates) {
+        server.set_rate(rate);
+        // 预热，丢弃改速率前的积压
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        recorder.reset();
+        client_recorder.reset();
+        kernel_recorder.reset();
+        uint64_t received_start = received.load();
+        uint64_t sent_start = server.stats().frames_sent;
+
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+        uint64_t sent = server.stats().frames_sent - sent_start;
+        uint64_t tickers = received.load() - received_start;
+        std::vector<int64_t> samples = recorder.take();
+        std::sort(samples.begin(), samples.end());
+        std::vector<int64_t> client_samples = client_recorder.take();
+        std::sort(client_samples.begin(), client_samples.end());
+        std::vector<int64_t> kernel_samples = kernel_recorder.take();
+        std::sort(kernel_samples.begin(), kernel_samples.end());
+
+        StepResult step;
+        step.rate = rate;
+        step.sent = sent;
+        step.received = tickers / config.tickers_per_frame;
+        step.p50_us = percentile_us(samples, 0.50);
+        step.p99_us = percentile_us(samples, 0.99);
+        step.p999_us = percentile_us(samples, 0.999);
+        step.max_us = samples.empty() ? 0 : samples.back() / 1000;
+        step.client_p99_us = percentile_us(client_samples, 0.99);
+        step.kernel_p99_us = percentile_us(kernel_samples, 0.99);
+
+        uint64_t target = static_cast<uint64_t>(rate) * seconds;
+        step.sustained = !samples.empty() && sent * 100 >= target * 95 &&
+                         step.received * 100 >= sent * 95 && step.p99_us <= max_p99_us;
+        results.push_back(step);
+
+        std::cout << (step.sustained ? "✅ " : "❌ ") << rate << " msg/s: sent " << sent / seconds
+                  << "/s, received " << step.received / seconds << "/s, p50 " << step.p50_us
+                  << "us, p99 " << step.p99_us << "us, p99.9 " << step.p999_us
+                  << "us, max " << step.max_us << "us (client p99 " << step.client_p99_us << "us";
+        if (rx_timestamps) std::cout << ", kernel p99 " << step.kernel_p99_us << "us";
+        std::cout << ")" << std::endl;
+
+        if (!step.sustained) break;
+    }
+
+    if (config.deflate) {
+        CompressionStats compression = client.compression_stats();
+        std::cout << "🗜️  permessage-deflate " << (compression.negotiated ? "negotiated" : "NOT negotiated")
+                  << ": ratio " << compression.ratio() << "x, inflate "
+                  << (compression.inflate_calls ? compression.inflate_ns / compression.inflate_calls : 0)
+                  << " ns/call" << std::endl;
+    }
+
+    server.set_rate(0);
+    client.disconnect();
+    if (rx_timestamps) {
+        RxTimestampingStatus status = client.rx_timestamping_status();
+        std::cout << "⏱️  SO_TIMESTAMPING " << (status.attached ? "attached" : "NOT attached")
+                  << ": " << status.stamped_reads << "/" << status.reads << " reads stamped"
+                  << (status.error.empty() ? "" : ", " + status.error) << std::endl;
+    }
+    if (uring) {
+        UringStats stats = client.uring_stats();
+        std::cout << "💍 io_uring " << (client.transport() == OKXWebSocketClient::Transport::IoUring ? "" : "NOT ")
+                  << "used: kTLS rx " << (stats.ktls_rx ? "on" : "off") << ", " << stats.completions << " completions, "
+                  << stats.enters << " io_uring_enter, " << stats.messages << " messages, "
+                  << stats.copied_bytes << "/" << stats.bytes << " bytes copied" << std::endl;
+    }
+    server.stop();
+
+    uint32_t max_rate = 0;
+    for (const auto& step : results) {
+        if (step.sustained) max_rate = step.rate;
+    }
+
+    if (max_rate == 0) {
+        std::cerr << "❌ Test FAILED: Client could not sustain the lowest rate" << std::endl;
+        return 1;
+    }
+    std::cout << "📈 最大可持续速率: " << max_rate << " msg/s (p99 <= " << max_p99_us << "us)" << std::endl;
+    std::cout << "✅ ALL TESTS PASSED!" << std::endl;
+    return 0;
+}
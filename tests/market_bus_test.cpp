@@ -0,0 +1,218 @@
+#include "../src/market_bus.h"
+#include "test_util.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::string bus_name(const char* suffix) {
+    return "/okx_bus_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+// 同一条记录的字段互相校验，用于检测读到写了一半的槽
+static MarketTick make_tick(uint64_t seq) {
+    MarketTick tick{};
+    strcpy(tick.inst_id, "BTC-USDT");
+    strcpy(tick.inst_type, "SPOT");
+    tick.ts = static_cast<int64_t>(seq);
+    tick.bid_px = static_cast<double>(seq);
+    tick.ask_px = static_cast<double>(seq) + 0.5;
+    tick.vol24h = static_cast<double>(seq) * 2;
+    return tick;
+}
+
+static bool consistent(const MarketTick& tick) {
+    double seq = static_cast<double>(tick.ts);
+    return tick.bid_px == seq && tick.ask_px == seq + 0.5 && tick.vol24h == seq * 2 &&
+           strcmp(tick.inst_id, "BTC-USDT") == 0;
+}
+
+static void test_basic_and_overrun() {
+    std::string name = bus_name("basic");
+    std::string error;
+    MarketBusPublisher publisher;
+    publisher.set_unlink_on_close(true);
+    check(publisher.create(name, 10, error), "创建共享内存环（槽数取整为16）");
+
+    MarketBusSubscriber subscriber;
+    check(subscriber.open(name, error), "订阅端打开同名段");
+    MarketBusSubscriber missing;
+    check(!missing.open(bus_name("missing"), error) && error.find("shm_open") == 0, "打开不存在的段失败并返回原因");
+
+    MarketTick tick;
+    check(subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Empty, "无数据时返回Empty");
+
+    TickerView view;
+    view.inst_id = "ETH-USDT";
+    view.inst_type = "SWAP";
+    view.last = "2250.75";
+    view.bid_px = "2250.5";
+    view.ask_px = "2251";
+    view.ts = "1703073600000";
+    publisher.publish(view);
+
+    check(subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Ok &&
+          std::string(tick.inst_id) == "ETH-USDT" && std::string(tick.inst_type) == "SWAP" &&
+          tick.last == 2250.75 && tick.ask_px == 2251 && tick.ts == 1703073600000 && tick.publish_ns > 0,
+          "TickerView转换为定长记录");
+
+    for (uint64_t i = 0; i < 40; ++i) {
+        publisher.publish(make_tick(i));
+    }
+    check(subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Overrun && subscriber.dropped() == 39,
+          "被套圈时返回Overrun并统计丢弃数");
+    check(subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Ok && tick.ts == 39, "Overrun后从最新一条继续");
+
+    publisher.publish(make_tick(40));
+    check(subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Ok && tick.ts == 40, "继续读取新发布的记录");
+
+    // 发布端重启沿用原序号，已连接的读者不受影响
+    uint64_t before = publisher.published();
+    publisher.set_unlink_on_close(false);
+    publisher.close();
+    check(publisher.create(name, 16, error) && publisher.published() == before, "发布端重启沿用原序号");
+    publisher.publish(make_tick(41));
+    check(subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Ok && tick.ts == 41, "重启后读者继续读取");
+    publisher.set_unlink_on_close(true);
+}
+
+static void test_futex_wait() {
+    std::string name = bus_name("futex");
+    std::string error;
+    MarketBusPublisher publisher;
+    publisher.set_unlink_on_close(true);
+    publisher.create(name, 64, error);
+
+    MarketBusSubscriber subscriber;
+    subscriber.open(name, error);
+
+    MarketTick tick;
+    auto start = std::chrono::steady_clock::now();
+    auto result = subscriber.wait(tick, 20, 0);
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    check(result == MarketBusSubscriber::ReadResult::Empty && waited >= 19, "futex等待超时返回Empty");
+
+    std::thread waiter([&] {
+        result = subscriber.wait(tick, 5000, 0);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    publisher.publish(make_tick(7));
+    waiter.join();
+    check(result == MarketBusSubscriber::ReadResult::Ok && tick.ts == 7, "发布后唤醒futex等待者");
+}
+
+// 子进程作为独立订阅者，检查不会读到撕裂记录、序号单调
+static void test_cross_process() {
+    constexpr uint64_t total = 2000000;
+    std::string name = bus_name("proc");
+    std::string error;
+    MarketBusPublisher publisher;
+    publisher.set_unlink_on_close(true);
+    publisher.create(name, 1024, error);
+
+    int ready[2];
+    if (pipe(ready) != 0) {
+        check(false, "创建管道");
+        return;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(ready[0]);
+        MarketBusSubscriber subscriber;
+        if (!subscriber.open(name, error)) _exit(2);
+        char byte = 1;
+        if (write(ready[1], &byte, 1) != 1) _exit(2);
+
+        MarketTick tick;
+        int64_t last_ts = -1;
+        uint64_t received = 0;
+        while (last_ts < static_cast<int64_t>(total - 1)) {
+            auto result = subscriber.wait(tick, 5000);
+            if (result == MarketBusSubscriber::ReadResult::Empty) _exit(3);
+            if (result == MarketBusSubscriber::ReadResult::Overrun) continue;
+            if (!consistent(tick) || tick.ts <= last_ts) _exit(4);
+            last_ts = tick.ts;
+            ++received;
+        }
+        if (received + subscriber.dropped() != total) _exit(5);
+        _exit(0);
+    }
+
+    close(ready[1]);
+    char byte;
+    bool child_ready = read(ready[0], &byte, 1) == 1;
+    close(ready[0]);
+
+    for (uint64_t i = 0; i < total; ++i) {
+        publisher.publish(make_tick(i));
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    check(child_ready && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+          "跨进程读取200万条无撕裂记录，收到+丢弃=发布数");
+}
+
+// 同机单跳延迟: publish_ns 到读者拿到记录
+static void benchmark_hop_latency() {
+    if (std::thread::hardware_concurrency() < 2) {
+        std::cout << "⚠️ 单核环境，跳过单跳延迟测量" << std::endl;
+        return;
+    }
+
+    std::string name = bus_name("latency");
+
+    std::string error;
+    MarketBusPublisher publisher;
+    publisher.set_unlink_on_close(true);
+    publisher.create(name, 4096, error);
+
+    MarketBusSubscriber subscriber;
+    subscriber.open(name, error);
+
+    constexpr int samples = 100000;
+    std::vector<int64_t> latencies;
+    latencies.reserve(samples);
+
+    std::thread reader([&] {
+        MarketTick tick;
+        tick.ts = -1;
+        while (tick.ts < samples - 1) {
+            if (subscriber.poll(tick) == MarketBusSubscriber::ReadResult::Ok) {
+                timespec now;
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                latencies.push_back(int64_t(now.tv_sec) * 1000000000LL + now.tv_nsec - tick.publish_ns);
+            }
+        }
+    });
+
+    for (int i = 0; i < samples; ++i) {
+        publisher.publish(make_tick(i));
+        // 留出间隔，测的是单条延迟而不是排队
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(2);
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+    reader.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    size_t n = latencies.size();
+    std::cout << "⚡ 发布->订阅单跳延迟: p50 " << latencies[n / 2] << "ns, p99 "
+              << latencies[n * 99 / 100] << "ns" << std::endl;
+}
+
+int main() {
+    std::cout << "📡 共享内存行情总线测试" << std::endl;
+
+    test_basic_and_overrun();
+    test_futex_wait();
+    test_cross_process();
+    benchmark_hop_latency();
+
+    return test_summary();
+}
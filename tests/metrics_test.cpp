@@ -0,0 +1,141 @@
+#include "../src/metrics.h"
+#include "../src/ticker_handler.h"
+#include "../src/async_logger.h"
+#include "test_util.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string http_get(int port, const std::string& path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return "";
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+static void test_counters() {
+    MetricsRegistry registry;
+    MetricCounter& counter = registry.counter("test_events_total", "Events");
+    check(&counter == &registry.counter("test_events_total", "Events"), "同名同标签返回同一计数器");
+
+    // 超过独占分片数的线程共享最后一片，总数仍然准确
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 20; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 100000; ++i) counter.add();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    check(counter.value() == 2000000, "20个线程并发累加求和准确: " + std::to_string(counter.value()));
+
+    MetricGauge& gauge = registry.gauge("test_depth", "Depth");
+    gauge.set(7);
+    gauge.add(-2);
+    check(gauge.value() == 5, "gauge set/add");
+
+    uint64_t external = 42;
+    registry.counter_fn("test_external_total", "External", [&] { return static_cast<double>(external); });
+    registry.counter("test_per_instrument_total", "Per instrument", MetricsRegistry::label("inst_id", "BTC-USDT")).add(3);
+    registry.counter("test_per_instrument_total", "Per instrument", MetricsRegistry::label("inst_id", "a\"b")).add(1);
+
+    auto samples = registry.snapshot();
+    check(samples.size() == 5, "snapshot 返回全部序列");
+
+    std::string text = registry.prometheus_text();
+    check(text.find("# TYPE test_events_total counter\ntest_events_total 2000000\n") != std::string::npos, "Prometheus 计数器格式");
+    check(text.find("# TYPE test_depth gauge\ntest_depth 5\n") != std::string::npos, "Prometheus gauge 格式");
+    check(text.find("test_external_total 42\n") != std::string::npos, "读取时回调取值");
+    check(text.find("test_per_instrument_total{inst_id=\"BTC-USDT\"} 3\n") != std::string::npos &&
+          text.find("test_per_instrument_total{inst_id=\"a\\\"b\"} 1\n") != std::string::npos, "标签输出与转义");
+    check(text.find("# HELP test_per_instrument_total") == text.rfind("# HELP test_per_instrument_total"), "同名序列只输出一次 HELP");
+}
+
+static void test_slot_reuse() {
+    MetricsRegistry registry;
+    MetricCounter& counter = registry.counter("test_reuse_total", "Reuse");
+
+    // 依次启动 40 个短命线程，退出的线程归还分片，后来的线程仍然拿到独占分片
+    bool all_exclusive = true;
+    for (int t = 0; t < 40; ++t) {
+        std::thread([&] {
+            all_exclusive &= MetricCounter::thread_slot() < MetricCounter::kExclusiveShards;
+            for (int i = 0; i < 1000; ++i) counter.add();
+        }).join();
+    }
+    check(all_exclusive, "线程退出后分片被复用，第 40 个线程仍独占分片");
+    check(counter.value() == 40000, "复用分片的线程接着累加，总数准确: " + std::to_string(counter.value()));
+}
+
+static void test_endpoint() {
+    MetricsRegistry registry;
+    registry.counter("test_requests_total", "Requests").add(9);
+
+    MetricsServer server(registry);
+    check(server.start(0), "端点启动（系统分配端口）");
+
+    std::string response = http_get(server.port(), "/metrics");
+    check(response.starts_with("HTTP/1.1 200 OK"), "GET /metrics 返回 200");
+    check(response.find("text/plain; version=0.0.4") != std::string::npos, "Content-Type 为 Prometheus 文本格式");
+    check(response.find("test_requests_total 9\n") != std::string::npos, "响应包含计数器");
+    check(http_get(server.port(), "/other").starts_with("HTTP/1.1 404"), "其它路径返回 404");
+
+    server.stop();
+    check(http_get(server.port(), "/metrics").empty(), "停止后端口关闭");
+}
+
+static void test_parse_failure_classification() {
+    TickerHandler handler([](const TickerData&) {});
+    using Result = TickerHandler::Result;
+    check(handler.handle_message(R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[{"instId":"BTC-USDT","last":"1","ts":"1"}]})") == Result::Dispatched,
+          "正常 ticker 推送被分发");
+    check(handler.handle_message(R"({"event":"subscribe","arg":{"channel":"tickers","instId":"BTC-USDT"},"connId":"1"})") == Result::Ignored,
+          "订阅回执不算解析失败");
+    check(handler.handle_message(R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[{"last":"1"}]})") == Result::ParseError,
+          "缺少 instId 的 ticker 推送算解析失败");
+}
+
+static void benchmark() {
+    MetricsRegistry registry;
+    MetricCounter& counter = registry.counter("bench_total", "Bench");
+    const int iterations = 10000000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) counter.add();
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+    std::cout << "  counter.add(): " << ns << " 纳秒/次" << std::endl;
+}
+
+int main() {
+    std::cout << "📊 指标测试" << std::endl;
+    AsyncLogger::set_level(LogLevel::Warn);
+
+    test_counters();
+    test_slot_reuse();
+    test_endpoint();
+    test_parse_failure_classification();
+    benchmark();
+
+    return test_summary();
+}
@@ -0,0 +1,67 @@
+#include "../src/mock_okx_server.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+static std::atomic<bool> running(true);
+
+static void usage(const char* name) {
+    std::cout << "Usage: " << name << " [--port N] [--ssl] [--cert FILE --key FILE] [--rate N]"
+              << " [--instruments N] [--per-frame N] [--replay FILE] [--deflate]"
+              << " [--api-key KEY --secret SECRET --passphrase PASS]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    MockServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--port" && has_value) config.port = atoi(argv[++i]);
+        else if (arg == "--ssl") config.use_ssl = true;
+        else if (arg == "--cert" && has_value) config.cert_path = argv[++i];
+        else if (arg == "--key" && has_value) config.key_path = argv[++i];
+        else if (arg == "--rate" && has_value) config.rate = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--instruments" && has_value) config.instruments = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--per-frame" && has_value) config.tickers_per_frame = static_cast<uint32_t>(atoi(argv[++i]));
+        else if (arg == "--replay" && has_value) config.replay_file = argv[++i];
+        else if (arg == "--deflate") config.deflate = true;
+        else if (arg == "--api-key" && has_value) config.api_key = argv[++i];
+        else if (arg == "--secret" && has_value) config.secret_key = argv[++i];
+        else if (arg == "--passphrase" && has_value) config.passphrase = argv[++i];
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, [](int) { running = false; });
+    std::signal(SIGTERM, [](int) { running = false; });
+
+    MockOKXServer server(config);
+    if (!server.start()) {
+        return 1;
+    }
+
+    std::cout << "Subscribe to " << MockOKXServer::instrument_name(0) << " .. "
+              << MockOKXServer::instrument_name(config.instruments > 0 ? config.instruments - 1 : 0)
+              << " (or any instId) on ws" << (config.use_ssl ? "s" : "") << "://127.0.0.1:" << config.port
+              << "/ws/v5/public" << std::endl;
+
+    MockServerStats last = server.stats();
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        MockServerStats now = server.stats();
+        std::cout << "sessions " << now.sessions
+                  << ", frames/s " << (now.frames_sent - last.frames_sent)
+                  << ", KB/s " << (now.bytes_sent - last.bytes_sent) / 1024 << std::endl;
+        last = now;
+    }
+
+    server.stop();
+    return 0;
+}
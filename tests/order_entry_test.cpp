@@ -0,0 +1,228 @@
+#include "../src/order_entry.h"
+#include "../src/json_parser.h"
+#include "../src/tsc_clock.h"
+#include "test_util.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static std::string frame_of(uint64_t id, const auto& request) {
+    char buffer[OrderEntry::kMaxFrame];
+    size_t length = OrderEntry::serialize(id, request, buffer, sizeof(buffer));
+    return std::string(buffer, length);
+}
+
+static std::string response(uint64_t id, const std::string& op, const std::string& s_code, const std::string& code = "0") {
+    return R"({"id":")" + std::to_string(id) + R"(","op":")" + op +
+           R"(","data":[{"clOrdId":"c1","ordId":"312269865356374016","tag":"","sCode":")" + s_code +
+           R"(","sMsg":""}],"code":")" + code + R"(","msg":"","inTime":"1","outTime":"2"})";
+}
+
+static OrderRequest limit_order() {
+    OrderRequest order;
+    order.inst_id = "BTC-USDT";
+    order.side = "buy";
+    order.ord_type = "limit";
+    order.sz = "0.01";
+    order.px = "30000";
+    order.cl_ord_id = "c1";
+    return order;
+}
+
+static void test_serialize() {
+    OrderRequest order = limit_order();
+    check(frame_of(42, order) ==
+          R"({"id":"42","op":"order","args":[{"instId":"BTC-USDT","tdMode":"cash","side":"buy","ordType":"limit","sz":"0.01","px":"30000","clOrdId":"c1"}]})",
+          "下单帧格式，空的可选字段省略");
+
+    order.px = "";
+    order.td_mode = "cross";
+    order.pos_side = "long";
+    order.reduce_only = true;
+    check(frame_of(7, order) ==
+          R"({"id":"7","op":"order","args":[{"instId":"BTC-USDT","tdMode":"cross","side":"buy","ordType":"limit","sz":"0.01","clOrdId":"c1","posSide":"long","reduceOnly":true}]})",
+          "市价/合约字段");
+
+    CancelRequest cancel;
+    cancel.inst_id = "BTC-USDT";
+    cancel.ord_id = "312269865356374016";
+    check(frame_of(8, cancel) ==
+          R"({"id":"8","op":"cancel-order","args":[{"instId":"BTC-USDT","ordId":"312269865356374016"}]})",
+          "撤单帧格式");
+    AmendRequest amend;
+    amend.inst_id = "BTC-USDT";
+    amend.cl_ord_id = "c1";
+    amend.new_sz = "0.02";
+    amend.new_px = "30100";
+    check(frame_of(9, amend) ==
+          R"({"id":"9","op":"amend-order","args":[{"instId":"BTC-USDT","clOrdId":"c1","newSz":"0.02","newPx":"30100"}]})",
+          "改单帧格式");
+
+    char tiny[16];
+    check(OrderEntry::serialize(1, order, tiny, sizeof(tiny)) == 0, "缓冲区不足返回 0");
+
+    // 字段值不转义，含引号/反斜杠/控制字符的请求不能变成注入了额外字段的帧
+    char buffer[512];
+    OrderRequest injected = limit_order();
+    injected.cl_ord_id = R"(c1","reduceOnly":true,"x":")";
+    check(OrderEntry::serialize(1, injected, buffer, sizeof(buffer)) == 0, "clOrdId 含引号时拒绝序列化");
+    cancel.ord_id = "1\\2";
+    amend.new_px = "30100\n";
+    check(OrderEntry::serialize(2, cancel, buffer, sizeof(buffer)) == 0 && OrderEntry::serialize(3, amend, buffer, sizeof(buffer)) == 0,
+          "反斜杠和控制字符同样拒绝");
+
+    OrderEntry entry;
+    int frames = 0;
+    entry.set_sender([&](std::string_view) { frames++; return true; });
+    check(entry.place(injected) == 0 && frames == 0 && entry.stats().send_failures == 1 && entry.in_flight() == 0,
+          "非法字段的下单不发送，计入发送失败");
+}
+
+static void test_request_ids() {
+    std::set<uint64_t> ids;
+    for (int i = 0; i < 1000; ++i) ids.insert(JsonParser::next_request_id());
+    check(ids.size() == 1000, "请求 id 不重复");
+
+    std::string a = JsonParser::create_subscription_message("tickers", "BTC-USDT");
+    std::string b = JsonParser::create_subscription_message("tickers", "BTC-USDT");
+    check(a != b && a.starts_with(R"({"id":")") &&
+          a.ends_with(R"(","op":"subscribe","args":[{"channel":"tickers","instId":"BTC-USDT"}]})"),
+          "同一秒内的两次订阅 id 不同");
+}
+
+static void test_in_flight_table() {
+    InFlightTable table(8);
+    check(table.capacity() == 8, "容量");
+    for (uint64_t id = 1; id <= 8; ++id) table.insert(id, OrderOp::Place, id * 10);
+    check(!table.insert(9, OrderOp::Place, 0), "满后拒绝插入");
+    check(!table.insert(0, OrderOp::Place, 0), "id 0 保留为空槽");
+
+    InFlightTable::Entry entry;
+    check(table.remove(5, entry) && entry.sent_ticks == 50 && table.size() == 7, "删除返回登记信息");
+    check(!table.remove(5, entry), "重复删除失败");
+
+    // 随机插入/删除，与 std::unordered_map 对照，覆盖回移删除
+    InFlightTable random_table(64);
+    std::unordered_map<uint64_t, uint64_t> reference;
+    std::mt19937_64 rng(1);
+    bool consistent = true;
+    uint64_t next_id = 1;
+    for (int step = 0; step < 200000; ++step) {
+        if (reference.size() < 64 && (rng() & 1)) {
+            uint64_t id = next_id++;
+            consistent &= random_table.insert(id, OrderOp::Cancel, id ^ 0xABCD);
+            reference[id] = id ^ 0xABCD;
+        } else if (!reference.empty()) {
+            // 乱序完成
+            auto it = reference.begin();
+            std::advance(it, rng() % reference.size());
+            consistent &= random_table.remove(it->first, entry) && entry.sent_ticks == it->second;
+            reference.erase(it);
+        }
+        // 也查找从未存在或已完成的 id
+        consistent &= !random_table.remove(next_id + 1000, entry);
+    }
+    check(consistent && random_table.size() == reference.size(), "随机乱序完成与参照实现一致");
+}
+
+static void test_matching() {
+    OrderEntry entry(4);
+    std::vector<std::string> sent;
+    bool connected = true;
+    entry.set_sender([&](std::string_view frame) {
+        if (!connected) return false;
+        sent.emplace_back(frame);
+        return true;
+    });
+
+    // 结果中的字符串只在回调期间有效，这里拷贝出来
+    struct Completed {
+        uint64_t request_id;
+        OrderOp op;
+        bool success;
+        std::string code;
+        std::string s_code;
+        std::string ord_id;
+        int64_t rtt_ns;
+    };
+    std::vector<Completed> results;
+    entry.set_completion([&](const OrderResult& result) {
+        results.push_back({result.request_id, result.op, result.success, std::string(result.code),
+                           std::string(result.s_code), std::string(result.ord_id), result.rtt_ns});
+    });
+
+    OrderRequest order = limit_order();
+    CancelRequest cancel;
+    cancel.inst_id = "BTC-USDT";
+    cancel.ord_id = "312269865356374016";
+    uint64_t first = entry.place(order);
+    uint64_t second = entry.cancel(cancel);
+    check(first != 0 && second == first + 1 && entry.in_flight() == 2 && sent.size() == 2, "登记在途请求");
+
+    check(!entry.handle_response(R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[]})"), "行情推送不被消费");
+    check(!entry.handle_response(R"({"id":"1","event":"subscribe","arg":{"channel":"tickers"}})"), "带 id 的订阅回执不被消费");
+
+    // 乱序应答
+    check(entry.handle_response(response(second, "cancel-order", "51400", "1")), "撤单应答被消费");
+    check(entry.handle_response(response(first, "order", "0")), "下单应答被消费");
+    check(results.size() == 2 && results[0].request_id == second && !results[0].success && results[0].s_code == "51400" &&
+          results[0].op == OrderOp::Cancel, "撤单失败结果");
+    check(results[1].request_id == first && results[1].success && results[1].ord_id == "312269865356374016" &&
+          results[1].rtt_ns >= 0, "下单成功结果与往返时间: " + std::to_string(results[1].rtt_ns) + " ns");
+    check(entry.in_flight() == 0, "完成后移出在途表");
+
+    check(entry.handle_response(response(first, "order", "0")) && entry.stats().unmatched == 1, "重复应答计为未匹配");
+
+    for (int i = 0; i < 4; ++i) entry.place(order);
+    check(entry.place(order) == 0 && entry.stats().send_failures == 1, "在途表满时拒绝下单");
+
+    entry.fail_all("disconnected", "closed");
+    check(results.size() == 6 && results.back().code == "disconnected" && entry.in_flight() == 0, "断线时完成全部在途请求");
+
+    connected = false;
+    check(entry.place(order) == 0 && entry.in_flight() == 0, "未连接时下单失败且不留在途记录");
+}
+
+static void benchmark() {
+    OrderRequest order = limit_order();
+    char buffer[OrderEntry::kMaxFrame];
+    const int iterations = 1000000;
+    size_t total = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) total += OrderEntry::serialize(static_cast<uint64_t>(i), order, buffer, sizeof(buffer));
+    auto end = std::chrono::high_resolution_clock::now();
+    double templated = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::ostringstream oss;
+        oss << "{\"id\":\"" << i << "\",\"op\":\"order\",\"args\":[{\"instId\":\"" << order.inst_id
+            << "\",\"tdMode\":\"" << order.td_mode << "\",\"side\":\"" << order.side << "\",\"ordType\":\""
+            << order.ord_type << "\",\"sz\":\"" << order.sz << "\",\"px\":\"" << order.px << "\",\"clOrdId\":\""
+            << order.cl_ord_id << "\"}]}";
+        total += oss.str().size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double stream = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+
+    std::cout << "  模板序列化: " << templated << " 纳秒/帧, ostringstream: " << stream << " 纳秒/帧 (" << total % 7 << ")" << std::endl;
+}
+
+int main() {
+    std::cout << "📝 WebSocket 下单测试" << std::endl;
+    TscClock::initialize();
+
+    test_serialize();
+    test_request_ids();
+    test_in_flight_table();
+    test_matching();
+    benchmark();
+
+    return test_summary();
+}
@@ -0,0 +1,52 @@
+#include "../src/json_parser.h"
+#include "../src/json_validator.h"
+#include "../src/okx_channels.h"
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+// libFuzzer入口: 快速模式只要求不崩溃/不越界，严格模式额外检查不变量
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string json(reinterpret_cast<const char*>(data), size);
+
+    JsonParser::parse_simple(json);
+    JsonParser::parse_ticker_data(json);
+
+    static TickerBatch batch;
+    JsonParser::parse_ticker_data_into(json, batch);
+
+    bool valid = JsonValidator::validate(json);
+    auto strict_simple = JsonParser::parse_simple(json, ParseMode::Strict);
+    auto strict = JsonParser::parse_ticker_data(json, ParseMode::Strict);
+    bool strict_batch = JsonParser::parse_ticker_data_into(json, batch, ParseMode::Strict);
+
+    // 严格模式只接受合法JSON
+    if ((strict_simple || strict || strict_batch) && !valid) {
+        abort();
+    }
+
+    // 两个严格接口的结果必须一致
+    if (static_cast<bool>(strict) != strict_batch || (strict && strict->size() != batch.size())) {
+        abort();
+    }
+
+    if (strict) {
+        for (size_t i = 0; i < strict->size(); ++i) {
+            const TickerData& ticker = (*strict)[i];
+            if (ticker.inst_id != batch[i].inst_id || ticker.last != batch[i].last || ticker.ts != batch[i].ts) {
+                abort();
+            }
+
+            // 序列化后重新严格解析得到相同的值
+            std::string message = R"({"arg":{"channel":"tickers"},"data":[)" + SchemaCodec<TickerData>::serialize(ticker) + "]}";
+            auto reparsed = JsonParser::parse_ticker_data(message, ParseMode::Strict);
+            if (JsonValidator::validate(message) &&
+                (!reparsed || reparsed->size() != 1 || (*reparsed)[0].inst_id != ticker.inst_id ||
+                 (*reparsed)[0].bid_px != ticker.bid_px)) {
+                abort();
+            }
+        }
+    }
+
+    return 0;
+}
@@ -1,8 +1,27 @@
 #include "../src/json_parser.h"
+#include "../src/okx_channels.h"
+#include "../src/ticker_fields.h"
 #include <iostream>
 #include <chrono>
 #include <vector>
 
+// 字段表生成的频道解析器吞吐
+template <typename T>
+static void benchmark_channel(const std::string& json, int iterations) {
+    std::vector<T> items;
+    int parsed = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        if (SchemaCodec<T>::parse_message(json, items)) {
+            parsed++;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+    std::cout << "  " << SchemaCodec<T>::channel() << ": " << parsed << "/" << iterations
+              << " 平均 " << ns << " 纳秒/消息" << std::endl;
+}
+
 int main() {
     // 模拟OKX ticker消息 (紧凑格式以提高性能测试准确性)
     const std::string test_ticker_json = R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[{"instType":"SPOT","instId":"BTC-USDT","last":"43250.5","lastSz":"0.1234","askPx":"43251.0","askSz":"1.5","bidPx":"43249.5","bidSz":"2.3","open24h":"42000.0","high24h":"43500.0","low24h":"41500.0","volCcy24h":"1234567.89","vol24h":"29.456","sodUtc0":"42100.0","sodUtc8":"42150.0","ts":"1703073600000"}]})";
@@ -36,6 +55,96 @@ int main() {
     std::cout << "  平均每次: " << (duration.count() / (double)iterations) << " 微秒" << std::endl;
     std::cout << "  吞吐量: " << (iterations * 1000000.0 / duration.count()) << " 消息/秒" << std::endl;
 
+    // 复用batch的批量解析接口（稳态零分配）
+    TickerBatch batch;
+    auto batch_start = std::chrono::high_resolution_clock::now();
+    int batch_parses = 0;
+    for (int i = 0; i < iterations; ++i) {
+        if (JsonParser::parse_ticker_data_into(test_ticker_json, batch)) {
+            batch_parses++;
+        }
+    }
+    auto batch_end = std::chrono::high_resolution_clock::now();
+    auto batch_duration = std::chrono::duration_cast<std::chrono::microseconds>(batch_end - batch_start);
+
+    std::cout << std::endl << "✅ parse_ticker_data_into (复用TickerBatch):" << std::endl;
+    std::cout << "  成功解析: " << batch_parses << "/" << iterations << std::endl;
+    std::cout << "  平均每次: " << (batch_duration.count() / (double)iterations) << " 微秒" << std::endl;
+    std::cout << "  吞吐量: " << (iterations * 1000000.0 / batch_duration.count()) << " 消息/秒" << std::endl;
+
+    // 严格模式的代价: 完整结构校验 + 转义处理；取 10 轮中最快的一轮，减少调度抖动
+    auto time_mode = [&](ParseMode mode) {
+        TickerBatch mode_batch;
+        double best = 0.0;
+        for (int round = 0; round < 10; ++round) {
+            auto mode_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations / 10; ++i) {
+                JsonParser::parse_ticker_data_into(test_ticker_json, mode_batch, mode);
+            }
+            auto mode_end = std::chrono::high_resolution_clock::now();
+            double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mode_end - mode_start).count() / (double)(iterations / 10);
+            if (round == 0 || ns < best) best = ns;
+        }
+        return best;
+    };
+    double fast_ns = time_mode(ParseMode::Fast);
+    double strict_ns = time_mode(ParseMode::Strict);
+    std::cout << std::endl << "✅ 严格模式 vs 快速模式:" << std::endl;
+    std::cout << "  Fast:   " << fast_ns << " 纳秒/消息" << std::endl;
+    std::cout << "  Strict: " << strict_ns << " 纳秒/消息" << std::endl;
+    std::cout << "  正确性代价: +" << (strict_ns - fast_ns) << " 纳秒 (" << (strict_ns / fast_ns) << "x)" << std::endl;
+
+    // 字段掩码: 按 schema 顺序取前 n 个字段（instId 总会解析）
+    // 掩码之间差几十纳秒，取 10 轮中最快的一轮，减少调度抖动的影响
+    auto time_mask = [&](FieldMask wanted) {
+        TickerBatch mask_batch;
+        double best = 0.0;
+        for (int round = 0; round < 10; ++round) {
+            auto mask_start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations / 10; ++i) {
+                JsonParser::parse_ticker_data_into(test_ticker_json, mask_batch, ParseMode::Fast, wanted);
+            }
+            auto mask_end = std::chrono::high_resolution_clock::now();
+            double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mask_end - mask_start).count() / (double)(iterations / 10);
+            if (round == 0 || ns < best) best = ns;
+        }
+        return best;
+    };
+    std::cout << std::endl << "✅ 字段掩码 (运行期，前缀掩码，找齐后提前停止):" << std::endl;
+    double all_ns = time_mask(kAllFields);
+    for (int fields : {1, 2, 4, 8, 12, 16}) {
+        FieldMask wanted = static_cast<FieldMask>((1ULL << fields) - 1);
+        double ns = time_mask(wanted);
+        std::cout << "  " << fields << " 个字段: " << ns << " 纳秒/消息 (" << (1.0 - ns / all_ns) * 100.0 << "% 节省)" << std::endl;
+    }
+    // 实际的掩码大多包含最后一个 key ts，提前停止不会触发，节省只来自跳过的解码和拷贝
+    std::cout << "  非前缀掩码 (含最后的 ts):" << std::endl;
+    const std::pair<const char*, FieldMask> typical_masks[] = {
+        {"Quote (instId/last/bidPx/askPx/ts)", TickerField::Quote},
+        {"K线 (instId/last/vol24h/ts)", TickerField::InstId | TickerField::Last | TickerField::Vol24h | TickerField::Ts},
+        {"instId/ts", TickerField::InstId | TickerField::Ts},
+    };
+    for (const auto& [name, wanted] : typical_masks) {
+        double ns = time_mask(wanted);
+        std::cout << "  " << name << ": " << ns << " 纳秒/消息 (" << (1.0 - ns / all_ns) * 100.0 << "% 节省)" << std::endl;
+    }
+    TickerBatch quote_batch;
+    auto quote_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        JsonParser::parse_ticker_fields_into<TickerField::Quote>(test_ticker_json, quote_batch);
+    }
+    auto quote_end = std::chrono::high_resolution_clock::now();
+    std::cout << "  Quote 运行期: " << time_mask(TickerField::Quote) << " 纳秒/消息, 编译期: "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(quote_end - quote_start).count() / (double)iterations
+              << " 纳秒/消息" << std::endl;
+
+    std::cout << std::endl << "✅ 字段表生成的频道解析器:" << std::endl;
+    benchmark_channel<MarkPriceData>(R"({"arg":{"channel":"mark-price","instId":"BTC-USDT-SWAP"},"data":[{"instType":"SWAP","instId":"BTC-USDT-SWAP","markPx":"43250.1","ts":"1703073600000"}]})", iterations);
+    benchmark_channel<FundingRateData>(R"({"arg":{"channel":"funding-rate","instId":"BTC-USDT-SWAP"},"data":[{"fundingRate":"0.0001","fundingTime":"1703088000000","instId":"BTC-USDT-SWAP","instType":"SWAP","method":"current_period","nextFundingRate":"","nextFundingTime":"1703116800000","premium":"0.0002","ts":"1703073600000"}]})", iterations);
+    benchmark_channel<IndexTickerData>(R"({"arg":{"channel":"index-tickers","instId":"BTC-USDT"},"data":[{"instId":"BTC-USDT","idxPx":"43000.1","high24h":"43500","low24h":"41500","open24h":"42000","sodUtc0":"42100","sodUtc8":"42150","ts":"1703073600000"}]})", iterations);
+    benchmark_channel<OpenInterestData>(R"({"arg":{"channel":"open-interest","instId":"BTC-USDT-SWAP"},"data":[{"instType":"SWAP","instId":"BTC-USDT-SWAP","oi":"5000","oiCcy":"50","oiUsd":"2150000","ts":"1703073600000"}]})", iterations);
+    benchmark_channel<TickerData>(test_ticker_json, iterations);
+
     // 验证解析正确性
     auto sample = JsonParser::parse_ticker_data(test_ticker_json);
     if (sample && !sample->empty()) {
@@ -0,0 +1,172 @@
+#include "../src/hmac_signer.h"
+#include "../src/okx_private_channels.h"
+#include "../src/json_parser.h"
+#include "../src/async_logger.h"
+#include "test_util.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <openssl/hmac.h>
+
+static std::string hex(const unsigned char* data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < size; ++i) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 0xF];
+    }
+    return out;
+}
+
+static bool inside(std::string_view view, const std::string& buffer) {
+    return view.data() >= buffer.data() && view.data() + view.size() <= buffer.data() + buffer.size();
+}
+
+static void test_signer() {
+    HmacSigner signer;
+    unsigned char digest[HmacSigner::kDigestSize];
+    check(!signer.sign("x", digest), "未设置密钥时签名失败");
+
+    // RFC 4231 测试用例 2
+    check(signer.set_key("Jefe"), "设置密钥");
+    check(signer.sign("what do ya want for nothing?", digest) &&
+          hex(digest, sizeof(digest)) == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+          "RFC 4231 HMAC-SHA256 向量");
+    // 重复签名复用预计算的密钥状态，结果不变
+    unsigned char again[HmacSigner::kDigestSize];
+    check(signer.sign("what do ya want for nothing?", again) && memcmp(digest, again, sizeof(digest)) == 0,
+          "重复签名结果一致");
+
+    // 与一次性 HMAC() 对比 OKX 登录签名
+    const std::string secret = "22582BD0CFF14C41EDBF1AB98506286D";
+    const std::string prehash = HmacSigner::login_prehash("1538054050");
+    check(prehash == "1538054050GET/users/self/verify", "登录待签名串");
+
+    unsigned int length = 0;
+    unsigned char* reference = HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+                                    reinterpret_cast<const unsigned char*>(prehash.data()), prehash.size(), nullptr, &length);
+    signer.set_key(secret);
+    std::string sign;
+    bool signed_ok = signer.sign_base64(prehash, sign);
+    check(signed_ok && sign == HmacSigner::base64(reference, length) && sign.size() == 44,
+          "base64 签名与 HMAC() 一致: " + sign);
+}
+
+static void test_messages() {
+    check(JsonParser::create_login_message("key", "pass", "1538054050", "c2lnbg==") ==
+          R"({"op":"login","args":[{"apiKey":"key","passphrase":"pass","timestamp":"1538054050","sign":"c2lnbg=="}]})",
+          "登录请求格式");
+    std::string orders = JsonParser::create_private_subscription_message("orders", "ANY");
+    check(orders.starts_with(R"({"id":")") &&
+          orders.ends_with(R"(","op":"subscribe","args":[{"channel":"orders","instType":"ANY"}]})"),
+          "orders 订阅带 instType");
+    check(JsonParser::create_private_subscription_message("account", "").ends_with(
+              R"(","op":"subscribe","args":[{"channel":"account"}]})"),
+          "account 订阅省略 instType");
+}
+
+static void test_orders() {
+    const std::string message =
+        R"({"arg":{"channel":"orders","instType":"SPOT","uid":"77"},"data":[)"
+        R"({"instType":"SPOT","instId":"BTC-USDT","ordId":"312269865356374016","clOrdId":"b1","tag":"","px":"30000",)"
+        R"("sz":"0.01","ordType":"limit","side":"buy","posSide":"","tdMode":"cash","fillPx":"29999.5","tradeId":"9",)"
+        R"("fillSz":"0.005","fillTime":"1597026383084","accFillSz":"0.005","avgPx":"29999.5","state":"partially_filled",)"
+        R"("lever":"","fee":"-0.0000025","feeCcy":"BTC","pnl":"0","code":"0","msg":"",)"
+        R"("cTime":"1597026383085","uTime":"1597026383089","reduceOnly":"false"},)"
+        R"({"instId":"ETH-USDT","ordId":"2","state":"canceled","cTime":"1597026383000"}]})";
+
+    std::vector<OrderView> orders;
+    check(SchemaCodec<OrderView>::parse_message(message, orders) && orders.size() == 2, "解析 orders 推送");
+    const OrderView& order = orders[0];
+    check(order.inst_id == "BTC-USDT" && order.ord_id == "312269865356374016" && order.side == "buy" &&
+          order.state == "partially_filled" && order.fill_sz == "0.005" && order.fee == "-0.0000025",
+          "订单字段");
+    check(order.fill_time == 1597026383084 && order.c_time == 1597026383085 && order.u_time == 1597026383089,
+          "订单时间戳解码为毫秒");
+    check(inside(order.inst_id, message) && inside(order.ord_id, message) && inside(orders[1].state, message),
+          "字符串字段指向输入缓冲区（零拷贝）");
+    check(orders[1].state == "canceled" && orders[1].px.empty() && orders[1].u_time == 0, "缺失字段被重置");
+
+    // 第二次解析复用已有元素，不再分配
+    const OrderView* first = orders.data();
+    SchemaCodec<OrderView>::parse_message(message, orders);
+    check(orders.data() == first, "重复解析复用 vector 容量");
+
+    std::vector<OrderView> wrong;
+    check(!SchemaCodec<OrderView>::parse_message(R"({"arg":{"channel":"positions"},"data":[{"instId":"x"}]})", wrong),
+          "其它频道的推送不匹配");
+}
+
+static void test_positions_and_account() {
+    const std::string positions =
+        R"({"arg":{"channel":"positions","instType":"SWAP"},"data":[{"instType":"SWAP","instId":"BTC-USDT-SWAP",)"
+        R"("posId":"307173036051017730","posSide":"long","mgnMode":"cross","pos":"1","availPos":"1","avgPx":"30000",)"
+        R"("upl":"12.5","uplRatio":"0.004","lever":"10","liqPx":"27000","markPx":"30012.5","margin":"",)"
+        R"("mgnRatio":"11.2","notionalUsd":"300.1","ccy":"USDT","cTime":"1619507758793","uTime":"1619507761462",)"
+        R"("pTime":"1619507761500"}]})";
+    std::vector<PositionView> items;
+    check(SchemaCodec<PositionView>::parse_message(positions, items) && items.size() == 1 &&
+          items[0].pos_id == "307173036051017730" && items[0].upl == "12.5" && items[0].p_time == 1619507761500,
+          "解析 positions 推送");
+
+    const std::string account =
+        R"({"arg":{"channel":"account","uid":"77"},"data":[{"uTime":"1597026383085","totalEq":"41624.32",)"
+        R"("isoEq":"3624.32","adjEq":"41624.32","imr":"4162.43","mmr":"4","mgnRatio":"","notionalUsd":"",)"
+        R"("details":[{"ccy":"BTC","eq":"1","cashBal":"1","availBal":"0.9","frozenBal":"0.1","availEq":"0.9",)"
+        R"("upl":"0","eqUsd":"30000","uTime":"1597026383085"},{"ccy":"USDT","eq":"11624.32","cashBal":"11624.32",)"
+        R"("availBal":"11624.32","frozenBal":"0","uTime":"1597026383085"}]}]})";
+    std::vector<AccountView> accounts;
+    check(SchemaCodec<AccountView>::parse_message(account, accounts) && accounts.size() == 1 &&
+          accounts[0].total_eq == "41624.32" && accounts[0].u_time == 1597026383085,
+          "解析 account 推送");
+
+    std::vector<std::string> currencies;
+    size_t count = for_each_account_detail(accounts[0], [&](const AccountDetailView& detail) {
+        currencies.emplace_back(detail.ccy);
+        if (detail.ccy == "BTC") {
+            check(detail.avail_bal == "0.9" && detail.eq_usd == "30000" && inside(detail.cash_bal, account),
+                  "币种明细字段零拷贝");
+        }
+    });
+    check(count == 2 && currencies == std::vector<std::string>{"BTC", "USDT"}, "遍历 account.details");
+}
+
+static void benchmark() {
+    HmacSigner signer;
+    signer.set_key("22582BD0CFF14C41EDBF1AB98506286D");
+    const std::string prehash = HmacSigner::login_prehash("1538054050");
+    const int iterations = 200000;
+    unsigned char digest[HmacSigner::kDigestSize];
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) signer.sign(prehash, digest);
+    auto end = std::chrono::high_resolution_clock::now();
+    double reused = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+
+    const std::string secret = "22582BD0CFF14C41EDBF1AB98506286D";
+    unsigned int length = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+             reinterpret_cast<const unsigned char*>(prehash.data()), prehash.size(), digest, &length);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double oneshot = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+
+    std::cout << "  预计算密钥签名: " << reused << " 纳秒/次, 一次性 HMAC(): " << oneshot << " 纳秒/次" << std::endl;
+}
+
+int main() {
+    std::cout << "🔐 私有频道测试" << std::endl;
+    AsyncLogger::set_level(LogLevel::Warn);
+
+    test_signer();
+    test_messages();
+    test_orders();
+    test_positions_and_account();
+    benchmark();
+
+    return test_summary();
+}
@@ -0,0 +1,133 @@
+#include "../src/okx_websocket_client.h"
+#include "../src/mock_okx_server.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 本地模拟服务校验登录签名，覆盖登录成功、签名错误，以及登录后的下单/撤单往返
+
+template <typename Pred>
+static bool wait_for(Pred pred, int timeout_ms = 5000) {
+    for (int waited = 0; waited < timeout_ms; waited += 10) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+}
+
+static void test_login(int port) {
+    OKXWebSocketClient client;
+    client.enable_auto_reconnect(false);
+
+    std::atomic<int> orders{0};
+    std::atomic<int> positions{0};
+    std::atomic<int> details{0};
+    std::string order_state;
+    client.set_channel_callback<OrderView>([&](const OrderView& order) {
+        order_state = std::string(order.state);
+        orders++;
+    });
+    client.set_channel_callback<PositionView>([&](const PositionView&) { positions++; });
+    client.set_channel_callback<AccountView>([&](const AccountView& account) {
+        details += static_cast<int>(for_each_account_detail(account, [](const AccountDetailView&) {}));
+    });
+
+    std::atomic<bool> login_reported{false};
+    client.set_login_callback([&](bool success, const std::string&, const std::string&) {
+        login_reported = success;
+    });
+
+    check(client.set_credentials("mock-key", "mock-secret", "mock-pass"), "设置凭证");
+    // 连接前登记，登录成功后自动发送
+    client.subscribe_private("orders");
+    client.subscribe_private("positions", "SWAP");
+    client.subscribe_private("account", "");
+
+    check(client.connect("127.0.0.1", port, "/ws/v5/private", false), "连接模拟服务");
+    check(wait_for([&] { return client.is_logged_in(); }) && login_reported, "签名校验通过并登录");
+    check(wait_for([&] { return orders > 0 && positions > 0 && details > 0; }), "收到 orders/positions/account 推送");
+    check(order_state == "live", "订单视图字段正确");
+
+    // 下单 -> 撤单 -> 重复撤单，应答按请求 id 匹配
+    std::atomic<int> completed{0};
+    std::vector<std::pair<bool, std::string>> results;   // success, sCode
+    std::string ord_id;
+    int64_t rtt_ns = 0;
+    client.order_entry().set_completion([&](const OrderResult& result) {
+        if (result.op == OrderOp::Place) {
+            ord_id = std::string(result.ord_id);
+            rtt_ns = result.rtt_ns;
+        }
+        results.emplace_back(result.success, std::string(result.s_code));
+        completed++;
+    });
+
+    OrderRequest order;
+    order.inst_id = "BTC-USDT";
+    order.side = "buy";
+    order.ord_type = "limit";
+    order.sz = "0.01";
+    order.px = "30000";
+    check(client.order_entry().place(order) != 0, "下单请求已发送");
+    bool placed = wait_for([&] { return completed == 1; }) && results[0].first && !ord_id.empty();
+    check(placed, "下单成功, ordId=" + ord_id + ", RTT " + std::to_string(rtt_ns / 1000) + " us");
+
+    CancelRequest cancel;
+    cancel.inst_id = "BTC-USDT";
+    cancel.ord_id = ord_id;
+    client.order_entry().cancel(cancel);
+    check(wait_for([&] { return completed == 2; }) && results[1].first, "撤单成功");
+    client.order_entry().cancel(cancel);
+    check(wait_for([&] { return completed == 3; }) && !results[2].first && results[2].second == "51400", "重复撤单返回 51400");
+    check(client.order_entry().in_flight() == 0, "无在途请求");
+
+    client.disconnect();
+}
+
+static void test_bad_signature(int port) {
+    OKXWebSocketClient client;
+    client.enable_auto_reconnect(false);
+
+    std::atomic<bool> failed{false};
+    std::string code;
+    client.set_login_callback([&](bool success, const std::string& error_code, const std::string&) {
+        code = error_code;
+        failed = !success;
+    });
+
+    client.set_credentials("mock-key", "wrong-secret", "mock-pass");
+    client.connect("127.0.0.1", port, "/ws/v5/private", false);
+    check(wait_for([&] { return failed.load(); }) && code == "60009", "错误密钥被拒绝 (60009)");
+    check(client.login_state() == OKXWebSocketClient::LoginState::Failed, "登录状态为 Failed");
+    check(client.metrics().counter("okx_login_failures_total", "").value() == 1, "登录失败计数");
+    client.disconnect();
+}
+
+int main() {
+    std::cout << "🔐 私有频道登录测试" << std::endl;
+
+    MockServerConfig config;
+    config.port = 18445;
+    config.api_key = "mock-key";
+    config.secret_key = "mock-secret";
+    config.passphrase = "mock-pass";
+    MockOKXServer server(config);
+    if (!server.start()) {
+        std::cerr << "❌ 模拟服务启动失败" << std::endl;
+        return 1;
+    }
+
+    test_login(config.port);
+    test_bad_signature(config.port);
+
+    MockServerStats stats = server.stats();
+    check(stats.logins == 1 && stats.login_failures == 1, "模拟服务统计: 1 次成功, 1 次失败");
+    server.stop();
+
+    return test_summary();
+}
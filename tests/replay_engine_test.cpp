@@ -0,0 +1,237 @@
+#include "../src/replay_engine.h"
+#include "../src/bar_aggregator.h"
+#include "../src/ticker_fields.h"
+#include "test_util.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+static std::string temp_path(const std::string& name) {
+    return "/tmp/okx_replay_test_" + std::to_string(getpid()) + "_" + name + ".jsonl";
+}
+
+static std::string ticker_object(const std::string& inst_id, int64_t ts, double last) {
+    return R"({"instType":"SPOT","instId":")" + inst_id + R"(","last":")" + std::to_string(last) +
+           R"(","lastSz":"0.1","askPx":"1","askSz":"1","bidPx":"1","bidSz":"1","open24h":"1","high24h":"1","low24h":"1","volCcy24h":"1","vol24h":")" +
+           std::to_string(ts % 100000) + R"(","sodUtc0":"1","sodUtc8":"1","ts":")" + std::to_string(ts) + R"("})";
+}
+
+// 每个文件覆盖所有交易对，文件之间 ts 交错，保证有序交付必须跨文件合并
+static std::vector<std::string> write_captures(size_t files, size_t lines, size_t instruments) {
+    std::vector<std::string> paths;
+    for (size_t f = 0; f < files; ++f) {
+        std::string path = temp_path(std::to_string(f));
+        std::ofstream out(path);
+        out << R"({"event":"subscribe","arg":{"channel":"tickers","instId":"BTC-USDT"},"connId":"1"})" << "\n";
+        for (size_t i = 0; i < lines; ++i) {
+            int64_t ts = 1700000000000 + static_cast<int64_t>(i * files + f) * 10;
+            std::string inst_id = "INST-" + std::to_string((i * 7 + f) % instruments);
+            out << R"({"arg":{"channel":"tickers","instId":")" << inst_id << R"("},"data":[)"
+                << ticker_object(inst_id, ts, 100.0 + i) << "]}";
+            // 偶尔混入 CRLF 和空行
+            out << (i % 50 == 0 ? "\r\n\n" : "\n");
+        }
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+static void remove_all(const std::vector<std::string>& paths) {
+    for (const auto& path : paths) std::remove(path.c_str());
+}
+
+static void test_pool() {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> runs(200);
+    std::vector<WorkStealingPool::Job> jobs;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        jobs.push_back([&, i](size_t) {
+            // 前四分之一的任务（全在 worker 0 上）明显更慢，其他 worker 做完自己的会来偷
+            if (i < runs.size() / 4) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            runs[i]++;
+        });
+    }
+    pool.run(std::move(jobs));
+    check(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& n) { return n == 1; }), "每个任务恰好执行一次");
+    check(pool.stats().executed == 200 && pool.stats().stolen > 0,
+          "负载不均时发生窃取: " + std::to_string(pool.stats().stolen) + " 次");
+    pool.run({});
+    check(pool.stats().executed == 200, "空任务列表立即返回");
+}
+
+static double process_cpu_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+static void test_pool_persistent_workers() {
+    WorkStealingPool pool(4);
+    std::vector<std::thread::id> first(pool.size()), second(pool.size());
+    auto record = [&](std::vector<std::thread::id>& ids) {
+        std::vector<WorkStealingPool::Job> jobs;
+        // 每个任务都足够慢，保证每个 worker 都从自己的队列取到任务
+        for (size_t i = 0; i < pool.size() * 4; ++i) {
+            jobs.push_back([&ids](size_t worker) {
+                ids[worker] = std::this_thread::get_id();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+        }
+        pool.run(std::move(jobs));
+    };
+    record(first);
+    record(second);
+    check(first == second, "两次 run() 由同一组常驻线程执行");
+
+    // 两次 run 之间 worker 停在条件变量上，不应消耗 CPU
+    double before = process_cpu_ms();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    double idle_ms = process_cpu_ms() - before;
+    check(idle_ms < 20.0, "空闲 100ms 内 4 个 worker 共用 CPU " + std::to_string(idle_ms) + " ms");
+
+    // 小批量反复 run 的固定开销: 唤醒 + 等待，不再有创建和 join 线程
+    const int rounds = 2000;
+    std::atomic<int> total(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        std::vector<WorkStealingPool::Job> jobs;
+        for (int i = 0; i < 8; ++i) jobs.push_back([&](size_t) { total++; });
+        pool.run(std::move(jobs));
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+    std::cout << "  8 个小任务一次 run(): " << us << " us" << std::endl;
+    check(total == rounds * 8, "反复 run() 每个任务都执行");
+}
+
+struct Delivered {
+    int64_t ts;
+    size_t worker;
+};
+
+static std::map<std::string, std::vector<Delivered>> replay_ordered(const std::vector<std::string>& files, size_t threads,
+                                                                     ReplayStats& stats) {
+    ReplayConfig config;
+    config.threads = threads;
+    config.chunk_bytes = 1024;     // 小块，制造大量窃取单位
+    ReplayEngine engine(config);
+
+    std::mutex mutex;
+    std::map<std::string, std::vector<Delivered>> delivered;
+    engine.add_handler([&](const TickerView& ticker, size_t worker) {
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered[std::string(ticker.inst_id)].push_back({std::stoll(std::string(ticker.ts)), worker});
+    }, true);
+
+    std::vector<uint64_t> per_worker(threads, 0);
+    engine.add_handler([&](const TickerView&, size_t worker) { per_worker[worker]++; });
+
+    engine.run(files);
+    stats = engine.stats();
+    uint64_t unordered = 0;
+    for (uint64_t n : per_worker) unordered += n;
+    check(unordered == stats.tickers, std::to_string(threads) + " 线程: 无序 handler 收到全部 ticker");
+    return delivered;
+}
+
+static void test_replay() {
+    const size_t files = 3, lines = 2000, instruments = 10;
+    auto paths = write_captures(files, lines, instruments);
+
+    ReplayStats single{};
+    ReplayStats parallel{};
+    auto expected = replay_ordered(paths, 1, single);
+    auto actual = replay_ordered(paths, 4, parallel);
+
+    check(single.messages == files * (lines + 1) && single.tickers == files * lines && single.skipped == files,
+          "消息/ticker/跳过计数 (空行与 CRLF 不计)");
+    check(parallel.chunks > files * 10 && parallel.messages == single.messages && parallel.tickers == single.tickers,
+          "4 线程计数一致, " + std::to_string(parallel.chunks) + " 个块");
+    check(parallel.ordered_ticks == parallel.tickers && expected.size() == instruments, "所有交易对都有序交付");
+
+    bool sorted = true;
+    bool same_worker = true;
+    bool identical = true;
+    for (const auto& [inst_id, ticks] : actual) {
+        for (size_t i = 1; i < ticks.size(); ++i) {
+            sorted &= ticks[i - 1].ts < ticks[i].ts;
+            same_worker &= ticks[i].worker == ticks[0].worker;
+        }
+        const auto& reference = expected[inst_id];
+        identical &= reference.size() == ticks.size();
+        for (size_t i = 0; identical && i < ticks.size(); ++i) identical &= reference[i].ts == ticks[i].ts;
+    }
+    check(sorted, "每个交易对按 ts 跨文件合并有序");
+    check(same_worker, "同一交易对在同一个 worker 上串行交付");
+    check(identical, "多线程结果与单线程相同");
+
+    // 每个 worker 一个K线聚合器，交易对不跨 worker，结果与单个聚合器一致
+    ReplayConfig config;
+    config.threads = 4;
+    config.chunk_bytes = 4096;
+    config.fields = TickerField::InstId | TickerField::Last | TickerField::Vol24h;
+    ReplayEngine engine(config);
+    std::vector<std::unique_ptr<BarAggregator>> bars;
+    std::vector<size_t> closed(engine.threads(), 0);
+    for (size_t w = 0; w < engine.threads(); ++w) {
+        bars.push_back(std::make_unique<BarAggregator>(std::vector<int64_t>{1000}));
+        bars.back()->set_callback([&closed, w](std::span<const Bar> batch) { closed[w] += batch.size(); });
+    }
+    engine.add_handler([&](const TickerView& ticker, size_t worker) { bars[worker]->on_tick(ticker); }, true);
+    engine.run(paths);
+    size_t total_bars = 0;
+    uint64_t late = 0;
+    for (size_t w = 0; w < bars.size(); ++w) {
+        bars[w]->flush();
+        total_bars += closed[w];
+        late += bars[w]->stats().late_ticks;
+    }
+    // 每 10ms 一条，3 个文件共 60 秒
+    check(late == 0 && total_bars > 0, "有序回放喂给每线程K线聚合器无迟到 tick, 收线 " + std::to_string(total_bars) + " 根");
+
+    check(!engine.run({paths[0], temp_path("missing")}), "文件不存在时返回 false");
+    remove_all(paths);
+}
+
+static void benchmark() {
+    const size_t files = 8, lines = 50000;
+    auto paths = write_captures(files, lines, 200);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "  " << files << " 个文件, 共 " << files * lines << " 条消息, " << cores << " 个硬件线程" << std::endl;
+    double base = 0;
+    for (size_t threads = 1; threads <= std::max(4u, cores); threads *= 2) {
+        ReplayConfig config;
+        config.threads = threads;
+        config.chunk_bytes = 1 << 20;
+        ReplayEngine engine(config);
+        std::vector<uint64_t> counts(threads, 0);
+        engine.add_handler([&](const TickerView&, size_t worker) { counts[worker]++; });
+        engine.run(paths);
+        ReplayStats stats = engine.stats();
+        if (threads == 1) base = stats.messages_per_sec;
+        std::cout << "  " << threads << " 线程: " << static_cast<uint64_t>(stats.messages_per_sec) << " 消息/秒 ("
+                  << (base > 0 ? stats.messages_per_sec / base : 0) << "x), 窃取 " << stats.steals << " 次" << std::endl;
+    }
+    remove_all(paths);
+}
+
+int main() {
+    std::cout << "⏪ 并行回放测试" << std::endl;
+
+    test_pool();
+    test_pool_persistent_workers();
+    test_replay();
+    benchmark();
+
+    return test_summary();
+}
@@ -0,0 +1,200 @@
+#include "../src/rx_timestamping.h"
+#include "test_util.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// 回环 TCP 上的内核收包时间戳: 控制消息解析、明文 recvmsg，以及替换读 BIO 后的 TLS 读取
+
+static int64_t realtime_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 建立一对回环 TCP 连接: client 为连接端，server 为 accept 端
+static bool loopback_pair(int& client, int& server) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        close(listener);
+        return false;
+    }
+    client = socket(AF_INET, SOCK_STREAM, 0);
+    bool ok = ::connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    server = ok ? accept(listener, nullptr, nullptr) : -1;
+    close(listener);
+    return ok && server >= 0;
+}
+
+static void test_parse_control() {
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timespec) * 3)] = {};
+    msghdr msg{};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SO_TIMESTAMPING;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(timespec) * 3);
+    timespec stamps[3] = {{1700000000, 123}, {0, 0}, {42, 7}};
+    memcpy(CMSG_DATA(cmsg), stamps, sizeof(stamps));
+
+    int64_t software = 0, hardware = 0;
+    check(RxTimestamper::parse_control(msg, software, hardware) && software == 1700000000000000123LL &&
+          hardware == 42000000007LL, "解析 SCM_TIMESTAMPING 软件/硬件时间戳");
+
+    memset(CMSG_DATA(cmsg), 0, sizeof(stamps));
+    check(!RxTimestamper::parse_control(msg, software, hardware), "全零时间戳视为没有");
+    msg.msg_controllen = 0;
+    check(!RxTimestamper::parse_control(msg, software, hardware), "无控制消息");
+}
+
+static void test_plain_socket() {
+    int client, server;
+    if (!loopback_pair(client, server)) {
+        check(false, "建立回环连接");
+        return;
+    }
+
+    RxTimestamper stamper;
+    check(stamper.attach(client, nullptr, {}), "设置 SO_TIMESTAMPING");
+
+    int64_t before = realtime_ns();
+    const char payload[] = "tick";
+    send(server, payload, sizeof(payload), 0);
+    char buffer[64];
+    ssize_t n = stamper.receive(buffer, sizeof(buffer));
+    int64_t after = realtime_ns();
+
+    check(n == sizeof(payload) && memcmp(buffer, payload, sizeof(payload)) == 0, "recvmsg 读到原始数据");
+    RxTimestampingStatus status = stamper.status();
+    check(status.enabled && !status.attached && status.stamped_reads == 1, "明文连接: 已开启，未替换 BIO");
+    check(stamper.software_ns() >= before - 1000000 && stamper.software_ns() <= after,
+          "软件时间戳在发送与读取之间 (内核到读取 " + std::to_string(after - stamper.software_ns()) + " ns)");
+    check(stamper.hardware_ns() == 0, "回环没有硬件时间戳");
+
+    close(client);
+    close(server);
+}
+
+static EVP_PKEY* make_key() {
+    return EVP_EC_gen("P-256");
+}
+
+static X509* make_cert(EVP_PKEY* key) {
+    X509* cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+    return cert;
+}
+
+static void test_tls() {
+    int client, server;
+    if (!loopback_pair(client, server)) {
+        check(false, "建立回环连接");
+        return;
+    }
+
+    EVP_PKEY* key = make_key();
+    X509* cert = make_cert(key);
+    SSL_CTX* server_ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(server_ctx, cert);
+    SSL_CTX_use_PrivateKey(server_ctx, key);
+    SSL_CTX* client_ctx = SSL_CTX_new(TLS_client_method());
+
+    const int messages = 200;
+    std::thread peer([&] {
+        SSL* ssl = SSL_new(server_ctx);
+        SSL_set_fd(ssl, server);
+        if (SSL_accept(ssl) == 1) {
+            for (int i = 0; i < messages; ++i) {
+                std::string frame = "{\"seq\":" + std::to_string(i) + "}";
+                SSL_write(ssl, frame.data(), static_cast<int>(frame.size()));
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+    });
+
+    // 与 lws 相同: 先用普通套接字 BIO 握手，建立后再替换读方向
+    SSL* ssl = SSL_new(client_ctx);
+    SSL_set_fd(ssl, client);
+    check(SSL_connect(ssl) == 1, "TLS 握手");
+
+    RxTimestamper stamper;
+    check(stamper.attach(client, ssl, {}) && stamper.status().attached, "替换 TLS 读 BIO");
+    check(SSL_get_fd(ssl) == client, "SSL_get_fd 仍返回套接字");
+
+    std::string received;
+    int64_t last_stamp = 0;
+    bool monotonic = true;
+    char buffer[4096];
+    int n;
+    while ((n = SSL_read(ssl, buffer, sizeof(buffer))) > 0) {
+        received.append(buffer, static_cast<size_t>(n));
+        monotonic &= stamper.software_ns() >= last_stamp;
+        last_stamp = stamper.software_ns();
+    }
+    int64_t done = realtime_ns();
+    peer.join();
+
+    std::string expected;
+    for (int i = 0; i < messages; ++i) expected += "{\"seq\":" + std::to_string(i) + "}";
+    check(received == expected, "经 recvmsg BIO 解密的数据完整 (" + std::to_string(received.size()) + " 字节)");
+
+    RxTimestampingStatus status = stamper.status();
+    // 与连接关闭合并读取的少数报文段可能不带时间戳
+    check(status.reads > 0 && status.stamped_reads * 10 >= status.reads * 9,
+          "recvmsg 带时间戳 (" + std::to_string(status.stamped_reads) + "/" + std::to_string(status.reads) + ")");
+    check(monotonic && last_stamp > 0 && last_stamp <= done && done - last_stamp < 5000000000LL, "时间戳单调且接近当前时间");
+
+    SSL_free(ssl);
+    SSL_CTX_free(client_ctx);
+    SSL_CTX_free(server_ctx);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    close(client);
+    close(server);
+}
+
+static void test_hardware_config() {
+    std::string error;
+    // 回环网卡不支持硬件时间戳，普通用户也没有 CAP_NET_ADMIN，两种情况都应返回错误而不是崩溃
+    bool enabled = RxTimestamper::enable_hardware("lo", error);
+    check(!enabled && !error.empty(), "lo 开启硬件时间戳失败: " + error);
+    check(!RxTimestamper::enable_hardware("", error), "空网卡名被拒绝");
+
+    RxTimestampingConfig none;
+    none.software = false;
+    RxTimestamper stamper;
+    check(!stamper.attach(-1, nullptr, none) && !stamper.status().error.empty(), "未请求任何时间戳时报错");
+}
+
+int main() {
+    std::cout << "⏱️ 内核收包时间戳测试" << std::endl;
+
+    test_parse_control();
+    test_plain_socket();
+    test_tls();
+    test_hardware_config();
+
+    return test_summary();
+}
@@ -0,0 +1,101 @@
+#include "../src/json_parser.h"
+#include "../src/json_stage1.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// 逐字节的参考实现；与 simdjson 一致，反斜杠在字符串外也转义下一个字符（非法JSON）
+static std::vector<uint32_t> reference_structurals(const std::string& json) {
+    std::vector<uint32_t> result;
+    bool in_string = false;
+    bool escaped = false;
+    for (size_t i = 0; i < json.size(); ++i) {
+        char c = json[i];
+        bool is_escaped = escaped;
+        escaped = c == '\\' && !is_escaped;
+
+        if (c == '"' && !is_escaped) {
+            in_string = !in_string;
+            result.push_back(static_cast<uint32_t>(i));
+        } else if (!in_string && (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',')) {
+            result.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return result;
+}
+
+static void test_index_against_reference() {
+    std::mt19937 rng(7);
+    const char alphabet[] = "{}[]:,\"\\\\\\ab 01";
+    StructuralIndex index;
+    bool ok = true;
+
+    for (int round = 0; round < 20000 && ok; ++round) {
+        // 长度覆盖多个64字节块，反斜杠串跨块边界
+        std::string json(rng() % 300, ' ');
+        for (auto& c : json) {
+            c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        }
+
+        auto expected = reference_structurals(json);
+        index.build(json);
+        if (index.size() != expected.size()) {
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (index.pos(i) != expected[i]) ok = false;
+        }
+
+        // 括号配对: 与按深度逐个扫描的结果一致，未闭合的返回 npos
+        for (size_t open = 0; open < expected.size() && ok; ++open) {
+            char c = json[expected[open]];
+            if (c != '{' && c != '[') continue;
+            size_t want = StructuralIndex::npos;
+            int depth = 0;
+            for (size_t i = open; i < expected.size(); ++i) {
+                char d = json[expected[i]];
+                if (d == '{' || d == '[') {
+                    ++depth;
+                } else if ((d == '}' || d == ']') && --depth == 0) {
+                    want = i + 1;
+                    break;
+                }
+            }
+            if (index.skip_container(open) != want) ok = false;
+        }
+    }
+    check(ok, "SIMD结构索引与逐字节参考实现一致，括号配对与逐个扫描一致");
+}
+
+static void test_exact_key_matching() {
+    // data 先出现在字符串值里，arg 里有同名的 instId/ts，值里有 "ts":
+    const std::string tricky = R"({"note":"\"data\":[{\"instId\":\"FAKE\"}]","arg":{"channel":"tickers","instId":"BTC-USDT","ts":"1"},"data":[{"instType":"SPOT","instId":"BTC-USDT","memo":"{\"ts\":\"2\"}","volCcy24h":"100","vol24h":"5","last":"43250.5","ts":"1703073600000"}]})";
+
+    auto result = JsonParser::parse_ticker_data(tricky);
+    check(result && result->size() == 1, "快速路径解析含干扰内容的消息");
+    if (result && !result->empty()) {
+        const auto& ticker = (*result)[0];
+        check(ticker.inst_id == "BTC-USDT", "不会命中字符串值中的data");
+        check(ticker.ts == "1703073600000", "不会命中值中或arg中的ts");
+        check(ticker.vol24h == "5" && ticker.vol_ccy24h == "100", "vol24h与volCcy24h精确区分");
+    }
+
+    check(!JsonParser::parse_ticker_data(R"({"arg":{"channel":"books"},"note":"\"channel\":\"tickers\"","data":[{"instId":"BTC-USDT"}]})"),
+          "值中的\"channel\":\"tickers\"不会被当成ticker频道");
+
+    TickerBatch batch;
+    check(JsonParser::parse_ticker_data_into(tricky, batch) && batch.size() == 1 && batch[0].last == "43250.5",
+          "批量接口同样精确匹配");
+}
+
+int main() {
+    std::cout << "🔎 结构索引与精确key匹配测试" << std::endl;
+
+    test_index_against_reference();
+    test_exact_key_matching();
+
+    return test_summary();
+}
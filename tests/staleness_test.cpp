@@ -0,0 +1,115 @@
+#include "../src/staleness_monitor.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// 随机arm/re-arm/cancel，与逐个比较的朴素实现对比到期时刻
+static void test_timer_wheel_against_reference() {
+    TimerWheel wheel(1000);
+    std::vector<int64_t> expected(2000, -1);
+    std::mt19937_64 rng(42);
+    bool ok = true;
+
+    uint64_t now = 1000;
+    for (int step = 0; step < 20000 && ok; ++step) {
+        uint32_t id = rng() % expected.size();
+        switch (rng() % 4) {
+            case 0:
+            case 1: {
+                // 覆盖0/1/2/3层的不同跨度
+                uint64_t spans[] = {1, 63, 64, 4095, 4096, 300000};
+                uint64_t expiry = now + 1 + rng() % spans[rng() % 6];
+                wheel.schedule(id, expiry);
+                expected[id] = static_cast<int64_t>(expiry);
+                break;
+            }
+            case 2:
+                wheel.cancel(id);
+                expected[id] = -1;
+                break;
+            default: {
+                uint64_t target = now + rng() % 200;
+                wheel.advance(target, [&](uint32_t fired) {
+                    if (expected[fired] != static_cast<int64_t>(wheel.current_tick())) {
+                        ok = false;
+                    }
+                    expected[fired] = -1;
+                });
+                now = target;
+                for (auto e : expected) {
+                    if (e != -1 && e <= static_cast<int64_t>(now)) ok = false;
+                }
+                break;
+            }
+        }
+    }
+
+    // 排空剩余定时器
+    wheel.advance(now + 400000, [&](uint32_t fired) {
+        if (expected[fired] != static_cast<int64_t>(wheel.current_tick())) ok = false;
+        expected[fired] = -1;
+    });
+    for (auto e : expected) {
+        if (e != -1) ok = false;
+    }
+
+    check(ok, "时间轮到期时刻与参考实现一致");
+    check(wheel.armed_count() == 0, "时间轮排空后无残留定时器");
+}
+
+static void test_monitor_thresholds() {
+    StalenessMonitor monitor(10);
+    monitor.set_default_threshold(1000);
+    monitor.set_threshold("SWAP", 200);
+
+    std::vector<std::string> fired;
+    monitor.set_callback([&](const StaleEvent& event) {
+        fired.emplace_back(event.inst_id);
+    });
+
+    int64_t t0 = StalenessMonitor::now_ms();
+    monitor.on_tick("BTC-USDT", "SPOT", t0);
+    monitor.on_tick("BTC-USDT-SWAP", "SWAP", t0);
+
+    monitor.poll(t0 + 150);
+    check(fired.empty(), "阈值内不触发");
+
+    monitor.poll(t0 + 250);
+    check(fired.size() == 1 && fired[0] == "BTC-USDT-SWAP", "SWAP按200ms阈值触发");
+    check(monitor.is_stale("BTC-USDT-SWAP") && !monitor.is_stale("BTC-USDT"), "is_stale反映状态");
+
+    // 持续推送的交易对不应触发
+    for (int64_t t = t0 + 100; t <= t0 + 2000; t += 100) {
+        monitor.on_tick("BTC-USDT", "SPOT", t);
+        monitor.on_tick("BTC-USDT-SWAP", "SWAP", t);
+        monitor.poll(t);
+    }
+    check(fired.size() == 1, "持续更新时re-arm不触发");
+    check(!monitor.is_stale("BTC-USDT-SWAP"), "收到更新后恢复");
+
+    monitor.watch("ETH-USDT", t0 + 2000);
+    monitor.poll(t0 + 3100);
+    bool eth_fired = false;
+    for (const auto& id : fired) {
+        if (id == "ETH-USDT") eth_fired = true;
+    }
+    check(eth_fired, "订阅后从未推送的交易对也会触发");
+
+    monitor.unwatch("ETH-USDT");
+    size_t before = fired.size();
+    monitor.on_tick("BTC-USDT", "SPOT", t0 + 3100);
+    monitor.on_tick("BTC-USDT-SWAP", "SWAP", t0 + 3100);
+    monitor.poll(t0 + 3200);
+    check(fired.size() == before, "取消登记后不再触发");
+}
+
+int main() {
+    std::cout << "🕒 行情新鲜度检测测试" << std::endl;
+
+    test_timer_wheel_against_reference();
+    test_monitor_thresholds();
+
+    return test_summary();
+}
@@ -0,0 +1,177 @@
+#include "../src/okx_websocket_client.h"
+#include "../src/mock_okx_server.h"
+#include "../src/failover_gap.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 热备切换: 模拟服务关闭主连接后，热备立即接管，行情中断时间应为毫秒级而不是退避重连的秒级；
+// 没有热备时退避重连在服务线程上原地进行
+
+template <typename Pred>
+static bool wait_for(Pred pred, int timeout_ms = 5000) {
+    for (int waited = 0; waited < timeout_ms; waited += 1) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return pred();
+}
+
+static void test_gap_counter() {
+    FailoverGapCounter gaps;
+    gaps.on_primary("BTC-USDT", 100);
+    for (int64_t ts : {90, 100, 110, 120}) gaps.on_standby("BTC-USDT", ts);
+    gaps.on_standby("ETH-USDT", 5);     // 主连接从未分发过
+    check(gaps.promote() == 3, "热备上比主连接新的更新计为漏掉");
+    check(gaps.promote() == 0, "提升后窗口清空");
+
+    gaps.on_primary("BTC-USDT", 1000);
+    for (int64_t ts = 1001; ts <= 1100; ++ts) gaps.on_standby("BTC-USDT", ts);
+    check(gaps.promote() == FailoverGapCounter::kWindow, "每个交易对最多统计窗口大小");
+
+    gaps.on_standby("BTC-USDT", 5000);
+    gaps.clear_standby();
+    check(gaps.promote() == 0 && gaps.instrument_count() == 2, "热备断开后窗口作废");
+}
+
+static void test_promotion_dedup() {
+    FailoverGapCounter gaps;
+    check(gaps.on_primary("BTC-USDT", 100) && gaps.on_primary("BTC-USDT", 100), "平时同一 ts 的多条更新照常分发");
+
+    // 热备落后于旧主连接: 提升后先收到 ts 为 90、100 的更新，主连接都已分发过
+    gaps.on_standby("BTC-USDT", 90);
+    gaps.promote();
+    check(!gaps.on_primary("BTC-USDT", 90) && !gaps.on_primary("BTC-USDT", 100), "提升后已分发过的更新被丢弃");
+    check(gaps.on_primary("BTC-USDT", 101) && gaps.on_primary("BTC-USDT", 101), "越过旧主连接的 ts 后恢复正常分发");
+    check(gaps.on_primary("ETH-USDT", 5), "提升前没分发过的交易对不受影响");
+}
+
+static void test_failover(MockOKXServer& server, int port) {
+    OKXWebSocketClient client;
+    client.enable_auto_reconnect(false);
+    client.enable_standby();
+
+    auto& failovers = client.metrics().counter("okx_failovers_total", "");
+    auto& missed = client.metrics().counter("okx_failover_missed_updates_total", "");
+    auto& duplicates = client.metrics().counter("okx_failover_duplicates_total", "");
+
+    std::atomic<int> ticks{0};
+    std::atomic<int64_t> last_tick_ns{0};
+    // 每个交易对分发过的最大 ts 及其所在的切换轮次。提升在服务线程上完成，之后才分发新主连接的数据，
+    // 所以轮次变化后的第一条 ts 不大于旧主连接的最后一条即为重复分发；同一连接上 ts 回退也算
+    struct Seen {
+        int64_t ts = 0;
+        uint64_t epoch = 0;
+    };
+    std::mutex seen_mutex;
+    std::map<std::string, Seen> seen;
+    std::atomic<int> repeats{0};
+    client.set_ticker_callback([&](const TickerData& ticker) {
+        int64_t ts = std::stoll(ticker.ts);
+        uint64_t epoch = failovers.value();
+        {
+            std::lock_guard<std::mutex> lock(seen_mutex);
+            Seen& last = seen[ticker.inst_id];
+            if (ts < last.ts || (epoch != last.epoch && ts <= last.ts)) repeats++;
+            last.ts = std::max(last.ts, ts);
+            last.epoch = epoch;
+        }
+        last_tick_ns = MockOKXServer::now_ns();
+        ticks++;
+    });
+    auto all_delivered_in = [&](uint64_t epoch) {
+        std::lock_guard<std::mutex> lock(seen_mutex);
+        if (seen.size() < 5) return false;
+        for (const auto& [inst_id, last] : seen) {
+            if (last.epoch != epoch) return false;
+        }
+        return true;
+    };
+
+    check(client.connect("127.0.0.1", port, "/ws/v5/public", false), "连接模拟服务");
+    check(wait_for([&] { return client.is_connected(); }), "主连接建立");
+    for (int i = 0; i < 5; ++i) client.subscribe_ticker(MockOKXServer::instrument_name(i));
+    check(wait_for([&] { return client.standby_ready(); }), "热备完成订阅");
+    check(wait_for([&] { return ticks > 100; }), "主连接收到行情");
+
+    // 连接按建立顺序编号: 1 为主连接，2 为热备，之后补上的热备依次为 3、4
+    for (uint64_t session = 1; session <= 2; ++session) {
+        int before = ticks;
+        int64_t drop_ns = MockOKXServer::now_ns();
+        server.drop_session(session);
+        bool promoted = wait_for([&] { return failovers.value() == session; });
+        bool resumed = wait_for([&] { return ticks > before && last_tick_ns > drop_ns; });
+        int64_t gap_us = (last_tick_ns - drop_ns) / 1000;
+        check(promoted && resumed && client.is_connected(),
+              "第 " + std::to_string(session) + " 次切换后行情恢复, 中断 " + std::to_string(gap_us) + " us, 累计漏掉 " +
+              std::to_string(missed.value()) + " 条");
+        check(gap_us < 500000, "中断远小于退避重连的 1 秒");
+
+        // 提升路径: 每个交易对都在新主连接上分发过，且没有一条重复旧主连接已分发的更新
+        check(wait_for([&] { return all_delivered_in(session); }) && repeats == 0,
+              "提升后没有重复分发 (丢弃 " + std::to_string(duplicates.value()) + " 条旧主连接已分发的更新)");
+        check(wait_for([&] { return client.standby_ready(); }), "后台补上新的热备");
+    }
+
+    check(client.metrics().counter("okx_reconnects_total", "").value() == 0, "未走退避重连");
+    client.disconnect();
+    check(!client.standby_ready(), "断开后热备关闭");
+}
+
+// 没有热备时走退避重连: 在服务线程上用原来的 ws:// 设置重新连接并重放订阅，不销毁正在服务的 context
+static void test_reconnect_in_place() {
+    MockServerConfig config;
+    config.port = 18448;
+    config.rate = 500;
+    config.instruments = 2;
+    MockOKXServer server(config);
+    if (!server.start()) {
+        check(false, "重连用模拟服务启动");
+        return;
+    }
+
+    OKXWebSocketClient client;
+    std::atomic<int> ticks{0};
+    client.set_ticker_callback([&](const TickerData&) { ticks++; });
+    check(client.connect("127.0.0.1", config.port, "/ws/v5/public", false), "无热备客户端连接");
+    check(wait_for([&] { return client.is_connected(); }), "连接建立");
+    for (int i = 0; i < 2; ++i) client.subscribe_ticker(MockOKXServer::instrument_name(i));
+    check(wait_for([&] { return ticks > 10; }), "收到行情");
+
+    server.drop_session(1);
+    check(wait_for([&] { return !client.is_connected(); }), "主连接被关闭");
+    int before = ticks;
+    check(wait_for([&] { return client.is_connected() && ticks > before; }, 10000), "退避后原地重连并重放订阅，行情恢复");
+    check(client.metrics().counter("okx_reconnects_total", "").value() == 1, "重连一次");
+
+    client.disconnect();
+    server.stop();
+}
+
+int main() {
+    std::cout << "🛟 热备连接切换测试" << std::endl;
+
+    test_gap_counter();
+    test_promotion_dedup();
+
+    MockServerConfig config;
+    config.port = 18447;
+    config.rate = 2000;
+    config.instruments = 5;
+    MockOKXServer server(config);
+    if (!server.start()) {
+        std::cerr << "❌ 模拟服务启动失败" << std::endl;
+        return 1;
+    }
+    test_failover(server, config.port);
+    server.stop();
+
+    test_reconnect_in_place();
+
+    return test_summary();
+}
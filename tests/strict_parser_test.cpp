@@ -0,0 +1,67 @@
+#include "../src/json_parser.h"
+#include "../src/json_validator.h"
+#include "test_util.h"
+#include <iostream>
+#include <string>
+
+static void test_validator() {
+    check(JsonValidator::validate(R"({"a":[1,-2.5e3,true,false,null,"x\"yé"]})"), "合法JSON通过校验");
+    check(!JsonValidator::validate(R"({"a":1,})"), "拒绝尾随逗号");
+    check(!JsonValidator::validate(R"({"a":01})"), "拒绝前导零");
+    check(!JsonValidator::validate(R"({"a":"\x"})"), "拒绝非法转义");
+    check(!JsonValidator::validate("{\"a\":\"\n\"}"), "拒绝字符串内控制字符");
+    check(!JsonValidator::validate(R"({"a":1} x)"), "拒绝尾随内容");
+    check(!JsonValidator::validate(std::string(100, '[') + std::string(100, ']')), "拒绝超过深度上限");
+
+    std::string out;
+    check(JsonValidator::unescape(R"(a\"b\\c\/\n\u0041\u00e9\ud83d\ude00)", out) &&
+          out == "a\"b\\c/\nA\xc3\xa9\xf0\x9f\x98\x80", "反转义包括代理对");
+    check(!JsonValidator::unescape(R"(\ud83d)", out), "拒绝孤立代理项");
+}
+
+static void test_strict_ticker() {
+    // 值中含转义引号、花括号，嵌套对象里有同名key
+    const std::string tricky = R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[{"meta":{"ts":"1","last":"bad"},"instType":"SPOT","instId":"BTC\"USDT","note":"}{ \"ts\":\"2\"","last":"43250.5","ts":"1703073600000"}]})";
+
+    auto strict = JsonParser::parse_ticker_data(tricky, ParseMode::Strict);
+    check(strict && strict->size() == 1, "严格模式解析含转义的消息");
+    if (strict && !strict->empty()) {
+        const auto& ticker = (*strict)[0];
+        check(ticker.inst_id == "BTC\"USDT", "转义引号被正确还原");
+        check(ticker.last == "43250.5", "嵌套对象中的last不会命中");
+        check(ticker.ts == "1703073600000", "字符串值中的\"ts\":不会命中");
+    }
+
+    TickerBatch batch;
+    check(JsonParser::parse_ticker_data_into(tricky, batch, ParseMode::Strict) && batch.size() == 1 &&
+          batch[0].inst_id == "BTC\"USDT" && batch[0].ts == "1703073600000", "严格模式批量接口");
+
+    // 格式错误整条拒绝
+    check(!JsonParser::parse_ticker_data(R"({"arg":{"channel":"tickers"},"data":[{"instId":"BTC-USDT","last":"1"})", ParseMode::Strict),
+          "截断消息被拒绝");
+    check(!JsonParser::parse_ticker_data(R"({"arg":{"channel":"books"},"note":"\"channel\":\"tickers\"","data":[{"instId":"BTC-USDT"}]})", ParseMode::Strict),
+          "非tickers频道不会被值中的文本误判");
+    check(!JsonParser::parse_ticker_data_into(R"({"arg":{"channel":"tickers"},"data":[{"instId":"A\ud800"}]})", batch, ParseMode::Strict) &&
+          batch.empty(), "非法转义导致整条拒绝");
+    check(!JsonParser::parse_ticker_data(R"({"arg":{"channel":"tickers"},"data":[{"instId":"A\ud800"}]})", ParseMode::Strict),
+          "TickerData 接口同样拒绝非法转义");
+    check(JsonParser::parse_ticker_data_into(R"({"\u0061rg":{"channel":"tick\u0065rs"},"data":[{"instId":"BTC-USDT"}]})", batch,
+                                             ParseMode::Strict) && batch.size() == 1, "顶层key和频道名按转义后的内容匹配");
+}
+
+static void test_strict_simple() {
+    auto result = JsonParser::parse_simple(R"({"event":"error","msg":"bad \"op\", code {1}","code":"60012","arg":{"channel":"tickers"}})", ParseMode::Strict);
+    check(result && (*result)["msg"] == "bad \"op\", code {1}" && (*result)["code"] == "60012" &&
+          (*result)["channel"] == "tickers", "parse_simple严格模式处理转义和嵌套");
+    check(!JsonParser::parse_simple(R"({"event":"error",)", ParseMode::Strict), "parse_simple严格模式拒绝非法JSON");
+}
+
+int main() {
+    std::cout << "🛡️ 严格解析模式测试" << std::endl;
+
+    test_validator();
+    test_strict_ticker();
+    test_strict_simple();
+
+    return test_summary();
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <iostream>
+#include <string>
+
+// 测试可执行文件共用的断言与汇总: check() 记录失败项，main 末尾 return test_summary()
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    if (condition) {
+        std::cout << "✅ " << name << std::endl;
+    } else {
+        std::cerr << "❌ " << name << std::endl;
+        failures++;
+    }
+}
+
+static int test_summary() {
+    if (failures > 0) {
+        std::cerr << "❌ " << failures << " 项测试失败" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ ALL TESTS PASSED!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "../src/thread_config.h"
+#include "../src/async_logger.h"
+#include "test_util.h"
+#include <pthread.h>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static void test_affinity_and_name() {
+    int target = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    if (target < 0) target = 0;
+
+    std::thread worker([&] {
+        ThreadConfig config;
+        config.cpus = {target};
+        config.name = "okx-service-thread-long-name";
+        check(ThreadPlacement::apply(config), "绑核和线程名设置成功");
+
+        // 迁移在下一次调度时发生
+        std::this_thread::yield();
+        check(ThreadPlacement::current_cpu() == target, "线程运行在指定CPU " + std::to_string(target));
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+        check(CPU_COUNT(&set) == 1 && CPU_ISSET(target, &set), "亲和性掩码只含指定CPU");
+
+        char name[16] = {0};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        check(std::string(name) == "okx-service-thr", "线程名截断到15字符");
+    });
+    worker.join();
+
+    ThreadConfig invalid;
+    invalid.cpus = {-1};
+    std::thread([&] { check(!ThreadPlacement::apply(invalid), "非法CPU编号返回失败"); }).join();
+}
+
+static void test_scheduler() {
+    std::thread worker([] {
+        // 没有 CAP_SYS_NICE 时会失败，两种结果都要和实际调度策略一致
+        bool applied = ThreadPlacement::set_scheduler(SCHED_FIFO, 10);
+        int policy = 0;
+        sched_param param{};
+        pthread_getschedparam(pthread_self(), &policy, &param);
+        if (applied) {
+            check(policy == SCHED_FIFO && param.sched_priority == 10, "SCHED_FIFO 优先级10生效");
+        } else {
+            std::cout << "ℹ️  无实时调度权限，跳过 SCHED_FIFO 校验" << std::endl;
+            check(policy == SCHED_OTHER, "设置失败时保持原调度策略");
+        }
+    });
+    worker.join();
+}
+
+static void test_numa() {
+    if (!ThreadPlacement::numa_supported()) {
+        std::cout << "ℹ️  无 NUMA 支持，检查绑定请求被拒绝" << std::endl;
+        ThreadConfig config;
+        config.numa_node = 0;
+        std::thread([&] { check(!ThreadPlacement::apply(config), "无 libnuma 时NUMA绑定返回失败"); }).join();
+        return;
+    }
+
+    int node = ThreadPlacement::numa_node_of_cpu(0);
+    check(node >= 0, "CPU 0 所在节点 " + std::to_string(node));
+
+    std::thread worker([node] {
+        ThreadConfig config;
+        config.numa_node = node;
+        check(ThreadPlacement::apply(config), "内存绑定到节点并在该节点运行");
+        check(ThreadPlacement::numa_node_of_cpu(ThreadPlacement::current_cpu()) == node, "线程运行在绑定节点的CPU上");
+        {
+            ScopedMemoryBinding scoped(node);
+        }
+        check(!ThreadPlacement::bind_memory(1 << 20, false), "不存在的节点返回失败");
+    });
+    worker.join();
+}
+
+int main() {
+    std::cout << "🧵 线程放置测试" << std::endl;
+
+    // 预期中的失败会打印告警
+    AsyncLogger::set_level(LogLevel::Error);
+
+    test_affinity_and_name();
+    test_scheduler();
+    test_numa();
+
+    AsyncLogger::flush();
+    return test_summary();
+}
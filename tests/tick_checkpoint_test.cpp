@@ -0,0 +1,193 @@
+#include "../src/tick_checkpoint.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
+// 检查点文件: 重启后恢复并标记陈旧、实时更新清除标记、写到一半的槽被丢弃、布局变化时重建、并发读一致
+
+static std::string checkpoint_path(const char* suffix) {
+    return "/tmp/okx_checkpoint_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+static TickerView make_view(const std::string& inst_id, const std::string& price) {
+    TickerView view{};
+    view.inst_id = inst_id;
+    view.inst_type = "SPOT";
+    view.last = price;
+    view.bid_px = price;
+    view.ask_px = price;
+    view.ts = "1700000000000";
+    return view;
+}
+
+static void test_restart() {
+    std::string path = checkpoint_path("restart");
+    std::string error;
+    {
+        TickCheckpoint checkpoint;
+        check(checkpoint.open(path, 16, error) && checkpoint.restored() == 0, "新建检查点文件");
+        std::string btc = "BTC-USDT", eth = "ETH-USDT", sol = "SOL-USDT";
+        checkpoint.record(make_view(btc, "43250.5"));
+        checkpoint.record(make_view(eth, "2250.75"));
+        checkpoint.record(make_view(sol, "101.25"));
+        checkpoint.record(make_view(btc, "43251"));
+
+        CheckpointedTick entry{};
+        check(checkpoint.size() == 3 && checkpoint.get("BTC-USDT", entry) && entry.tick.last == 43251.0 && !entry.stale,
+              "同一品种复用槽，记录最新值");
+        check(!checkpoint.get("XRP-USDT", entry), "未记录的品种查不到");
+    }
+
+    TickCheckpoint restarted;
+    auto start = std::chrono::steady_clock::now();
+    check(restarted.open(path, 16, error) && restarted.restored() == 3, "重启后恢复 3 个品种");
+    std::vector<CheckpointedTick> ticks = restarted.snapshot();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    bool all_stale = ticks.size() == 3;
+    for (const auto& tick : ticks) all_stale &= tick.stale && tick.saved_ns > 0;
+    check(all_stale, "恢复的记录全部标记为陈旧 (" + std::to_string(elapsed.count()) + " us)");
+
+    CheckpointedTick entry{};
+    check(restarted.get("ETH-USDT", entry) && entry.tick.last == 2250.75 && strcmp(entry.tick.inst_type, "SPOT") == 0 &&
+          entry.tick.ts == 1700000000000LL, "恢复的价格与时间戳");
+
+    std::string eth = "ETH-USDT";
+    restarted.record(make_view(eth, "2251"));
+    CheckpointedTick btc{};
+    check(restarted.get("ETH-USDT", entry) && !entry.stale && entry.tick.last == 2251.0 &&
+          restarted.get("BTC-USDT", btc) && btc.stale, "实时更新只清除该品种的陈旧标记");
+
+    restarted.close();
+    unlink(path.c_str());
+}
+
+static void test_torn_slot_and_layout() {
+    std::string path = checkpoint_path("torn");
+    std::string error;
+    {
+        TickCheckpoint checkpoint;
+        checkpoint.open(path, 8, error);
+        std::string a = "A-USDT", b = "B-USDT", c = "C-USDT";
+        checkpoint.record(make_view(a, "1"));
+        checkpoint.record(make_view(b, "2"));
+        checkpoint.record(make_view(c, "3"));
+    }
+
+    // 模拟写者在第一个槽写到一半时退出
+    int fd = open(path.c_str(), O_RDWR);
+    size_t size = sizeof(CheckpointHeader) + 8 * sizeof(CheckpointSlot);
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    auto* slots = reinterpret_cast<CheckpointSlot*>(static_cast<char*>(addr) + sizeof(CheckpointHeader));
+    slots[0].version.fetch_add(1);
+    munmap(addr, size);
+
+    {
+        TickCheckpoint checkpoint;
+        CheckpointedTick entry{};
+        check(checkpoint.open(path, 8, error) && checkpoint.restored() == 2 && !checkpoint.get("A-USDT", entry),
+              "写到一半的槽被丢弃");
+        check(checkpoint.get("C-USDT", entry) && entry.tick.last == 3.0 && entry.stale, "其余槽前移后仍可读");
+
+        std::string d = "D-USDT";
+        checkpoint.record(make_view(d, "4"));
+        check(checkpoint.size() == 3 && checkpoint.get("D-USDT", entry) && !entry.stale, "压实后新品种接在末尾");
+    }
+
+    TickCheckpoint resized;
+    check(resized.open(path, 32, error) && resized.restored() == 0 && resized.size() == 0, "容量改变时清空重建");
+
+    std::string name;
+    for (int i = 0; i < 40; ++i) {
+        name = "INST-" + std::to_string(i);
+        resized.record(make_view(name, "1"));
+    }
+    check(resized.size() == 32 && resized.dropped() == 8, "槽用完后丢弃新品种并计数");
+
+    resized.close();
+    unlink(path.c_str());
+
+    TickCheckpoint missing;
+    bool opened = missing.open("/nonexistent-dir/checkpoint", 8, error);
+    check(!opened && !error.empty(), "无法创建文件时报错: " + error);
+}
+
+static void test_concurrent_reader() {
+    std::string path = checkpoint_path("concurrent");
+    std::string error;
+    TickCheckpoint checkpoint;
+    checkpoint.open(path, 4, error);
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> reads(0);
+    std::atomic<uint64_t> torn(0);
+    std::thread reader([&] {
+        CheckpointedTick entry{};
+        while (!done.load(std::memory_order_acquire)) {
+            if (checkpoint.get("BTC-USDT", entry)) {
+                if (entry.tick.bid_px != entry.tick.last || entry.tick.ask_px != entry.tick.last) torn++;
+                reads++;
+            }
+        }
+    });
+
+    std::string inst = "BTC-USDT";
+    std::string price;
+    for (int i = 0; i < 200000; ++i) {
+        price = std::to_string(i);
+        checkpoint.record(make_view(inst, price));
+    }
+    done = true;
+    reader.join();
+
+    check(reads > 0 && torn == 0, "并发读 " + std::to_string(reads.load()) + " 次，没有读到写了一半的记录");
+    checkpoint.close();
+    unlink(path.c_str());
+}
+
+static void test_restore_time() {
+    std::string path = checkpoint_path("timing");
+    std::string error;
+    const int instruments = 2000;
+    {
+        TickCheckpoint checkpoint;
+        checkpoint.open(path, 4096, error);
+        std::string name;
+        for (int i = 0; i < instruments; ++i) {
+            name = "INST-" + std::to_string(i) + "-USDT";
+            checkpoint.record(make_view(name, "100.5"));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    TickCheckpoint checkpoint;
+    checkpoint.open(path, 4096, error);
+    CheckpointedTick entry{};
+    bool usable = checkpoint.get("INST-1999-USDT", entry) && entry.tick.last == 100.5;
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    check(usable && checkpoint.restored() == instruments,
+          "重启后 " + std::to_string(instruments) + " 个品种可用耗时 " + std::to_string(elapsed.count()) + " us");
+    check(elapsed.count() < 100000, "恢复耗时在毫秒级");
+    checkpoint.close();
+    unlink(path.c_str());
+}
+
+int main() {
+    std::cout << "💾 检查点测试" << std::endl;
+
+    test_restart();
+    test_torn_slot_and_layout();
+    test_concurrent_reader();
+    test_restore_time();
+
+    return test_summary();
+}
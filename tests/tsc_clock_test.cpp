@@ -0,0 +1,92 @@
+#include "../src/tsc_clock.h"
+#include "test_util.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void test_conversion() {
+    TscClock::initialize();
+    std::cout << "  时钟源: " << (TscClock::uses_tsc() ? "TSC" : "clock_gettime")
+              << ", " << TscClock::ticks_per_ns() << " ticks/ns" << std::endl;
+
+    // 与 CLOCK_MONOTONIC 的偏差
+    int64_t worst = 0;
+    for (int i = 0; i < 1000; ++i) {
+        int64_t before = TscClock::monotonic_ns();
+        uint64_t ticks = TscClock::now();
+        int64_t after = TscClock::monotonic_ns();
+        int64_t converted = TscClock::to_ns(ticks);
+        int64_t error = converted < before ? before - converted : (converted > after ? converted - after : 0);
+        worst = std::max(worst, error);
+    }
+    std::cout << "  与 CLOCK_MONOTONIC 最大偏差: " << worst << " ns" << std::endl;
+    check(worst < 50000, "换算结果与 CLOCK_MONOTONIC 一致（偏差 < 50us）");
+
+    int64_t real = TscClock::realtime_ns();
+    int64_t converted_real = TscClock::to_realtime_ns(TscClock::now());
+    check(std::abs(converted_real - real) < 1000000, "换算到 CLOCK_REALTIME 偏差 < 1ms");
+
+    uint64_t start = TscClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int64_t elapsed = TscClock::ticks_to_ns(TscClock::now_ordered() - start);
+    check(elapsed >= 20000000 && elapsed < 200000000, "区间换算: sleep 20ms 测得 " + std::to_string(elapsed / 1000) + "us");
+}
+
+static void test_monotonic() {
+    bool monotonic = true;
+    int64_t last = TscClock::to_ns(TscClock::now());
+    uint64_t last_ticks = TscClock::now();
+    for (int i = 0; i < 200000; ++i) {
+        uint64_t ticks = TscClock::now();
+        int64_t ns = TscClock::to_ns(ticks);
+        if (ticks < last_ticks || ns < last) monotonic = false;
+        last = ns;
+        last_ticks = ticks;
+    }
+    check(monotonic, "同一线程读数与换算值单调");
+
+    // 重标定只调整斜率，不会让时间倒退
+    bool continuous = true;
+    for (int round = 0; round < 5; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        uint64_t ticks = TscClock::now();
+        int64_t before = TscClock::to_ns(ticks);
+        TscClock::maybe_recalibrate(1000000);
+        int64_t after = TscClock::to_ns(TscClock::now());
+        if (after < before) continuous = false;
+    }
+    check(continuous, "重标定前后连续");
+
+    int64_t error = std::abs(TscClock::to_ns(TscClock::now()) - TscClock::monotonic_ns());
+    check(error < 50000, "重标定后仍贴合 CLOCK_MONOTONIC");
+}
+
+static void benchmark() {
+    const int iterations = 1000000;
+    uint64_t sink = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) sink += TscClock::now();
+    auto mid = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) sink += std::chrono::steady_clock::now().time_since_epoch().count();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double tsc_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count() / (double)iterations;
+    double steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count() / (double)iterations;
+    std::cout << "  TscClock::now(): " << tsc_ns << " 纳秒/次, steady_clock::now(): " << steady_ns
+              << " 纳秒/次" << (sink == 0 ? " " : "") << std::endl;
+}
+
+int main() {
+    std::cout << "⏱️ TSC 时钟测试" << std::endl;
+
+    test_conversion();
+    test_monotonic();
+    benchmark();
+
+    return test_summary();
+}
@@ -0,0 +1,382 @@
+#include "../src/uring_transport.h"
+#include "../src/ws_frame.h"
+#include "test_util.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <netinet/in.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// WebSocket 帧编解码，以及 io_uring 传输对进程内 WebSocket 服务（明文/TLS）的收发；
+// 最后与阻塞 recv 循环比较每帧的系统调用次数
+
+// 服务端帧不带掩码
+static std::string server_frame(WsOpcode opcode, std::string_view payload, bool fin = true) {
+    std::string frame;
+    frame.push_back(static_cast<char>((fin ? 0x80 : 0) | static_cast<int>(opcode)));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(payload.size()));
+    } else if (payload.size() <= 0xFFFF) {
+        frame.push_back(126);
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size()));
+    } else {
+        frame.push_back(127);
+        for (int i = 0; i < 8; ++i) frame.push_back(static_cast<char>(uint64_t(payload.size()) >> (56 - 8 * i)));
+    }
+    frame.append(payload);
+    return frame;
+}
+
+static void test_decoder() {
+    std::vector<std::string> messages;
+    std::vector<WsOpcode> controls;
+    WsFrameDecoder decoder;
+    decoder.set_message_handler([&](std::string_view payload, bool) { messages.emplace_back(payload); });
+    decoder.set_control_handler([&](WsOpcode opcode, std::string_view) { controls.push_back(opcode); });
+
+    std::string big(70000, 'x');
+    std::string stream = server_frame(WsOpcode::Text, "small") + server_frame(WsOpcode::Text, std::string(300, 'm')) +
+                         server_frame(WsOpcode::Binary, big) + server_frame(WsOpcode::Ping, "p") +
+                         server_frame(WsOpcode::Text, "frag-", false) + server_frame(WsOpcode::Pong, "") +
+                         server_frame(WsOpcode::Continuation, "ment", false) +
+                         server_frame(WsOpcode::Continuation, "ed");
+
+    std::string copy = stream;
+    check(decoder.feed(copy.data(), copy.size()) && messages.size() == 4 && messages[0] == "small" &&
+          messages[1].size() == 300 && messages[2] == big && messages[3] == "frag-mented", "7/16/64 位长度与分片消息");
+    check(controls.size() == 2 && controls[0] == WsOpcode::Ping && controls[1] == WsOpcode::Pong, "分片中间插入的控制帧");
+
+    // 在每个字节位置切成两段输入
+    bool all_splits = true;
+    for (size_t cut = 0; cut <= stream.size(); cut += (cut < 400 ? 1 : 997)) {
+        messages.clear();
+        controls.clear();
+        decoder.reset();
+        copy = stream;
+        all_splits &= decoder.feed(copy.data(), cut) && decoder.feed(copy.data() + cut, copy.size() - cut);
+        all_splits &= messages.size() == 4 && messages[2] == big && messages[3] == "frag-mented" && controls.size() == 2;
+    }
+    check(all_splits, "任意位置切分输入结果相同");
+
+    // 客户端编码的带掩码帧也能解码
+    char encoded[256];
+    size_t length = WsFrameDecoder::encode(WsOpcode::Text, "{\"op\":\"subscribe\"}", 0xA1B2C3D4, encoded, sizeof(encoded));
+    check(length == 6 + 18 && (encoded[1] & 0x80) && memcmp(encoded + 6, "{\"op\"", 5) != 0, "客户端帧带掩码");
+    messages.clear();
+    decoder.reset();
+    check(decoder.feed(encoded, length) && messages.size() == 1 && messages[0] == "{\"op\":\"subscribe\"}", "掩码往返");
+    check(WsFrameDecoder::encode(WsOpcode::Text, std::string(300, 'a'), 1, encoded, sizeof(encoded)) == 0, "编码空间不足返回 0");
+
+    std::string bad = server_frame(WsOpcode::Continuation, "x");
+    decoder.reset();
+    check(!decoder.feed(bad.data(), bad.size()) && !decoder.error().empty(), "孤立的续帧报错");
+    bad = server_frame(WsOpcode::Ping, std::string(126, 'p'));
+    decoder.reset();
+    check(!decoder.feed(bad.data(), bad.size()), "超长控制帧报错");
+    bad = "\xC1\x01x";
+    decoder.reset();
+    check(!decoder.feed(bad.data(), bad.size()), "未协商扩展时 RSV1 报错");
+    WsFrameDecoder small(1024);
+    bad = server_frame(WsOpcode::Text, std::string(2000, 'y'));
+    check(!small.feed(bad.data(), 4), "超过消息上限在收齐之前就报错");
+}
+
+// 进程内 WebSocket 服务端连接: 明文或 TLS
+struct Peer {
+    int fd = -1;
+    SSL* ssl = nullptr;
+
+    bool write(std::string_view data) {
+        while (!data.empty()) {
+            long n = ssl ? SSL_write(ssl, data.data(), static_cast<int>(data.size())) : send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            data.remove_prefix(static_cast<size_t>(n));
+        }
+        return true;
+    }
+    long read(char* buffer, size_t length) {
+        return ssl ? SSL_read(ssl, buffer, static_cast<int>(length)) : recv(fd, buffer, length, 0);
+    }
+    // 读一个客户端帧（带掩码），返回操作码与载荷
+    bool read_frame(WsOpcode& opcode, std::string& payload) {
+        std::string data;
+        char buffer[4096];
+        std::string decoded;
+        WsOpcode seen = WsOpcode::Continuation;
+        bool done = false;
+        WsFrameDecoder decoder;
+        decoder.set_message_handler([&](std::string_view p, bool) { decoded = p; seen = WsOpcode::Text; done = true; });
+        decoder.set_control_handler([&](WsOpcode op, std::string_view p) { decoded = p; seen = op; done = true; });
+        while (!done) {
+            long n = read(buffer, sizeof(buffer));
+            if (n <= 0) return false;
+            decoder.feed(buffer, static_cast<size_t>(n));
+        }
+        opcode = seen;
+        payload = decoded;
+        return true;
+    }
+};
+
+static int listen_loopback(int& port) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    listen(listener, 1);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &length);
+    port = ntohs(addr.sin_port);
+    return listener;
+}
+
+static std::string accept_key(const std::string& key) {
+    std::string source = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(source.data(), source.size(), digest, &length, EVP_sha1(), nullptr);
+    unsigned char out[64];
+    int n = EVP_EncodeBlock(out, digest, static_cast<int>(length));
+    return std::string(reinterpret_cast<char*>(out), static_cast<size_t>(n));
+}
+
+// 接受一个连接，完成升级后执行 script；first_frames 与 101 响应在同一次写出
+static std::thread serve_once(int listener, SSL_CTX* tls, std::string first_frames, std::function<void(Peer&)> script) {
+    return std::thread([=] {
+        Peer peer;
+        peer.fd = accept(listener, nullptr, nullptr);
+        if (tls) {
+            peer.ssl = SSL_new(tls);
+            SSL_set_fd(peer.ssl, peer.fd);
+            if (SSL_accept(peer.ssl) != 1) return;
+        }
+        std::string request;
+        char buffer[4096];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            long n = peer.read(buffer, sizeof(buffer));
+            if (n <= 0) return;
+            request.append(buffer, static_cast<size_t>(n));
+        }
+        size_t at = request.find("Sec-WebSocket-Key: ") + 19;
+        std::string key = request.substr(at, request.find("\r\n", at) - at);
+        peer.write("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: " +
+                   accept_key(key) + "\r\n\r\n" + first_frames);
+        script(peer);
+        if (peer.ssl) {
+            SSL_shutdown(peer.ssl);
+            SSL_free(peer.ssl);
+        }
+        close(peer.fd);
+    });
+}
+
+static EVP_PKEY* tls_key = nullptr;
+static X509* tls_cert = nullptr;
+
+static SSL_CTX* server_context() {
+    if (!tls_key) {
+        tls_key = EVP_EC_gen("P-256");
+        tls_cert = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(tls_cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(tls_cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(tls_cert), 3600);
+        X509_set_pubkey(tls_cert, tls_key);
+        X509_NAME* name = X509_get_subject_name(tls_cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(tls_cert, name);
+        X509_sign(tls_cert, tls_key, EVP_sha256());
+    }
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(ctx, tls_cert);
+    SSL_CTX_use_PrivateKey(ctx, tls_key);
+    return ctx;
+}
+
+static void test_transport(bool use_ssl) {
+    std::string label = use_ssl ? "TLS" : "明文";
+    int port;
+    int listener = listen_loopback(port);
+    SSL_CTX* tls = use_ssl ? server_context() : nullptr;
+
+    const int count = 2000;
+    std::string large(200000, 'L');   // 大于单个接收缓冲区，跨多个完成项
+    std::atomic<bool> pong_seen{false};
+    std::string subscription;
+    std::thread server = serve_once(listener, tls, server_frame(WsOpcode::Text, "hello"), [&](Peer& peer) {
+        WsOpcode opcode;
+        peer.read_frame(opcode, subscription);
+        std::string burst;
+        for (int i = 0; i < count; ++i) burst += server_frame(WsOpcode::Text, "{\"seq\":" + std::to_string(i) + "}");
+        peer.write(burst);
+        peer.write(server_frame(WsOpcode::Text, large));
+        peer.write(server_frame(WsOpcode::Ping, "are-you-there"));
+        std::string payload;
+        pong_seen = peer.read_frame(opcode, payload) && opcode == WsOpcode::Pong && payload == "are-you-there";
+        peer.write(server_frame(WsOpcode::Close, "\x03\xe8"));
+        peer.read_frame(opcode, payload);
+    });
+
+    UringTransportConfig config;
+    config.buffer_count = 8;
+    config.buffer_size = 16 * 1024;
+    UringTransport transport(config);
+    std::vector<std::string> received;
+    transport.set_message_handler([&](std::string_view payload) { received.emplace_back(payload); });
+
+    std::string error;
+    bool connected = transport.connect("127.0.0.1", port, "/ws/v5/public", use_ssl, error);
+    check(connected, label + ": 握手与升级 " + error);
+    if (connected) {
+        transport.send_text("{\"op\":\"subscribe\"}");
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (transport.poll(100) && std::chrono::steady_clock::now() < deadline) {
+        }
+    }
+    server.join();
+    close(listener);
+    if (tls) SSL_CTX_free(tls);
+
+    bool ordered = received.size() == static_cast<size_t>(count) + 2 && received.front() == "hello" && received.back() == large;
+    for (int i = 0; ordered && i < count; ++i) ordered = received[1 + i] == "{\"seq\":" + std::to_string(i) + "}";
+    check(subscription == "{\"op\":\"subscribe\"}", label + ": 服务端收到带掩码的订阅帧");
+    check(ordered, label + ": " + std::to_string(received.size()) + " 条消息完整有序（含与 101 同包的首帧和 200KB 大帧）");
+    check(pong_seen, label + ": 自动回应 ping");
+    check(!transport.is_open() && transport.error() == "server closed the connection", label + ": 关闭帧 -> " + transport.error());
+
+    UringStats stats = transport.stats();
+    check(stats.completions > 0 && stats.messages == received.size() && stats.enters < stats.completions + 16,
+          label + ": " + std::to_string(stats.completions) + " 次接收完成, " + std::to_string(stats.enters) +
+              " 次 io_uring_enter, 重新挂载 " + std::to_string(stats.rearms) + ", 缓冲区用尽 " +
+              std::to_string(stats.buffer_exhausted) + ", kTLS " + (stats.ktls_rx ? "on" : "off"));
+}
+
+static void test_wake() {
+    int port;
+    int listener = listen_loopback(port);
+    std::atomic<bool> done{false};
+    std::thread server = serve_once(listener, nullptr, "", [&](Peer&) {
+        while (!done) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    });
+
+    int wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    UringTransport transport;
+    transport.set_wake_fd(wake);
+    std::string error;
+    check(transport.connect("127.0.0.1", port, "/", false, error), "连接（唤醒测试）");
+
+    std::thread waker([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        eventfd_write(wake, 1);
+    });
+    auto start = std::chrono::steady_clock::now();
+    transport.poll(5000);
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    check(transport.is_open() && waited < 2000, "eventfd 唤醒阻塞的 poll (" + std::to_string(waited) + " ms)");
+
+    waker.join();
+    done = true;
+    transport.close();
+    server.join();
+    close(listener);
+    close(wake);
+}
+
+// 同一服务端推送，io_uring 忙轮询 vs 阻塞 recv 循环
+static void benchmark() {
+    const int frames = 200000;
+    std::string burst;
+    for (int i = 0; i < 1000; ++i) burst += server_frame(WsOpcode::Text, R"({"arg":{"channel":"tickers","instId":"BTC-USDT"},"data":[{"last":"43250.5"}]})");
+    auto script = [&](Peer& peer) {
+        for (int i = 0; i < frames / 1000; ++i) peer.write(burst);
+        peer.write(server_frame(WsOpcode::Close, "\x03\xe8"));
+    };
+
+    int port;
+    int listener = listen_loopback(port);
+    std::thread server = serve_once(listener, nullptr, "", script);
+    UringTransport transport;
+    uint64_t uring_messages = 0;
+    transport.set_message_handler([&](std::string_view) { uring_messages++; });
+    std::string error;
+    transport.connect("127.0.0.1", port, "/", false, error);
+    auto start = std::chrono::steady_clock::now();
+    while (transport.poll(0)) {
+    }
+    double uring_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    server.join();
+    close(listener);
+    UringStats stats = transport.stats();
+
+    listener = listen_loopback(port);
+    server = serve_once(listener, nullptr, "", script);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    std::string upgrade = "GET / HTTP/1.1\r\nHost: x\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n";
+    send(fd, upgrade.data(), upgrade.size(), 0);
+    WsFrameDecoder decoder;
+    uint64_t recv_messages = 0;
+    bool closed = false;
+    decoder.set_message_handler([&](std::string_view, bool) { recv_messages++; });
+    decoder.set_control_handler([&](WsOpcode, std::string_view) { closed = true; });
+    std::vector<char> buffer(64 * 1024);
+    uint64_t recv_calls = 0;
+    bool header_done = false;
+    start = std::chrono::steady_clock::now();
+    while (!closed) {
+        long n = recv(fd, buffer.data(), buffer.size(), 0);
+        recv_calls++;
+        if (n <= 0) break;
+        size_t skip = 0;
+        if (!header_done) {
+            std::string_view view(buffer.data(), static_cast<size_t>(n));
+            skip = view.find("\r\n\r\n") + 4;
+            header_done = true;
+        }
+        decoder.feed(buffer.data() + skip, static_cast<size_t>(n) - skip);
+    }
+    double recv_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    close(fd);
+    server.join();
+    close(listener);
+
+    std::cout << "  io_uring 忙轮询: " << uring_messages << " 帧, " << uring_ns / frames << " ns/帧, "
+              << double(stats.enters) / frames << " 次系统调用/帧" << std::endl;
+    std::cout << "  阻塞 recv 循环:  " << recv_messages << " 帧, " << recv_ns / frames << " ns/帧, "
+              << double(recv_calls) / frames << " 次系统调用/帧" << std::endl;
+    check(uring_messages == frames && recv_messages == frames, "两种接收方式收到全部帧");
+}
+
+int main() {
+    std::cout << "🌀 io_uring 传输测试" << std::endl;
+
+    test_decoder();
+
+    std::string error;
+    if (!UringTransport::available(error)) {
+        std::cout << "⚠️  跳过 io_uring 传输测试: " << error << std::endl;
+    } else {
+        test_transport(false);
+        test_transport(true);
+        test_wake();
+        benchmark();
+    }
+
+    return test_summary();
+}